@@ -0,0 +1,23 @@
+/// \file
+/// \brief Include this file to use any of Agency's parallel algorithms.
+///
+/// Including `<agency/algorithm.hpp>` recursively includes Agency header files organized beneath
+/// `<agency/algorithm/*>`.
+///
+
+///
+/// \defgroup algorithms Algorithms
+/// \brief Parallel algorithms which execute with any execution policy.
+///
+
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/algorithm/for_each.hpp>
+#include <agency/algorithm/partition.hpp>
+#include <agency/algorithm/reduce.hpp>
+#include <agency/algorithm/scan.hpp>
+#include <agency/algorithm/sort.hpp>
+#include <agency/algorithm/transform.hpp>
+#include <agency/algorithm/transform_reduce.hpp>
+
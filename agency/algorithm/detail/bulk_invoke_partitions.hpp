@@ -0,0 +1,238 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/bulk_invoke.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/execution/execution_policy/execution_policy_traits.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/experimental/optional.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// the algorithms in agency/algorithm divide their input into contiguous partitions and
+// execute each partition with an agent created by the caller's execution policy
+//
+// the number of partitions depends on the kind of policy:
+//   * sequenced and unsequenced policies execute a single partition, so the algorithm runs as one loop in the calling thread
+//   * other flat policies execute roughly one partition per hardware thread, each at least min_partition_size elements
+//   * scoped policies execute one outer agent for each group of partitions and one inner agent per partition,
+//     keeping the size of the inner group given by the policy
+//
+// the shape of the caller's policy is replaced; only its executor, and the inner group size of a scoped policy, are kept
+
+
+constexpr std::size_t min_partition_size = 2048;
+
+
+template<class T>
+struct is_scoped_execution_policy : std::false_type {};
+
+template<class ExecutionPolicy1, class ExecutionPolicy2>
+struct is_scoped_execution_policy<scoped_execution_policy<ExecutionPolicy1,ExecutionPolicy2>> : std::true_type {};
+
+
+template<class ExecutionPolicy>
+struct policy_executes_in_one_partition
+  : std::integral_constant<
+      bool,
+      std::is_same<bulk_guarantee_t::sequenced_t,   execution_policy_execution_requirement_t<ExecutionPolicy>>::value ||
+      std::is_same<bulk_guarantee_t::unsequenced_t, execution_policy_execution_requirement_t<ExecutionPolicy>>::value
+    >
+{};
+
+
+inline std::size_t partition_count_for_hardware(std::size_t n, std::size_t group_size)
+{
+  std::size_t num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::size_t num_groups = (n + min_partition_size * group_size - 1) / (min_partition_size * group_size);
+
+  return std::max<std::size_t>(1, std::min(num_groups, num_threads)) * group_size;
+}
+
+
+// returns the size of the inner group of a scoped policy
+// a policy whose inner group is not parameterized gets a single inner agent
+template<class ExecutionPolicy>
+std::size_t inner_group_size(const ExecutionPolicy& policy)
+{
+  std::size_t result = policy.inner().param().domain().size();
+  return result > 0 ? result : 1;
+}
+
+
+// returns the number of partitions an algorithm should divide n elements into
+template<class ExecutionPolicy,
+         __AGENCY_REQUIRES(policy_executes_in_one_partition<ExecutionPolicy>::value)
+        >
+std::size_t partition_count(const ExecutionPolicy&, std::size_t)
+{
+  return 1;
+}
+
+template<class ExecutionPolicy,
+         __AGENCY_REQUIRES(!policy_executes_in_one_partition<ExecutionPolicy>::value),
+         __AGENCY_REQUIRES(!is_scoped_execution_policy<ExecutionPolicy>::value)
+        >
+std::size_t partition_count(const ExecutionPolicy&, std::size_t n)
+{
+  return partition_count_for_hardware(n, 1);
+}
+
+template<class ExecutionPolicy,
+         __AGENCY_REQUIRES(!policy_executes_in_one_partition<ExecutionPolicy>::value),
+         __AGENCY_REQUIRES(is_scoped_execution_policy<ExecutionPolicy>::value)
+        >
+std::size_t partition_count(const ExecutionPolicy& policy, std::size_t n)
+{
+  return partition_count_for_hardware(n, inner_group_size(policy));
+}
+
+
+// returns the first element of the given partition of [0, n)
+// the partitions' sizes differ by at most one
+inline std::size_t partition_begin(std::size_t partition, std::size_t num_partitions, std::size_t n)
+{
+  std::size_t size = n / num_partitions;
+  std::size_t remainder = n % num_partitions;
+
+  return partition * size + std::min(partition, remainder);
+}
+
+
+template<class Function>
+struct flat_partition_functor
+{
+  Function f;
+  std::size_t num_partitions;
+  std::size_t n;
+
+  template<class Agent>
+  void operator()(Agent& self) const
+  {
+    std::size_t partition = self.rank();
+
+    f(partition, partition_begin(partition, num_partitions, n), partition_begin(partition + 1, num_partitions, n));
+  }
+};
+
+
+template<class Function>
+struct scoped_partition_functor
+{
+  Function f;
+  std::size_t num_partitions;
+  std::size_t n;
+
+  template<class Agent>
+  void operator()(Agent& self) const
+  {
+    std::size_t partition = self.outer().rank() * self.inner().group_size() + self.inner().rank();
+
+    f(partition, partition_begin(partition, num_partitions, n), partition_begin(partition + 1, num_partitions, n));
+  }
+};
+
+
+// bulk_invoke_partitions() divides [0, n) into num_partitions partitions and calls f(partition, begin, end) for each
+// num_partitions should be the result of partition_count(policy, n)
+template<class ExecutionPolicy, class Function,
+         __AGENCY_REQUIRES(!is_scoped_execution_policy<decay_t<ExecutionPolicy>>::value)
+        >
+void bulk_invoke_partitions(ExecutionPolicy&& policy, std::size_t num_partitions, std::size_t n, Function f)
+{
+  agency::bulk_invoke(policy(num_partitions), flat_partition_functor<Function>{f, num_partitions, n});
+}
+
+template<class ExecutionPolicy, class Function,
+         __AGENCY_REQUIRES(is_scoped_execution_policy<decay_t<ExecutionPolicy>>::value)
+        >
+void bulk_invoke_partitions(ExecutionPolicy&& policy, std::size_t num_partitions, std::size_t n, Function f)
+{
+  std::size_t inner_size = inner_group_size(policy);
+
+  agency::bulk_invoke(policy.outer()(num_partitions / inner_size, policy.inner()(inner_size)), scoped_partition_functor<Function>{f, num_partitions, n});
+}
+
+
+template<class Function>
+struct task_functor
+{
+  Function f;
+
+  template<class Agent>
+  void operator()(Agent& self) const
+  {
+    f(self.rank());
+  }
+};
+
+
+// bulk_invoke_tasks() calls f(task) for each task in [0, num_tasks)
+// tasks do not correspond to partitions, so a scoped policy executes them with its outer policy alone
+template<class ExecutionPolicy, class Function,
+         __AGENCY_REQUIRES(!is_scoped_execution_policy<decay_t<ExecutionPolicy>>::value)
+        >
+void bulk_invoke_tasks(ExecutionPolicy&& policy, std::size_t num_tasks, Function f)
+{
+  agency::bulk_invoke(policy(num_tasks), task_functor<Function>{f});
+}
+
+template<class ExecutionPolicy, class Function,
+         __AGENCY_REQUIRES(is_scoped_execution_policy<decay_t<ExecutionPolicy>>::value)
+        >
+void bulk_invoke_tasks(ExecutionPolicy&& policy, std::size_t num_tasks, Function f)
+{
+  agency::bulk_invoke(policy.outer()(num_tasks), task_functor<Function>{f});
+}
+
+
+// cache_padded keeps each partition's partial result on its own cache line,
+// so that agents writing adjacent partial results do not contend
+template<class T>
+struct cache_padded
+{
+  T value;
+  char padding[64];
+};
+
+
+// partial_results holds an optional partial result for each partition
+template<class T>
+class partial_results
+{
+  public:
+    explicit partial_results(std::size_t num_partitions)
+      : results_(num_partitions)
+    {}
+
+    experimental::optional<T>& operator[](std::size_t partition)
+    {
+      return results_[partition].value;
+    }
+
+    std::size_t size() const
+    {
+      return results_.size();
+    }
+
+  private:
+    std::vector<cache_padded<experimental::optional<T>>> results_;
+};
+
+
+} // end detail
+} // end agency
+
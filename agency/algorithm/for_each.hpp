@@ -0,0 +1,46 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/algorithm/detail/bulk_invoke_partitions.hpp>
+
+
+namespace agency
+{
+
+
+/// \brief Applies a function to each element of a range.
+/// \ingroup algorithms
+///
+///
+/// for_each() calls `f(*i)` for each iterator `i` in `[first, last)`. The elements are divided into
+/// contiguous partitions which are executed by the agents of `policy`.
+///
+/// \param policy The execution policy whose executor executes the partitions.
+/// \param first The beginning of the range.
+/// \param last The end of the range.
+/// \param f The function to apply.
+template<class ExecutionPolicy, class RandomAccessIterator, class Function,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+void for_each(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, Function f)
+{
+  std::size_t n = last - first;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [=](std::size_t, std::size_t begin, std::size_t end)
+  {
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      f(first[i]);
+    }
+  });
+}
+
+
+} // end agency
+
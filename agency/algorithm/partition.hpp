@@ -0,0 +1,173 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/algorithm/detail/bulk_invoke_partitions.hpp>
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// partition_buffer is the temporary storage partition() moves elements through
+// it remembers which of its elements have been constructed so that if an exception escapes partition(),
+// the elements are destroyed and the storage is released
+template<class T>
+class partition_buffer
+{
+  public:
+    explicit partition_buffer(std::size_t n)
+      : data_(alloc_.allocate(n)),
+        is_constructed_(n)
+    {}
+
+    partition_buffer(const partition_buffer&) = delete;
+
+    ~partition_buffer()
+    {
+      for(std::size_t i = 0; i != is_constructed_.size(); ++i)
+      {
+        if(is_constructed_[i])
+        {
+          data_[i].~T();
+        }
+      }
+
+      alloc_.deallocate(data_, is_constructed_.size());
+    }
+
+    // each element may be constructed and destroyed concurrently with the others
+    void construct(std::size_t i, T&& value)
+    {
+      ::new(static_cast<void*>(data_ + i)) T(std::move(value));
+      is_constructed_[i] = true;
+    }
+
+    void destroy(std::size_t i)
+    {
+      is_constructed_[i] = false;
+      data_[i].~T();
+    }
+
+    T& operator[](std::size_t i)
+    {
+      return data_[i];
+    }
+
+  private:
+    std::allocator<T> alloc_;
+    T* data_;
+    std::vector<char> is_constructed_;
+};
+
+
+} // end detail
+
+
+/// \brief Reorders a range so that the elements which satisfy a predicate precede those which do not.
+/// \ingroup algorithms
+///
+///
+/// partition() reorders the elements of `[first, last)` so that each element for which `pred` returns `true`
+/// precedes every element for which it returns `false`. `pred` is applied once to each element.
+///
+/// Each agent of `policy` tests its partition of the range and counts the elements which satisfy `pred`. The counts
+/// are then scanned in order, and each agent moves its elements to their destinations in a temporary buffer before
+/// they are moved back into the range. When the range is divided into more than one partition, the relative order
+/// of the elements is preserved, but callers should not rely on this.
+///
+/// \return An iterator to the first element which does not satisfy `pred`.
+template<class ExecutionPolicy, class RandomAccessIterator, class Predicate,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+RandomAccessIterator partition(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, Predicate pred)
+{
+  using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  std::size_t n = last - first;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  if(num_partitions == 1)
+  {
+    RandomAccessIterator result = first;
+
+    detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t, std::size_t, std::size_t)
+    {
+      result = std::partition(first, last, pred);
+    });
+
+    return result;
+  }
+
+  // test each element and count the elements of each partition which satisfy pred
+  std::vector<char> flags(n);
+  detail::partial_results<std::size_t> counts(num_partitions);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    std::size_t count = 0;
+
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      flags[i] = static_cast<bool>(pred(first[i]));
+      count += flags[i];
+    }
+
+    counts[partition] = count;
+  });
+
+  // scan the counts to find where each partition's elements go
+  std::vector<std::size_t> true_offsets(num_partitions);
+  std::size_t num_true = 0;
+
+  for(std::size_t partition = 0; partition != num_partitions; ++partition)
+  {
+    true_offsets[partition] = num_true;
+    num_true += *counts[partition];
+  }
+
+  // move each element into its destination in a temporary buffer
+  detail::partition_buffer<value_type> buffer(n);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    std::size_t true_position = true_offsets[partition];
+    std::size_t false_position = num_true + begin - true_offsets[partition];
+
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      std::size_t& position = flags[i] ? true_position : false_position;
+
+      buffer.construct(position, std::move(first[i]));
+      ++position;
+    }
+  });
+
+  // move the elements back into the range
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t, std::size_t begin, std::size_t end)
+  {
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      first[i] = std::move(buffer[i]);
+      buffer.destroy(i);
+    }
+  });
+
+  return first + num_true;
+}
+
+
+} // end agency
+
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/algorithm/transform_reduce.hpp>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+struct reduce_identity
+{
+  template<class T>
+  T&& operator()(T&& x) const
+  {
+    return std::forward<T>(x);
+  }
+};
+
+
+} // end detail
+
+
+/// \brief Reduces a range.
+/// \ingroup algorithms
+///
+///
+/// reduce() returns the generalized sum of `init` and the elements of `[first, last)` using `binary_op`.
+/// Each agent of `policy` reduces a contiguous partition of the range into a partial result, and the partial
+/// results are then reduced in order, so `binary_op` must be associative but need not be commutative.
+///
+/// \return The reduction, or `init` if the range is empty.
+template<class ExecutionPolicy, class RandomAccessIterator, class T, class BinaryOperation,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+T reduce(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation binary_op)
+{
+  return agency::transform_reduce(std::forward<ExecutionPolicy>(policy), first, last, init, binary_op, detail::reduce_identity());
+}
+
+
+/// \brief Sums a range.
+/// \ingroup algorithms
+///
+///
+/// This overload of reduce() is equivalent to `reduce(policy, first, last, init, std::plus<T>())`.
+template<class ExecutionPolicy, class RandomAccessIterator, class T,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+T reduce(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, T init)
+{
+  return agency::reduce(std::forward<ExecutionPolicy>(policy), first, last, init, std::plus<T>());
+}
+
+
+/// \brief Sums a range.
+/// \ingroup algorithms
+///
+///
+/// This overload of reduce() is equivalent to `reduce(policy, first, last, T())`, where `T` is the range's value type.
+template<class ExecutionPolicy, class RandomAccessIterator,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+typename std::iterator_traits<RandomAccessIterator>::value_type
+  reduce(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last)
+{
+  using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  return agency::reduce(std::forward<ExecutionPolicy>(policy), first, last, value_type());
+}
+
+
+} // end agency
+
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/experimental/optional.hpp>
+#include <agency/algorithm/detail/bulk_invoke_partitions.hpp>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// scan_carries() returns, for each partition of [first, first + n), the sum of init and every element preceding the partition
+// the first partition's carry is init, which may be empty
+//
+// each agent sums its partition into a partial result, and the partial results are then scanned in order
+template<class T, class ExecutionPolicy, class RandomAccessIterator, class BinaryOperation>
+std::vector<experimental::optional<T>> scan_carries(ExecutionPolicy& policy, std::size_t num_partitions, RandomAccessIterator first, std::size_t n, experimental::optional<T> init, BinaryOperation op)
+{
+  partial_results<T> partials(num_partitions);
+
+  bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    if(begin == end) return;
+
+    T partial = first[begin];
+
+    for(std::size_t i = begin + 1; i != end; ++i)
+    {
+      partial = op(std::move(partial), first[i]);
+    }
+
+    partials[partition] = std::move(partial);
+  });
+
+  std::vector<experimental::optional<T>> carries(num_partitions);
+
+  carries[0] = std::move(init);
+
+  for(std::size_t partition = 1; partition < num_partitions; ++partition)
+  {
+    carries[partition] = carries[partition - 1];
+
+    if(partials[partition - 1])
+    {
+      if(carries[partition])
+      {
+        carries[partition] = op(std::move(*carries[partition]), std::move(*partials[partition - 1]));
+      }
+      else
+      {
+        carries[partition] = std::move(*partials[partition - 1]);
+      }
+    }
+  }
+
+  return carries;
+}
+
+
+template<class T, class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class BinaryOperation>
+RandomAccessIterator2 inclusive_scan(ExecutionPolicy& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result, BinaryOperation op, experimental::optional<T> init)
+{
+  std::size_t n = last - first;
+  std::size_t num_partitions = partition_count(policy, n);
+
+  std::vector<experimental::optional<T>> carries;
+
+  if(num_partitions > 1)
+  {
+    carries = scan_carries(policy, num_partitions, first, n, std::move(init), op);
+  }
+  else
+  {
+    carries.emplace_back(std::move(init));
+  }
+
+  bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    if(begin == end) return;
+
+    T sum = carries[partition] ? op(*carries[partition], first[begin]) : T(first[begin]);
+    result[begin] = sum;
+
+    for(std::size_t i = begin + 1; i != end; ++i)
+    {
+      sum = op(std::move(sum), first[i]);
+      result[i] = sum;
+    }
+  });
+
+  return result + n;
+}
+
+
+} // end detail
+
+
+/// \brief Computes the inclusive prefix sums of a range.
+/// \ingroup algorithms
+///
+///
+/// inclusive_scan() assigns the generalized sum of `init` and `first[0]`, ..., `first[i]` to `result[i]` using `op`,
+/// for each `i` in `[0, last - first)`. `result` may equal `first`.
+///
+/// The scan executes in three phases: each agent of `policy` sums its partition of the input, the partitions'
+/// sums are scanned in order, and then each agent scans its partition starting from the sum of the partitions before it.
+///
+/// \return `result + (last - first)`
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class BinaryOperation, class T,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+RandomAccessIterator2 inclusive_scan(ExecutionPolicy&& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result, BinaryOperation op, T init)
+{
+  return detail::inclusive_scan<T>(policy, first, last, result, op, experimental::optional<T>(std::move(init)));
+}
+
+
+/// \brief Computes the inclusive prefix sums of a range.
+/// \ingroup algorithms
+///
+///
+/// This overload of inclusive_scan() assigns the generalized sum of `first[0]`, ..., `first[i]` to `result[i]` using `op`.
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class BinaryOperation,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+RandomAccessIterator2 inclusive_scan(ExecutionPolicy&& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result, BinaryOperation op)
+{
+  using value_type = typename std::iterator_traits<RandomAccessIterator1>::value_type;
+
+  return detail::inclusive_scan<value_type>(policy, first, last, result, op, experimental::nullopt);
+}
+
+
+/// \brief Computes the inclusive prefix sums of a range.
+/// \ingroup algorithms
+///
+///
+/// This overload of inclusive_scan() is equivalent to `inclusive_scan(policy, first, last, result, std::plus<T>())`,
+/// where `T` is the input range's value type.
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+RandomAccessIterator2 inclusive_scan(ExecutionPolicy&& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result)
+{
+  using value_type = typename std::iterator_traits<RandomAccessIterator1>::value_type;
+
+  return agency::inclusive_scan(std::forward<ExecutionPolicy>(policy), first, last, result, std::plus<value_type>());
+}
+
+
+/// \brief Computes the exclusive prefix sums of a range.
+/// \ingroup algorithms
+///
+///
+/// exclusive_scan() assigns the generalized sum of `init` and `first[0]`, ..., `first[i-1]` to `result[i]` using `op`,
+/// for each `i` in `[0, last - first)`. `result` may equal `first`.
+///
+/// \return `result + (last - first)`
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class T, class BinaryOperation,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+RandomAccessIterator2 exclusive_scan(ExecutionPolicy&& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result, T init, BinaryOperation op)
+{
+  std::size_t n = last - first;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  std::vector<experimental::optional<T>> carries;
+
+  if(num_partitions > 1)
+  {
+    carries = detail::scan_carries(policy, num_partitions, first, n, experimental::optional<T>(std::move(init)), op);
+  }
+  else
+  {
+    carries.emplace_back(std::move(init));
+  }
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    T sum = *carries[partition];
+
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      // read the input before writing the result, in case they are the same
+      T next = op(sum, first[i]);
+      result[i] = std::move(sum);
+      sum = std::move(next);
+    }
+  });
+
+  return result + n;
+}
+
+
+/// \brief Computes the exclusive prefix sums of a range.
+/// \ingroup algorithms
+///
+///
+/// This overload of exclusive_scan() is equivalent to `exclusive_scan(policy, first, last, result, init, std::plus<T>())`.
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class T,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+RandomAccessIterator2 exclusive_scan(ExecutionPolicy&& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result, T init)
+{
+  return agency::exclusive_scan(std::forward<ExecutionPolicy>(policy), first, last, result, init, std::plus<T>());
+}
+
+
+} // end agency
+
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/algorithm/detail/bulk_invoke_partitions.hpp>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+
+namespace agency
+{
+
+
+/// \brief Sorts a range.
+/// \ingroup algorithms
+///
+///
+/// sort() sorts the elements of `[first, last)` into ascending order according to `comp`.
+/// The relative order of equivalent elements is not preserved.
+///
+/// Each agent of `policy` sorts a partition of the range, and the sorted partitions are then merged pairwise.
+/// Each level of merges is executed by a single launch of `policy`'s executor.
+template<class ExecutionPolicy, class RandomAccessIterator, class Compare,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+void sort(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, Compare comp)
+{
+  std::size_t n = last - first;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t, std::size_t begin, std::size_t end)
+  {
+    std::sort(first + begin, first + end, comp);
+  });
+
+  // merge runs of width partitions into runs of 2 * width partitions until one run remains
+  for(std::size_t width = 1; width < num_partitions; width *= 2)
+  {
+    std::size_t num_merges = (num_partitions + 2 * width - 1) / (2 * width);
+
+    detail::bulk_invoke_tasks(policy, num_merges, [&](std::size_t merge)
+    {
+      std::size_t left  = 2 * width * merge;
+      std::size_t mid   = std::min(left + width, num_partitions);
+      std::size_t right = std::min(left + 2 * width, num_partitions);
+
+      std::inplace_merge(first + detail::partition_begin(left,  num_partitions, n),
+                         first + detail::partition_begin(mid,   num_partitions, n),
+                         first + detail::partition_begin(right, num_partitions, n),
+                         comp);
+    });
+  }
+}
+
+
+/// \brief Sorts a range.
+/// \ingroup algorithms
+///
+///
+/// This overload of sort() is equivalent to `sort(policy, first, last, std::less<T>())`, where `T` is the range's value type.
+template<class ExecutionPolicy, class RandomAccessIterator,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+void sort(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last)
+{
+  using value_type = typename std::iterator_traits<RandomAccessIterator>::value_type;
+
+  agency::sort(std::forward<ExecutionPolicy>(policy), first, last, std::less<value_type>());
+}
+
+
+} // end agency
+
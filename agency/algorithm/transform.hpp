@@ -0,0 +1,73 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/algorithm/detail/bulk_invoke_partitions.hpp>
+
+
+namespace agency
+{
+
+
+/// \brief Stores the result of applying a function to each element of a range into another range.
+/// \ingroup algorithms
+///
+///
+/// transform() assigns `op(first[i])` to `result[i]` for each `i` in `[0, last - first)`. The elements are divided into
+/// contiguous partitions which are executed by the agents of `policy`.
+///
+/// \return `result + (last - first)`
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class UnaryOperation,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+RandomAccessIterator2 transform(ExecutionPolicy&& policy, RandomAccessIterator1 first, RandomAccessIterator1 last, RandomAccessIterator2 result, UnaryOperation op)
+{
+  std::size_t n = last - first;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [=](std::size_t, std::size_t begin, std::size_t end)
+  {
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      result[i] = op(first[i]);
+    }
+  });
+
+  return result + n;
+}
+
+
+/// \brief Stores the result of applying a binary function to each pair of elements of two ranges into another range.
+/// \ingroup algorithms
+///
+///
+/// transform() assigns `op(first1[i], first2[i])` to `result[i]` for each `i` in `[0, last1 - first1)`.
+///
+/// \return `result + (last1 - first1)`
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class RandomAccessIterator3, class BinaryOperation,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2,RandomAccessIterator3>::value)
+        >
+RandomAccessIterator3 transform(ExecutionPolicy&& policy, RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, RandomAccessIterator3 result, BinaryOperation op)
+{
+  std::size_t n = last1 - first1;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [=](std::size_t, std::size_t begin, std::size_t end)
+  {
+    for(std::size_t i = begin; i != end; ++i)
+    {
+      result[i] = op(first1[i], first2[i]);
+    }
+  });
+
+  return result + n;
+}
+
+
+} // end agency
+
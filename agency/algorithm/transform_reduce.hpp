@@ -0,0 +1,122 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/algorithm/detail/bulk_invoke_partitions.hpp>
+#include <functional>
+#include <utility>
+
+
+namespace agency
+{
+
+
+/// \brief Reduces the results of applying a function to each element of a range.
+/// \ingroup algorithms
+///
+///
+/// transform_reduce() returns the generalized sum of `init` and `transform_op(*i)` for each iterator `i` in `[first, last)`
+/// using `reduce_op`. Each agent of `policy` reduces a contiguous partition of the range into a partial result, and the partial
+/// results are then reduced in order, so `reduce_op` must be associative but need not be commutative.
+///
+/// \return The reduction, or `init` if the range is empty.
+template<class ExecutionPolicy, class RandomAccessIterator, class T, class BinaryOperation, class UnaryOperation,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator>::value)
+        >
+T transform_reduce(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, T init, BinaryOperation reduce_op, UnaryOperation transform_op)
+{
+  std::size_t n = last - first;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  detail::partial_results<T> partials(num_partitions);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    if(begin == end) return;
+
+    T partial = transform_op(first[begin]);
+
+    for(std::size_t i = begin + 1; i != end; ++i)
+    {
+      partial = reduce_op(std::move(partial), transform_op(first[i]));
+    }
+
+    partials[partition] = std::move(partial);
+  });
+
+  for(std::size_t partition = 0; partition != partials.size(); ++partition)
+  {
+    if(partials[partition])
+    {
+      init = reduce_op(std::move(init), std::move(*partials[partition]));
+    }
+  }
+
+  return init;
+}
+
+
+/// \brief Reduces the results of applying a binary function to each pair of elements of two ranges.
+/// \ingroup algorithms
+///
+///
+/// transform_reduce() returns the generalized sum of `init` and `transform_op(first1[i], first2[i])`
+/// for each `i` in `[0, last1 - first1)` using `reduce_op`.
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class T, class BinaryOperation1, class BinaryOperation2,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+T transform_reduce(ExecutionPolicy&& policy, RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, T init, BinaryOperation1 reduce_op, BinaryOperation2 transform_op)
+{
+  std::size_t n = last1 - first1;
+  std::size_t num_partitions = detail::partition_count(policy, n);
+
+  detail::partial_results<T> partials(num_partitions);
+
+  detail::bulk_invoke_partitions(policy, num_partitions, n, [&](std::size_t partition, std::size_t begin, std::size_t end)
+  {
+    if(begin == end) return;
+
+    T partial = transform_op(first1[begin], first2[begin]);
+
+    for(std::size_t i = begin + 1; i != end; ++i)
+    {
+      partial = reduce_op(std::move(partial), transform_op(first1[i], first2[i]));
+    }
+
+    partials[partition] = std::move(partial);
+  });
+
+  for(std::size_t partition = 0; partition != partials.size(); ++partition)
+  {
+    if(partials[partition])
+    {
+      init = reduce_op(std::move(init), std::move(*partials[partition]));
+    }
+  }
+
+  return init;
+}
+
+
+/// \brief Computes the inner product of two ranges.
+/// \ingroup algorithms
+///
+///
+/// This overload of transform_reduce() is equivalent to `transform_reduce(policy, first1, last1, first2, init, std::plus<T>(), std::multiplies<T>())`.
+template<class ExecutionPolicy, class RandomAccessIterator1, class RandomAccessIterator2, class T,
+         __AGENCY_REQUIRES(is_execution_policy<detail::decay_t<ExecutionPolicy>>::value),
+         __AGENCY_REQUIRES(detail::iterators_are_random_access<RandomAccessIterator1,RandomAccessIterator2>::value)
+        >
+T transform_reduce(ExecutionPolicy&& policy, RandomAccessIterator1 first1, RandomAccessIterator1 last1, RandomAccessIterator2 first2, T init)
+{
+  return agency::transform_reduce(std::forward<ExecutionPolicy>(policy), first1, last1, first2, init, std::plus<T>(), std::multiplies<T>());
+}
+
+
+} // end agency
+
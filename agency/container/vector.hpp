@@ -490,11 +490,13 @@ class vector
         // create a new storage object
         storage_type new_storage(new_capacity, storage_.allocator());
 
-        // copy our elements into the new storage
-        end_ = detail::uninitialized_copy(std::forward<ExecutionPolicy>(policy), storage_.allocator(), begin(), end(), new_storage.data());
+        // relocate our elements into the new storage
+        iterator new_end = detail::uninitialized_relocate_n(policy, storage_.allocator(), begin(), size(), new_storage.data());
+        detail::destroy_relocated(policy, storage_.allocator(), begin(), end());
 
         // swap out our storage
         storage_.swap(new_storage);
+        end_ = new_end;
       }
     }
 
@@ -712,6 +714,36 @@ class vector
       }
     }
 
+    // resize_default_init() is like resize(), but default-initializes rather than value-initializes new elements
+    // this leaves new elements of trivially default constructible types uninitialized,
+    // which avoids a pass over memory which will be overwritten anyway
+    __AGENCY_ANNOTATION
+    void resize_default_init(size_type new_size)
+    {
+      resize_default_init(sequenced_execution_policy(), new_size);
+    }
+
+    template<class ExecutionPolicy, __AGENCY_REQUIRES(is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value)>
+    __AGENCY_ANNOTATION
+    void resize_default_init(ExecutionPolicy&& policy, size_type new_size)
+    {
+      if(new_size < size())
+      {
+        detail::destroy(std::forward<ExecutionPolicy>(policy), storage_.allocator(), begin() + new_size, end());
+        end_ = begin() + new_size;
+      }
+      else if(new_size > size())
+      {
+        if(new_size > capacity())
+        {
+          // grow exponentially, as insertion does, without exceeding maximum storage
+          reserve(policy, detail::max(new_size, detail::min(size_type(2) * capacity(), max_size())));
+        }
+
+        default_construct_at_end(std::forward<ExecutionPolicy>(policy), new_size - size());
+      }
+    }
+
     __AGENCY_ANNOTATION
     void resize(size_type new_size, const value_type& value)
     {
@@ -818,35 +850,44 @@ class vector
 
         storage_type new_storage(new_capacity, storage_.allocator());
 
-        // record how many constructors we invoke in the try block below
-        iterator new_end = new_storage.data();
+        iterator new_position = new_storage.data() + (position - begin());
+
+        // construct the new elements first, because their arguments may refer to our existing elements
+        detail::construct_n(policy, storage_.allocator(), new_position, count, iters...);
+
+        result = new_position;
+
+        // record the range of elements we construct in the new storage
+        iterator new_begin = new_position;
+        iterator new_end = new_position + count;
 
 #ifndef __CUDA_ARCH__
         try
 #endif
         {
-          // move elements before the insertion to the beginning of the new storage
-          new_end = detail::uninitialized_move_n(policy, storage_.allocator(), begin(), position - begin(), new_storage.data());
-
-          result = new_end;
-
-          // copy construct new elements
-          new_end = detail::construct_n(policy, storage_.allocator(), new_end, count, iters...);
+          // relocate elements after the insertion to the end of the new storage
+          new_end = detail::uninitialized_relocate_n(policy, storage_.allocator(), position, end() - position, new_end);
 
-          // move elements after the insertion to the end of the new storage
-          new_end = detail::uninitialized_move_n(policy, storage_.allocator(), position, end() - position, new_end);
+          // relocate elements before the insertion to the beginning of the new storage
+          detail::uninitialized_relocate_n(policy, storage_.allocator(), begin(), position - begin(), new_storage.data());
+          new_begin = new_storage.data();
         }
 #ifndef __CUDA_ARCH__
         catch(...)
         {
-          // something went wrong, so destroy as many new elements as were constructed
-          detail::destroy(policy, new_storage.allocator(), new_storage.data(), new_end);
+          // something went wrong, so destroy the new elements we constructed
+          // a relocation which throws has already destroyed the elements it constructed,
+          // and relocation does not move elements whose move constructors may throw, so our existing elements remain intact
+          detail::destroy(policy, storage_.allocator(), new_begin, new_end);
 
           // rethrow
           throw;
         }
 #endif
 
+        // all of our existing elements have been relocated, so end their lifetimes
+        detail::destroy_relocated(policy, storage_.allocator(), begin(), end());
+
         // record the vector's new state
         storage_.swap(new_storage);
         end_ = new_end;
@@ -855,6 +896,30 @@ class vector
       return result;
     }
 
+    // default-initializes count elements at the end of this vector, which must have room for them
+    template<class ExecutionPolicy,
+             __AGENCY_REQUIRES(
+               std::is_trivially_default_constructible<T>::value and
+               !detail::allocator_traits_detail::has_construct<allocator_type,pointer>::value
+             )>
+    __AGENCY_ANNOTATION
+    void default_construct_at_end(ExecutionPolicy&&, size_type count)
+    {
+      // default-initializing trivially default constructible elements does nothing
+      end_ += count;
+    }
+
+    template<class ExecutionPolicy,
+             __AGENCY_REQUIRES(
+               !std::is_trivially_default_constructible<T>::value or
+               detail::allocator_traits_detail::has_construct<allocator_type,pointer>::value
+             )>
+    __AGENCY_ANNOTATION
+    void default_construct_at_end(ExecutionPolicy&& policy, size_type count)
+    {
+      end_ = detail::construct_n(std::forward<ExecutionPolicy>(policy), storage_.allocator(), end(), count);
+    }
+
     storage_type storage_;
     iterator end_;
 };
@@ -6,6 +6,7 @@
 #include <agency/detail/algorithm/copy.hpp>
 #include <agency/detail/algorithm/destroy.hpp>
 #include <agency/detail/algorithm/equal.hpp>
+#include <agency/detail/algorithm/fill.hpp>
 #include <agency/detail/algorithm/max.hpp>
 #include <agency/detail/algorithm/min.hpp>
 #include <agency/detail/algorithm/move.hpp>
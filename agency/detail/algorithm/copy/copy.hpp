@@ -5,6 +5,7 @@
 #include <agency/detail/algorithm/copy/copy_n.hpp>
 #include <agency/execution/execution_policy.hpp>
 #include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/experimental/ranges/detail/segmented_iterator.hpp>
 
 namespace agency
 {
@@ -44,6 +45,42 @@ OutputIterator copy(ExecutionPolicy&&, InputIterator first, InputIterator last,
 }
 
 
+namespace copy_detail
+{
+
+
+template<class ExecutionPolicy, class OutputIterator>
+struct copy_segment
+{
+  ExecutionPolicy& policy;
+  OutputIterator& result;
+
+  template<class LocalIterator>
+  __AGENCY_ANNOTATION
+  void operator()(LocalIterator first, LocalIterator last) const
+  {
+    result = detail::copy(policy, first, last, result);
+  }
+};
+
+
+} // end copy_detail
+
+
+// copying from a segmented range copies each of its segments in turn,
+// so that each copy traverses a segment's contiguous local iterators rather than the segmented iterator
+template<class ExecutionPolicy, class Segments, class OutputIterator>
+__AGENCY_ANNOTATION
+OutputIterator copy(ExecutionPolicy&& policy,
+                    experimental::detail::segmented_iterator<Segments> first,
+                    experimental::detail::segmented_iterator<Segments> last,
+                    OutputIterator result)
+{
+  experimental::detail::for_each_segment(first, last, copy_detail::copy_segment<typename std::remove_reference<ExecutionPolicy>::type,OutputIterator>{policy, result});
+  return result;
+}
+
+
 template<class InputIterator, class OutputIterator>
 __AGENCY_ANNOTATION
 OutputIterator copy(InputIterator first, InputIterator last, OutputIterator result)
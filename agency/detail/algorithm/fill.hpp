@@ -0,0 +1,111 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/bulk_invoke.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/iterator/iterator_traits.hpp>
+#include <agency/experimental/ranges/detail/segmented_iterator.hpp>
+#include <type_traits>
+
+namespace agency
+{
+namespace detail
+{
+namespace fill_detail
+{
+
+
+struct fill_functor
+{
+  __agency_exec_check_disable__
+  template<class Agent, class RandomAccessIterator, class T>
+  __AGENCY_ANNOTATION
+  void operator()(Agent& self, RandomAccessIterator first, const T& value)
+  {
+    first[self.rank()] = value;
+  }
+};
+
+
+} // end fill_detail
+
+
+template<class ExecutionPolicy, class RandomAccessIterator, class T,
+         __AGENCY_REQUIRES(
+           !policy_is_sequenced<decay_t<ExecutionPolicy>>::value and
+           iterators_are_random_access<RandomAccessIterator>::value
+         )>
+__AGENCY_ANNOTATION
+void fill(ExecutionPolicy&& policy, RandomAccessIterator first, RandomAccessIterator last, const T& value)
+{
+  agency::bulk_invoke(policy(last - first), fill_detail::fill_functor(), first, value);
+}
+
+
+__agency_exec_check_disable__
+template<class ExecutionPolicy, class ForwardIterator, class T,
+         __AGENCY_REQUIRES(
+           policy_is_sequenced<decay_t<ExecutionPolicy>>::value or
+           !iterators_are_random_access<ForwardIterator>::value
+         )>
+__AGENCY_ANNOTATION
+void fill(ExecutionPolicy&&, ForwardIterator first, ForwardIterator last, const T& value)
+{
+  for(; first != last; ++first)
+  {
+    *first = value;
+  }
+}
+
+
+namespace fill_detail
+{
+
+
+template<class ExecutionPolicy, class T>
+struct fill_segment
+{
+  ExecutionPolicy& policy;
+  const T& value;
+
+  template<class LocalIterator>
+  __AGENCY_ANNOTATION
+  void operator()(LocalIterator first, LocalIterator last) const
+  {
+    detail::fill(policy, first, last, value);
+  }
+};
+
+
+} // end fill_detail
+
+
+// filling a segmented range fills each of its segments in turn,
+// so that each fill traverses a segment's contiguous local iterators rather than the segmented iterator
+template<class ExecutionPolicy, class Segments, class T>
+__AGENCY_ANNOTATION
+void fill(ExecutionPolicy&& policy,
+          experimental::detail::segmented_iterator<Segments> first,
+          experimental::detail::segmented_iterator<Segments> last,
+          const T& value)
+{
+  experimental::detail::for_each_segment(first, last, fill_detail::fill_segment<typename std::remove_reference<ExecutionPolicy>::type,T>{policy, value});
+}
+
+
+template<class ForwardIterator, class T>
+__AGENCY_ANNOTATION
+void fill(ForwardIterator first, ForwardIterator last, const T& value)
+{
+  // pass this instead of agency::seq to work around the prohibition on
+  // taking the address of a global constexpr object (i.e., agency::seq) from a CUDA __device__ function
+  agency::sequenced_execution_policy seq;
+  detail::fill(seq, first, last, value);
+}
+
+
+} // end detail
+} // end agency
+
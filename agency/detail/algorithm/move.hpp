@@ -4,4 +4,5 @@
 #include <agency/detail/algorithm/move/overlapped_uninitialized_move.hpp>
 #include <agency/detail/algorithm/move/uninitialized_move.hpp>
 #include <agency/detail/algorithm/move/uninitialized_move_n.hpp>
+#include <agency/detail/algorithm/move/uninitialized_relocate_n.hpp>
 
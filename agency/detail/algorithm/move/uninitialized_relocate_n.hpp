@@ -0,0 +1,251 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/bulk_invoke.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/algorithm/destroy.hpp>
+#include <agency/detail/algorithm/move/uninitialized_move_n.hpp>
+#include <agency/memory/allocator/detail/allocator_traits.hpp>
+#include <agency/memory/allocator/detail/allocator_traits/check_for_member_functions.hpp>
+#include <agency/memory/is_trivially_relocatable.hpp>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace agency
+{
+namespace detail
+{
+namespace uninitialized_relocate_n_detail
+{
+
+
+template<class Allocator>
+struct is_std_allocator : std::false_type {};
+
+template<class T>
+struct is_std_allocator<std::allocator<T>> : std::true_type {};
+
+
+// std::allocator's construct() & destroy() are equivalent to placement new & explicit destruction
+template<class Allocator, class T>
+using allocator_has_trivial_construct_and_destroy = std::integral_constant<
+  bool,
+  is_std_allocator<Allocator>::value or
+  (!allocator_traits_detail::has_construct<Allocator,T*,T&&>::value and !allocator_traits_detail::has_destroy<Allocator,T*>::value)
+>;
+
+
+template<class Allocator, class Iterator1, class Iterator2>
+struct relocation_is_bitwise_impl : std::false_type {};
+
+template<class Allocator, class T>
+struct relocation_is_bitwise_impl<Allocator,T*,T*>
+  : conjunction<
+      is_trivially_relocatable<T>,
+      allocator_has_trivial_construct_and_destroy<Allocator,T>
+    >
+{};
+
+
+// relocation moves elements whose move constructor cannot throw, and copies the others, like std::move_if_noexcept
+// elements which cannot be copied are moved anyway
+template<class T>
+using relocation_moves = std::integral_constant<
+  bool,
+  std::is_nothrow_move_constructible<T>::value or !std::is_copy_constructible<T>::value
+>;
+
+
+// the number of bytes copied by each agent of a parallel bitwise relocation
+constexpr std::size_t bytes_per_agent = 1 << 16;
+
+
+struct copy_bytes_functor
+{
+  template<class Agent>
+  __AGENCY_ANNOTATION
+  void operator()(Agent& self, unsigned char* result, const unsigned char* first, std::size_t num_bytes) const
+  {
+    std::size_t begin = self.rank() * bytes_per_agent;
+    std::size_t end = begin + bytes_per_agent < num_bytes ? begin + bytes_per_agent : num_bytes;
+
+    std::memcpy(result + begin, first + begin, end - begin);
+  }
+};
+
+
+} // end uninitialized_relocate_n_detail
+
+
+// relocation_is_bitwise is true when relocating elements from Iterator1 to Iterator2
+// is equivalent to copying their bytes
+template<class Allocator, class Iterator1, class Iterator2>
+using relocation_is_bitwise = uninitialized_relocate_n_detail::relocation_is_bitwise_impl<
+  typename std::decay<Allocator>::type,
+  Iterator1,
+  Iterator2
+>;
+
+
+// Relocation happens in two steps:
+//   1. uninitialized_relocate_n() copies or moves the elements of [first, first + n) into the uninitialized storage at result
+//   2. destroy_relocated() ends the lifetimes of the original elements
+//
+// Step 1 moves an element only when its move constructor cannot throw, and copies it otherwise.
+// If step 1 throws, it destroys the elements it has constructed at result, and the original elements remain intact.
+// Callers which relocate several ranges perform step 2 only after step 1 has succeeded for every range.
+//
+// When relocation is bitwise, step 1 is a memcpy and step 2 does nothing.
+
+
+// this overload is for bitwise relocations which need not execute sequentially
+template<class ExecutionPolicy, class Allocator, class T, class Size,
+         __AGENCY_REQUIRES(
+           is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
+         ),
+         __AGENCY_REQUIRES(
+           relocation_is_bitwise<Allocator,T*,T*>::value and
+           !policy_is_sequenced<decay_t<ExecutionPolicy>>::value
+         )>
+__AGENCY_ANNOTATION
+T* uninitialized_relocate_n(ExecutionPolicy&& policy, Allocator&, T* first, Size n, T* result)
+{
+  using namespace uninitialized_relocate_n_detail;
+
+  std::size_t num_bytes = n * sizeof(T);
+  std::size_t num_agents = (num_bytes + bytes_per_agent - 1) / bytes_per_agent;
+
+  if(num_agents > 1)
+  {
+    agency::bulk_invoke(policy(num_agents), copy_bytes_functor(), reinterpret_cast<unsigned char*>(result), reinterpret_cast<const unsigned char*>(first), num_bytes);
+  }
+  else if(num_bytes > 0 && first != nullptr)
+  {
+    // a small relocation is not worth the cost of creating agents
+    std::memcpy(static_cast<void*>(result), static_cast<const void*>(first), num_bytes);
+  }
+
+  return result + n;
+}
+
+
+// this overload is for bitwise relocations which must execute sequentially
+template<class ExecutionPolicy, class Allocator, class T, class Size,
+         __AGENCY_REQUIRES(
+           is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
+         ),
+         __AGENCY_REQUIRES(
+           relocation_is_bitwise<Allocator,T*,T*>::value and
+           policy_is_sequenced<decay_t<ExecutionPolicy>>::value
+         )>
+__AGENCY_ANNOTATION
+T* uninitialized_relocate_n(ExecutionPolicy&&, Allocator&, T* first, Size n, T* result)
+{
+  // the range of an empty container may begin at null, which memcpy must not receive
+  if(n > 0 && first != nullptr)
+  {
+    std::memcpy(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+  }
+
+  return result + n;
+}
+
+
+// this overload is for relocations which are not bitwise and which move elements without throwing
+template<class ExecutionPolicy, class Allocator, class Iterator1, class Size, class Iterator2,
+         __AGENCY_REQUIRES(
+           is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
+         ),
+         __AGENCY_REQUIRES(
+           !relocation_is_bitwise<Allocator,Iterator1,Iterator2>::value and
+           std::is_nothrow_move_constructible<typename std::iterator_traits<Iterator1>::value_type>::value
+         )>
+__AGENCY_ANNOTATION
+Iterator2 uninitialized_relocate_n(ExecutionPolicy&& policy, Allocator& alloc, Iterator1 first, Size n, Iterator2 result)
+{
+  return detail::uninitialized_move_n(std::forward<ExecutionPolicy>(policy), alloc, first, n, result);
+}
+
+
+// this overload is for relocations which are not bitwise and which may throw
+// the elements are constructed sequentially, so that those constructed before an exception can be destroyed
+__agency_exec_check_disable__
+template<class ExecutionPolicy, class Allocator, class Iterator1, class Size, class Iterator2,
+         __AGENCY_REQUIRES(
+           is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
+         ),
+         __AGENCY_REQUIRES(
+           !relocation_is_bitwise<Allocator,Iterator1,Iterator2>::value and
+           !std::is_nothrow_move_constructible<typename std::iterator_traits<Iterator1>::value_type>::value
+         )>
+__AGENCY_ANNOTATION
+Iterator2 uninitialized_relocate_n(ExecutionPolicy&&, Allocator& alloc, Iterator1 first, Size n, Iterator2 result)
+{
+  using value_type = typename std::iterator_traits<Iterator1>::value_type;
+
+  // move or copy, as relocation_moves decides
+  using source_reference = conditional_t<
+    uninitialized_relocate_n_detail::relocation_moves<value_type>::value,
+    value_type&&,
+    const value_type&
+  >;
+
+  Iterator2 current = result;
+
+#ifndef __CUDA_ARCH__
+  try
+#endif
+  {
+    for(Size i = 0; i < n; ++i, ++first, ++current)
+    {
+      detail::allocator_traits<Allocator>::construct(alloc, &*current, static_cast<source_reference>(*first));
+    }
+  }
+#ifndef __CUDA_ARCH__
+  catch(...)
+  {
+    detail::destroy(alloc, result, current);
+    throw;
+  }
+#endif
+
+  return current;
+}
+
+
+template<class ExecutionPolicy, class Allocator, class T,
+         __AGENCY_REQUIRES(
+           is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
+         ),
+         __AGENCY_REQUIRES(
+           relocation_is_bitwise<Allocator,T*,T*>::value
+         )>
+__AGENCY_ANNOTATION
+T* destroy_relocated(ExecutionPolicy&&, Allocator&, T*, T* last)
+{
+  // the original elements' lifetimes ended when their bytes were copied
+  return last;
+}
+
+
+template<class ExecutionPolicy, class Allocator, class Iterator,
+         __AGENCY_REQUIRES(
+           is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
+         ),
+         __AGENCY_REQUIRES(
+           !relocation_is_bitwise<Allocator,Iterator,Iterator>::value
+         )>
+__AGENCY_ANNOTATION
+Iterator destroy_relocated(ExecutionPolicy&& policy, Allocator& alloc, Iterator first, Iterator last)
+{
+  return detail::destroy(std::forward<ExecutionPolicy>(policy), alloc, first, last);
+}
+
+
+} // end detail
+} // end agency
+
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <agency/detail/config.hpp>
+#include <agency/detail/concurrency/synchronic>
+#include <agency/detail/concurrency/fiber.hpp>
 
 #include <functional>
 #include <thread>
@@ -136,7 +138,81 @@ protected:
 };
 
 
-using barrier = blocking_barrier;
+// synchronic_barrier is a sense-reversing barrier which does not take a lock
+// each phase of the barrier has a generation number which the last thread to arrive advances
+// threads waiting for the generation to change spin briefly before parking on a futex via synchronic
+// fibers waiting for the generation to change yield to the other fibers of their thread instead of parking it
+class synchronic_barrier
+{
+  public:
+    inline explicit synchronic_barrier(size_t num_threads)
+      : count_(num_threads),
+        unarrived_count_(num_threads),
+        generation_(0)
+    {
+      if(num_threads == 0) throw std::invalid_argument("barrier: num_threads may not be 0.");
+    }
+
+    // define this to workaround nvcc's automatic execution space deduction for compiler-generated functions
+    inline ~synchronic_barrier() {}
+
+    inline size_t count() const
+    {
+      return count_;
+    }
+
+    inline void arrive_and_drop()
+    {
+      arrive(generation_.load());
+    }
+
+    inline void arrive_and_wait()
+    {
+      // read the generation before arriving, because the last thread to arrive advances it
+      int generation = generation_.load();
+
+      if(!arrive(generation))
+      {
+        if(this_thread_is_fiber())
+        {
+          // the arrivals this fiber waits for may come from fibers of this same thread
+          while(generation_.load() == generation)
+          {
+            this_fiber_yield();
+          }
+        }
+        else
+        {
+          notifier_.wait_for_change(generation_, generation);
+        }
+      }
+    }
+
+  private:
+    // returns true if the caller was the last to arrive
+    inline bool arrive(int generation)
+    {
+      if(unarrived_count_.fetch_sub(1) == 1)
+      {
+        // reset the count for the next phase before releasing the waiting threads into it
+        unarrived_count_.store(count_);
+
+        notifier_.notify_all(generation_, generation + 1);
+
+        return true;
+      }
+
+      return false;
+    }
+
+    size_t count_;
+    std::atomic<size_t> unarrived_count_;
+    std::atomic<int> generation_;
+    std::experimental::synchronic<int, std::experimental::synchronic_option::optimize_for_short_wait> notifier_;
+};
+
+
+using barrier = synchronic_barrier;
 
 
 } // end detail
@@ -6,6 +6,11 @@
 #include <queue>
 #include <atomic>
 #include <condition_variable>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <type_traits>
 
 
 namespace agency
@@ -37,10 +42,18 @@ struct scope_bumper
 template<class T>
 void wait_until_equal(const std::atomic<T>& a, const T& value)
 {
-  // implement this with a spin loop
-  while(a != value)
+  // spin briefly and then yield the processor between polls
+  // so that a thread waiting on a slow popper does not starve it
+  for(int i = 0; a != value; ++i)
   {
-    // spin
+    if(i < 64)
+    {
+      std::experimental::__synchronic_relax();
+    }
+    else
+    {
+      std::experimental::__synchronic_yield();
+    }
   }
 }
 
@@ -282,8 +295,326 @@ class condition_variable_concurrent_queue
 };
 
 
+// lock_free_concurrent_queue is an unbounded multi-producer/multi-consumer queue
+// which does not take a lock to push or pop in the common case
+//
+// items live in a ring which follows Vyukov's bounded MPMC queue: each slot
+// carries a sequence number which tells producers whether the slot is free
+// and consumers whether it is full, so producers & consumers only contend on
+// the positions they claim
+//
+// emplace() never waits: when the ring is full, the item spills into an overflow
+// queue guarded by a mutex. This matters when the only consumers of a queue are
+// also its producers, e.g. thread pool workers which post tasks to their own pool.
+// While the overflow holds items, producers append to it rather than to the ring,
+// so items are popped in approximately the order they were pushed
+//
+// wait_and_pop() waits while the queue is empty
+// the waiting thread spins briefly before parking on a futex via synchronic
+//
+// T's move constructor & move assignment should not throw
+template<class T>
+class lock_free_concurrent_queue
+{
+  public:
+    explicit lock_free_concurrent_queue(std::size_t ring_capacity = 1024)
+      : mask_(round_up_to_power_of_two(ring_capacity) - 1),
+        slots_(new slot[mask_ + 1]),
+        enqueue_position_(0),
+        dequeue_position_(0),
+        overflow_size_(0),
+        is_closed_(false),
+        num_poppers_(0),
+        items_epoch_(0),
+        num_waiting_consumers_(0)
+    {
+      for(std::size_t i = 0; i <= mask_; ++i)
+      {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+      }
+    }
+
+    ~lock_free_concurrent_queue()
+    {
+      close();
+
+      // destroy the items which were never popped
+      while(try_pop([](T&&){}))
+      {
+      }
+    }
+
+    // returns the number of items the ring holds before items spill into the overflow queue
+    std::size_t ring_capacity() const
+    {
+      return mask_ + 1;
+    }
+
+    void close()
+    {
+      // don't attempt to close a closed queue
+      if(is_closed_.exchange(true)) return;
+
+      // wake everyone up
+      items_notifier_.notify_all(items_epoch_, [](std::atomic<int>& epoch)
+      {
+        ++epoch;
+      });
+
+      // wait until all the poppers have finished with wait_and_pop() 
+      detail::wait_until_equal(num_poppers_, 0);
+    }
+
+    bool is_closed()
+    {
+      return is_closed_;
+    }
+
+    template<class... Args>
+    queue_status emplace(Args&&... args)
+    {
+      if(is_closed_)
+      {
+        return queue_status::closed;
+      }
+
+      // construct the item before claiming a slot
+      // so that a throwing constructor cannot leave a claimed slot empty
+      T item(std::forward<Args>(args)...);
+
+      // items which arrive while the overflow queue is non-empty join it,
+      // so that they are not popped before the items which overflowed earlier
+      if(overflow_size_ != 0 || !try_enqueue(item))
+      {
+        std::lock_guard<std::mutex> lock(overflow_mutex_);
+        overflow_.push(std::move(item));
+        ++overflow_size_;
+      }
+
+      notify_if_waiting(num_waiting_consumers_, items_epoch_, items_notifier_);
+
+      return queue_status::open_and_ready;
+    }
+
+    queue_status push(const T& item)
+    {
+      return emplace(item);
+    }
+
+    // XXX this should return queue_status
+    bool wait_and_pop(T& item)
+    {
+      scope_bumper<int> popping(num_poppers_);
+
+      auto move_into_item = [&](T&& value)
+      {
+        item = std::move(value);
+      };
+
+      while(!is_closed_)
+      {
+        if(try_pop(move_into_item))
+        {
+          return true;
+        }
+
+        // the queue is empty, so wait for a producer to fill it
+        ++num_waiting_consumers_;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        int epoch = items_epoch_;
+
+        bool dequeued = !is_closed_ && try_pop(move_into_item);
+
+        if(!dequeued && !is_closed_)
+        {
+          items_notifier_.wait_for_change(items_epoch_, epoch);
+        }
+
+        --num_waiting_consumers_;
+
+        if(dequeued)
+        {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+  private:
+    using notifier_type = std::experimental::synchronic<int, std::experimental::synchronic_option::optimize_for_short_wait>;
+
+    struct slot
+    {
+      std::atomic<std::size_t> sequence;
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+      T& value()
+      {
+        return *reinterpret_cast<T*>(&storage);
+      }
+    };
+
+    static std::size_t round_up_to_power_of_two(std::size_t n)
+    {
+      std::size_t result = 2;
+      while(result < n)
+      {
+        result *= 2;
+      }
+
+      return result;
+    }
+
+    // a slot whose sequence number equals position is free for the producer which claims position
+    // a slot whose sequence number equals position + 1 is full for the consumer which claims position
+    bool try_enqueue(T& item)
+    {
+      std::size_t position = enqueue_position_.load(std::memory_order_relaxed);
+      slot* s = nullptr;
+
+      while(true)
+      {
+        s = &slots_[position & mask_];
+        std::size_t sequence = s->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+
+        if(difference == 0)
+        {
+          if(enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if(difference < 0)
+        {
+          // the queue is full
+          return false;
+        }
+        else
+        {
+          // another producer claimed this position
+          position = enqueue_position_.load(std::memory_order_relaxed);
+        }
+      }
+
+      ::new(&s->storage) T(std::move(item));
+
+      // publish the item to consumers
+      s->sequence.store(position + 1, std::memory_order_release);
+
+      return true;
+    }
+
+    // pops from the ring before the overflow queue, whose items were pushed after the ring's
+    template<class Function>
+    bool try_pop(Function f)
+    {
+      return try_dequeue(f) || try_dequeue_overflow(f);
+    }
+
+    template<class Function>
+    bool try_dequeue_overflow(Function f)
+    {
+      if(overflow_size_ == 0) return false;
+
+      std::lock_guard<std::mutex> lock(overflow_mutex_);
+
+      if(overflow_.empty()) return false;
+
+      f(std::move(overflow_.front()));
+      overflow_.pop();
+      --overflow_size_;
+
+      return true;
+    }
+
+    template<class Function>
+    bool try_dequeue(Function f)
+    {
+      std::size_t position = dequeue_position_.load(std::memory_order_relaxed);
+      slot* s = nullptr;
+
+      while(true)
+      {
+        s = &slots_[position & mask_];
+        std::size_t sequence = s->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+
+        if(difference == 0)
+        {
+          if(dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+          {
+            break;
+          }
+        }
+        else if(difference < 0)
+        {
+          // the queue is empty
+          return false;
+        }
+        else
+        {
+          // another consumer claimed this position
+          position = dequeue_position_.load(std::memory_order_relaxed);
+        }
+      }
+
+      f(std::move(s->value()));
+      s->value().~T();
+
+      // return the slot to producers for the next lap around the ring
+      s->sequence.store(position + mask_ + 1, std::memory_order_release);
+
+      return true;
+    }
+
+    // the fence orders the publication of a slot before the read of the waiter count
+    // a waiter increments its count & fences before its final attempt,
+    // so either that attempt succeeds or we observe the waiter here and bump the epoch
+    static void notify_if_waiting(std::atomic<int>& num_waiting, std::atomic<int>& epoch, notifier_type& notifier)
+    {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      if(num_waiting.load(std::memory_order_relaxed) > 0)
+      {
+        notifier.notify_one(epoch, [](std::atomic<int>& e)
+        {
+          ++e;
+        });
+      }
+    }
+
+    const std::size_t mask_;
+    std::unique_ptr<slot[]> slots_;
+
+    // producers & consumers contend on different positions,
+    // so the positions are padded onto separate cache lines
+    // XXX we pad rather than use alignas() because C++11 operator new
+    //     does not honor extended alignment
+    char padding0_[64];
+    std::atomic<std::size_t> enqueue_position_;
+    char padding1_[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> dequeue_position_;
+    char padding2_[64 - sizeof(std::atomic<std::size_t>)];
+
+    std::mutex overflow_mutex_;
+    std::queue<T> overflow_;
+    std::atomic<std::size_t> overflow_size_;
+
+    std::atomic<bool> is_closed_;
+    std::atomic<int> num_poppers_;
+
+    std::atomic<int> items_epoch_;
+    std::atomic<int> num_waiting_consumers_;
+    notifier_type items_notifier_;
+};
+
+
+// concurrent_queue is unbounded: emplace() never waits for a consumer
 template<class T>
-using concurrent_queue = synchronic_concurrent_queue<T>;
+using concurrent_queue = lock_free_concurrent_queue<T>;
 
 
 } // end detail
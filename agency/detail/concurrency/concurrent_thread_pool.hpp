@@ -0,0 +1,219 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/concurrency/synchronic>
+#include <agency/detail/concurrency/latch.hpp>
+#include <agency/detail/unique_function.hpp>
+
+#include <thread>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <exception>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// concurrent_thread_pool runs each submitted task on a thread of its own as soon as it is submitted
+// a thread which has finished its task parks until it is given another one,
+// and submit() creates a new thread only when no parked thread is available
+//
+// unlike thread_pool, which queues tasks behind a fixed number of threads,
+// every incomplete task submitted to a concurrent_thread_pool makes progress concurrently with every other
+// this is the guarantee required by groups of concurrent agents which synchronize with each other
+class concurrent_thread_pool
+{
+  private:
+    using task_type = unique_function<void()>;
+
+    struct worker
+    {
+      enum state_type
+      {
+        parked = 0,
+        ready = 1,
+        stopped = 2
+      };
+
+      worker()
+        : state(parked)
+      {}
+
+      // the submitter writes task before it changes state to ready
+      task_type task;
+      std::atomic<int> state;
+      std::experimental::synchronic<int, std::experimental::synchronic_option::optimize_for_short_wait> notifier;
+      std::thread thread;
+    };
+
+  public:
+    concurrent_thread_pool()
+      : stopping_(false)
+    {}
+
+    concurrent_thread_pool(const concurrent_thread_pool&) = delete;
+
+    ~concurrent_thread_pool()
+    {
+      std::vector<worker*> parked_workers;
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        parked_workers.swap(parked_workers_);
+      }
+
+      // wake up parked workers and tell them to exit
+      // busy workers exit when they finish their task
+      for(worker* w : parked_workers)
+      {
+        w->notifier.notify_one(w->state, (int)worker::stopped);
+      }
+
+      for(auto& w : workers_)
+      {
+        w->thread.join();
+      }
+    }
+
+    template<class Function>
+    void submit(Function&& f)
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+
+      if(!parked_workers_.empty())
+      {
+        worker* w = parked_workers_.back();
+        parked_workers_.pop_back();
+
+        lock.unlock();
+
+        // hand the task to the parked worker and wake it up
+        w->task = task_type(std::forward<Function>(f));
+        w->notifier.notify_one(w->state, (int)worker::ready);
+      }
+      else
+      {
+        // there are no parked workers, so create a new one
+        std::unique_ptr<worker> w(new worker);
+        w->task = task_type(std::forward<Function>(f));
+        w->state = worker::ready;
+
+        worker* ptr = w.get();
+        w->thread = std::thread([this,ptr]
+        {
+          work(*ptr);
+        });
+
+        workers_.push_back(std::move(w));
+      }
+    }
+
+    // calls f(idx) for each idx in [0, n), each call on a different thread
+    // the calling thread makes the first call and then waits for the others to complete
+    // if any call throws an exception, one such exception is rethrown after all calls complete
+    template<class Function>
+    void bulk_invoke(Function f, size_t n)
+    {
+      if(n == 0) return;
+
+      std::exception_ptr exception;
+      std::atomic_flag has_exception = ATOMIC_FLAG_INIT;
+
+      auto invoke_and_catch = [&](size_t idx)
+      {
+        try
+        {
+          f(idx);
+        }
+        catch(...)
+        {
+          if(!has_exception.test_and_set())
+          {
+            exception = std::current_exception();
+          }
+        }
+      };
+
+      if(n > 1)
+      {
+        latch calls_complete(n - 1);
+
+        for(size_t idx = 1; idx < n; ++idx)
+        {
+          submit([&,idx]
+          {
+            invoke_and_catch(idx);
+            calls_complete.count_down(1);
+          });
+        }
+
+        invoke_and_catch(0);
+
+        calls_complete.wait();
+      }
+      else
+      {
+        invoke_and_catch(0);
+      }
+
+      if(exception)
+      {
+        std::rethrow_exception(exception);
+      }
+    }
+
+    // returns the number of threads created so far
+    size_t size() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return workers_.size();
+    }
+
+  private:
+    void work(worker& self)
+    {
+      while(true)
+      {
+        // spin briefly and then park until we are given a task or told to stop
+        self.notifier.wait_for_change(self.state, (int)worker::parked);
+
+        if(self.state == worker::stopped) return;
+
+        self.task();
+
+        // release the resources owned by the task before parking
+        self.task = task_type();
+
+        self.state = worker::parked;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if(stopping_) return;
+
+        parked_workers_.push_back(&self);
+      }
+    }
+
+    mutable std::mutex mutex_;
+    bool stopping_;
+    std::vector<worker*> parked_workers_;
+    std::vector<std::unique_ptr<worker>> workers_;
+};
+
+
+inline concurrent_thread_pool& system_concurrent_thread_pool()
+{
+  static concurrent_thread_pool resource;
+  return resource;
+}
+
+
+} // end detail
+} // end agency
+
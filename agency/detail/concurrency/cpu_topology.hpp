@@ -0,0 +1,272 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+#endif // __linux__
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// parses a list of cpus such as "0-3,8,10-11" into {0,1,2,3,8,10,11}
+// returns an empty vector if the list is malformed
+inline std::vector<int> parse_cpu_list(const std::string& list)
+{
+  std::vector<int> result;
+
+  std::stringstream ranges(list);
+  std::string range;
+
+  while(std::getline(ranges, range, ','))
+  {
+    // ignore surrounding whitespace, including the newline which ends sysfs files
+    range.erase(0, range.find_first_not_of(" \t\n"));
+    range.erase(range.find_last_not_of(" \t\n") + 1);
+
+    if(range.empty()) continue;
+
+    char* end = nullptr;
+    long first = std::strtol(range.c_str(), &end, 10);
+    long last = first;
+
+    if(end == range.c_str() || first < 0) return std::vector<int>();
+
+    if(*end == '-')
+    {
+      const char* second = end + 1;
+      last = std::strtol(second, &end, 10);
+
+      if(end == second || last < first) return std::vector<int>();
+    }
+
+    if(*end != '\0') return std::vector<int>();
+
+    for(long cpu = first; cpu <= last; ++cpu)
+    {
+      result.push_back(static_cast<int>(cpu));
+    }
+  }
+
+  return result;
+}
+
+
+// cpu_topology describes the cpus available to this process, grouped by the NUMA node they belong to
+class cpu_topology
+{
+  public:
+    // creates a topology from a list of nodes, each of which is a list of cpus
+    explicit cpu_topology(std::vector<std::vector<int>> nodes)
+      : nodes_(std::move(nodes))
+    {
+      // drop nodes without cpus
+      nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), [](const std::vector<int>& node)
+      {
+        return node.empty();
+      }), nodes_.end());
+    }
+
+    // returns the topology of the system this process is running on
+    // on systems where the topology cannot be discovered, this is a single node containing every cpu
+    static const cpu_topology& system()
+    {
+      static const cpu_topology result = discover();
+      return result;
+    }
+
+    size_t num_nodes() const
+    {
+      return nodes_.size();
+    }
+
+    const std::vector<int>& node(size_t i) const
+    {
+      return nodes_[i];
+    }
+
+    const std::vector<std::vector<int>>& nodes() const
+    {
+      return nodes_;
+    }
+
+    // returns every cpu, ordered node by node
+    std::vector<int> cpus() const
+    {
+      std::vector<int> result;
+
+      for(auto& node : nodes_)
+      {
+        result.insert(result.end(), node.begin(), node.end());
+      }
+
+      return result;
+    }
+
+    size_t num_cpus() const
+    {
+      size_t result = 0;
+
+      for(auto& node : nodes_)
+      {
+        result += node.size();
+      }
+
+      return result;
+    }
+
+    // returns the topology restricted to the given cpus
+    // nodes containing none of the given cpus are dropped
+    cpu_topology restrict_to(const std::vector<int>& cpus) const
+    {
+      std::vector<std::vector<int>> nodes;
+
+      for(auto& node : nodes_)
+      {
+        std::vector<int> restricted_node;
+
+        for(int cpu : node)
+        {
+          if(std::find(cpus.begin(), cpus.end(), cpu) != cpus.end())
+          {
+            restricted_node.push_back(cpu);
+          }
+        }
+
+        nodes.push_back(std::move(restricted_node));
+      }
+
+      return cpu_topology(std::move(nodes));
+    }
+
+  private:
+    static cpu_topology discover()
+    {
+      std::vector<int> available = available_cpus();
+
+      std::vector<std::vector<int>> nodes;
+
+#ifdef __linux__
+      if(DIR* dir = opendir("/sys/devices/system/node"))
+      {
+        // collect the ids of the nodes, which need not be contiguous
+        std::vector<int> node_ids;
+
+        while(dirent* entry = readdir(dir))
+        {
+          std::string name = entry->d_name;
+
+          if(name.size() > 4 && name.compare(0, 4, "node") == 0 && name.find_first_not_of("0123456789", 4) == std::string::npos)
+          {
+            node_ids.push_back(std::atoi(name.c_str() + 4));
+          }
+        }
+
+        closedir(dir);
+
+        std::sort(node_ids.begin(), node_ids.end());
+
+        for(int id : node_ids)
+        {
+          std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+          std::string list;
+          std::getline(file, list);
+
+          nodes.push_back(parse_cpu_list(list));
+        }
+      }
+#endif // __linux__
+
+      cpu_topology result = cpu_topology(std::move(nodes)).restrict_to(available);
+
+      if(result.num_cpus() == 0)
+      {
+        // we couldn't discover any nodes, so assume a single node
+        result = cpu_topology(std::vector<std::vector<int>>(1, available));
+      }
+
+      return result;
+    }
+
+    // returns the cpus this process is allowed to run on
+    static std::vector<int> available_cpus()
+    {
+      std::vector<int> result;
+
+#ifdef __linux__
+      cpu_set_t set;
+      CPU_ZERO(&set);
+
+      if(sched_getaffinity(0, sizeof(set), &set) == 0)
+      {
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+          if(CPU_ISSET(cpu, &set))
+          {
+            result.push_back(cpu);
+          }
+        }
+      }
+#endif // __linux__
+
+      if(result.empty())
+      {
+        int n = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+        for(int cpu = 0; cpu < n; ++cpu)
+        {
+          result.push_back(cpu);
+        }
+      }
+
+      return result;
+    }
+
+    std::vector<std::vector<int>> nodes_;
+};
+
+
+// restricts the calling thread to run on the given cpus
+// an empty list of cpus leaves the calling thread's affinity unchanged
+// returns whether or not the affinity was changed
+// on systems without affinity control, this function has no effect
+inline bool bind_this_thread_to_cpus(const std::vector<int>& cpus)
+{
+  if(cpus.empty()) return false;
+
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  for(int cpu : cpus)
+  {
+    if(0 <= cpu && cpu < CPU_SETSIZE)
+    {
+      CPU_SET(cpu, &set);
+    }
+  }
+
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  return false;
+#endif // __linux__
+}
+
+
+} // end detail
+} // end agency
+
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/unique_function.hpp>
+
+#include <memory>
+#include <utility>
+#include <exception>
+#include <cstddef>
+
+#ifdef __linux__
+#include <ucontext.h>
+#define __AGENCY_HAS_FIBERS 1
+#endif // __linux__
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+#if __AGENCY_HAS_FIBERS
+
+
+// fiber is a stackful coroutine which runs a function on a stack of its own
+// the thread which calls resume() runs the fiber until the fiber either calls fiber::yield() or returns,
+// after which resume() returns to its caller
+// a fiber must always be resumed by the thread which created it
+class fiber
+{
+  public:
+    template<class Function>
+    fiber(Function&& f, std::size_t stack_size)
+      : function_(std::forward<Function>(f)),
+        stack_(new char[stack_size]),
+        finished_(false)
+    {
+      getcontext(&context_);
+      context_.uc_stack.ss_sp = stack_.get();
+      context_.uc_stack.ss_size = stack_size;
+      context_.uc_link = nullptr;
+      makecontext(&context_, &fiber::entry, 0);
+    }
+
+    fiber(const fiber&) = delete;
+
+    // runs this fiber until it yields or returns
+    // if the fiber's function exited with an exception, resume() rethrows it
+    inline void resume()
+    {
+      fiber* resumer = current();
+      current() = this;
+
+      swapcontext(&resumer_context_, &context_);
+
+      current() = resumer;
+
+      if(exception_)
+      {
+        std::exception_ptr e = std::move(exception_);
+        exception_ = nullptr;
+        std::rethrow_exception(e);
+      }
+    }
+
+    inline bool finished() const
+    {
+      return finished_;
+    }
+
+    // returns the fiber running on the current thread, or nullptr if the current thread is not running a fiber
+    static fiber*& current()
+    {
+      static thread_local fiber* result = nullptr;
+      return result;
+    }
+
+    // suspends the fiber running on the current thread and returns control to the caller of its resume()
+    // the current thread must be running a fiber
+    static void yield()
+    {
+      fiber* self = current();
+      swapcontext(&self->context_, &self->resumer_context_);
+    }
+
+  private:
+    static void entry()
+    {
+      fiber* self = current();
+
+      try
+      {
+        self->function_();
+      }
+      catch(...)
+      {
+        self->exception_ = std::current_exception();
+      }
+
+      self->finished_ = true;
+
+      // return to the last resumer for good
+      setcontext(&self->resumer_context_);
+    }
+
+    unique_function<void()> function_;
+    std::unique_ptr<char[]> stack_;
+    ucontext_t context_;
+    ucontext_t resumer_context_;
+    bool finished_;
+    std::exception_ptr exception_;
+};
+
+
+#endif // __AGENCY_HAS_FIBERS
+
+
+// returns true when the current thread is running a fiber
+inline bool this_thread_is_fiber()
+{
+#if __AGENCY_HAS_FIBERS
+  return fiber::current() != nullptr;
+#else
+  return false;
+#endif
+}
+
+
+// suspends the fiber running on the current thread so that other fibers of the same thread may run
+// when the current thread is not running a fiber, does nothing
+inline void this_fiber_yield()
+{
+#if __AGENCY_HAS_FIBERS
+  if(fiber::current())
+  {
+    fiber::yield();
+  }
+#endif
+}
+
+
+} // end detail
+} // end agency
+
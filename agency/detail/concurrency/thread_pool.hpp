@@ -6,10 +6,17 @@
 #include <agency/execution/executor/scoped_executor.hpp>
 #include <agency/execution/executor/flattened_executor.hpp>
 #include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/execution/executor/properties/schedule.hpp>
 #include <agency/detail/concurrency/latch.hpp>
 #include <agency/detail/concurrency/concurrent_queue.hpp>
+#include <agency/detail/concurrency/work_stealing_deque.hpp>
+#include <agency/detail/concurrency/thread_pool_config.hpp>
+#include <agency/detail/concurrency/cpu_topology.hpp>
+#include <agency/detail/concurrency/synchronic>
 #include <agency/detail/unique_function.hpp>
+#include <agency/memory/detail/resource/pooled_resource.hpp>
 #include <agency/future.hpp>
+#include <agency/future/detail/on_ready.hpp>
 #include <agency/detail/type_traits.hpp>
 
 #include <thread>
@@ -17,6 +24,10 @@
 #include <algorithm>
 #include <memory>
 #include <future>
+#include <new>
+#include <array>
+#include <mutex>
+#include <atomic>
 
 
 namespace agency
@@ -40,14 +51,100 @@ class thread_pool
       }
     };
 
+    using task_type = unique_function<void()>;
+
+    // each worker in a work-stealing pool owns a deque of tasks which it
+    // pushes & pops without locking and which idle workers steal from
+    // tasks submitted from outside of the pool arrive in a worker's inbox
+    struct worker
+    {
+      explicit worker(unsigned int seed)
+        : inbox_begin(0),
+          inbox_size(0),
+          random_state(seed)
+      {
+        inbox.reserve(256);
+      }
+
+      work_stealing_deque<task_type> deque;
+
+      // the inbox is a queue of the tasks in inbox[inbox_begin, inbox.size())
+      // a vector whose capacity is retained keeps submissions from allocating in the steady state
+      std::mutex inbox_mutex;
+      std::vector<task_type*> inbox;
+      size_t inbox_begin;
+
+      // inbox_size allows thieves to skip empty inboxes without locking
+      std::atomic<size_t> inbox_size;
+
+      // only the worker's thread touches random_state
+      unsigned int random_state;
+    };
+
+    // identifies the pool and worker, if any, the current thread belongs to
+    struct this_thread_state
+    {
+      const thread_pool* pool;
+      size_t worker_index;
+    };
+
+    static this_thread_state& this_thread()
+    {
+      static thread_local this_thread_state state{nullptr, 0};
+      return state;
+    }
+
   public:
-    explicit thread_pool(size_t num_threads = std::max(1u, std::thread::hardware_concurrency()))
+    enum scheduling_policy
+    {
+      // every worker pops tasks from a single queue shared by the whole pool
+      shared_queue,
+
+      // every worker pops tasks from its own deque and steals from others when idle
+      work_stealing
+    };
+
+    explicit thread_pool(size_t num_threads = std::max(1u, std::thread::hardware_concurrency()),
+                         scheduling_policy policy = work_stealing)
+      : thread_pool(std::vector<std::vector<int>>(num_threads), policy)
+    {}
+
+    // creates a pool whose threads are sized & bound to cpus according to config
+    explicit thread_pool(const thread_pool_config& config,
+                         scheduling_policy policy = work_stealing,
+                         const cpu_topology& topology = cpu_topology::system())
+      : thread_pool(config.thread_affinities(topology), policy)
+    {}
+
+    // creates a pool with one thread per element of thread_affinities
+    // each thread is bound to the cpus in its element of thread_affinities, if any
+    explicit thread_pool(std::vector<std::vector<int>> thread_affinities,
+                         scheduling_policy policy = work_stealing)
+      : policy_(policy),
+        epoch_(0),
+        num_sleepers_(0),
+        stopping_(false),
+        next_inbox_(0)
     {
+      size_t num_threads = thread_affinities.size();
+
+      if(policy_ == work_stealing)
+      {
+        for(size_t i = 0; i < num_threads; ++i)
+        {
+          workers_.emplace_back(new worker(static_cast<unsigned int>(i + 1)));
+        }
+      }
+
       for(size_t i = 0; i < num_threads; ++i)
       {
-        threads_.emplace_back([this]
+        std::vector<int> cpus = std::move(thread_affinities[i]);
+
+        threads_.emplace_back([this,i,cpus]
         {
-          work();
+          bind_this_thread_to_cpus(cpus);
+
+          work(i);
         });
       }
     }
@@ -55,28 +152,77 @@ class thread_pool
     ~thread_pool()
     {
       tasks_.close();
+
+      // wake up every sleeping worker and tell it to exit
+      stopping_ = true;
+      notifier_.notify_all(epoch_, [](std::atomic<int>& epoch)
+      {
+        ++epoch;
+      });
+
       threads_.clear();
+
+      // destroy any tasks which were never executed
+      for(auto& w : workers_)
+      {
+        while(task_type* task = w->deque.pop())
+        {
+          delete_task(task);
+        }
+
+        for(size_t i = w->inbox_begin; i < w->inbox.size(); ++i)
+        {
+          delete_task(w->inbox[i]);
+        }
+      }
     }
 
     template<class Function,
              class = result_of_t<Function()>>
     inline void submit(Function&& f)
     {
-      auto is_this_thread = [=](const joining_thread& t)
-      {
-        return t.get_id() == std::this_thread::get_id();
-      };
-
       // guard against self-submission which may result in deadlock
-      // XXX it might be faster to compare this to a thread_local variable
-      if(std::find_if(threads_.begin(), threads_.end(), is_this_thread) == threads_.end())
+      if(this_thread().pool == this)
+      {
+        // the submitting thread is part of this pool so execute immediately 
+        std::forward<Function>(f)();
+      }
+      else if(policy_ == work_stealing)
+      {
+        submit_to_inbox(new_task(std::forward<Function>(f)));
+      }
+      else
       {
         tasks_.emplace(std::forward<Function>(f));
       }
+    }
+
+    // post() is like submit(), except that f never executes on the calling thread
+    // when the caller is a thread of this pool, f goes to the caller's own deque, where idle threads may steal it
+    // continuations use post() so that the thread which made a predecessor ready does not execute every task it launches
+    template<class Function,
+             class = result_of_t<Function()>>
+    inline void post(Function&& f)
+    {
+      if(policy_ == work_stealing)
+      {
+        if(this_thread().pool == this)
+        {
+          workers_[this_thread().worker_index]->deque.push(new_task(std::forward<Function>(f)));
+
+          // order the publication of the task before wake_one_sleeper()'s read of num_sleepers_
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+
+          wake_one_sleeper();
+        }
+        else
+        {
+          submit_to_inbox(new_task(std::forward<Function>(f)));
+        }
+      }
       else
       {
-        // the submitting thread is part of this pool so execute immediately 
-        std::forward<Function>(f)();
+        tasks_.emplace(std::forward<Function>(f));
       }
     }
 
@@ -85,6 +231,11 @@ class thread_pool
       return threads_.size();
     }
 
+    inline scheduling_policy policy() const
+    {
+      return policy_;
+    }
+
     template<class Function, class... Args>
     std::future<result_of_t<Function(Args...)>>
       async(Function&& f, Args&&... args)
@@ -108,104 +259,449 @@ class thread_pool
 
 
   private:
-    inline void work()
+    // tasks are allocated from the system_pooled_resource, so submitting a task
+    // takes no lock and performs no allocation in the steady state
+    template<class Function>
+    inline static task_type* new_task(Function&& f)
     {
-      unique_function<void()> task;
+      void* ptr = system_pooled_resource().allocate(sizeof(task_type));
 
-      while(tasks_.wait_and_pop(task))
+      if(ptr == nullptr)
       {
-        task();
+        throw std::bad_alloc();
       }
+
+      return ::new(ptr) task_type(std::forward<Function>(f));
+    }
+
+    inline static void delete_task(task_type* task)
+    {
+      task->~task_type();
+      system_pooled_resource().deallocate(task, sizeof(task_type));
     }
 
-    agency::detail::concurrent_queue<unique_function<void()>> tasks_;
+    inline void work(size_t worker_index)
+    {
+      this_thread() = this_thread_state{this, worker_index};
+
+      if(policy_ == work_stealing)
+      {
+        steal_work(worker_index);
+      }
+      else
+      {
+        task_type task;
+
+        while(tasks_.wait_and_pop(task))
+        {
+          task();
+        }
+      }
+    }
+
+    inline void steal_work(size_t worker_index)
+    {
+      while(task_type* task = find_or_wait_for_task(worker_index))
+      {
+        (*task)();
+        delete_task(task);
+      }
+    }
+
+    inline void submit_to_inbox(task_type* task)
+    {
+      // distribute submissions round-robin so that concurrent submitters rarely share a lock
+      worker& w = *workers_[next_inbox_.fetch_add(1, std::memory_order_relaxed) % workers_.size()];
+
+      {
+        std::lock_guard<std::mutex> lock(w.inbox_mutex);
+
+        if(w.inbox_begin > 0 && w.inbox.size() == w.inbox.capacity())
+        {
+          // make room by discarding the slots of tasks which have already been taken
+          w.inbox.erase(w.inbox.begin(), w.inbox.begin() + w.inbox_begin);
+          w.inbox_begin = 0;
+        }
+
+        w.inbox.push_back(task);
+        ++w.inbox_size;
+      }
+
+      wake_one_sleeper();
+    }
+
+    inline void wake_one_sleeper()
+    {
+      // the read of num_sleepers_ is ordered after the publication of the task
+      // a worker about to sleep increments num_sleepers_ before its final search for work,
+      // so either that search finds the task or we observe the sleeper here and bump epoch_
+      if(num_sleepers_ > 0)
+      {
+        notifier_.notify_one(epoch_, [](std::atomic<int>& epoch)
+        {
+          ++epoch;
+        });
+      }
+    }
+
+    // returns nullptr only when the pool is stopping
+    inline task_type* find_or_wait_for_task(size_t worker_index)
+    {
+      if(task_type* task = find_task(worker_index))
+      {
+        return task;
+      }
+
+      while(!stopping_)
+      {
+        ++num_sleepers_;
+
+        int epoch = epoch_;
+
+        task_type* task = find_task(worker_index);
+
+        if(task == nullptr && !stopping_)
+        {
+          // spin briefly and then park until a submitter or the destructor changes the epoch
+          notifier_.wait_for_change(epoch_, epoch);
+        }
+
+        --num_sleepers_;
+
+        if(task) return task;
+      }
+
+      return nullptr;
+    }
+
+    inline task_type* find_task(size_t worker_index)
+    {
+      worker& self = *workers_[worker_index];
+
+      // look in our own deque first
+      if(task_type* task = self.deque.pop())
+      {
+        return task;
+      }
+
+      // next, claim the tasks submitted to our inbox
+      if(task_type* task = claim_inbox(self))
+      {
+        return task;
+      }
+
+      // finally, try to steal from other workers beginning at a random victim
+      size_t n = workers_.size();
+      size_t start = next_random(self) % n;
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        size_t victim_index = (start + i) % n;
+        if(victim_index == worker_index) continue;
+
+        worker& victim = *workers_[victim_index];
+
+        if(task_type* task = victim.deque.steal())
+        {
+          return task;
+        }
+
+        // the victim may be busy and not have claimed its inbox yet
+        if(task_type* task = steal_from_inbox(victim))
+        {
+          return task;
+        }
+      }
+
+      return nullptr;
+    }
+
+    inline task_type* claim_inbox(worker& self)
+    {
+      if(self.inbox_size == 0) return nullptr;
+
+      size_t num_transferred = 0;
+      task_type* result = nullptr;
+
+      {
+        std::lock_guard<std::mutex> lock(self.inbox_mutex);
+
+        if(self.inbox_begin == self.inbox.size()) return nullptr;
+
+        // keep the oldest task for ourself
+        result = self.inbox[self.inbox_begin];
+
+        // transfer the rest into our deque where thieves can take them without locking
+        // push them newest-first so that we pop them oldest-first
+        num_transferred = self.inbox.size() - self.inbox_begin - 1;
+        for(size_t i = self.inbox.size() - 1; i > self.inbox_begin; --i)
+        {
+          self.deque.push(self.inbox[i]);
+        }
+
+        self.inbox.clear();
+        self.inbox_begin = 0;
+        self.inbox_size = 0;
+      }
+
+      if(num_transferred > 0)
+      {
+        // there is more work than we can do alone
+        wake_one_sleeper();
+      }
+
+      return result;
+    }
+
+    inline task_type* steal_from_inbox(worker& victim)
+    {
+      if(victim.inbox_size == 0) return nullptr;
+
+      std::lock_guard<std::mutex> lock(victim.inbox_mutex);
+
+      if(victim.inbox_begin == victim.inbox.size()) return nullptr;
+
+      task_type* result = victim.inbox[victim.inbox_begin];
+      ++victim.inbox_begin;
+      --victim.inbox_size;
+
+      if(victim.inbox_begin == victim.inbox.size())
+      {
+        victim.inbox.clear();
+        victim.inbox_begin = 0;
+      }
+
+      return result;
+    }
+
+    inline static unsigned int next_random(worker& self)
+    {
+      // xorshift32
+      unsigned int x = self.random_state;
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      self.random_state = x;
+      return x;
+    }
+
+    scheduling_policy policy_;
+
+    // state used by the work_stealing policy
+    std::vector<std::unique_ptr<worker>> workers_;
+    std::atomic<int> epoch_;
+    std::atomic<int> num_sleepers_;
+    std::atomic<bool> stopping_;
+    std::atomic<size_t> next_inbox_;
+    std::experimental::synchronic<int, std::experimental::synchronic_option::optimize_for_short_wait> notifier_;
+
+    // state used by the shared_queue policy
+    agency::detail::concurrent_queue<task_type> tasks_;
+
     std::vector<joining_thread> threads_;
 };
 
 
 
+// the configuration of the system_thread_pool is initially read from the environment
+// changes made to it before the system_thread_pool is first used take effect
+inline thread_pool_config& system_thread_pool_config()
+{
+  static thread_pool_config config = thread_pool_config::from_environment();
+  return config;
+}
+
+
 inline thread_pool& system_thread_pool()
 {
-  static thread_pool resource;
+  static thread_pool resource(system_thread_pool_config());
   return resource;
 }
 
 
-class thread_pool_executor
+// index_dispenser hands out contiguous ranges of a launch's index space
+// to the tasks which execute that launch, according to a schedule
+class index_dispenser
 {
   public:
-    constexpr static bulk_guarantee_t::parallel_t query(bulk_guarantee_t)
-    {
-      return bulk_guarantee.parallel;
-    }
+    inline index_dispenser(schedule_t schedule, size_t num_indices, size_t num_tasks)
+      : schedule_(schedule),
+        num_indices_(num_indices),
+        num_tasks_(num_tasks),
+        cursor_(0)
+    {}
 
-    friend constexpr bool operator==(const thread_pool_executor&, const thread_pool_executor&) noexcept
+    // returns the number of tasks which should execute a launch of num_indices indices
+    // on a pool of num_threads threads
+    inline static size_t num_tasks(schedule_t schedule, size_t num_indices, size_t num_threads)
     {
-      // currently, all thread_pool_executors compare equal because they all refer to the
-      // system_thread_pool
-      return true;
+      size_t max_num_tasks = num_indices;
+
+      if(!schedule.is_uniform())
+      {
+        // there is no point in creating more tasks than there are chunks
+        max_num_tasks = (num_indices + schedule.chunk_size() - 1) / schedule.chunk_size();
+      }
+
+      return std::min(num_threads, max_num_tasks);
     }
 
-    friend constexpr bool operator!=(const thread_pool_executor& a, const thread_pool_executor& b) noexcept
+    // calls f(idx) for each index assigned to the given task
+    template<class Function>
+    void for_each_index(size_t task_idx, Function&& f)
     {
-      return !(a == b);
+      size_t begin = 0, end = 0;
+
+      if(schedule_.is_uniform())
+      {
+        // each task executes a single block, and the first num_indices_ % num_tasks_ blocks get one extra index
+        size_t block_size = num_indices_ / num_tasks_;
+        size_t remainder  = num_indices_ % num_tasks_;
+
+        begin = task_idx * block_size + std::min(task_idx, remainder);
+        end   = begin + block_size + (task_idx < remainder ? 1 : 0);
+
+        for(size_t idx = begin; idx < end; ++idx)
+        {
+          f(idx);
+        }
+      }
+      else
+      {
+        while(claim(begin, end))
+        {
+          for(size_t idx = begin; idx < end; ++idx)
+          {
+            f(idx);
+          }
+        }
+      }
     }
 
   private:
-    // this deleter fulfills a promise just before
-    // it deletes its argument
-    template<class ResultType>
-    struct fulfill_promise_and_delete
+    // claims the next range of indices from the cursor
+    // returns false when none remain
+    inline bool claim(size_t& begin, size_t& end)
     {
-      std::shared_ptr<std::promise<ResultType>> shared_promise_ptr;
+      if(schedule_.is_dynamic())
+      {
+        begin = cursor_.fetch_add(schedule_.chunk_size(), std::memory_order_relaxed);
+
+        if(begin >= num_indices_) return false;
+
+        end = std::min(num_indices_, begin + schedule_.chunk_size());
+        return true;
+      }
 
-      void operator()(ResultType* ptr_to_result)
+      // the guided schedule claims a share of the remaining indices which shrinks as they are claimed
+      begin = cursor_.load(std::memory_order_relaxed);
+
+      while(begin < num_indices_)
       {
-        // move the result object into the promise
-        shared_promise_ptr->set_value(std::move(*ptr_to_result));
+        size_t remaining = num_indices_ - begin;
+        size_t size = std::min(remaining, std::max(schedule_.chunk_size(), remaining / (2 * num_tasks_)));
 
-        // delete the pointer
-        delete ptr_to_result;
+        if(cursor_.compare_exchange_weak(begin, begin + size, std::memory_order_relaxed))
+        {
+          end = begin + size;
+          return true;
+        }
       }
-    };
-    
 
-  public:
-    // this is the overload of bulk_then_execute for non-void Future
-    template<class Function, class Future, class ResultFactory, class SharedFactory,
-             __AGENCY_REQUIRES(!std::is_void<future_result_t<Future>>::value)
-            >
-    std::future<
-      result_of_t<ResultFactory()>
-    >
-      bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
-    {
-      using result_type = result_of_t<ResultFactory()>;
+      return false;
+    }
+
+    schedule_t schedule_;
+    size_t num_indices_;
+    size_t num_tasks_;
+    std::atomic<size_t> cursor_;
+};
 
-      // create a shared promise to fulfill the result
-      auto shared_promise_ptr = std::make_shared<std::promise<result_type>>();
 
-      // get the shared promise's future
-      auto result_future = shared_promise_ptr->get_future();
+// thread_pool_partition assigns the indices [begin, end) of a bulk launch to a thread pool
+struct thread_pool_partition
+{
+  thread_pool* pool;
+  size_t begin;
+  size_t end;
+};
+
+
+// this deleter fulfills a promise just before
+// it deletes its argument
+template<class ResultType>
+struct fulfill_promise_and_delete
+{
+  std::shared_ptr<agency::promise<ResultType>> shared_promise_ptr;
+
+  void operator()(ResultType* ptr_to_result)
+  {
+    // move the result object into the promise
+    shared_promise_ptr->set_value(std::move(*ptr_to_result));
+
+    // delete the pointer
+    delete ptr_to_result;
+  }
+};
+
+
+// bulk_then_execute_on_thread_pools() executes a bulk continuation whose index space is divided among thread pools by partitions
+// within each partition, indices are assigned to the pool's threads according to schedule
+//
+// no thread waits on the predecessor. instead, the tasks are launched by a continuation of the predecessor
+// when the predecessor is already ready, the calling thread submits the tasks as usual
+// otherwise, the thread which makes the predecessor ready posts them, so that it does not execute them all itself
+//
+// this is the overload for non-void Future
+template<class Partitions, class Function, class Future, class ResultFactory, class SharedFactory,
+         __AGENCY_REQUIRES(!std::is_void<future_result_t<Future>>::value)
+        >
+agency::future<
+  result_of_t<ResultFactory()>
+>
+  bulk_then_execute_on_thread_pools(const Partitions& partitions, schedule_t schedule, Function f, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory)
+{
+  using result_type = result_of_t<ResultFactory()>;
+
+  // create a shared promise to fulfill the result
+  auto shared_promise_ptr = std::make_shared<agency::promise<result_type>>();
 
-      // create a deleter which fulfills the promise with the result and then deletes the result
-      fulfill_promise_and_delete<result_type> deleter{std::move(shared_promise_ptr)};
+  // get the shared promise's future
+  auto result_future = shared_promise_ptr->get_future();
 
-      // create the shared state for the result
-      // note that we use our special deleter with this state
-      auto shared_result_ptr = std::shared_ptr<result_type>(new result_type(result_factory()), std::move(deleter));
+  // create a deleter which fulfills the promise with the result and then deletes the result
+  fulfill_promise_and_delete<result_type> deleter{std::move(shared_promise_ptr)};
 
-      // create the shared state for the shared parameter
-      using shared_arg_type = result_of_t<SharedFactory()>;
-      auto shared_arg_ptr = std::make_shared<shared_arg_type>(shared_factory());
+  // create the shared state for the result
+  // note that we use our special deleter with this state
+  auto shared_result_ptr = std::shared_ptr<result_type>(new result_type(result_factory()), std::move(deleter));
 
-      // share the incoming future
-      auto shared_predecessor = future_traits<Future>::share(predecessor);
+  // create the shared state for the shared parameter
+  using shared_arg_type = result_of_t<SharedFactory()>;
+  auto shared_arg_ptr = std::make_shared<shared_arg_type>(shared_factory());
 
-      // submit n tasks to the thread pool
-      for(size_t idx = 0; idx < n; ++idx)
+  // share the incoming future
+  auto shared_predecessor = future_traits<Future>::share(predecessor);
+
+  std::thread::id caller_id = std::this_thread::get_id();
+
+  detail::on_ready(shared_predecessor, [=]
+  {
+    bool submitted_by_caller = std::this_thread::get_id() == caller_id;
+
+    for(const thread_pool_partition& partition : partitions)
+    {
+      size_t first_idx = partition.begin;
+
+      // create the state which assigns this partition's indices to tasks
+      size_t num_tasks = index_dispenser::num_tasks(schedule, partition.end - partition.begin, partition.pool->size());
+      if(num_tasks == 0) continue;
+
+      auto dispenser_ptr = std::make_shared<index_dispenser>(schedule, partition.end - partition.begin, num_tasks);
+
+      for(size_t task_idx = 0; task_idx < num_tasks; ++task_idx)
       {
-        system_thread_pool().submit([=]() mutable
+        auto task = [=]() mutable
         {
 // nvcc makes this lambda's constructors __host__ __device__ when
 // any of its captures' constructors are __host__ __device__. This causes nvcc
@@ -216,8 +712,11 @@ class thread_pool_executor
           using predecessor_type = future_result_t<Future>;
           predecessor_type& predecessor_arg = const_cast<predecessor_type&>(shared_predecessor.get());
 
-          // call the user's function
-          f(idx, predecessor_arg, *shared_result_ptr, *shared_arg_ptr);
+          // call the user's function for each index assigned to this task
+          dispenser_ptr->for_each_index(task_idx, [&](size_t idx)
+          {
+            f(first_idx + idx, predecessor_arg, *shared_result_ptr, *shared_arg_ptr);
+          });
 
           // we explicitly release shared_result_ptr because even though this
           // lambda's invocation is complete, the lambda's lifetime
@@ -225,59 +724,86 @@ class thread_pool_executor
           // this .reset() is what fulfills the promise via shared_result_ptr's deleter
           shared_result_ptr.reset();
 #endif
-        });
-      }
+        };
 
-      // return the result future
-      return std::move(result_future);
+        // submit the task to the thread pool
+        if(submitted_by_caller)
+        {
+          partition.pool->submit(std::move(task));
+        }
+        else
+        {
+          partition.pool->post(std::move(task));
+        }
+      }
     }
+  });
 
+  // return the result future
+  return result_future;
+}
 
-    // this is the overload of bulk_then_execute for void Future
-    template<class Function, class Future, class ResultFactory, class SharedFactory,
-             __AGENCY_REQUIRES(std::is_void<future_result_t<Future>>::value)
-            >
-    std::future<
-      result_of_t<ResultFactory()>
-    >
-      bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
-    {
-      using result_type = result_of_t<ResultFactory()>;
 
-      // create a shared promise to fulfill the result
-      auto shared_promise_ptr = std::make_shared<std::promise<result_type>>();
+// this is the overload of bulk_then_execute_on_thread_pools() for void Future
+template<class Partitions, class Function, class Future, class ResultFactory, class SharedFactory,
+         __AGENCY_REQUIRES(std::is_void<future_result_t<Future>>::value)
+        >
+agency::future<
+  result_of_t<ResultFactory()>
+>
+  bulk_then_execute_on_thread_pools(const Partitions& partitions, schedule_t schedule, Function f, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory)
+{
+  using result_type = result_of_t<ResultFactory()>;
+
+  // create a shared promise to fulfill the result
+  auto shared_promise_ptr = std::make_shared<agency::promise<result_type>>();
+
+  // get the shared promise's future
+  auto result_future = shared_promise_ptr->get_future();
+
+  // create a deleter which fulfills the promise with the result and then deletes the result
+  fulfill_promise_and_delete<result_type> deleter{std::move(shared_promise_ptr)};
+
+  // create the shared state for the result
+  auto shared_result_ptr = std::shared_ptr<result_type>(new result_type(result_factory()), std::move(deleter));
 
-      // get the shared promise's future
-      auto result_future = shared_promise_ptr->get_future();
+  // create the shared state for the shared parameter
+  using shared_arg_type = result_of_t<SharedFactory()>;
+  auto shared_arg_ptr = std::make_shared<shared_arg_type>(shared_factory());
 
-      // create a deleter which fulfills the promise with the result and then deletes the result
-      fulfill_promise_and_delete<result_type> deleter{std::move(shared_promise_ptr)};
+  // share the incoming future
+  auto shared_predecessor = future_traits<Future>::share(predecessor);
 
-      // create the shared state for the result
-      auto shared_result_ptr = std::shared_ptr<result_type>(new result_type(result_factory()), std::move(deleter));
+  std::thread::id caller_id = std::this_thread::get_id();
 
-      // create the shared state for the shared parameter
-      using shared_arg_type = result_of_t<SharedFactory()>;
-      auto shared_arg_ptr = std::make_shared<shared_arg_type>(shared_factory());
+  detail::on_ready(shared_predecessor, [=]
+  {
+    bool submitted_by_caller = std::this_thread::get_id() == caller_id;
 
-      // share the incoming future
-      auto shared_predecessor = future_traits<Future>::share(predecessor);
+    for(const thread_pool_partition& partition : partitions)
+    {
+      size_t first_idx = partition.begin;
+
+      // create the state which assigns this partition's indices to tasks
+      size_t num_tasks = index_dispenser::num_tasks(schedule, partition.end - partition.begin, partition.pool->size());
+      if(num_tasks == 0) continue;
 
-      // submit n tasks to the thread pool
-      for(size_t idx = 0; idx < n; ++idx)
+      auto dispenser_ptr = std::make_shared<index_dispenser>(schedule, partition.end - partition.begin, num_tasks);
+
+      for(size_t task_idx = 0; task_idx < num_tasks; ++task_idx)
       {
-        system_thread_pool().submit([=]() mutable
+        auto task = [=]() mutable
         {
 // nvcc makes this lambda's constructors __host__ __device__ when
 // any of its captures' constructors are __host__ __device__. This causes nvcc
 // to emit warnings about a __host__ __device__ function calling __host__ functions 
 // this #ifndef works around this problem
 #ifndef __CUDA_ARCH__
-          // wait on the predecessor future
-          shared_predecessor.wait();
-
-          // call the user's function
-          f(idx, *shared_result_ptr, *shared_arg_ptr);
+          // call the user's function for each index assigned to this task
+          dispenser_ptr->for_each_index(task_idx, [&](size_t idx)
+          {
+            f(first_idx + idx, *shared_result_ptr, *shared_arg_ptr);
+          });
 
           // we explicitly release shared_result_ptr because even though this
           // lambda's invocation is complete, the lambda's lifetime
@@ -285,17 +811,286 @@ class thread_pool_executor
           // this .reset() is what fulfills the promise via shared_result_ptr's deleter
           shared_result_ptr.reset();
 #endif
-        });
+        };
+
+        // submit the task to the thread pool
+        if(submitted_by_caller)
+        {
+          partition.pool->submit(std::move(task));
+        }
+        else
+        {
+          partition.pool->post(std::move(task));
+        }
       }
+    }
+  });
 
-      // return the result future
-      return std::move(result_future);
+  // return the result future
+  return result_future;
+}
+
+
+class thread_pool_executor
+{
+  public:
+    template<class T>
+    using future = agency::future<T>;
+
+    // a default-constructed thread_pool_executor refers to the system_thread_pool
+    // note that the system_thread_pool is not created until it is first used
+    constexpr thread_pool_executor()
+      : pool_(nullptr),
+        schedule_()
+    {}
+
+    explicit constexpr thread_pool_executor(thread_pool& pool, schedule_t schedule = schedule_t())
+      : pool_(&pool),
+        schedule_(schedule)
+    {}
+
+    thread_pool& pool() const
+    {
+      return pool_ ? *pool_ : system_thread_pool();
+    }
+
+    constexpr static bulk_guarantee_t::parallel_t query(bulk_guarantee_t)
+    {
+      return bulk_guarantee.parallel;
+    }
+
+    constexpr schedule_t query(const schedule_t&) const
+    {
+      return schedule_;
+    }
+
+    template<class Schedule,
+             __AGENCY_REQUIRES(is_schedule<Schedule>::value)
+            >
+    thread_pool_executor require(const Schedule& schedule) const
+    {
+      thread_pool_executor result = *this;
+      result.schedule_ = schedule;
+      return result;
+    }
+
+    friend bool operator==(const thread_pool_executor& a, const thread_pool_executor& b) noexcept
+    {
+      return &a.pool() == &b.pool() && a.schedule_ == b.schedule_;
+    }
+
+    friend bool operator!=(const thread_pool_executor& a, const thread_pool_executor& b) noexcept
+    {
+      return !(a == b);
+    }
+
+    template<class Function, class Future, class ResultFactory, class SharedFactory>
+    future<
+      result_of_t<ResultFactory()>
+    >
+      bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+      // the whole index space goes to our pool
+      std::array<thread_pool_partition, 1> partitions{{thread_pool_partition{&pool(), 0, n}}};
+
+      return detail::bulk_then_execute_on_thread_pools(partitions, schedule_, f, predecessor, result_factory, shared_factory);
     }
 
     size_t unit_shape() const
     {
-      return system_thread_pool().size();
+      return pool().size();
     }
+
+  private:
+    thread_pool* pool_;
+    schedule_t schedule_;
+};
+
+
+// numa_thread_pool is a collection of thread pools, one per NUMA node
+// the threads of each node's pool are bound to the cpus of that node
+class numa_thread_pool
+{
+  public:
+    // config.num_threads threads are divided evenly among the nodes of the topology which contain cpus in config.cpus
+    // within each node, config.pinning determines how threads are bound to that node's cpus
+    // with no_pinning, a node's threads may run on any of that node's cpus
+    explicit numa_thread_pool(const thread_pool_config& config = thread_pool_config(),
+                              thread_pool::scheduling_policy policy = thread_pool::work_stealing,
+                              const cpu_topology& topology = cpu_topology::system())
+    {
+      cpu_topology usable = config.usable_topology(topology);
+
+      size_t num_threads = config.resolve_num_threads(topology);
+
+      if(usable.num_nodes() == 0)
+      {
+        // none of the requested cpus exist, so create a single unbound node
+        node_pools_.emplace_back(new thread_pool(num_threads, policy));
+        return;
+      }
+
+      // every node gets at least one thread
+      size_t num_nodes = std::min(usable.num_nodes(), num_threads);
+
+      for(size_t i = 0; i < num_nodes; ++i)
+      {
+        size_t num_node_threads = num_threads / num_nodes + (i < num_threads % num_nodes ? 1 : 0);
+
+        thread_pool_config node_config(num_node_threads, config.pinning, usable.node(i));
+
+        if(config.pinning == thread_pool_config::scatter)
+        {
+          // there is only one node to scatter threads across
+          node_config.pinning = thread_pool_config::compact;
+        }
+        else if(config.pinning == thread_pool_config::cpu_list)
+        {
+          // preserve the order of the given list
+          node_config.cpus.clear();
+
+          for(int cpu : config.cpus)
+          {
+            if(std::find(usable.node(i).begin(), usable.node(i).end(), cpu) != usable.node(i).end())
+            {
+              node_config.cpus.push_back(cpu);
+            }
+          }
+        }
+
+        node_pools_.emplace_back(new thread_pool(node_config, policy, topology));
+      }
+    }
+
+    inline size_t num_nodes() const
+    {
+      return node_pools_.size();
+    }
+
+    inline thread_pool& node(size_t i) const
+    {
+      return *node_pools_[i];
+    }
+
+    inline size_t size() const
+    {
+      size_t result = 0;
+
+      for(auto& pool : node_pools_)
+      {
+        result += pool->size();
+      }
+
+      return result;
+    }
+
+    // divides the indices [0, n) into contiguous ranges, one per node, in proportion to the size of each node's pool
+    // the division depends only on n, so index i of two launches of the same size runs on the same node
+    inline std::vector<thread_pool_partition> partitions(size_t n) const
+    {
+      std::vector<thread_pool_partition> result;
+      result.reserve(node_pools_.size());
+
+      size_t total_num_threads = size();
+      size_t num_preceding_threads = 0;
+
+      for(auto& pool : node_pools_)
+      {
+        size_t begin = n * num_preceding_threads / total_num_threads;
+        num_preceding_threads += pool->size();
+        size_t end = n * num_preceding_threads / total_num_threads;
+
+        result.push_back(thread_pool_partition{pool.get(), begin, end});
+      }
+
+      return result;
+    }
+
+  private:
+    std::vector<std::unique_ptr<thread_pool>> node_pools_;
+};
+
+
+inline numa_thread_pool& system_numa_thread_pool()
+{
+  static numa_thread_pool resource(system_thread_pool_config());
+  return resource;
+}
+
+
+// numa_thread_pool_executor sends each agent of a bulk launch to the NUMA node given by numa_thread_pool::partitions()
+// because the assignment depends only on the size of the launch, the memory pages first touched by agent i
+// are local to the node which executes agent i in later launches of the same size
+class numa_thread_pool_executor
+{
+  public:
+    template<class T>
+    using future = agency::future<T>;
+
+    // a default-constructed numa_thread_pool_executor refers to the system_numa_thread_pool
+    // note that the system_numa_thread_pool is not created until it is first used
+    constexpr numa_thread_pool_executor()
+      : pool_(nullptr),
+        schedule_()
+    {}
+
+    explicit constexpr numa_thread_pool_executor(numa_thread_pool& pool, schedule_t schedule = schedule_t())
+      : pool_(&pool),
+        schedule_(schedule)
+    {}
+
+    numa_thread_pool& pool() const
+    {
+      return pool_ ? *pool_ : system_numa_thread_pool();
+    }
+
+    constexpr static bulk_guarantee_t::parallel_t query(bulk_guarantee_t)
+    {
+      return bulk_guarantee.parallel;
+    }
+
+    constexpr schedule_t query(const schedule_t&) const
+    {
+      return schedule_;
+    }
+
+    template<class Schedule,
+             __AGENCY_REQUIRES(is_schedule<Schedule>::value)
+            >
+    numa_thread_pool_executor require(const Schedule& schedule) const
+    {
+      numa_thread_pool_executor result = *this;
+      result.schedule_ = schedule;
+      return result;
+    }
+
+    friend bool operator==(const numa_thread_pool_executor& a, const numa_thread_pool_executor& b) noexcept
+    {
+      return &a.pool() == &b.pool() && a.schedule_ == b.schedule_;
+    }
+
+    friend bool operator!=(const numa_thread_pool_executor& a, const numa_thread_pool_executor& b) noexcept
+    {
+      return !(a == b);
+    }
+
+    template<class Function, class Future, class ResultFactory, class SharedFactory>
+    future<
+      result_of_t<ResultFactory()>
+    >
+      bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+      return detail::bulk_then_execute_on_thread_pools(pool().partitions(n), schedule_, f, predecessor, result_factory, shared_factory);
+    }
+
+    size_t unit_shape() const
+    {
+      return pool().size();
+    }
+
+  private:
+    numa_thread_pool* pool_;
+    schedule_t schedule_;
 };
 
 
@@ -319,6 +1114,16 @@ using parallel_vector_thread_pool_executor = agency::flattened_executor<
 >;
 
 
+// compose numa_thread_pool_executor with other fancy executors
+// to yield a parallel_numa_thread_pool_executor
+using parallel_numa_thread_pool_executor = agency::flattened_executor<
+  agency::scoped_executor<
+    numa_thread_pool_executor,
+    agency::this_thread::parallel_executor
+  >
+>;
+
+
 } // end detail
 } // end agency
 
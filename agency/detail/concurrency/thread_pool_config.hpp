@@ -0,0 +1,170 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/concurrency/cpu_topology.hpp>
+
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// thread_pool_config describes how many threads a thread_pool creates and which cpus they run on
+struct thread_pool_config
+{
+  enum pinning_policy
+  {
+    // threads are not bound to particular cpus
+    // if cpus is non-empty, each thread may run on any cpu in cpus
+    no_pinning,
+
+    // thread i is bound to the i-th cpu, where cpus are ordered node by node
+    // consecutive threads share a NUMA node
+    compact,
+
+    // consecutive threads are bound to cpus of different NUMA nodes, round-robin
+    scatter,
+
+    // thread i is bound to cpus[i], in the order given
+    cpu_list
+  };
+
+  // when num_threads is zero, a pool creates one thread per cpu
+  // when cpus is empty, a pool uses every cpu available to the process
+  explicit thread_pool_config(size_t num_threads = 0,
+                              pinning_policy pinning = no_pinning,
+                              std::vector<int> cpus = std::vector<int>())
+    : num_threads(num_threads),
+      pinning(pinning),
+      cpus(std::move(cpus))
+  {}
+
+  size_t num_threads;
+  pinning_policy pinning;
+  std::vector<int> cpus;
+
+  // creates a configuration from the following environment variables:
+  //
+  // AGENCY_NUM_THREADS: the number of threads
+  // AGENCY_PIN_THREADS: one of "none", "compact", "scatter", or a list of cpus such as "0-3,8,10"
+  //
+  // variables which are unset or malformed are ignored
+  inline static thread_pool_config from_environment()
+  {
+    thread_pool_config result;
+
+    if(const char* num_threads = std::getenv("AGENCY_NUM_THREADS"))
+    {
+      long n = std::atol(num_threads);
+
+      if(n > 0)
+      {
+        result.num_threads = static_cast<size_t>(n);
+      }
+    }
+
+    if(const char* pin = std::getenv("AGENCY_PIN_THREADS"))
+    {
+      std::string policy = pin;
+
+      if(policy == "compact")
+      {
+        result.pinning = compact;
+      }
+      else if(policy == "scatter")
+      {
+        result.pinning = scatter;
+      }
+      else if(policy != "none")
+      {
+        std::vector<int> cpus = parse_cpu_list(policy);
+
+        if(!cpus.empty())
+        {
+          result.pinning = cpu_list;
+          result.cpus = std::move(cpus);
+        }
+      }
+    }
+
+    return result;
+  }
+
+  // returns the number of threads a pool created from this configuration has on the given topology
+  inline size_t resolve_num_threads(const cpu_topology& topology) const
+  {
+    if(num_threads > 0) return num_threads;
+
+    size_t result = (pinning == cpu_list && !cpus.empty()) ? cpus.size() : usable_topology(topology).num_cpus();
+
+    return result > 0 ? result : 1;
+  }
+
+  // returns, for each thread of a pool created from this configuration, the cpus that thread may run on
+  // an empty list means that the thread may run anywhere
+  inline std::vector<std::vector<int>> thread_affinities(const cpu_topology& topology) const
+  {
+    size_t n = resolve_num_threads(topology);
+
+    std::vector<std::vector<int>> result(n);
+
+    cpu_topology usable = usable_topology(topology);
+
+    if(usable.num_cpus() == 0)
+    {
+      // none of the requested cpus exist, so don't bind
+      return result;
+    }
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      switch(pinning)
+      {
+        case no_pinning:
+        {
+          result[i] = cpus.empty() ? std::vector<int>() : usable.cpus();
+          break;
+        }
+
+        case compact:
+        {
+          std::vector<int> ordered = usable.cpus();
+          result[i].push_back(ordered[i % ordered.size()]);
+          break;
+        }
+
+        case scatter:
+        {
+          const std::vector<int>& node = usable.node(i % usable.num_nodes());
+          result[i].push_back(node[(i / usable.num_nodes()) % node.size()]);
+          break;
+        }
+
+        case cpu_list:
+        {
+          std::vector<int> list = cpus.empty() ? usable.cpus() : cpus;
+          result[i].push_back(list[i % list.size()]);
+          break;
+        }
+      }
+    }
+
+    return result;
+  }
+
+  // returns the part of the given topology this configuration's threads may use
+  inline cpu_topology usable_topology(const cpu_topology& topology) const
+  {
+    return cpus.empty() ? topology : topology.restrict_to(cpus);
+  }
+};
+
+
+} // end detail
+} // end agency
+
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// work_stealing_deque is a Chase-Lev deque of pointers
+// the single thread which owns the deque pushes and pops at the bottom without taking any locks
+// while any number of other threads may concurrently steal from the top
+//
+// the implementation follows Le, Pop, Cohen & Zappa Nardelli,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013)
+//
+// the deque does not own the objects its elements point to
+template<class T>
+class work_stealing_deque
+{
+  private:
+    // a ring is a circular array of atomic pointers whose capacity is a power of two
+    class ring
+    {
+      public:
+        explicit ring(std::ptrdiff_t capacity)
+          : mask_(capacity - 1),
+            elements_(new std::atomic<T*>[capacity])
+        {}
+
+        std::ptrdiff_t capacity() const
+        {
+          return mask_ + 1;
+        }
+
+        T* get(std::ptrdiff_t i) const
+        {
+          return elements_[i & mask_].load(std::memory_order_relaxed);
+        }
+
+        void put(std::ptrdiff_t i, T* ptr)
+        {
+          elements_[i & mask_].store(ptr, std::memory_order_relaxed);
+        }
+
+        // returns a copy of this ring with twice its capacity
+        std::unique_ptr<ring> grow(std::ptrdiff_t top, std::ptrdiff_t bottom) const
+        {
+          std::unique_ptr<ring> result(new ring(2 * capacity()));
+
+          for(std::ptrdiff_t i = top; i < bottom; ++i)
+          {
+            result->put(i, get(i));
+          }
+
+          return result;
+        }
+
+      private:
+        std::ptrdiff_t mask_;
+        std::unique_ptr<std::atomic<T*>[]> elements_;
+    };
+
+  public:
+    explicit work_stealing_deque(std::ptrdiff_t initial_capacity = 256)
+      : top_(0),
+        bottom_(0)
+    {
+      rings_.emplace_back(new ring(initial_capacity));
+      ring_.store(rings_.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    // only the owning thread may call push()
+    void push(T* ptr)
+    {
+      std::ptrdiff_t b = bottom_.load(std::memory_order_relaxed);
+      std::ptrdiff_t t = top_.load(std::memory_order_acquire);
+      ring* r = ring_.load(std::memory_order_relaxed);
+
+      if(b - t > r->capacity() - 1)
+      {
+        // the ring is full, so grow it
+        // the old ring is retained until the deque is destroyed
+        // because a concurrent thief may still be reading from it
+        rings_.emplace_back(r->grow(t, b));
+        r = rings_.back().get();
+        ring_.store(r, std::memory_order_release);
+      }
+
+      r->put(b, ptr);
+
+      // publish the element to thieves
+      bottom_.store(b + 1, std::memory_order_release);
+    }
+
+    // only the owning thread may call pop()
+    // returns nullptr if the deque is empty
+    T* pop()
+    {
+      std::ptrdiff_t b = bottom_.load(std::memory_order_relaxed) - 1;
+      ring* r = ring_.load(std::memory_order_relaxed);
+      bottom_.store(b, std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      std::ptrdiff_t t = top_.load(std::memory_order_relaxed);
+
+      T* result = nullptr;
+
+      if(t <= b)
+      {
+        // the deque is non-empty
+        result = r->get(b);
+
+        if(t == b)
+        {
+          // this is the last element, so race thieves for it
+          if(!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+          {
+            // a thief won the race
+            result = nullptr;
+          }
+
+          bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+      }
+      else
+      {
+        // the deque is empty, so restore bottom
+        bottom_.store(b + 1, std::memory_order_relaxed);
+      }
+
+      return result;
+    }
+
+    // any thread may call steal()
+    // returns nullptr if the deque is empty or if the steal lost a race
+    T* steal()
+    {
+      std::ptrdiff_t t = top_.load(std::memory_order_acquire);
+
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+
+      std::ptrdiff_t b = bottom_.load(std::memory_order_acquire);
+
+      T* result = nullptr;
+
+      if(t < b)
+      {
+        ring* r = ring_.load(std::memory_order_acquire);
+        result = r->get(t);
+
+        if(!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+          // another thread won the race
+          result = nullptr;
+        }
+      }
+
+      return result;
+    }
+
+    // the result of size() is only a snapshot when other threads are active
+    std::size_t size() const
+    {
+      std::ptrdiff_t b = bottom_.load(std::memory_order_relaxed);
+      std::ptrdiff_t t = top_.load(std::memory_order_relaxed);
+      return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+    bool empty() const
+    {
+      return size() == 0;
+    }
+
+  private:
+    // top_ and bottom_ are padded onto separate cache lines
+    // because thieves contend on top_ while the owner writes bottom_
+    // XXX we pad rather than use alignas() because C++11 operator new
+    //     does not honor extended alignment
+    std::atomic<std::ptrdiff_t> top_;
+    char padding0_[64 - sizeof(std::atomic<std::ptrdiff_t>)];
+    std::atomic<std::ptrdiff_t> bottom_;
+    char padding1_[64 - sizeof(std::atomic<std::ptrdiff_t>)];
+    std::atomic<ring*> ring_;
+
+    // only the owner touches rings_
+    std::vector<std::unique_ptr<ring>> rings_;
+};
+
+
+} // end detail
+} // end agency
+
@@ -34,13 +34,27 @@ struct then_execute_agent_functor
 
   using executor_shape_type = executor_shape_t<Executor>;
 
+  using agent_index_type    = typename AgentTraits::index_type;
+  using executor_index_type = executor_index_t<Executor>;
+
+  using index_caster_type = index_caster<agent_index_type, executor_index_type, executor_shape_type, agent_shape_type>;
+
   agent_param_type    agent_param_;
   agent_shape_type    agent_shape_;
   executor_shape_type executor_shape_;
   Function            f_;
 
-  using agent_index_type    = typename AgentTraits::index_type;
-  using executor_index_type = executor_index_t<Executor>;
+  // turns each executor index into an agent index
+  index_caster_type   index_caster_;
+
+  __AGENCY_ANNOTATION
+  then_execute_agent_functor(const agent_param_type& agent_param, const agent_shape_type& agent_shape, const executor_shape_type& executor_shape, const Function& f)
+    : agent_param_(agent_param),
+      agent_shape_(agent_shape),
+      executor_shape_(executor_shape),
+      f_(f),
+      index_caster_(executor_shape, agent_shape)
+  {}
 
   template<class OtherFunction, class Tuple, size_t... Indices>
   __AGENCY_ANNOTATION
@@ -68,7 +82,7 @@ struct then_execute_agent_functor
     auto agent_shared_args = detail::tuple_drop_view<sizeof...(UserArgIndices)>(args_tuple);
 
     // turn the executor index into an agent index
-    auto agent_idx = detail::index_cast<agent_index_type>(executor_idx, executor_shape_, agent_shape_);
+    auto&& agent_idx = index_caster_(executor_idx);
 
     // AgentTraits::execute expects a function whose only parameter is agent_type
     // so we have to wrap f_ into a function of one parameter
@@ -100,7 +114,7 @@ struct then_execute_agent_functor
     auto agent_shared_args = detail::tuple_drop_view<sizeof...(UserArgIndices)>(args_tuple);
 
     // turn the executor index into an agent index
-    auto agent_idx = detail::index_cast<agent_index_type>(executor_idx, executor_shape_, agent_shape_);
+    auto&& agent_idx = index_caster_(executor_idx);
 
     // AgentTraits::execute expects a function whose only parameter is agent_type
     // so we have to wrap f_ into a function of one parameter
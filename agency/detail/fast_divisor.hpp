@@ -0,0 +1,85 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace agency
+{
+namespace detail
+{
+
+
+// fast_divisor divides unsigned integers by a divisor chosen at construction
+// when both the dividend and the divisor fit in 32 bits, the quotient is computed with a multiplication and shifts
+// instead of a hardware division, using a multiplier computed once by the constructor
+// other dividends fall back to ordinary division
+//
+// the multiplier is the "round-up" method of Hacker's Delight, 10-9 (Unsigned Division by Divisors >= 1)
+class fast_divisor
+{
+  public:
+    __AGENCY_ANNOTATION
+    fast_divisor()
+      : fast_divisor(1)
+    {}
+
+    __AGENCY_ANNOTATION
+    explicit fast_divisor(std::size_t divisor)
+      : divisor_(divisor),
+        multiplier_(0),
+        shift_(0),
+        is_32b_(0 < divisor && divisor <= max_32b)
+    {
+      if(is_32b_)
+      {
+        // shift_ is ceil(log2(divisor))
+        while((std::uint64_t(1) << shift_) < divisor)
+        {
+          ++shift_;
+        }
+
+        multiplier_ = static_cast<std::uint32_t>(((std::uint64_t(1) << 32) * ((std::uint64_t(1) << shift_) - divisor)) / divisor + 1);
+      }
+    }
+
+    __AGENCY_ANNOTATION
+    std::size_t divisor() const
+    {
+      return divisor_;
+    }
+
+    __AGENCY_ANNOTATION
+    std::size_t divide(std::size_t dividend) const
+    {
+      if(is_32b_ && dividend <= max_32b)
+      {
+        std::uint64_t t = (std::uint64_t(multiplier_) * dividend) >> 32;
+        return static_cast<std::size_t>((t + dividend) >> shift_);
+      }
+
+      return dividend / divisor_;
+    }
+
+    // returns the quotient and stores the remainder in remainder
+    __AGENCY_ANNOTATION
+    std::size_t divide(std::size_t dividend, std::size_t& remainder) const
+    {
+      std::size_t quotient = divide(dividend);
+      remainder = dividend - quotient * divisor_;
+      return quotient;
+    }
+
+  private:
+    static constexpr std::uint64_t max_32b = 0xFFFFFFFF;
+
+    std::size_t divisor_;
+    std::uint32_t multiplier_;
+    unsigned int shift_;
+    bool is_32b_;
+};
+
+
+} // end detail
+} // end agency
+
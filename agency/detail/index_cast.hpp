@@ -7,6 +7,7 @@
 #include <agency/coordinate.hpp>
 #include <agency/detail/tuple/tuple_utility.hpp>
 #include <agency/detail/point_size.hpp>
+#include <agency/detail/fast_divisor.hpp>
 
 namespace agency
 {
@@ -299,7 +300,108 @@ typename std::enable_if<
   return index_cast<ToIndex>(detail::project_index(from_idx, from_shape), detail::project_shape(from_shape), to_shape);
 }
 
-                     
+// index_caster performs index_cast from a fixed FromShape to a fixed ToShape for many indices
+// it avoids work index_cast would repeat for each index:
+//   * when the index and shape types are identical, the index is returned unchanged
+//   * when a scalar index is lifted into a point, the divisions by the point's shape use fast_divisors computed once
+//   * otherwise, index_cast is called
+
+// the general case calls index_cast
+template<class ToIndex, class FromIndex, class FromShape, class ToShape, class Enable = void>
+class index_caster
+{
+  public:
+    __AGENCY_ANNOTATION
+    index_caster(const FromShape& from_shape, const ToShape& to_shape)
+      : from_shape_(from_shape),
+        to_shape_(to_shape)
+    {}
+
+    __AGENCY_ANNOTATION
+    ToIndex operator()(const FromIndex& from_idx) const
+    {
+      return detail::index_cast<ToIndex>(from_idx, from_shape_, to_shape_);
+    }
+
+  private:
+    FromShape from_shape_;
+    ToShape to_shape_;
+};
+
+
+// when the index and shape types are identical, the cast is the identity
+template<class Index, class Shape>
+class index_caster<Index, Index, Shape, Shape>
+{
+  public:
+    __AGENCY_ANNOTATION
+    index_caster(const Shape&, const Shape&) {}
+
+    __AGENCY_ANNOTATION
+    const Index& operator()(const Index& from_idx) const
+    {
+      return from_idx;
+    }
+};
+
+
+template<class T>
+struct is_point : std::false_type {};
+
+template<class T, size_t Rank>
+struct is_point<point<T,Rank>> : std::true_type {};
+
+
+// when a scalar index is lifted into a point, each dimension but the last
+// is the remainder of dividing by that dimension of the shape, and the quotient is carried to the next dimension
+// this is the same lift index_cast performs, with the first dimension varying fastest
+template<class ToIndex, class FromIndex, class FromShape, class ToShape>
+class index_caster<ToIndex, FromIndex, FromShape, ToShape,
+  typename std::enable_if<
+    std::is_integral<FromIndex>::value &&
+    is_point<ToIndex>::value &&
+    (index_size<ToIndex>::value > 1)
+  >::type>
+{
+  private:
+    static constexpr size_t rank = index_size<ToIndex>::value;
+
+  public:
+    __AGENCY_ANNOTATION
+    index_caster(const FromShape&, const ToShape& to_shape)
+    {
+      for(size_t i = 0; i + 1 < rank; ++i)
+      {
+        divisors_[i] = fast_divisor(static_cast<size_t>(to_shape[i]));
+      }
+    }
+
+    __AGENCY_ANNOTATION
+    ToIndex operator()(const FromIndex& from_idx) const
+    {
+      using element_type = typename std::decay<decltype(std::declval<ToIndex>()[0])>::type;
+
+      ToIndex result;
+
+      size_t quotient = static_cast<size_t>(from_idx);
+
+      for(size_t i = 0; i + 1 < rank; ++i)
+      {
+        size_t remainder = 0;
+        quotient = divisors_[i].divide(quotient, remainder);
+        result[i] = static_cast<element_type>(remainder);
+      }
+
+      result[rank - 1] = static_cast<element_type>(quotient);
+
+      return result;
+    }
+
+  private:
+    fast_divisor divisors_[rank - 1];
+};
+
+
 } // end detail
 } // end agency
 
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <agency/detail/config.hpp>
-#include <agency/memory/detail/unique_ptr.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/memory/detail/resource/pooled_resource.hpp>
 #include <stdexcept>
 #include <cassert>
 #include <utility>
 #include <type_traits>
 #include <memory>
+#include <new>
+#include <cstddef>
 
 
 namespace agency
@@ -50,19 +53,36 @@ class unique_function;
 template<class Result, class... Args>
 class unique_function<Result(Args...)>
 {
+  private:
+    // inline storage for small callables
+    // this leaves room for a callable of six pointers alongside its vtable pointer, and together with
+    // the pointer to the target, makes a unique_function 64 bytes large on 64-bit systems
+    using storage_type = typename std::aligned_storage<7 * sizeof(void*), alignof(void*)>::type;
+
   public:
     using result_type = Result;
 
-    unique_function() = default;
+    __AGENCY_ANNOTATION
+    unique_function()
+      : unique_function(nullptr)
+    {}
 
     __AGENCY_ANNOTATION
     unique_function(std::nullptr_t)
-      : f_ptr_(nullptr)
+      : ptr_(nullptr)
     {}
 
-    unique_function(unique_function&& other) = default;
+    __AGENCY_ANNOTATION
+    unique_function(unique_function&& other) noexcept
+      : ptr_(other.ptr_ ? other.ptr_->relocate(&storage_) : nullptr)
+    {
+      other.ptr_ = nullptr;
+    }
 
-    template<class Function>
+    template<class Function,
+             __AGENCY_REQUIRES(
+               !std::is_same<typename std::decay<Function>::type, unique_function>::value
+             )>
     __AGENCY_ANNOTATION
     unique_function(Function&& f)
       : unique_function(std::allocator_arg, default_allocator<typename std::decay<Function>::type>{}, std::forward<Function>(f))
@@ -83,16 +103,36 @@ class unique_function<Result(Args...)>
     template<class Alloc>
     __AGENCY_ANNOTATION
     unique_function(std::allocator_arg_t, const Alloc&, unique_function&& other)
-      : f_ptr_(std::move(other.f_ptr_))
+      : unique_function(std::move(other))
     {}
 
+    // callables which fit into the inline storage and which are nothrow move constructible
+    // are stored inline. otherwise, alloc allocates storage for the callable
     template<class Alloc, class Function>
     __AGENCY_ANNOTATION
     unique_function(std::allocator_arg_t, const Alloc& alloc, Function&& f)
-      : f_ptr_(allocate_function_pointer(alloc, std::forward<Function>(f)))
+      : ptr_(make_callable(alloc, std::forward<Function>(f), is_stored_inline<typename std::decay<Function>::type>()))
     {}
 
-    unique_function& operator=(unique_function&& other) = default;
+    __AGENCY_ANNOTATION
+    ~unique_function()
+    {
+      reset();
+    }
+
+    __AGENCY_ANNOTATION
+    unique_function& operator=(unique_function&& other) noexcept
+    {
+      if(this != &other)
+      {
+        reset();
+
+        ptr_ = other.ptr_ ? other.ptr_->relocate(&storage_) : nullptr;
+        other.ptr_ = nullptr;
+      }
+
+      return *this;
+    }
 
     __AGENCY_ANNOTATION
     Result operator()(Args... args) const
@@ -102,61 +142,100 @@ class unique_function<Result(Args...)>
         unique_function_detail::throw_bad_function_call();
       }
 
-      return (*f_ptr_)(args...);
+      return (*ptr_)(args...);
     }
 
     __AGENCY_ANNOTATION
     operator bool () const
     {
-      return f_ptr_;
+      return ptr_ != nullptr;
     }
 
   private:
+    __AGENCY_ANNOTATION
+    void reset()
+    {
+      if(ptr_)
+      {
+        ptr_->destroy();
+        ptr_ = nullptr;
+      }
+    }
+
     // this is the abstract base class for a type
     // which is both
     // 1. callable like a function and
-    // 2. deallocates itself inside its destructor
-    struct callable_self_deallocator_base
+    // 2. responsible for destroying itself and releasing its storage
+    struct callable_base
     {
-      using self_deallocate_function_type = void(*)(callable_self_deallocator_base*);
+      __AGENCY_ANNOTATION
+      virtual Result operator()(Args... args) const = 0;
+
+      // moves this callable into storage if it is stored inline and returns a pointer to the result
+      // otherwise, returns this
+      __AGENCY_ANNOTATION
+      virtual callable_base* relocate(void* storage) noexcept = 0;
 
-      self_deallocate_function_type self_deallocate_function;
+      // destroys this callable and deallocates its storage, if any
+      __AGENCY_ANNOTATION
+      virtual void destroy() = 0;
+
+      protected:
+        __AGENCY_ANNOTATION
+        ~callable_base() = default;
+    };
+
+    // inline_callable lives inside a unique_function's storage
+    template<class Function>
+    struct inline_callable : callable_base
+    {
+      mutable Function f_;
 
-      template<class Function>
+      __agency_exec_check_disable__
+      template<class OtherFunction>
       __AGENCY_ANNOTATION
-      callable_self_deallocator_base(Function callback)
-        : self_deallocate_function(callback)
+      inline_callable(OtherFunction&& f)
+        : f_(std::forward<OtherFunction>(f))
       {}
 
+      __agency_exec_check_disable__
       __AGENCY_ANNOTATION
-      virtual ~callable_self_deallocator_base()
+      virtual Result operator()(Args... args) const
       {
-        self_deallocate_function(this);
+        return f_(args...);
       }
 
+      __agency_exec_check_disable__
       __AGENCY_ANNOTATION
-      virtual Result operator()(Args... args) const = 0;
+      virtual callable_base* relocate(void* storage) noexcept
+      {
+        inline_callable* result = ::new(storage) inline_callable(std::move(f_));
+        this->~inline_callable();
+        return result;
+      }
+
+      __agency_exec_check_disable__
+      __AGENCY_ANNOTATION
+      virtual void destroy()
+      {
+        this->~inline_callable();
+      }
     };
 
+    // allocated_callable lives in storage allocated by an allocator
     template<class Function, class Alloc>
-    struct callable : callable_self_deallocator_base
+    struct allocated_callable : callable_base
     {
-      using super_t = callable_self_deallocator_base;
-      using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<callable>;
+      using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<allocated_callable>;
 
+      allocator_type alloc_;
       mutable Function f_;
 
       __agency_exec_check_disable__
-      ~callable() = default;
-
-      __agency_exec_check_disable__
-      template<class OtherFunction,
-               class = typename std::enable_if<
-                 std::is_constructible<Function,OtherFunction&&>::value
-               >::type>
+      template<class OtherFunction>
       __AGENCY_ANNOTATION
-      callable(const Alloc&, OtherFunction&& f)
-        : super_t(deallocate),
+      allocated_callable(const Alloc& alloc, OtherFunction&& f)
+        : alloc_(alloc),
           f_(std::forward<OtherFunction>(f))
       {}
 
@@ -167,43 +246,69 @@ class unique_function<Result(Args...)>
         return f_(args...);
       }
 
-      __agency_exec_check_disable__
       __AGENCY_ANNOTATION
-      static void deallocate(callable_self_deallocator_base* ptr)
+      virtual callable_base* relocate(void*) noexcept
       {
-        // upcast to the right type of pointer
-        callable* self = static_cast<callable*>(ptr);
-
-        // XXX seems like creating a new allocator here is cheating
-        //     we should use some member allocator, but it's not clear where to put it
-        allocator_type alloc_;
-        alloc_.deallocate(self, 1);
+        return this;
       }
-    };
 
-    // this deleter calls the destructor of its argument but does not
-    // deallocate the ptr
-    // T will deallocate itself inside ~T()
-    struct self_deallocator_deleter
-    {
-      template<class T>
+      __agency_exec_check_disable__
       __AGENCY_ANNOTATION
-      void operator()(T* ptr) const
+      virtual void destroy()
       {
-        ptr->~T();
+        // copy the allocator out of this object before destroying it
+        allocator_type alloc = alloc_;
+        this->~allocated_callable();
+        alloc.deallocate(this, 1);
       }
     };
 
-    using function_pointer = detail::unique_ptr<callable_self_deallocator_base, self_deallocator_deleter>;
+    template<class Function>
+    using is_stored_inline = std::integral_constant<
+      bool,
+      sizeof(inline_callable<Function>) <= sizeof(storage_type) and
+      alignof(inline_callable<Function>) <= alignof(storage_type) and
+      std::is_nothrow_move_constructible<Function>::value
+    >;
 
     template<class Alloc, class Function>
     __AGENCY_ANNOTATION
-    static function_pointer allocate_function_pointer(const Alloc& alloc, Function&& f)
+    callable_base* make_callable(const Alloc&, Function&& f, std::true_type)
     {
-      using concrete_function_type = callable<typename std::decay<Function>::type, Alloc>;
-      return agency::detail::allocate_unique_with_deleter<concrete_function_type>(alloc, self_deallocator_deleter(), alloc, std::forward<Function>(f));
+      return ::new(&storage_) inline_callable<typename std::decay<Function>::type>(std::forward<Function>(f));
     }
 
+    __agency_exec_check_disable__
+    template<class Alloc, class Function>
+    __AGENCY_ANNOTATION
+    callable_base* make_callable(const Alloc& alloc, Function&& f, std::false_type)
+    {
+      using concrete_function_type = allocated_callable<typename std::decay<Function>::type, Alloc>;
+      typename concrete_function_type::allocator_type alloc_copy = alloc;
+
+      concrete_function_type* ptr = alloc_copy.allocate(1);
+
+#ifndef __CUDA_ARCH__
+      try
+#endif
+      {
+        return ::new(ptr) concrete_function_type(alloc, std::forward<Function>(f));
+      }
+#ifndef __CUDA_ARCH__
+      catch(...)
+      {
+        // copying or moving f threw, so return the storage to the allocator
+        alloc_copy.deallocate(ptr, 1);
+
+        // rethrow
+        throw;
+      }
+#endif
+    }
+
+    // default_allocator allocates callables which do not fit into the inline storage
+    // from the system_pooled_resource, whose per-thread caches recycle the storage of
+    // destroyed unique_functions without locking
     template<class T>
     struct default_allocator
     {
@@ -217,30 +322,26 @@ class unique_function<Result(Args...)>
       __AGENCY_ANNOTATION
       default_allocator(const default_allocator<U>&) {}
 
-      // XXX we have to implement this member function superfluously because
-      //     agency::detail::allocate_unique calls it directly instead of using std::allocator_traits
-      template<class U, class... OtherArgs>
-      __AGENCY_ANNOTATION
-      void construct(U* ptr, OtherArgs&&... args)
-      {
-        ::new(ptr) U(std::forward<OtherArgs>(args)...);
-      }
-
       value_type* allocate(size_t n)
       {
-        std::allocator<T> alloc;
-        return alloc.allocate(n);
+        void* result = system_pooled_resource().allocate(n * sizeof(T));
+
+        if(result == nullptr)
+        {
+          throw std::bad_alloc();
+        }
+
+        return reinterpret_cast<value_type*>(result);
       }
 
       void deallocate(value_type* ptr, std::size_t n)
       {
-        std::allocator<value_type> alloc;
-        alloc.deallocate(ptr, n);
+        system_pooled_resource().deallocate(ptr, n * sizeof(T));
       }
     };
 
-
-    function_pointer f_ptr_; 
+    storage_type storage_;
+    callable_base* ptr_;
 };
 
 
@@ -3,9 +3,8 @@
 #include <agency/detail/config.hpp>
 #include <agency/execution/execution_agent/detail/basic_concurrent_agent.hpp>
 #include <agency/detail/concurrency/any_barrier.hpp>
-#include <agency/memory/detail/resource/arena_resource.hpp>
 #include <agency/memory/detail/resource/malloc_resource.hpp>
-#include <agency/memory/detail/resource/tiered_resource.hpp>
+#include <agency/memory/detail/resource/monotonic_resource.hpp>
 #include <agency/coordinate/point.hpp>
 #include <cstddef>
 
@@ -17,7 +16,11 @@ namespace detail
 
 
 using default_barrier = any_barrier;
-using default_concurrent_resource = tiered_resource<arena_resource<sizeof(int) * 128>, malloc_resource>;
+
+// a group's temporary storage begins in a small buffer within the group's shared parameter
+// when that buffer is exhausted, the storage grows geometrically, so a group with large temporaries
+// calls malloc a few times rather than once per temporary. the storage is freed when the group completes
+using default_concurrent_resource = inline_monotonic_resource<sizeof(int) * 128, malloc_resource>;
 
 
 } // end detail
@@ -6,7 +6,6 @@
 #include <agency/execution/execution_agent/detail/basic_execution_agent.hpp>
 #include <agency/detail/concurrency/barrier.hpp>
 #include <agency/detail/concurrency/in_place_barrier.hpp>
-#include <agency/container/array.hpp>
 #include <agency/experimental/optional.hpp>
 #include <agency/experimental/variant.hpp>
 #include <type_traits>
@@ -28,125 +27,165 @@ class basic_concurrent_agent : public detail::basic_execution_agent<bulk_guarant
     // in_place_type_t with its constructor
     using barrier_type = in_place_barrier<Barrier>;
 
-    static constexpr size_t broadcast_channel_size = sizeof(void*);
-    using broadcast_channel_type = agency::array<char, broadcast_channel_size>;
+    // each slot of the broadcast channel stores objects no larger than a pointer inline
+    // larger objects are stored in the group's memory resource, and the slot stores a pointer to them
+    static constexpr size_t broadcast_slot_size = sizeof(void*);
+
+    struct broadcast_slot
+    {
+      typename std::aligned_storage<broadcast_slot_size>::type storage;
+
+      // destroys the object stored through this slot, or is null when there is no such object to destroy
+      void (*destroy)(broadcast_slot&, MemoryResource&);
+    };
+
+    template<class T>
+    struct stores_inline : std::integral_constant<bool, sizeof(T) <= broadcast_slot_size && alignof(T) <= alignof(broadcast_slot)> {};
 
-    // this function destroys *ptr if ptr is not null and then makes the entire group wait
-    // only one agent should pass a non-nullptr to this function
-    // the entire group should be convergent before calling this function
     template<class T>
     __AGENCY_ANNOTATION
-    typename std::enable_if<
-      std::is_trivially_destructible<T>::value
-    >::type
-      destroy_and_wait_if(T*)
+    static void destroy_inline_object(broadcast_slot& slot, MemoryResource&)
     {
-      // no op: T has a trivial destructor, so there's no need to do anything
-      // including synchronize
+      reinterpret_cast<T*>(&slot.storage)->~T();
     }
 
-    // this function destroys *ptr if ptr is not null and then makes the entire group wait
-    // only one agent should pass a non-nullptr to this function
-    // the entire group should be convergent before calling this function
     template<class T>
     __AGENCY_ANNOTATION
-    typename std::enable_if<
-      !std::is_trivially_destructible<T>::value
-    >::type
-      destroy_and_wait_if(T* ptr)
+    static void destroy_allocated_object(broadcast_slot& slot, MemoryResource& resource)
     {
-      // first destroy the object
-      if(ptr)
-      {
-        ptr->~T();
-      }
+      T* ptr = *reinterpret_cast<T**>(&slot.storage);
 
-      // synchronize the group
-      wait();
+      ptr->~T();
+      resource.deallocate(ptr, sizeof(T));
     }
 
-    
-    // this overload of broadcast_impl() is for small T
+    // this overload of emplace_broadcast_object() is for small T
     template<class T,
-             __AGENCY_REQUIRES(
-               (sizeof(T) <= broadcast_channel_size)
-             )>
+             __AGENCY_REQUIRES(stores_inline<T>::value)
+            >
     __AGENCY_ANNOTATION
-    T broadcast_impl(const experimental::optional<T>& value)
+    void emplace_broadcast_object(broadcast_slot& slot, const T& value)
     {
-      // value is small enough to fit inside broadcast_channel_, so we can
+      // value is small enough to fit inside the slot, so we can
       // send it through directly without needing to dynamically allocate storage
-      
-      // reinterpret the broadcast channel into the right kind of type
-      T* shared_temporary_object = reinterpret_cast<T*>(shared_param_.broadcast_channel_.data());
-
-      // the thread with the value copies it into a shared temporary
-      if(value)
-      {
-        // copy construct the shared temporary
-        ::new(shared_temporary_object) T(*value);
-      }
+      ::new(&slot.storage) T(value);
 
-      // all agents wait for the object to be ready
-      wait();
-
-      // copy the shared temporary to a local variable
-      T result = *shared_temporary_object;
-
-      // all agents wait for all other agents to finish copying the shared temporary
-      wait();
+      slot.destroy = std::is_trivially_destructible<T>::value ? nullptr : &destroy_inline_object<T>;
+    }
 
-      // destroy the object and all agents wait for the broadcast to become ready again
-      destroy_and_wait_if(value ? shared_temporary_object : nullptr);
+    // this overload of emplace_broadcast_object() is for large T
+    template<class T,
+             __AGENCY_REQUIRES(!stores_inline<T>::value)
+            >
+    __AGENCY_ANNOTATION
+    void emplace_broadcast_object(broadcast_slot& slot, const T& value)
+    {
+      // value is too large to fit inside the slot, so
+      // we need to dynamically allocate storage
+      T* ptr = reinterpret_cast<T*>(memory_resource().allocate(sizeof(T)));
+      ::new(ptr) T(value);
 
-      return result;
+      *reinterpret_cast<T**>(&slot.storage) = ptr;
+      slot.destroy = &destroy_allocated_object<T>;
     }
 
+    template<class T,
+             __AGENCY_REQUIRES(stores_inline<T>::value)
+            >
+    __AGENCY_ANNOTATION
+    static const T& broadcast_object(const broadcast_slot& slot)
+    {
+      return *reinterpret_cast<const T*>(&slot.storage);
+    }
 
-    // this overload of broadcast_impl() is for large T
     template<class T,
-             __AGENCY_REQUIRES(
-               (sizeof(T) > broadcast_channel_size)
-             )>
+             __AGENCY_REQUIRES(!stores_inline<T>::value)
+            >
     __AGENCY_ANNOTATION
-    T broadcast_impl(const experimental::optional<T>& value)
+    static const T& broadcast_object(const broadcast_slot& slot)
     {
-      // value is too large to fit through broadcast_channel_, so
-      // we need to dynamically allocate storage
+      return **reinterpret_cast<const T* const*>(&slot.storage);
+    }
 
-      // reinterpret the broadcast channel into a pointer
-      static_assert(sizeof(broadcast_channel_type) >= sizeof(T*), "broadcast channel is too small to accomodate T*");
-      T* shared_temporary_object = reinterpret_cast<T*>(&shared_param_.broadcast_channel_);
+    // the broadcast channel is double-buffered: each agent counts the broadcasts it has participated in,
+    // and the parity of that count selects the slot which carries the next broadcast
+    // consecutive broadcasts use different slots, so an agent may publish a broadcast while other agents are still
+    // reading the previous one. by the time a slot is reused, every agent has passed the barrier of the intervening
+    // broadcast, and so has finished reading the slot's previous object
+    // as a result, each broadcast costs a single barrier episode
+    template<class T>
+    __AGENCY_ANNOTATION
+    T broadcast_impl(const experimental::optional<T>& value)
+    {
+      broadcast_slot& slot = shared_param_.broadcast_slots_[broadcast_generation_ % 2];
+      ++broadcast_generation_;
 
+      // the agent with the value replaces the slot's previous object with a copy of value
       if(value)
       {
-        // dynamically allocate the shared temporary object
-        shared_temporary_object = memory_resource().allocate<alignof(T)>(sizeof(T));
+        if(slot.destroy)
+        {
+          slot.destroy(slot, memory_resource());
+        }
 
-        // copy construct the shared temporary
-        ::new(shared_temporary_object) T(*value);
+        emplace_broadcast_object(slot, *value);
       }
 
       // all agents wait for the object to be ready
       wait();
 
-      // copy the shared temporary to a local variable
-      T result = *shared_temporary_object;
-
-      // all agents wait for other agents to finish copying the shared temporary
-      wait();
+      // copy the shared object to a local variable
+      return broadcast_object<T>(slot);
+    }
 
-      if(value)
+    // this function publishes the address of this agent's value to the rest of the group
+    // through this agent's slot in the group's array of collective slots
+    // upon return, the value of every agent in the group may be read through collective_value()
+    // the entire group should be convergent before calling this function
+    template<class T>
+    __AGENCY_ANNOTATION
+    void publish(const T& value)
+    {
+      if(!has_collective_slots_)
       {
-        // destroy the shared temporary
-        shared_temporary_object->~T();
+        // the first collective operation creates the slots for the group
+        if(this->elect())
+        {
+          shared_param_.create_collective_slots(this->group_size());
+        }
+
+        // all agents wait for the slots to be ready
+        wait();
 
-        // deallocate the temporary storage
-        memory_resource().deallocate(shared_temporary_object);
+        has_collective_slots_ = true;
       }
 
-      // all agents wait for the broadcast channel and memory resource to become ready again
+      shared_param_.collective_slots_[this->rank()] = &value;
+
+      // all agents wait for every value to be published
       wait();
+    }
+
+    // returns the value published by the agent of the given rank
+    template<class T>
+    __AGENCY_ANNOTATION
+    const T& collective_value(std::size_t rank) const
+    {
+      return *reinterpret_cast<const T*>(shared_param_.collective_slots_[rank]);
+    }
+
+    // returns the combination of the values published by the agents of ranks [first, last) in rank order
+    // first must be less than last
+    template<class T, class BinaryOperation>
+    __AGENCY_ANNOTATION
+    T combine_collective_values(std::size_t first, std::size_t last, BinaryOperation op) const
+    {
+      T result = collective_value<T>(first);
+
+      for(std::size_t rank = first + 1; rank < last; ++rank)
+      {
+        result = op(result, collective_value<T>(rank));
+      }
 
       return result;
     }
@@ -169,6 +208,95 @@ class basic_concurrent_agent : public detail::basic_execution_agent<bulk_guarant
       return broadcast_impl(value);
     }
 
+    // The following collective operations combine a value from each agent of the group with a binary operation.
+    // Values are combined in the order of the ranks of the agents which contributed them,
+    // so op need be associative but not commutative.
+    //
+    // Each agent's value is read directly from the agent's argument rather than copied through a tree of temporaries,
+    // so each collective costs two barrier episodes regardless of the size of the group.
+    // (The first collective executed by a group costs one additional episode.)
+    //
+    // The reductions combine the group's values once, on the agent for which elect() is true.
+    // The scans instead combine on every agent: an agent of rank r applies op r times,
+    // so a scan costs O(n) applications of op per agent and O(n^2) per group of n agents.
+    // The scans suit the small groups typical of concurrent agents; larger groups should scan hierarchically.
+    //
+    // The entire group should be convergent before calling a collective operation.
+
+    // returns the combination of every agent's value to the agent for which elect() is true
+    // every other agent receives an empty optional
+    template<class T, class BinaryOperation>
+    __AGENCY_ANNOTATION
+    experimental::optional<T> reduce(const T& value, BinaryOperation op)
+    {
+      publish(value);
+
+      experimental::optional<T> result;
+
+      if(this->elect())
+      {
+        result = combine_collective_values<T>(0, this->group_size(), op);
+      }
+
+      // all agents wait for the result to be computed before their values may be destroyed
+      wait();
+
+      return result;
+    }
+
+    // returns the combination of every agent's value to every agent
+    template<class T, class BinaryOperation>
+    __AGENCY_ANNOTATION
+    T all_reduce(const T& value, BinaryOperation op)
+    {
+      publish(value);
+
+      experimental::optional<T> result;
+
+      if(this->elect())
+      {
+        result = combine_collective_values<T>(0, this->group_size(), op);
+      }
+
+      // the barrier which broadcasts the result also keeps the values alive until the result has been computed
+      return broadcast_impl(result);
+    }
+
+    // returns to each agent the combination of the values of the agents whose rank is no greater than its own
+    template<class T, class BinaryOperation>
+    __AGENCY_ANNOTATION
+    T inclusive_scan(const T& value, BinaryOperation op)
+    {
+      publish(value);
+
+      T result = combine_collective_values<T>(0, this->rank() + 1, op);
+
+      // all agents wait for all results to be computed before their values may be destroyed
+      wait();
+
+      return result;
+    }
+
+    // returns to each agent the combination of init with the values of the agents whose rank is less than its own
+    template<class T, class BinaryOperation>
+    __AGENCY_ANNOTATION
+    T exclusive_scan(const T& value, const T& init, BinaryOperation op)
+    {
+      publish(value);
+
+      T result = init;
+
+      if(this->rank() > 0)
+      {
+        result = op(init, combine_collective_values<T>(0, this->rank(), op));
+      }
+
+      // all agents wait for all results to be computed before their values may be destroyed
+      wait();
+
+      return result;
+    }
+
     using memory_resource_type = MemoryResource;
 
     __AGENCY_ANNOTATION
@@ -183,9 +311,11 @@ class basic_concurrent_agent : public detail::basic_execution_agent<bulk_guarant
         __AGENCY_ANNOTATION
         shared_param_type(const param_type& param)
           : barrier_(param.domain().size()),
-            memory_resource_()
+            memory_resource_(),
+            collective_slots_(nullptr),
+            num_collective_slots_(0)
         {
-          // note we specifically avoid default constructing broadcast_channel_
+          clear_broadcast_slots();
         }
 
         template<class OtherBarrier,
@@ -195,9 +325,11 @@ class basic_concurrent_agent : public detail::basic_execution_agent<bulk_guarant
         __AGENCY_ANNOTATION
         shared_param_type(const param_type& param, experimental::in_place_type_t<OtherBarrier> which_barrier)
           : barrier_(which_barrier, param.domain().size()),
-            memory_resource_()
+            memory_resource_(),
+            collective_slots_(nullptr),
+            num_collective_slots_(0)
         {
-          // note we specifically avoid default constructing broadcast_channel_
+          clear_broadcast_slots();
         }
 
         // shared_param_type needs to be moveable, even if its member types aren't,
@@ -209,27 +341,73 @@ class basic_concurrent_agent : public detail::basic_execution_agent<bulk_guarant
         __AGENCY_ANNOTATION
         shared_param_type(shared_param_type&& other)
           : barrier_(other.barrier_.index(), other.barrier_.count()),
-            memory_resource_()
-        {}
+            memory_resource_(),
+            collective_slots_(nullptr),
+            num_collective_slots_(0)
+        {
+          clear_broadcast_slots();
+        }
+
+        __AGENCY_ANNOTATION
+        ~shared_param_type()
+        {
+          // destroy the objects which remain in the broadcast channel
+          for(broadcast_slot& slot : broadcast_slots_)
+          {
+            if(slot.destroy)
+            {
+              slot.destroy(slot, memory_resource_);
+            }
+          }
+
+          if(collective_slots_)
+          {
+            memory_resource_.deallocate(collective_slots_, num_collective_slots_ * sizeof(const void*));
+          }
+        }
 
       private:
-        // broadcast_channel_ needs to be the first member to ensure proper alignment because we reinterpret it to arbitrary T*
-        // XXX is there a more comprehensive way to ensure that this member falls on the right address?
-        broadcast_channel_type broadcast_channel_;
+        __AGENCY_ANNOTATION
+        void create_collective_slots(std::size_t n)
+        {
+          collective_slots_ = reinterpret_cast<const void**>(memory_resource_.allocate(n * sizeof(const void*)));
+          num_collective_slots_ = n;
+        }
+
+        __AGENCY_ANNOTATION
+        void clear_broadcast_slots()
+        {
+          broadcast_slots_[0].destroy = nullptr;
+          broadcast_slots_[1].destroy = nullptr;
+        }
+
+        broadcast_slot broadcast_slots_[2];
         barrier_type barrier_;
         memory_resource_type memory_resource_;
 
+        // each agent publishes the address of its argument to a collective operation through its slot
+        const void** collective_slots_;
+        std::size_t num_collective_slots_;
+
         friend basic_concurrent_agent;
     };
 
   private:
     shared_param_type& shared_param_;
 
+    // whether or not the group's collective slots have been created
+    bool has_collective_slots_;
+
+    // the number of broadcasts this agent has participated in
+    std::size_t broadcast_generation_;
+
   protected:
     __AGENCY_ANNOTATION
     basic_concurrent_agent(const index_type& index, const param_type& param, shared_param_type& shared_param)
       : super_t(index, param),
-        shared_param_(shared_param)
+        shared_param_(shared_param),
+        has_collective_slots_(false),
+        broadcast_generation_(0)
     {}
 
     // friend execution_agent_traits to give it access to the constructor
@@ -2,24 +2,40 @@
 
 #include <agency/detail/config.hpp>
 #include <agency/future.hpp>
+#include <agency/future/detail/on_ready.hpp>
 #include <agency/execution/executor/properties/bulk_guarantee.hpp>
 #include <agency/detail/invoke.hpp>
 #include <agency/detail/type_traits.hpp>
+#include <agency/detail/concurrency/concurrent_thread_pool.hpp>
 
 #include <thread>
 #include <vector>
 #include <memory>
 #include <algorithm>
 #include <utility>
+#include <future>
+#include <exception>
 
 
 namespace agency
 {
 
 
+// concurrent_executor executes each group of n agents on n threads of the system_concurrent_thread_pool
+// threads are reused across launches, yet all agents of a group are guaranteed to execute concurrently
+// note that the system_concurrent_thread_pool is not created until it is first used
+// a launch which depends on a pending predecessor occupies no thread until the predecessor becomes ready
 class concurrent_executor
 {
   public:
+    template<class T>
+    using future = agency::future<T>;
+
+    detail::concurrent_thread_pool& pool() const
+    {
+      return detail::system_concurrent_thread_pool();
+    }
+
     size_t unit_shape() const
     {
       constexpr size_t default_result = 1;
@@ -36,7 +52,7 @@ class concurrent_executor
     }
 
     template<class Function, class Future, class ResultFactory, class SharedFactory>
-    std::future<
+    future<
       detail::result_of_t<ResultFactory()>
     >
     bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
@@ -58,7 +74,7 @@ class concurrent_executor
 
   private:
     template<class Function, class Future, class ResultFactory, class SharedFactory>
-    std::future<agency::detail::result_of_t<ResultFactory()>>
+    future<agency::detail::result_of_t<ResultFactory()>>
       bulk_then_execute_impl(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory,
                              typename std::enable_if<
                                !std::is_void<
@@ -70,46 +86,32 @@ class concurrent_executor
       {
         using predecessor_type = future_result_t<Future>;
 
-        return agency::detail::monadic_then(predecessor, std::launch::async, [=](predecessor_type& predecessor) mutable
+        auto shared_predecessor = future_traits<Future>::share(predecessor);
+        detail::concurrent_thread_pool* pool_ptr = &pool();
+
+        return async_execute_after(shared_predecessor, [=]() mutable
         {
+          predecessor_type& predecessor_arg = const_cast<predecessor_type&>(shared_predecessor.get());
+
           // put all the shared parameters on the first thread's stack
           auto result = result_factory();
           auto shared_parameter = shared_factory();
 
-          // create a lambda to handle parameter passing
-          auto g = [&,f](size_t idx)
+          // the first agent executes on this thread
+          pool_ptr->bulk_invoke([&](size_t idx)
           {
-            agency::detail::invoke(f, idx, predecessor, result, shared_parameter);
-          };
-
-          size_t mid = n / 2;
-
-          std::future<void> left = agency::detail::make_ready_future();
-          if(0 < mid)
-          {
-            left = this->twoway_execute(g, 0, mid);
-          }
-
-          std::future<void> right = agency::detail::make_ready_future();
-          if(mid + 1 < n)
-          {
-            right = this->twoway_execute(g, mid + 1, n);
-          }
-
-          g(mid);
-
-          left.wait();
-          right.wait();
+            agency::detail::invoke(f, idx, predecessor_arg, result, shared_parameter);
+          }, n);
 
           return std::move(result);
         });
       }
 
-      return agency::detail::make_ready_future(result_factory());
+      return future<agency::detail::result_of_t<ResultFactory()>>::make_ready(result_factory());
     }
 
     template<class Function, class Future, class ResultFactory, class SharedFactory>
-    std::future<agency::detail::result_of_t<ResultFactory()>>
+    future<agency::detail::result_of_t<ResultFactory()>>
       bulk_then_execute_impl(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory,
                              typename std::enable_if<
                                std::is_void<
@@ -119,69 +121,58 @@ class concurrent_executor
     {
       if(n > 0)
       {
-        return agency::detail::monadic_then(predecessor, std::launch::async, [=]() mutable
+        auto shared_predecessor = future_traits<Future>::share(predecessor);
+        detail::concurrent_thread_pool* pool_ptr = &pool();
+
+        return async_execute_after(shared_predecessor, [=]() mutable
         {
+          shared_predecessor.get();
+
           // put all the shared parameters on the first thread's stack
           auto result = result_factory();
           auto shared_parameter = shared_factory();
 
-          // create a lambda to handle parameter passing
-          auto g = [&,f](size_t idx)
+          // the first agent executes on this thread
+          pool_ptr->bulk_invoke([&](size_t idx)
           {
             agency::detail::invoke(f, idx, result, shared_parameter);
-          };
-
-          size_t mid = n / 2;
-
-          std::future<void> left = agency::detail::make_ready_future();
-          if(0 < mid)
-          {
-            left = this->twoway_execute(g, 0, mid);
-          }
-
-          std::future<void> right = agency::detail::make_ready_future();
-          if(mid + 1 < n)
-          {
-            right = this->twoway_execute(g, mid + 1, n);
-          }
-
-          g(mid);
-
-          left.wait();
-          right.wait();
+          }, n);
 
           return std::move(result);
         });
       }
 
-      return agency::detail::make_ready_future(result_factory());
+      return future<agency::detail::result_of_t<ResultFactory()>>::make_ready(result_factory());
     }
 
-    // first must be less than last
-    template<class Function>
-    std::future<void> twoway_execute(Function f, size_t first, size_t last) const
+    // executes f on a thread of the pool after predecessor becomes ready and returns a future to its result
+    // no thread waits on predecessor: the thread which makes it ready submits f to the pool
+    template<class SharedFuture, class Function>
+    future<detail::result_of_t<Function()>> async_execute_after(const SharedFuture& predecessor, Function f) const
     {
-      return std::async(std::launch::async, [=]() mutable
-      {
-        size_t mid = (last + first) / 2;
+      using result_type = detail::result_of_t<Function()>;
 
-        std::future<void> left = detail::make_ready_future();
-        if(first < mid)
-        {
-          left = this->twoway_execute(f, first, mid);
-        }
+      auto shared_promise_ptr = std::make_shared<agency::promise<result_type>>();
+      auto result_future = shared_promise_ptr->get_future();
 
-        std::future<void> right = detail::make_ready_future();
-        if(mid + 1 < last)
-        {
-          right = this->twoway_execute(f, mid + 1, last);
-        }
+      detail::concurrent_thread_pool* pool_ptr = &pool();
 
-        agency::detail::invoke(f,mid);
-
-        left.wait();
-        right.wait();
+      detail::on_ready(predecessor, [=]
+      {
+        pool_ptr->submit([=]() mutable
+        {
+          try
+          {
+            shared_promise_ptr->set_value(f());
+          }
+          catch(...)
+          {
+            shared_promise_ptr->set_exception(std::current_exception());
+          }
+        });
       });
+
+      return result_future;
     }
 };
 
@@ -12,7 +12,9 @@
 #include <agency/execution/executor/executor_traits.hpp>
 #include <agency/execution/executor/executor_traits/detail/member_barrier_type_or.hpp>
 #include <agency/execution/executor/customization_points.hpp>
+#include <agency/execution/executor/inner_executor_selection.hpp>
 #include <agency/execution/executor/detail/execution_functions/bulk_then_execute.hpp>
+#include <agency/execution/executor/detail/execution_functions/then_execute.hpp>
 #include <agency/execution/executor/properties/bulk_guarantee.hpp>
 #include <agency/execution/executor/query.hpp>
 #include <agency/detail/scoped_in_place_type.hpp>
@@ -23,12 +25,15 @@ namespace agency
 {
 
 
-template<class InnerExecutor, class OuterExecutor = this_thread::parallel_executor>
+// executor_array creates groups of agents with its outer executor, and each group executes on one of its inner executors
+// SelectionPolicy chooses the inner executor of each group; see inner_executor_selection.hpp
+template<class InnerExecutor, class OuterExecutor = this_thread::parallel_executor, class SelectionPolicy = round_robin_selection>
 class executor_array
 {
   public:
     using outer_executor_type = OuterExecutor;
     using inner_executor_type = InnerExecutor;
+    using selection_policy_type = SelectionPolicy;
 
   private:
     using outer_bulk_guarantee = decltype(bulk_guarantee_t::template static_query<outer_executor_type>());
@@ -67,12 +72,43 @@ class executor_array
     __agency_exec_check_disable__
     __AGENCY_ANNOTATION
     executor_array(size_t n, const inner_executor_type& exec = inner_executor_type())
-      : inner_executors_(n, exec)
+      : inner_executors_(n, exec),
+        selection_policy_(detail::make_selection_policy<selection_policy_type>(n))
+    {}
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    executor_array(size_t n, const inner_executor_type& exec, const selection_policy_type& selection_policy)
+      : inner_executors_(n, exec),
+        selection_policy_(selection_policy)
+    {}
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    executor_array(const outer_executor_type& outer_exec, size_t n, const inner_executor_type& exec = inner_executor_type())
+      : outer_executor_(outer_exec),
+        inner_executors_(n, exec),
+        selection_policy_(detail::make_selection_policy<selection_policy_type>(n))
+    {}
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    executor_array(const outer_executor_type& outer_exec, size_t n, const inner_executor_type& exec, const selection_policy_type& selection_policy)
+      : outer_executor_(outer_exec),
+        inner_executors_(n, exec),
+        selection_policy_(selection_policy)
     {}
 
     template<class Iterator>
     executor_array(Iterator executors_begin, Iterator executors_end)
-      : inner_executors_(executors_begin, executors_end)
+      : inner_executors_(executors_begin, executors_end),
+        selection_policy_(detail::make_selection_policy<selection_policy_type>(inner_executors_.size()))
+    {}
+
+    template<class Iterator>
+    executor_array(Iterator executors_begin, Iterator executors_end, const selection_policy_type& selection_policy)
+      : inner_executors_(executors_begin, executors_end),
+        selection_policy_(selection_policy)
     {}
 
     template<class T>
@@ -144,13 +180,67 @@ class executor_array
       return detail::make_scoped_index<outer_depth,inner_depth>(outer_idx, inner_idx);
     }
 
+    __agency_exec_check_disable__
     __AGENCY_ANNOTATION
     size_t select_inner_executor(const outer_index_type& idx, const outer_shape_type& shape) const
     {
       size_t rank = detail::index_cast<size_t>(idx, shape, inner_executors_.size());
       
-      // round robin through inner executors
-      return rank % inner_executors_.size();
+      return selection_policy_.select(rank, inner_executors_.size());
+    }
+
+    // tells the selection policy that a group executing on the given inner executor has completed
+    __AGENCY_ANNOTATION
+    void release_inner_executor(size_t inner_executor_idx) const
+    {
+      detail::release_inner_executor(selection_policy_, inner_executor_idx);
+    }
+
+    // releases an inner executor when destroyed, so that the selection policy is told of a group's completion
+    // even when the group's agents throw
+    struct release_inner_executor_guard
+    {
+      const executor_array& exec;
+      size_t inner_executor_idx;
+
+      __AGENCY_ANNOTATION
+      ~release_inner_executor_guard()
+      {
+        exec.release_inner_executor(inner_executor_idx);
+      }
+    };
+
+    struct release_inner_executor_functor
+    {
+      selection_policy_type selection_policy;
+      size_t inner_executor_idx;
+
+      __AGENCY_ANNOTATION
+      void operator()() const
+      {
+        detail::release_inner_executor(selection_policy, inner_executor_idx);
+      }
+    };
+
+    // returns a future which becomes ready after the group executing on the given inner executor has completed
+    // and the selection policy has been told so
+    template<class Future,
+             __AGENCY_REQUIRES(detail::has_selection_policy_release<selection_policy_type>::value)
+            >
+    __AGENCY_ANNOTATION
+    executor_future_t<inner_executor_type,void> release_inner_executor_when_ready(size_t inner_executor_idx, Future& fut) const
+    {
+      return detail::then_execute(inner_executor(inner_executor_idx), release_inner_executor_functor{selection_policy_, inner_executor_idx}, fut);
+    }
+
+    // when the selection policy has nothing to release, the future is returned as-is
+    template<class Future,
+             __AGENCY_REQUIRES(!detail::has_selection_policy_release<selection_policy_type>::value)
+            >
+    __AGENCY_ANNOTATION
+    executor_future_t<inner_executor_type,void> release_inner_executor_when_ready(size_t, Future& fut) const
+    {
+      return std::move(fut);
     }
 
     // lazy implementation of then_execute()
@@ -205,6 +295,8 @@ class executor_array
         auto inner_executor_idx = exec.select_inner_executor(outer_idx, outer_shape);
         inner_executor_type& inner_exec = exec.inner_executor(inner_executor_idx);
 
+        release_inner_executor_guard release_guard{exec, inner_executor_idx};
+
         // XXX avoid lambdas to workaround nvcc limitations
         //detail::blocking_bulk_twoway_execute_with_void_result(adapted_exec, [=,&predecessor,&result,&outer_shared_arg](const inner_index_type& inner_idx, detail::result_of_t<InnerFactories()>&... inner_shared_args)
         //{
@@ -340,13 +432,15 @@ class executor_array
       {
         auto inner_executor_idx = exec.select_inner_executor(outer_idx, outer_shape);
 
-        return detail::bulk_then_execute_with_void_result(
+        auto inner_future = detail::bulk_then_execute_with_void_result(
           exec.inner_executor(inner_executor_idx),
           inner_functor{f,outer_idx,*result_ptr,*outer_shared_arg_ptr},
           inner_shape,
           predecessor_futures[outer_idx],
           agency::get<Indices>(inner_factories)...
         );
+
+        return exec.release_inner_executor_when_ready(inner_executor_idx, inner_future);
       }
 
       __AGENCY_ANNOTATION
@@ -439,6 +533,8 @@ class executor_array
 
     experimental::ndarray<inner_executor_type, 1, allocator<inner_executor_type>> inner_executors_;
 
+    selection_policy_type selection_policy_;
+
     using bulk_then_execute_implementation_strategy = typename std::conditional<
       detail::disjunction<
         std::is_same<outer_bulk_guarantee, bulk_guarantee_t::sequenced_t>,
@@ -530,6 +626,12 @@ class executor_array
       return begin()[i];
     }
 
+    __AGENCY_ANNOTATION
+    const selection_policy_type& selection_policy() const
+    {
+      return selection_policy_;
+    }
+
     __AGENCY_ANNOTATION
     inner_executor_type& operator[](size_t i)
     {
@@ -1,5 +1,9 @@
 #pragma once
 
 #include <agency/detail/config.hpp>
+#include <agency/execution/executor/experimental/adaptive_executor.hpp>
+#include <agency/execution/executor/experimental/fiber_executor.hpp>
+#include <agency/execution/executor/experimental/tracing_executor.hpp>
+#include <agency/execution/executor/experimental/traversal_executor.hpp>
 #include <agency/execution/executor/experimental/unrolling_executor.hpp>
 
@@ -0,0 +1,552 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/shape.hpp>
+#include <agency/detail/shape_cast.hpp>
+#include <agency/detail/integer_sequence.hpp>
+#include <agency/detail/factory.hpp>
+#include <agency/execution/executor/variant_executor.hpp>
+#include <agency/execution/executor/detail/utility/blocking_bulk_twoway_execute_with_void_result.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace agency
+{
+namespace experimental
+{
+namespace detail
+{
+
+
+// adaptive_state holds the thresholds which select an adaptive_executor's alternative for each launch,
+// along with the launch timings which refine these thresholds online
+//
+// copies of an adaptive_executor share a single adaptive_state
+class adaptive_state
+{
+  public:
+    // the number of launches between explorations of an alternative which would not otherwise be chosen
+    static constexpr std::size_t exploration_period = 16;
+
+    // the number of timings of an alternative at a size required before they may move a threshold
+    static constexpr std::size_t min_num_samples = 4;
+
+    adaptive_state(std::size_t num_alternatives, const std::vector<std::size_t>& thresholds)
+      : num_alternatives_(num_alternatives),
+        thresholds_(new std::atomic<std::size_t>[num_alternatives - 1]),
+        refinement_enabled_(false),
+        num_launches_(0),
+        timings_(num_alternatives * num_buckets)
+    {
+      set_thresholds(thresholds);
+    }
+
+    std::vector<std::size_t> thresholds() const
+    {
+      std::vector<std::size_t> result(num_alternatives_ - 1);
+
+      for(std::size_t i = 0; i < result.size(); ++i)
+      {
+        result[i] = thresholds_[i].load(std::memory_order_relaxed);
+      }
+
+      return result;
+    }
+
+    // thresholds[i] is the smallest number of agents for which alternative i + 1 is chosen over alternative i
+    // missing thresholds select alternatives which are never chosen, unless online refinement finds them to be faster
+    void set_thresholds(std::vector<std::size_t> thresholds)
+    {
+      thresholds.resize(num_alternatives_ - 1, std::size_t(-1));
+
+      // thresholds must be nondecreasing
+      for(std::size_t i = 1; i < thresholds.size(); ++i)
+      {
+        thresholds[i] = std::max(thresholds[i], thresholds[i-1]);
+      }
+
+      for(std::size_t i = 0; i < thresholds.size(); ++i)
+      {
+        thresholds_[i].store(thresholds[i], std::memory_order_relaxed);
+      }
+    }
+
+    bool refinement_enabled() const
+    {
+      return refinement_enabled_.load(std::memory_order_relaxed);
+    }
+
+    void enable_refinement(bool enabled)
+    {
+      refinement_enabled_.store(enabled, std::memory_order_relaxed);
+    }
+
+    // returns the index of the alternative which should execute a launch of num_agents agents
+    std::size_t select(std::size_t num_agents)
+    {
+      std::size_t result = 0;
+      while(result < num_alternatives_ - 1 && thresholds_[result].load(std::memory_order_relaxed) <= num_agents)
+      {
+        ++result;
+      }
+
+      if(refinement_enabled() && num_launches_.fetch_add(1, std::memory_order_relaxed) % exploration_period == 0)
+      {
+        // occasionally explore the neighboring alternative when num_agents lies near the threshold between them,
+        // so that both alternatives have timings to compare
+        // an alternative with an infinite threshold has never been observed to pay off, so it is explored at every size
+        std::size_t next_threshold = result < num_alternatives_ - 1 ? thresholds_[result].load(std::memory_order_relaxed) : 0;
+
+        if(result < num_alternatives_ - 1 && (next_threshold == std::size_t(-1) || is_near(num_agents, next_threshold)))
+        {
+          ++result;
+        }
+        else if(result > 0 && is_near(num_agents, thresholds_[result-1].load(std::memory_order_relaxed)))
+        {
+          --result;
+        }
+      }
+
+      return result;
+    }
+
+    // records that a launch of num_agents agents on the given alternative took the given time,
+    // and moves the thresholds adjacent to that alternative when its neighbors are known to be faster or slower at this size
+    void record(std::size_t alternative, std::size_t num_agents, std::chrono::nanoseconds time)
+    {
+      std::size_t bucket = bucket_of(num_agents);
+
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      timing& t = timing_of(alternative, bucket);
+
+      // keep an exponentially-weighted moving average so that the timings track changes in the system's load
+      double nanoseconds = static_cast<double>(time.count());
+      t.mean_nanoseconds = t.num_samples == 0 ? nanoseconds : t.mean_nanoseconds + (nanoseconds - t.mean_nanoseconds) / 8;
+      ++t.num_samples;
+
+      if(alternative > 0)
+      {
+        refine_threshold(alternative - 1, bucket);
+      }
+
+      if(alternative < num_alternatives_ - 1)
+      {
+        refine_threshold(alternative, bucket);
+      }
+    }
+
+  private:
+    static constexpr std::size_t num_buckets = 8 * sizeof(std::size_t);
+
+    struct timing
+    {
+      double mean_nanoseconds = 0;
+      std::size_t num_samples = 0;
+    };
+
+    static std::size_t bucket_of(std::size_t num_agents)
+    {
+      std::size_t result = 0;
+      while(num_agents >>= 1)
+      {
+        ++result;
+      }
+
+      return result;
+    }
+
+    // num_agents is near a threshold when it lies within a factor of four of it
+    static bool is_near(std::size_t num_agents, std::size_t threshold)
+    {
+      return num_agents < threshold ? num_agents >= threshold / 4 : num_agents / 4 < threshold;
+    }
+
+    timing& timing_of(std::size_t alternative, std::size_t bucket)
+    {
+      return timings_[alternative * num_buckets + bucket];
+    }
+
+    // compares alternatives i and i + 1 at launches of the given bucket's size
+    // this function requires that mutex_ be locked
+    void refine_threshold(std::size_t i, std::size_t bucket)
+    {
+      const timing& lower = timing_of(i, bucket);
+      const timing& upper = timing_of(i + 1, bucket);
+
+      if(lower.num_samples < min_num_samples || upper.num_samples < min_num_samples) return;
+
+      std::vector<std::size_t> new_thresholds = thresholds();
+
+      std::size_t bucket_begin = std::size_t(1) << bucket;
+      std::size_t bucket_end = bucket + 1 < num_buckets ? std::size_t(1) << (bucket + 1) : std::size_t(-1);
+
+      if(upper.mean_nanoseconds < lower.mean_nanoseconds)
+      {
+        // alternative i + 1 is faster at this size, so choose it for launches at least this large
+        new_thresholds[i] = std::min(new_thresholds[i], bucket_begin);
+
+        // the thresholds below must not exceed this one
+        for(std::size_t j = 0; j < i; ++j)
+        {
+          new_thresholds[j] = std::min(new_thresholds[j], new_thresholds[i]);
+        }
+      }
+      else
+      {
+        // alternative i is at least as fast at this size, so choose it for launches of this size
+        new_thresholds[i] = std::max(new_thresholds[i], bucket_end);
+      }
+
+      set_thresholds(new_thresholds);
+    }
+
+    const std::size_t num_alternatives_;
+    std::unique_ptr<std::atomic<std::size_t>[]> thresholds_;
+    std::atomic<bool> refinement_enabled_;
+    std::atomic<std::size_t> num_launches_;
+
+    std::mutex mutex_;
+    std::vector<timing> timings_;
+};
+
+
+// launch_timer measures the time from a launch until its last agent completes
+class launch_timer
+{
+  public:
+    launch_timer(const std::shared_ptr<adaptive_state>& state, std::size_t alternative, std::size_t num_agents)
+      : state_(state),
+        alternative_(alternative),
+        num_agents_(num_agents),
+        num_remaining_agents_(num_agents),
+        start_(std::chrono::steady_clock::now())
+    {}
+
+    // called by each agent upon completion
+    // the last agent records the launch's time and deletes this launch_timer
+    void agent_completed()
+    {
+      if(num_remaining_agents_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        state_->record(alternative_, num_agents_, std::chrono::steady_clock::now() - start_);
+
+        delete this;
+      }
+    }
+
+  private:
+    std::shared_ptr<adaptive_state> state_;
+    std::size_t alternative_;
+    std::size_t num_agents_;
+    std::atomic<std::size_t> num_remaining_agents_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+
+template<class Function>
+struct timed_function
+{
+  struct completion_guard
+  {
+    launch_timer* timer;
+
+    ~completion_guard()
+    {
+      timer->agent_completed();
+    }
+  };
+
+  Function f;
+  launch_timer* timer;
+
+  template<class... Args>
+  auto operator()(Args&&... args) const ->
+    decltype(f(std::forward<Args>(args)...))
+  {
+    completion_guard guard{timer};
+
+    return f(std::forward<Args>(args)...);
+  }
+};
+
+
+struct empty_bulk_function
+{
+  template<class... Args>
+  void operator()(Args&&...) const
+  {
+    // keep the compiler from eliding agents which do nothing
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+};
+
+
+} // end detail
+
+
+/// adaptive_executor chooses among its alternative executors per launch according to the launch's number of agents.
+/// The alternatives are ordered from the one with the least overhead per launch (e.g., sequenced_executor)
+/// to the one with the most throughput (e.g., parallel_executor).
+/// A launch of n agents executes on alternative i, where i is the number of thresholds no greater than n.
+///
+/// Default-constructed adaptive_executors measure their thresholds once, upon the first default construction,
+/// and share them thereafter. Thresholds may also be supplied explicitly, e.g., from a tuning file
+/// read by read_adaptive_thresholds().
+///
+/// When online refinement is enabled, adaptive_executor times its bulk_twoway_execute launches and moves
+/// its thresholds toward whichever alternative is observed to be faster. Copies of an adaptive_executor
+/// share their thresholds and timings.
+///
+/// The alternative executors must have distinct types.
+template<class Executor, class... Executors>
+class adaptive_executor
+{
+  private:
+    using variant_type = variant_executor<Executor,Executors...>;
+
+    static constexpr std::size_t num_alternatives = 1 + sizeof...(Executors);
+
+  public:
+    /// adaptive_executor's bulk_guarantee_t is the strongest guarantee provided by all of its alternatives.
+    __AGENCY_ANNOTATION
+    constexpr static decltype(bulk_guarantee_t::static_query<variant_type>()) query(bulk_guarantee_t)
+    {
+      return bulk_guarantee_t::static_query<variant_type>();
+    }
+
+    template<class T>
+    using future = typename variant_type::template future<T>;
+
+    using shape_type = typename variant_type::shape_type;
+
+    template<class T>
+    using allocator = typename variant_type::template allocator<T>;
+
+    /// Creates an adaptive_executor whose thresholds are measured upon the first default construction.
+    adaptive_executor()
+      : adaptive_executor(calibrated_state(), Executor(), Executors()...)
+    {}
+
+    /// Creates an adaptive_executor with the given thresholds.
+    /// thresholds[i] is the smallest number of agents for which alternative i + 1 is chosen over alternative i.
+    adaptive_executor(const std::vector<std::size_t>& thresholds, const Executor& ex, const Executors&... exs)
+      : adaptive_executor(std::make_shared<detail::adaptive_state>(std::size_t(num_alternatives), thresholds), ex, exs...)
+    {}
+
+    explicit adaptive_executor(const std::vector<std::size_t>& thresholds)
+      : adaptive_executor(thresholds, Executor(), Executors()...)
+    {}
+
+    std::vector<std::size_t> thresholds() const
+    {
+      return state_->thresholds();
+    }
+
+    void set_thresholds(const std::vector<std::size_t>& thresholds) const
+    {
+      state_->set_thresholds(thresholds);
+    }
+
+    bool online_refinement() const
+    {
+      return state_->refinement_enabled();
+    }
+
+    void enable_online_refinement(bool enabled = true) const
+    {
+      state_->enable_refinement(enabled);
+    }
+
+    /// Measures and returns the thresholds at which each of this adaptive_executor's alternatives
+    /// becomes faster than the previous one at launching agents which do nothing.
+    /// Because real agents do work, these thresholds overestimate the sizes at which the
+    /// alternatives with more throughput pay off. Online refinement corrects for this.
+    /// An alternative which is not faster at any size up to max_num_agents receives the infinite threshold std::size_t(-1),
+    /// which online refinement lowers once it observes that alternative to be faster at some size.
+    std::vector<std::size_t> calibrate(std::size_t max_num_agents = std::size_t(1) << 20) const
+    {
+      const std::size_t num_trials = 5;
+
+      std::vector<std::size_t> result(num_alternatives - 1, std::size_t(-1));
+
+      for(std::size_t i = 0; i < result.size(); ++i)
+      {
+        for(std::size_t n = 1; n <= max_num_agents; n *= 2)
+        {
+          if(time_empty_launch(alternatives_[i+1], n, num_trials) < time_empty_launch(alternatives_[i], n, num_trials))
+          {
+            result[i] = n;
+            break;
+          }
+        }
+      }
+
+      return result;
+    }
+
+    /// Returns the index of the alternative which would execute a launch of the given shape.
+    std::size_t alternative(const shape_type& shape) const
+    {
+      return select(shape);
+    }
+
+    template<class Function>
+    future<agency::detail::result_of_t<agency::detail::decay_t<Function>()>>
+      twoway_execute(Function&& f) const
+    {
+      return alternatives_[state_->select(1)].twoway_execute(std::forward<Function>(f));
+    }
+
+    template<class Function, class Future>
+    future<agency::detail::result_of_continuation_t<agency::detail::decay_t<Function>, Future>>
+      then_execute(Function&& f, Future& predecessor_future) const
+    {
+      return alternatives_[state_->select(1)].then_execute(std::forward<Function>(f), predecessor_future);
+    }
+
+    template<class Function, class ResultFactory, class... SharedFactories>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, shape_type shape, ResultFactory result_factory, SharedFactories... shared_factories) const
+    {
+      std::size_t alternative = select(shape);
+      std::size_t num_agents = agency::detail::index_space_size(shape);
+
+      if(online_refinement() && num_agents > 0)
+      {
+        auto timer = new detail::launch_timer(state_, alternative, num_agents);
+
+        return alternatives_[alternative].bulk_twoway_execute(detail::timed_function<Function>{f, timer}, shape, result_factory, shared_factories...);
+      }
+
+      return alternatives_[alternative].bulk_twoway_execute(f, shape, result_factory, shared_factories...);
+    }
+
+    // bulk_then_execute() launches are not timed, because their agents wait on their predecessor
+    template<class Function, class Future, class ResultFactory, class... SharedFactories>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_then_execute(Function f, shape_type shape, Future& predecessor_future, ResultFactory result_factory, SharedFactories... shared_factories) const
+    {
+      return alternatives_[select(shape)].bulk_then_execute(f, shape, predecessor_future, result_factory, shared_factories...);
+    }
+
+    template<class T, class Future>
+    future<T> future_cast(Future& fut) const
+    {
+      return alternatives_[0].template future_cast<T>(fut);
+    }
+
+    template<class T, class... Args>
+    future<T> make_ready_future(Args&&... args) const
+    {
+      return alternatives_[0].template make_ready_future<T>(std::forward<Args>(args)...);
+    }
+
+    shape_type unit_shape() const
+    {
+      return alternatives_[0].unit_shape();
+    }
+
+    shape_type max_shape_dimensions() const
+    {
+      return alternatives_[num_alternatives - 1].max_shape_dimensions();
+    }
+
+  private:
+    adaptive_executor(const std::shared_ptr<detail::adaptive_state>& state, const Executor& ex, const Executors&... exs)
+      : state_(state),
+        alternatives_{{variant_type(ex), variant_type(exs)...}}
+    {}
+
+    // the state shared by default-constructed adaptive_executors
+    static const std::shared_ptr<detail::adaptive_state>& calibrated_state()
+    {
+      static const std::shared_ptr<detail::adaptive_state> result = std::make_shared<detail::adaptive_state>(
+        std::size_t(num_alternatives),
+        adaptive_executor(std::vector<std::size_t>(), Executor(), Executors()...).calibrate()
+      );
+
+      return result;
+    }
+
+    std::size_t select(const shape_type& shape) const
+    {
+      return state_->select(agency::detail::index_space_size(shape));
+    }
+
+    // returns the median time to launch num_agents agents which do nothing
+    static std::chrono::nanoseconds time_empty_launch(const variant_type& exec, std::size_t num_agents, std::size_t num_trials)
+    {
+      std::vector<std::chrono::nanoseconds> times;
+
+      for(std::size_t trial = 0; trial < num_trials; ++trial)
+      {
+        auto start = std::chrono::steady_clock::now();
+
+        agency::detail::blocking_bulk_twoway_execute_with_void_result(exec, detail::empty_bulk_function(), agency::detail::shape_cast<shape_type>(num_agents), agency::detail::unit_factory());
+
+        times.push_back(std::chrono::steady_clock::now() - start);
+      }
+
+      std::sort(times.begin(), times.end());
+
+      return times[times.size() / 2];
+    }
+
+    std::shared_ptr<detail::adaptive_state> state_;
+    std::array<variant_type, num_alternatives> alternatives_;
+};
+
+
+/// Reads thresholds for an adaptive_executor from a tuning file written by write_adaptive_thresholds().
+/// The file contains the thresholds separated by whitespace. Lines beginning with '#' are comments.
+inline std::vector<std::size_t> read_adaptive_thresholds(std::istream& is)
+{
+  std::vector<std::size_t> result;
+
+  while(is >> std::ws && !is.eof())
+  {
+    if(is.peek() == '#')
+    {
+      is.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    else
+    {
+      std::size_t threshold = 0;
+      if(!(is >> threshold)) break;
+
+      result.push_back(threshold);
+    }
+  }
+
+  return result;
+}
+
+
+/// Writes thresholds for an adaptive_executor in the format read by read_adaptive_thresholds().
+inline void write_adaptive_thresholds(std::ostream& os, const std::vector<std::size_t>& thresholds)
+{
+  os << "# adaptive_executor thresholds" << std::endl;
+
+  for(std::size_t threshold : thresholds)
+  {
+    os << threshold << std::endl;
+  }
+}
+
+
+} // end experimental
+} // end agency
+
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/invoke.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/concurrency/fiber.hpp>
+#include <agency/detail/concurrency/concurrent_thread_pool.hpp>
+#include <agency/execution/executor/properties/always_blocking.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/future/always_ready_future.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstddef>
+
+
+// fiber_executor executes concurrent groups of agents on a fixed number of threads
+//
+// concurrent_executor runs each agent of a group on a thread of its own, because an agent which waits at the group's barrier
+// blocks its thread until every other agent arrives. A group of n agents therefore occupies n threads at once, which makes
+// large groups such as con(4096) impractical.
+//
+// fiber_executor instead runs each agent as a fiber, i.e. a stackful coroutine, and multiplexes the fibers of a group onto
+// a fixed number of threads. A fiber which waits at its group's barrier yields to the other fibers of its thread, so switching
+// between agents at self.wait() costs a context switch within a thread rather than a trip through the operating system.
+//
+//     // 4096 concurrent agents on at most hardware_concurrency threads
+//     agency::bulk_invoke(agency::con(4096).on(agency::experimental::fiber_executor()), f);
+//
+//     // each group of 256 concurrent agents runs on the thread of its parallel agent
+//     agency::bulk_invoke(agency::par(n, agency::con(256).on(agency::experimental::fiber_executor(1))), f);
+//
+// Each fiber has a stack of its own, whose size is fixed when the fiber_executor is constructed.
+// Agents which block their thread other than by waiting at their group's barrier stall the other fibers of their thread.
+
+
+namespace agency
+{
+namespace experimental
+{
+namespace detail
+{
+
+
+#if __AGENCY_HAS_FIBERS
+
+
+// runs f(idx) for each idx in [begin, end) as a fiber of the current thread, and returns after every call has returned
+// when the fibers' group is shared with other threads, the thread yields whenever each of its fibers has had a turn,
+// so that the fibers of other threads may arrive at a barrier the fibers of this thread wait on
+// if any call throws an exception, one such exception is rethrown after every call has returned
+template<class Function>
+void run_as_fibers(Function f, std::size_t begin, std::size_t end, std::size_t stack_size, bool group_spans_threads)
+{
+  std::vector<std::unique_ptr<agency::detail::fiber>> fibers;
+  fibers.reserve(end - begin);
+
+  for(std::size_t idx = begin; idx < end; ++idx)
+  {
+    fibers.emplace_back(new agency::detail::fiber([&f,idx]
+    {
+      f(idx);
+    },
+    stack_size));
+  }
+
+  std::exception_ptr exception;
+
+  while(!fibers.empty())
+  {
+    // give each fiber a turn, and retire those which have finished
+    for(std::size_t i = 0; i < fibers.size();)
+    {
+      try
+      {
+        fibers[i]->resume();
+      }
+      catch(...)
+      {
+        if(!exception)
+        {
+          exception = std::current_exception();
+        }
+      }
+
+      if(fibers[i]->finished())
+      {
+        std::swap(fibers[i], fibers.back());
+        fibers.pop_back();
+      }
+      else
+      {
+        ++i;
+      }
+    }
+
+    if(group_spans_threads && !fibers.empty())
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  if(exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+
+#endif // __AGENCY_HAS_FIBERS
+
+
+} // end detail
+
+
+class fiber_executor
+{
+  public:
+    template<class T>
+    using future = always_ready_future<T>;
+
+    // each group executes on at most num_threads threads, and each of its agents executes on a stack of stack_size bytes
+    explicit fiber_executor(std::size_t num_threads = default_num_threads(),
+                            std::size_t stack_size = default_stack_size)
+      : num_threads_(std::max<std::size_t>(1, num_threads)),
+        stack_size_(stack_size)
+    {}
+
+    std::size_t num_threads() const
+    {
+      return num_threads_;
+    }
+
+    std::size_t stack_size() const
+    {
+      return stack_size_;
+    }
+
+    std::size_t unit_shape() const
+    {
+      return num_threads_;
+    }
+
+    constexpr static bool query(always_blocking_t)
+    {
+      return true;
+    }
+
+    constexpr static bulk_guarantee_t::concurrent_t query(const bulk_guarantee_t&)
+    {
+      return bulk_guarantee_t::concurrent_t();
+    }
+
+    template<class Function, class ResultFactory, class SharedFactory>
+    always_ready_future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, std::size_t n, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+#if __AGENCY_HAS_FIBERS
+      auto result = result_factory();
+      auto shared_parameter = shared_factory();
+
+      if(n > 0)
+      {
+        std::size_t num_threads = std::min(n, num_threads_);
+        std::size_t stack_size = stack_size_;
+
+        auto invoke_agent = [&](std::size_t idx)
+        {
+          agency::detail::invoke(f, idx, result, shared_parameter);
+        };
+
+        // each thread executes a contiguous range of the group's agents
+        auto execute_agents_of_thread = [&](std::size_t thread_idx)
+        {
+          std::size_t begin = n * thread_idx / num_threads;
+          std::size_t end = n * (thread_idx + 1) / num_threads;
+
+          detail::run_as_fibers(invoke_agent, begin, end, stack_size, num_threads > 1);
+        };
+
+        if(num_threads == 1)
+        {
+          execute_agents_of_thread(0);
+        }
+        else
+        {
+          // the fibers of different threads wait on each other, so the threads must run concurrently
+          // the calling thread executes the first range of agents
+          agency::detail::system_concurrent_thread_pool().bulk_invoke(execute_agents_of_thread, num_threads);
+        }
+      }
+
+      return agency::make_always_ready_future(std::move(result));
+#else
+      static_assert(sizeof(Function) && false, "agency::experimental::fiber_executor requires ucontext, which is unavailable on this platform.");
+#endif // __AGENCY_HAS_FIBERS
+    }
+
+    friend bool operator==(const fiber_executor& a, const fiber_executor& b) noexcept
+    {
+      return a.num_threads_ == b.num_threads_ && a.stack_size_ == b.stack_size_;
+    }
+
+    friend bool operator!=(const fiber_executor& a, const fiber_executor& b) noexcept
+    {
+      return !(a == b);
+    }
+
+  private:
+    static constexpr std::size_t default_stack_size = 64 * 1024;
+
+    static std::size_t default_num_threads()
+    {
+      // hardware_concurency() is allowed to return 0, so guard against a 0 result
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::size_t num_threads_;
+    std::size_t stack_size_;
+};
+
+
+} // end experimental
+} // end agency
+
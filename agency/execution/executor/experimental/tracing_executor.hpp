@@ -0,0 +1,683 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/shape.hpp>
+#include <agency/execution/executor/detail/adaptors/basic_executor_adaptor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_then_executor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_twoway_executor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_single_then_executor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_single_twoway_executor.hpp>
+#include <agency/execution/executor/executor_traits/executor_shape.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// tracing_executor records each launch made through it, and the work done by each worker thread on behalf of each launch
+// the recorded trace may be exported in the Chrome trace event format (viewable in chrome://tracing or Perfetto)
+// with experimental::write_chrome_trace(), and summarized with experimental::write_trace_summary()
+//
+// defining AGENCY_DISABLE_TRACING before including this header turns tracing_executor into an adaptor which merely forwards
+// to its base executor, so programs may leave tracing_executor in place without paying for it
+
+
+namespace agency
+{
+namespace experimental
+{
+namespace detail
+{
+
+
+// a trace_event describes either a launch or a span of time during which a worker thread executed agents of a launch
+struct trace_event
+{
+  static constexpr std::size_t max_shape_rank = 8;
+
+  enum kind_type { launch_event, worker_event };
+
+  kind_type kind;
+
+  // the name of the execution function which made the launch
+  const char* function;
+
+  std::size_t launch;
+
+  // nanoseconds since the beginning of the trace
+  // a launch begins when it is submitted to the base executor and ends when the execution function returns
+  // a worker span begins when its first agent begins and ends when its last agent ends
+  std::int64_t begin;
+  std::int64_t end;
+
+  // the number of agents created by a launch, or executed during a worker span
+  std::size_t num_agents;
+
+  // the shape of a launch, flattened into its scalar dimensions
+  std::size_t shape[max_shape_rank];
+  std::size_t shape_rank;
+};
+
+
+// a trace_buffer is a ring of the most recent trace_events recorded by a single thread
+// the ring grows as events are recorded until it reaches its capacity, so threads which record few events use little memory
+// only its owning thread writes to a trace_buffer, so recording an event never waits on other threads
+// a trace_buffer may only be read when no traced launches are executing
+class trace_buffer
+{
+  public:
+    static constexpr std::size_t capacity = 1 << 14;
+
+    explicit trace_buffer(std::size_t thread_index)
+      : thread_index_(thread_index),
+        size_(0)
+    {}
+
+    std::size_t thread_index() const
+    {
+      return thread_index_;
+    }
+
+    void push(const trace_event& e)
+    {
+      std::size_t n = size_.load(std::memory_order_relaxed);
+
+      if(n < capacity)
+      {
+        events_.push_back(e);
+      }
+      else
+      {
+        events_[n % capacity] = e;
+      }
+
+      size_.store(n + 1, std::memory_order_release);
+    }
+
+    // extends this thread's most recent worker span by an agent of the given launch
+    // if the most recent event is not a span of the given launch, begins a new span
+    void record_agent(std::size_t launch, std::int64_t begin, std::int64_t end)
+    {
+      std::size_t n = size_.load(std::memory_order_relaxed);
+
+      if(n > 0)
+      {
+        trace_event& last = events_[(n - 1) % capacity];
+
+        if(last.kind == trace_event::worker_event && last.launch == launch)
+        {
+          last.end = end;
+          ++last.num_agents;
+          return;
+        }
+      }
+
+      trace_event span{};
+      span.kind = trace_event::worker_event;
+      span.function = "agents";
+      span.launch = launch;
+      span.begin = begin;
+      span.end = end;
+      span.num_agents = 1;
+
+      push(span);
+    }
+
+    // returns the retained events, oldest first
+    std::vector<trace_event> events() const
+    {
+      std::size_t n = size_.load(std::memory_order_acquire);
+      std::size_t num_retained = n < capacity ? n : capacity;
+
+      std::vector<trace_event> result;
+      result.reserve(num_retained);
+
+      for(std::size_t i = n - num_retained; i < n; ++i)
+      {
+        result.push_back(events_[i % capacity]);
+      }
+
+      return result;
+    }
+
+    // discards the recorded events and releases their storage
+    void clear()
+    {
+      events_ = std::vector<trace_event>();
+      size_.store(0, std::memory_order_release);
+    }
+
+  private:
+    std::size_t thread_index_;
+    std::vector<trace_event> events_;
+    std::atomic<std::size_t> size_;
+};
+
+
+// the trace_registry owns the trace_buffer of each thread which has recorded an event
+// buffers outlive their threads, so that the work of exited threads remains in the trace until it is cleared
+class trace_registry
+{
+  public:
+    static trace_registry& instance()
+    {
+      static trace_registry result;
+      return result;
+    }
+
+    // nanoseconds since the registry was created
+    std::int64_t now() const
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch_).count();
+    }
+
+    std::size_t next_launch()
+    {
+      return next_launch_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    trace_buffer& this_thread_buffer()
+    {
+      thread_local std::shared_ptr<trace_buffer> buffer = register_thread();
+      return *buffer;
+    }
+
+    // returns the retained events of each thread, keyed by thread index
+    std::map<std::size_t, std::vector<trace_event>> events() const
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      std::map<std::size_t, std::vector<trace_event>> result;
+
+      for(const auto& buffer : buffers_)
+      {
+        result[buffer->thread_index()] = buffer->events();
+      }
+
+      return result;
+    }
+
+    // discards the events of each thread, and the buffers of threads which have exited
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      // a buffer which is no longer shared with its thread's this_thread_buffer() belongs to an exited thread
+      buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(), [](const std::shared_ptr<trace_buffer>& buffer)
+      {
+        return buffer.use_count() == 1;
+      }),
+      buffers_.end());
+
+      for(auto& buffer : buffers_)
+      {
+        buffer->clear();
+      }
+    }
+
+  private:
+    trace_registry()
+      : epoch_(std::chrono::steady_clock::now()),
+        next_launch_(0),
+        next_thread_index_(0)
+    {}
+
+    std::shared_ptr<trace_buffer> register_thread()
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      buffers_.push_back(std::make_shared<trace_buffer>(next_thread_index_++));
+      return buffers_.back();
+    }
+
+    std::chrono::steady_clock::time_point epoch_;
+    std::atomic<std::size_t> next_launch_;
+    std::size_t next_thread_index_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<trace_buffer>> buffers_;
+};
+
+
+struct record_shape_dimension
+{
+  trace_event& e;
+
+  template<class Integral,
+           __AGENCY_REQUIRES(std::is_integral<Integral>::value)
+          >
+  void operator()(const Integral& dimension) const
+  {
+    if(e.shape_rank < trace_event::max_shape_rank)
+    {
+      e.shape[e.shape_rank] = static_cast<std::size_t>(dimension);
+      ++e.shape_rank;
+    }
+  }
+
+  template<class Tuple,
+           __AGENCY_REQUIRES(!std::is_integral<Tuple>::value)
+          >
+  void operator()(const Tuple& dimensions) const
+  {
+    __tu::tuple_for_each(*this, dimensions);
+  }
+};
+
+
+#ifndef AGENCY_DISABLE_TRACING
+
+
+// traced_function wraps the function of a launch and records the agents it executes
+template<class Function>
+struct traced_function
+{
+  Function f;
+  std::size_t launch;
+
+  struct agent_recorder
+  {
+    std::size_t launch;
+    std::int64_t begin;
+
+    ~agent_recorder()
+    {
+      trace_registry& registry = trace_registry::instance();
+      registry.this_thread_buffer().record_agent(launch, begin, registry.now());
+    }
+  };
+
+  template<class... Args>
+  auto operator()(Args&&... args) const ->
+    decltype(f(std::forward<Args>(args)...))
+  {
+    agent_recorder recorder{launch, trace_registry::instance().now()};
+
+    return f(std::forward<Args>(args)...);
+  }
+};
+
+
+// a launch_tracer records a single launch
+// it is created immediately before submission to the base executor, and records the launch when destroyed
+class launch_tracer
+{
+  public:
+    template<class Shape>
+    launch_tracer(const char* function, const Shape& shape)
+      : launch_{}
+    {
+      trace_registry& registry = trace_registry::instance();
+
+      launch_.kind = trace_event::launch_event;
+      launch_.function = function;
+      launch_.launch = registry.next_launch();
+      launch_.num_agents = agency::detail::index_space_size(shape);
+      record_shape_dimension{launch_}(shape);
+
+      launch_.begin = registry.now();
+    }
+
+    ~launch_tracer()
+    {
+      trace_registry& registry = trace_registry::instance();
+
+      launch_.end = registry.now();
+      registry.this_thread_buffer().push(launch_);
+    }
+
+    template<class Function>
+    traced_function<Function> trace(Function f) const
+    {
+      return traced_function<Function>{f, launch_.launch};
+    }
+
+  private:
+    trace_event launch_;
+};
+
+
+#else
+
+
+// when tracing is disabled, launch_tracer neither records anything nor wraps the function of a launch
+class launch_tracer
+{
+  public:
+    template<class Shape>
+    __AGENCY_ANNOTATION
+    launch_tracer(const char*, const Shape&) {}
+
+    template<class Function>
+    __AGENCY_ANNOTATION
+    Function&& trace(Function&& f) const
+    {
+      return std::forward<Function>(f);
+    }
+};
+
+
+#endif // AGENCY_DISABLE_TRACING
+
+
+// a summary of a single launch, assembled from its launch event and its worker spans
+struct launch_summary
+{
+  std::size_t num_agents;
+  std::int64_t submitted;
+  std::int64_t first_agent_began;
+  std::int64_t last_agent_ended;
+  std::size_t num_agents_executed;
+
+  // the time from submission until the first agent began
+  std::int64_t queueing_delay() const
+  {
+    return std::max<std::int64_t>(0, first_agent_began - submitted);
+  }
+
+  // the time from the beginning of the first agent until the end of the last agent
+  std::int64_t execution_time() const
+  {
+    return last_agent_ended - first_agent_began;
+  }
+};
+
+
+inline std::map<std::size_t, launch_summary> summarize_launches(const std::map<std::size_t, std::vector<trace_event>>& events)
+{
+  std::map<std::size_t, launch_summary> result;
+
+  // first find each launch
+  for(const auto& thread : events)
+  {
+    for(const trace_event& e : thread.second)
+    {
+      if(e.kind == trace_event::launch_event)
+      {
+        result[e.launch] = launch_summary{e.num_agents, e.begin, e.end, e.begin, 0};
+      }
+    }
+  }
+
+  // then fold each worker span into its launch
+  for(const auto& thread : events)
+  {
+    for(const trace_event& e : thread.second)
+    {
+      auto launch = result.find(e.launch);
+
+      if(e.kind == trace_event::worker_event && launch != result.end())
+      {
+        launch_summary& s = launch->second;
+
+        if(s.num_agents_executed == 0 || e.begin < s.first_agent_began)
+        {
+          s.first_agent_began = e.begin;
+        }
+
+        s.last_agent_ended = std::max(s.last_agent_ended, e.end);
+        s.num_agents_executed += e.num_agents;
+      }
+    }
+  }
+
+  return result;
+}
+
+
+// a histogram with power-of-two buckets: bucket 0 counts the value 0, and bucket i counts values in [2^(i-1), 2^i)
+class log2_histogram
+{
+  public:
+    void insert(std::uint64_t value)
+    {
+      std::size_t bucket = 0;
+      for(; value > 0; value >>= 1)
+      {
+        ++bucket;
+      }
+
+      if(bucket >= counts_.size())
+      {
+        counts_.resize(bucket + 1, 0);
+      }
+
+      ++counts_[bucket];
+    }
+
+    void write(std::ostream& os, const char* title) const
+    {
+      os << title << std::endl;
+
+      for(std::size_t bucket = 0; bucket < counts_.size(); ++bucket)
+      {
+        std::uint64_t lower = bucket == 0 ? 0 : std::uint64_t(1) << (bucket - 1);
+        std::uint64_t upper = std::uint64_t(1) << bucket;
+
+        os << "  [" << std::setw(10) << lower << ", " << std::setw(10) << upper << ") " << std::setw(10) << counts_[bucket] << std::endl;
+      }
+    }
+
+  private:
+    std::vector<std::size_t> counts_;
+};
+
+
+inline void write_microseconds(std::ostream& os, std::int64_t nanoseconds)
+{
+  os << nanoseconds / 1000 << "." << std::setw(3) << std::setfill('0') << nanoseconds % 1000 << std::setfill(' ');
+}
+
+
+} // end detail
+
+
+// tracing_executor adapts an executor to record a trace of its launches
+// each launch records its shape, the number of agents it creates, and the times at which it was submitted and returned
+// each worker thread records the span of time it spent executing agents of each launch, and how many it executed
+// events are recorded into per-thread ring buffers, so recording never contends with other threads
+//
+// time spent waiting at barriers is included in the spans of the agents which waited, because barriers belong to
+// the execution agents rather than to the executor, and so are invisible to an executor adaptor
+// likewise, the time between the end of a launch's last agent and the readiness of its result is not recorded,
+// because observing that readiness would require attaching a continuation to the future returned to the caller
+//
+// tracing_executor may adapt the executor of any execution policy without changing the code which uses that policy:
+//
+//     auto policy = agency::par(n);
+//     agency::bulk_invoke(policy.on(agency::experimental::make_tracing_executor(policy.executor())), f);
+//
+// XXX tracing_executor records host timestamps only, so it is not suitable for executors whose agents execute on a device
+template<class Executor>
+class tracing_executor : public agency::detail::basic_executor_adaptor<Executor>
+{
+  private:
+    using super_t = agency::detail::basic_executor_adaptor<Executor>;
+
+  public:
+    template<class T>
+    using future = typename super_t::template future<T>;
+
+    tracing_executor() = default;
+
+    tracing_executor(const Executor& ex) noexcept : super_t{ex} {}
+
+    // inherit all of basic_executor_adaptor's query members
+    using super_t::query;
+
+    template<class Function,
+             __AGENCY_REQUIRES(agency::detail::is_single_twoway_executor<Executor>::value)
+            >
+    future<agency::detail::result_of_t<agency::detail::decay_t<Function>()>>
+      twoway_execute(Function&& f) const
+    {
+      detail::launch_tracer tracer("twoway_execute", std::size_t(1));
+
+      return super_t::twoway_execute(tracer.trace(std::forward<Function>(f)));
+    }
+
+    template<class Function, class Future,
+             __AGENCY_REQUIRES(agency::detail::is_single_then_executor<Executor>::value)
+            >
+    future<agency::detail::result_of_continuation_t<agency::detail::decay_t<Function>, Future>>
+      then_execute(Function&& f, Future& fut) const
+    {
+      detail::launch_tracer tracer("then_execute", std::size_t(1));
+
+      return super_t::then_execute(tracer.trace(std::forward<Function>(f)), fut);
+    }
+
+    template<class Function, class Shape, class ResultFactory, class... Factories,
+             __AGENCY_REQUIRES(agency::detail::is_bulk_twoway_executor<Executor>::value)
+            >
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, Shape shape, ResultFactory result_factory, Factories... shared_factories) const
+    {
+      detail::launch_tracer tracer("bulk_twoway_execute", shape);
+
+      return super_t::bulk_twoway_execute(tracer.trace(f), shape, result_factory, shared_factories...);
+    }
+
+    template<class Function, class Shape, class Future, class ResultFactory, class... Factories,
+             __AGENCY_REQUIRES(agency::detail::is_bulk_then_executor<Executor>::value)
+            >
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_then_execute(Function f, Shape shape, Future& fut, ResultFactory result_factory, Factories... shared_factories) const
+    {
+      detail::launch_tracer tracer("bulk_then_execute", shape);
+
+      return super_t::bulk_then_execute(tracer.trace(f), shape, fut, result_factory, shared_factories...);
+    }
+};
+
+
+template<class Executor>
+tracing_executor<Executor> make_tracing_executor(const Executor& ex)
+{
+  return tracing_executor<Executor>(ex);
+}
+
+
+// writes the events recorded by all tracing_executors in the Chrome trace event format
+// this function may only be called when no traced launch is executing
+inline void write_chrome_trace(std::ostream& os)
+{
+  auto events = detail::trace_registry::instance().events();
+  auto launches = detail::summarize_launches(events);
+
+  os << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [" << std::endl;
+
+  bool first = true;
+
+  for(const auto& thread : events)
+  {
+    os << (first ? "" : ",\n")
+       << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << thread.first
+       << ", \"args\": {\"name\": \"thread " << thread.first << "\"}}";
+    first = false;
+
+    for(const detail::trace_event& e : thread.second)
+    {
+      os << ",\n{\"name\": \"";
+
+      if(e.kind == detail::trace_event::launch_event)
+      {
+        os << e.function;
+      }
+      else
+      {
+        os << "launch " << e.launch;
+      }
+
+      os << "\", \"cat\": \"" << (e.kind == detail::trace_event::launch_event ? "launch" : "agents") << "\""
+         << ", \"ph\": \"X\", \"pid\": 0, \"tid\": " << thread.first
+         << ", \"ts\": ";
+      detail::write_microseconds(os, e.begin);
+      os << ", \"dur\": ";
+      detail::write_microseconds(os, e.end - e.begin);
+
+      os << ", \"args\": {\"launch\": " << e.launch << ", \"agents\": " << e.num_agents;
+
+      if(e.kind == detail::trace_event::launch_event)
+      {
+        os << ", \"shape\": [";
+        for(std::size_t i = 0; i < e.shape_rank; ++i)
+        {
+          os << (i ? ", " : "") << e.shape[i];
+        }
+        os << "]";
+
+        auto launch = launches.find(e.launch);
+        if(launch != launches.end() && launch->second.num_agents_executed > 0)
+        {
+          os << ", \"queueing_delay_us\": ";
+          detail::write_microseconds(os, launch->second.queueing_delay());
+        }
+      }
+
+      os << "}}";
+    }
+  }
+
+  os << std::endl << "]}" << std::endl;
+}
+
+
+// writes histograms summarizing the launches recorded by all tracing_executors
+// durations are measured in microseconds
+// this function may only be called when no traced launch is executing
+inline void write_trace_summary(std::ostream& os)
+{
+  auto launches = detail::summarize_launches(detail::trace_registry::instance().events());
+
+  std::size_t num_agents = 0;
+
+  detail::log2_histogram queueing_delays;
+  detail::log2_histogram execution_times;
+  detail::log2_histogram agents_per_launch;
+
+  for(const auto& launch : launches)
+  {
+    const detail::launch_summary& s = launch.second;
+
+    num_agents += s.num_agents;
+    agents_per_launch.insert(s.num_agents);
+
+    if(s.num_agents_executed > 0)
+    {
+      queueing_delays.insert(s.queueing_delay() / 1000);
+      execution_times.insert(s.execution_time() / 1000);
+    }
+  }
+
+  os << "launches: " << launches.size() << std::endl;
+  os << "agents: " << num_agents << std::endl;
+
+  agents_per_launch.write(os, "agents per launch:");
+  queueing_delays.write(os, "queueing delay (microseconds):");
+  execution_times.write(os, "execution time (microseconds):");
+}
+
+
+// discards the events recorded by all tracing_executors
+// this function may only be called when no traced launch is executing
+inline void clear_trace()
+{
+  detail::trace_registry::instance().clear();
+}
+
+
+} // end experimental
+} // end agency
+
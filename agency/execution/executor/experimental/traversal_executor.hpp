@@ -0,0 +1,354 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/shape.hpp>
+#include <agency/detail/shape_cast.hpp>
+#include <agency/detail/index_lexicographical_rank.hpp>
+#include <agency/detail/fast_divisor.hpp>
+#include <agency/coordinate/lattice.hpp>
+#include <agency/coordinate/point.hpp>
+#include <agency/execution/executor/detail/adaptors/basic_executor_adaptor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_then_executor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_twoway_executor.hpp>
+#include <agency/execution/executor/executor_traits/executor_shape.hpp>
+#include <agency/experimental/ndarray/layout.hpp>
+#include <cstddef>
+#include <utility>
+
+
+// traversal_executor adapts an executor to create the agents of a multidimensional launch in a cache-friendly order
+//
+// When a multidimensional policy such as par2d runs on a one-dimensional executor, index_cast creates the agents with the
+// first dimension of their index varying fastest, so each worker is handed a contiguous range of agents which walks down
+// the columns of a row-major array. Agents which access neighboring rows or columns, as in stencils and transposes, then
+// touch memory far from the memory touched by their neighbors on the same worker.
+//
+// traversal_executor launches its base executor over the positions of a traversal, and maps each position to the index
+// of the agent it creates. A tiled traversal hands each worker whole tiles, and a Morton traversal hands each worker
+// blocks of neighboring indices at every scale. The traversal order is invisible to agents: each agent's index() is the
+// same as it would be without the adaptor.
+//
+//     using executor_type = agency::experimental::traversal_executor<agency::parallel_executor, agency::experimental::tiled_traversal<32,32>>;
+//     agency::bulk_invoke(agency::par2d({0,0}, {m,n}).on(executor_type()), f);
+
+
+namespace agency
+{
+namespace experimental
+{
+
+
+// A traversal is an order in which to visit the indices of a multidimensional shape.
+// Each traversal has a nested class template mapping<Shape>, which maps positions in the traversal to indices.
+// A mapping provides the following members:
+//
+//   shape()                    returns the shape being traversed
+//   size()                     returns the number of positions in the traversal
+//   index_of(position, idx)    finds the index visited at position, and returns false when position visits no index
+//
+// Every index of the shape is visited at exactly one position.
+
+
+/// lexicographic_traversal visits indices in lexicographic order, i.e. the last dimension varies fastest.
+/// This is the order of the elements of a row-major array.
+struct lexicographic_traversal
+{
+  template<class Shape>
+  class mapping
+  {
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape) : layout_(shape) {}
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return layout_.shape();
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t size() const
+      {
+        return layout_.required_span_size();
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t position, Index& idx) const
+      {
+        return layout_.index_of(position, idx);
+      }
+
+    private:
+      layout_right::mapping<Shape> layout_;
+  };
+};
+
+
+/// tiled_traversal visits indices tile by tile. The extents of each tile are given by TileExtents.
+/// Tiles are visited in lexicographic order, and the indices within each tile are visited in lexicographic order.
+/// Tiles at the edges of the shape are clipped to the shape, so every position visits an index.
+template<std::size_t... TileExtents>
+struct tiled_traversal
+{
+  template<class Shape>
+  class mapping
+  {
+    private:
+      static constexpr std::size_t rank = agency::detail::index_size<Shape>::value;
+
+      static_assert(sizeof...(TileExtents) == rank, "The number of tile extents must equal the rank of Shape.");
+
+      using extents_type = point<std::size_t, rank>;
+
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape)
+        : shape_(shape),
+          extents_(agency::detail::shape_cast<extents_type>(shape))
+      {
+        extents_type tile{TileExtents...};
+
+        // precompute the volume of a full slab along each dimension, assuming no earlier dimension was clipped
+        for(std::size_t d = 0; d < rank; ++d)
+        {
+          std::size_t volume = 1;
+          for(std::size_t k = 0; k < rank; ++k)
+          {
+            volume *= k <= d ? tile[k] : extents_[k];
+          }
+
+          full_slab_divisors_[d] = agency::detail::fast_divisor(volume > 0 ? volume : 1);
+        }
+      }
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return shape_;
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t size() const
+      {
+        return agency::detail::index_space_size(shape_);
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t position, Index& idx) const
+      {
+        extents_type tile{TileExtents...};
+
+        // box holds the extents of the region of the shape which contains position
+        // initially, the region is the entire shape
+        extents_type box = extents_;
+        std::size_t volume = size();
+
+        if(position >= volume) return false;
+
+        extents_type result;
+        bool clipped = false;
+
+        // along each dimension, the region is divided into slabs one tile thick
+        // find the slab which contains position, and narrow the region to that slab
+        // only the final slab along a dimension may be thinner than a tile,
+        // so the slab containing position is found by dividing by the volume of a full slab
+        for(std::size_t d = 0; d < rank; ++d)
+        {
+          std::size_t volume_per_unit_thickness = volume / box[d];
+          std::size_t full_slab_volume = volume_per_unit_thickness * tile[d];
+
+          // until a dimension is clipped, the volume of a full slab is known in advance
+          std::size_t slab = clipped ? position / full_slab_volume : full_slab_divisors_[d].divide(position);
+
+          position -= slab * full_slab_volume;
+          result[d] = slab * tile[d];
+
+          if(box[d] - result[d] < tile[d])
+          {
+            box[d] = box[d] - result[d];
+            clipped = true;
+          }
+          else
+          {
+            box[d] = tile[d];
+          }
+
+          volume = volume_per_unit_thickness * box[d];
+        }
+
+        // the region is now a single tile, whose indices are visited in lexicographic order
+        for(std::size_t d = rank; d > 0; --d)
+        {
+          result[d-1] += position % box[d-1];
+          position /= box[d-1];
+        }
+
+        idx = agency::detail::shape_cast<Index>(result);
+        return true;
+      }
+
+    private:
+      shape_type shape_;
+      extents_type extents_;
+      agency::detail::fast_divisor full_slab_divisors_[rank];
+  };
+};
+
+
+/// morton_traversal visits indices in Z-order, i.e. the order in which layout_morton arranges array elements in memory.
+/// When the extents of the shape are not powers of two, some positions of the traversal fall into gaps of the Z-order
+/// curve and visit no index. Agents created for those positions return immediately.
+struct morton_traversal
+{
+  template<class Shape>
+  class mapping
+  {
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape) : layout_(shape) {}
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return layout_.shape();
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t size() const
+      {
+        return layout_.required_span_size();
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t position, Index& idx) const
+      {
+        return layout_.index_of(position, idx);
+      }
+
+    private:
+      layout_morton::mapping<Shape> layout_;
+  };
+};
+
+
+namespace detail
+{
+
+
+// traversal_function receives the index of an agent created by the base executor,
+// and invokes the adapted function with the index visited at that agent's position in the traversal
+template<class Function, class Mapping, class BaseShape>
+struct traversal_function
+{
+  Function f;
+  Mapping mapping;
+  BaseShape base_shape;
+
+  __agency_exec_check_disable__
+  template<class BaseIndex, class... Args>
+  __AGENCY_ANNOTATION
+  void operator()(const BaseIndex& base_idx, Args&&... args) const
+  {
+    std::size_t position = agency::detail::index_lexicographical_rank(base_idx, base_shape);
+
+    typename Mapping::shape_type idx;
+
+    if(mapping.index_of(position, idx))
+    {
+      f(idx, std::forward<Args>(args)...);
+    }
+  }
+};
+
+
+} // end detail
+
+
+/// traversal_executor adapts an executor to visit the indices of multidimensional launches in the order given by Traversal.
+/// Its shape is Shape, which defaults to a two-dimensional point. The base executor is launched over the positions of the
+/// traversal, so workers of the base executor are handed ranges of positions rather than ranges of rows.
+/// Launches made through traversal_executor have the same bulk guarantee as the base executor.
+template<class Executor, class Traversal, class Shape = point<std::size_t,2>>
+class traversal_executor : public agency::detail::basic_executor_adaptor<Executor>
+{
+  private:
+    using super_t = agency::detail::basic_executor_adaptor<Executor>;
+    using base_shape_type = executor_shape_t<Executor>;
+
+    using mapping_type = typename Traversal::template mapping<Shape>;
+
+  public:
+    template<class T>
+    using future = typename super_t::template future<T>;
+
+    using shape_type = Shape;
+    using index_type = Shape;
+    using traversal_type = Traversal;
+
+    traversal_executor() = default;
+
+    __AGENCY_ANNOTATION
+    traversal_executor(const Executor& ex) noexcept : super_t{ex} {}
+
+    // inherit all of basic_executor_adaptor's query members
+    using super_t::query;
+
+    template<class Function, class ResultFactory, class... Factories,
+             __AGENCY_REQUIRES(agency::detail::is_bulk_twoway_executor<Executor>::value)
+            >
+    __AGENCY_ANNOTATION
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, shape_type shape, ResultFactory result_factory, Factories... shared_factories) const
+    {
+      mapping_type mapping(shape);
+      base_shape_type base_shape = agency::detail::shape_cast<base_shape_type>(mapping.size());
+
+      return super_t::bulk_twoway_execute(make_traversal_function(f, mapping, base_shape), base_shape, result_factory, shared_factories...);
+    }
+
+    template<class Function, class Future, class ResultFactory, class... Factories,
+             __AGENCY_REQUIRES(agency::detail::is_bulk_then_executor<Executor>::value)
+            >
+    __AGENCY_ANNOTATION
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_then_execute(Function f, shape_type shape, Future& fut, ResultFactory result_factory, Factories... shared_factories) const
+    {
+      mapping_type mapping(shape);
+      base_shape_type base_shape = agency::detail::shape_cast<base_shape_type>(mapping.size());
+
+      return super_t::bulk_then_execute(make_traversal_function(f, mapping, base_shape), base_shape, fut, result_factory, shared_factories...);
+    }
+
+  private:
+    template<class Function>
+    __AGENCY_ANNOTATION
+    static detail::traversal_function<Function,mapping_type,base_shape_type>
+      make_traversal_function(const Function& f, const mapping_type& mapping, const base_shape_type& base_shape)
+    {
+      return detail::traversal_function<Function,mapping_type,base_shape_type>{f, mapping, base_shape};
+    }
+};
+
+
+template<class Traversal, class Shape = point<std::size_t,2>, class Executor>
+__AGENCY_ANNOTATION
+traversal_executor<Executor,Traversal,Shape> make_traversal_executor(const Executor& ex)
+{
+  return traversal_executor<Executor,Traversal,Shape>(ex);
+}
+
+
+} // end experimental
+} // end agency
+
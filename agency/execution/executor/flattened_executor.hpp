@@ -14,6 +14,9 @@
 #include <agency/execution/executor/scoped_executor.hpp>
 #include <agency/execution/executor/customization_points.hpp>
 #include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/execution/executor/properties/schedule.hpp>
+#include <agency/execution/executor/executor_traits/detail/has_query_member.hpp>
+#include <agency/execution/executor/require.hpp>
 #include <agency/execution/executor/query.hpp>
 #include <agency/detail/algorithm/min.hpp>
 #include <agency/detail/algorithm/max.hpp>
@@ -209,6 +212,15 @@ struct flatten_index_and_invoke<Index,void,Function,Shape>
 };
 
 
+template<class Executor>
+using member_outer_executor_t = decay_t<decltype(std::declval<const Executor&>().outer_executor())>;
+
+
+// a scoped executor is dynamically scheduled when its outer executor is
+template<class Executor>
+using has_schedulable_outer_executor = has_query_member<detected_t<member_outer_executor_t, Executor>, schedule_t>;
+
+
 template<class Index, class Predecessor, class Function, class Shape>
 __AGENCY_ANNOTATION
 flatten_index_and_invoke<Index,Predecessor,Function,Shape>
@@ -291,6 +303,29 @@ class flattened_executor
       return detail::flatten_bulk_guarantee(agency::query(base_executor(), prop));
     }
 
+    // the schedule of a flattened_executor is the schedule of its base executor's outer executor
+    template<class E = base_executor_type,
+             __AGENCY_REQUIRES(
+               detail::has_schedulable_outer_executor<E>::value
+             )>
+    schedule_t query(const schedule_t& prop) const
+    {
+      return agency::query(base_executor().outer_executor(), prop);
+    }
+
+    template<class Schedule,
+             class E = base_executor_type,
+             __AGENCY_REQUIRES(
+               detail::is_schedule<Schedule>::value and
+               detail::has_schedulable_outer_executor<E>::value
+             )>
+    flattened_executor require(const Schedule& schedule) const
+    {
+      flattened_executor result = *this;
+      result.base_executor().outer_executor() = agency::require(base_executor().outer_executor(), schedule);
+      return result;
+    }
+
     template<class Function, class Future, class ResultFactory, class OuterFactory, class... InnerFactories,
              __AGENCY_REQUIRES(sizeof...(InnerFactories) == execution_depth - 1)
             >
@@ -367,25 +402,39 @@ class flattened_executor
       size_t outer_max_size = detail::shape_head(base_executor_max_sizes);
       size_t inner_max_size = agency::get<1>(base_executor_max_sizes);
 
-      // set outer subscription to 1
-      size_t outer_size = detail::min(outer_max_size, detail::min(requested_size, outer_granularity));
+      size_t outer_size = 0;
+      size_t inner_size = 0;
 
-      size_t inner_size = (requested_size + outer_size - 1) / outer_size;
-
-      // address inner underutilization
-      // XXX consider trying to balance the utilization
-      while(inner_size < inner_granularity)
+      if(base_executor_is_dynamically_scheduled())
       {
-        // halve the outer size
-        outer_size = detail::max<int>(1, outer_size / 2);
-        inner_size *= 2;
+        // when the outer executor schedules its agents dynamically, it balances the load
+        // of each group across its workers at runtime. so, rather than creating a single large group per worker,
+        // create many small groups and let the outer executor's schedule determine how many each worker receives
+        inner_size = inner_granularity;
+        outer_size = (requested_size + inner_size - 1) / inner_size;
       }
-
-      // we may require one partially-full group of agents
-      if(outer_size * inner_size < requested_size)
+      else
       {
-        // we require a single partially-full group of agents
-        outer_size += 1;
+        // set outer subscription to 1
+        outer_size = detail::min(outer_max_size, detail::min(requested_size, outer_granularity));
+
+        inner_size = (requested_size + outer_size - 1) / outer_size;
+
+        // address inner underutilization
+        // XXX consider trying to balance the utilization
+        while(inner_size < inner_granularity)
+        {
+          // halve the outer size
+          outer_size = detail::max<int>(1, outer_size / 2);
+          inner_size *= 2;
+        }
+
+        // we may require one partially-full group of agents
+        if(outer_size * inner_size < requested_size)
+        {
+          // we require a single partially-full group of agents
+          outer_size += 1;
+        }
       }
 
       if(inner_size > inner_max_size)
@@ -419,6 +468,25 @@ class flattened_executor
       return head_partition_type{outer_shape, inner_shape};
     }
 
+    template<class E = base_executor_type,
+             __AGENCY_REQUIRES(
+               detail::has_schedulable_outer_executor<E>::value
+             )>
+    bool base_executor_is_dynamically_scheduled() const
+    {
+      return !query(schedule).is_uniform();
+    }
+
+    template<class E = base_executor_type,
+             __AGENCY_REQUIRES(
+               !detail::has_schedulable_outer_executor<E>::value
+             )>
+    __AGENCY_ANNOTATION
+    bool base_executor_is_dynamically_scheduled() const
+    {
+      return false;
+    }
+
     template<size_t... Indices>
     __AGENCY_ANNOTATION
     static base_shape_type make_base_shape_impl(detail::index_sequence<Indices...>, const head_partition_type& partition_of_head, const shape_tail_type& tail)
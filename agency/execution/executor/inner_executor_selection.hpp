@@ -0,0 +1,337 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstddef>
+
+
+// An inner executor selection policy chooses which of an executor_array's inner executors executes each group of agents.
+// A selection policy provides the following members:
+//
+//   select(rank, n)    returns the index in [0, n) of the inner executor which executes the group whose outer index has the given rank
+//
+// A selection policy may also provide:
+//
+//   release(i)         is called when a group selected to execute on inner executor i has completed
+//
+// Copies of an executor_array share the state of their selection policy.
+
+
+namespace agency
+{
+
+
+/// round_robin_selection assigns the group with rank r to inner executor r % n.
+/// This is executor_array's default selection policy.
+struct round_robin_selection
+{
+  __AGENCY_ANNOTATION
+  std::size_t select(std::size_t rank, std::size_t num_inner_executors) const
+  {
+    return rank % num_inner_executors;
+  }
+};
+
+
+/// inner_executor_occupancy reports the work assigned to an inner executor by a selection policy which tracks load.
+struct inner_executor_occupancy
+{
+  /// The number of groups assigned to the inner executor which have not yet completed.
+  std::size_t outstanding;
+
+  /// The number of groups ever assigned to the inner executor.
+  std::size_t assigned;
+};
+
+
+namespace detail
+{
+
+
+// occupancy_counters counts the groups assigned to and outstanding on each of a collection of inner executors
+class occupancy_counters
+{
+  public:
+    explicit occupancy_counters(std::size_t n)
+      : size_(n),
+        outstanding_(new std::atomic<std::size_t>[n]),
+        assigned_(new std::atomic<std::size_t>[n])
+    {
+      for(std::size_t i = 0; i < size_; ++i)
+      {
+        outstanding_[i].store(0, std::memory_order_relaxed);
+        assigned_[i].store(0, std::memory_order_relaxed);
+      }
+    }
+
+    std::size_t size() const
+    {
+      return size_;
+    }
+
+    std::size_t outstanding(std::size_t i) const
+    {
+      return outstanding_[i].load(std::memory_order_relaxed);
+    }
+
+    inner_executor_occupancy occupancy(std::size_t i) const
+    {
+      return inner_executor_occupancy{outstanding_[i].load(std::memory_order_relaxed), assigned_[i].load(std::memory_order_relaxed)};
+    }
+
+    void acquire(std::size_t i)
+    {
+      outstanding_[i].fetch_add(1, std::memory_order_relaxed);
+      assigned_[i].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(std::size_t i)
+    {
+      outstanding_[i].fetch_sub(1, std::memory_order_relaxed);
+    }
+
+  private:
+    std::size_t size_;
+    std::unique_ptr<std::atomic<std::size_t>[]> outstanding_;
+    std::unique_ptr<std::atomic<std::size_t>[]> assigned_;
+};
+
+
+// load_tracking_selection is the base of the selection policies which count the outstanding groups of each inner executor
+class load_tracking_selection
+{
+  public:
+    load_tracking_selection() = default;
+
+    explicit load_tracking_selection(std::size_t num_inner_executors)
+      : counters_(std::make_shared<occupancy_counters>(num_inner_executors))
+    {}
+
+    /// Returns the occupancy of inner executor i.
+    inner_executor_occupancy occupancy(std::size_t i) const
+    {
+      return tracks(i) ? counters_->occupancy(i) : inner_executor_occupancy{0, 0};
+    }
+
+    void release(std::size_t i) const
+    {
+      if(tracks(i))
+      {
+        counters_->release(i);
+      }
+    }
+
+  protected:
+    // selects the inner executor with the fewest outstanding groups among those for which pred returns true
+    // ties are broken in favor of the first candidate at or after rank % n, so that idle executors share groups evenly
+    // when no inner executor satisfies pred, every inner executor is a candidate
+    template<class Predicate>
+    std::size_t select_least_loaded(std::size_t rank, std::size_t num_inner_executors, Predicate pred) const
+    {
+      std::size_t start = rank % num_inner_executors;
+
+      // without counters for every inner executor, there's no load to balance
+      if(!counters_ || counters_->size() < num_inner_executors) return start;
+
+      std::size_t result = num_inner_executors;
+      std::size_t fewest = 0;
+
+      for(int pass = 0; pass < 2 && result == num_inner_executors; ++pass)
+      {
+        for(std::size_t j = 0; j < num_inner_executors; ++j)
+        {
+          std::size_t i = (start + j) % num_inner_executors;
+
+          if(pass == 1 || pred(i))
+          {
+            std::size_t outstanding = counters_->outstanding(i);
+
+            if(result == num_inner_executors || outstanding < fewest)
+            {
+              result = i;
+              fewest = outstanding;
+            }
+          }
+        }
+      }
+
+      // the counts may change between reading them and acquiring the selection,
+      // so concurrent selections may occasionally choose the same executor
+      counters_->acquire(result);
+
+      return result;
+    }
+
+  private:
+    bool tracks(std::size_t i) const
+    {
+      return counters_ && i < counters_->size();
+    }
+
+    std::shared_ptr<occupancy_counters> counters_;
+};
+
+
+} // end detail
+
+
+/// least_loaded_selection assigns each group to the inner executor with the fewest outstanding groups.
+/// When inner executors differ in speed, or groups differ in the amount of work they do, faster executors finish their groups
+/// sooner and receive more of them.
+///
+/// A least_loaded_selection must be constructed with the number of inner executors whose load it tracks.
+/// executor_array's constructors do this automatically. A default-constructed least_loaded_selection selects round-robin.
+class least_loaded_selection : public detail::load_tracking_selection
+{
+  public:
+    least_loaded_selection() = default;
+
+    explicit least_loaded_selection(std::size_t num_inner_executors)
+      : detail::load_tracking_selection(num_inner_executors)
+    {}
+
+    std::size_t select(std::size_t rank, std::size_t num_inner_executors) const
+    {
+      return this->select_least_loaded(rank, num_inner_executors, [](std::size_t){ return true; });
+    }
+};
+
+
+/// affinity_selection assigns each group to an inner executor in the locality domain of the data it accesses.
+/// A domain is any integer which identifies a locality, for example the NUMA node an inner executor's threads run on, or the
+/// allocator which owns the memory a group accesses. affinity_selection is constructed with the domain of each inner executor
+/// and a function which returns the domain of the data accessed by the group with a given rank.
+/// Among the inner executors of a group's domain, the one with the fewest outstanding groups is selected.
+/// When no inner executor belongs to a group's domain, the least loaded of all inner executors is selected.
+///
+///     // inner executor i runs on NUMA node i, and the data of group r lives on node r / groups_per_node
+///     std::vector<size_t> domains = {0, 1};
+///     auto policy = agency::make_affinity_selection(domains, [=](size_t r){ return r / groups_per_node; });
+template<class DomainFunction>
+class affinity_selection : public detail::load_tracking_selection
+{
+  public:
+    affinity_selection(const std::vector<std::size_t>& executor_domains, DomainFunction domain_of_group)
+      : detail::load_tracking_selection(executor_domains.size()),
+        executor_domains_(std::make_shared<const std::vector<std::size_t>>(executor_domains)),
+        domain_of_group_(domain_of_group)
+    {}
+
+    std::size_t select(std::size_t rank, std::size_t num_inner_executors) const
+    {
+      std::size_t domain = domain_of_group_(rank);
+      const std::vector<std::size_t>& executor_domains = *executor_domains_;
+
+      return this->select_least_loaded(rank, num_inner_executors, [&](std::size_t i)
+      {
+        return i < executor_domains.size() && executor_domains[i] == domain;
+      });
+    }
+
+    /// Returns the domain of inner executor i.
+    std::size_t domain(std::size_t i) const
+    {
+      return (*executor_domains_)[i];
+    }
+
+  private:
+    std::shared_ptr<const std::vector<std::size_t>> executor_domains_;
+    DomainFunction domain_of_group_;
+};
+
+
+template<class DomainFunction>
+affinity_selection<DomainFunction> make_affinity_selection(const std::vector<std::size_t>& executor_domains, DomainFunction domain_of_group)
+{
+  return affinity_selection<DomainFunction>(executor_domains, domain_of_group);
+}
+
+
+/// mapped_selection assigns the group with rank r to the inner executor returned by a user-supplied function of r.
+/// Results outside of [0, n) wrap around.
+template<class Function>
+class mapped_selection
+{
+  public:
+    __AGENCY_ANNOTATION
+    mapped_selection(Function f) : f_(f) {}
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    std::size_t select(std::size_t rank, std::size_t num_inner_executors) const
+    {
+      return static_cast<std::size_t>(f_(rank)) % num_inner_executors;
+    }
+
+  private:
+    Function f_;
+};
+
+
+template<class Function>
+__AGENCY_ANNOTATION
+mapped_selection<Function> make_mapped_selection(Function f)
+{
+  return mapped_selection<Function>(f);
+}
+
+
+namespace detail
+{
+
+
+// constructs a SelectionPolicy for n inner executors
+// policies which track the load of each inner executor are constructed with n, and other policies are default-constructed
+template<class SelectionPolicy,
+         __AGENCY_REQUIRES(std::is_constructible<SelectionPolicy,std::size_t>::value)
+        >
+SelectionPolicy make_selection_policy(std::size_t n)
+{
+  return SelectionPolicy(n);
+}
+
+__agency_exec_check_disable__
+template<class SelectionPolicy,
+         __AGENCY_REQUIRES(!std::is_constructible<SelectionPolicy,std::size_t>::value)
+        >
+__AGENCY_ANNOTATION
+SelectionPolicy make_selection_policy(std::size_t)
+{
+  return SelectionPolicy();
+}
+
+
+template<class SelectionPolicy>
+using selection_policy_release_t = decltype(std::declval<const SelectionPolicy&>().release(std::declval<std::size_t>()));
+
+template<class SelectionPolicy>
+using has_selection_policy_release = is_detected<selection_policy_release_t, SelectionPolicy>;
+
+
+__agency_exec_check_disable__
+template<class SelectionPolicy,
+         __AGENCY_REQUIRES(has_selection_policy_release<SelectionPolicy>::value)
+        >
+__AGENCY_ANNOTATION
+void release_inner_executor(const SelectionPolicy& policy, std::size_t i)
+{
+  policy.release(i);
+}
+
+template<class SelectionPolicy,
+         __AGENCY_REQUIRES(!has_selection_policy_release<SelectionPolicy>::value)
+        >
+__AGENCY_ANNOTATION
+void release_inner_executor(const SelectionPolicy&, std::size_t)
+{
+}
+
+
+} // end detail
+} // end agency
+
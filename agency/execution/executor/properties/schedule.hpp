@@ -0,0 +1,243 @@
+// Copyright (c) 2018, NVIDIA CORPORATION. All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <cstddef>
+#include <type_traits>
+
+
+namespace agency
+{
+
+
+// schedule_t describes how an executor assigns the agents of a bulk launch to its workers
+//
+// uniform: the index space is split once, up front, into equally-sized contiguous blocks, one per worker
+// dynamic: workers repeatedly claim blocks of chunk_size agents from a shared cursor until none remain
+// guided:  like dynamic, but the size of each claimed block shrinks in proportion to the number of
+//          remaining agents, down to a minimum of chunk_size agents
+//
+// the uniform schedule has the lowest overhead, while the dynamic & guided schedules tolerate agents with
+// irregular costs by allowing idle workers to take on work which would otherwise wait behind a straggler
+struct schedule_t
+{
+  static constexpr bool is_requirable = false;
+  static constexpr bool is_preferable = false;
+
+  struct uniform_t
+  {
+    static constexpr bool is_requirable = true;
+    static constexpr bool is_preferable = true;
+
+    __AGENCY_ANNOTATION
+    constexpr uniform_t value() const
+    {
+      return *this;
+    }
+
+    __AGENCY_ANNOTATION
+    constexpr std::size_t chunk_size() const
+    {
+      return 0;
+    }
+  };
+
+  struct dynamic_t
+  {
+    static constexpr bool is_requirable = true;
+    static constexpr bool is_preferable = true;
+
+    __AGENCY_ANNOTATION
+    constexpr explicit dynamic_t(std::size_t chunk_size = 1)
+      : chunk_size_(chunk_size > 0 ? chunk_size : 1)
+    {}
+
+    __AGENCY_ANNOTATION
+    constexpr dynamic_t value() const
+    {
+      return *this;
+    }
+
+    __AGENCY_ANNOTATION
+    constexpr std::size_t chunk_size() const
+    {
+      return chunk_size_;
+    }
+
+    private:
+      std::size_t chunk_size_;
+  };
+
+  struct guided_t
+  {
+    static constexpr bool is_requirable = true;
+    static constexpr bool is_preferable = true;
+
+    __AGENCY_ANNOTATION
+    constexpr explicit guided_t(std::size_t min_chunk_size = 1)
+      : chunk_size_(min_chunk_size > 0 ? min_chunk_size : 1)
+    {}
+
+    __AGENCY_ANNOTATION
+    constexpr guided_t value() const
+    {
+      return *this;
+    }
+
+    __AGENCY_ANNOTATION
+    constexpr std::size_t chunk_size() const
+    {
+      return chunk_size_;
+    }
+
+    private:
+      std::size_t chunk_size_;
+  };
+
+  // these factories create schedule property values
+  // they are static member functions rather than static data members
+  // so that using them does not require out-of-line definitions
+  __AGENCY_ANNOTATION
+  static constexpr uniform_t uniform()
+  {
+    return uniform_t{};
+  }
+
+  __AGENCY_ANNOTATION
+  static constexpr dynamic_t dynamic(std::size_t chunk_size = 1)
+  {
+    return dynamic_t{chunk_size};
+  }
+
+  __AGENCY_ANNOTATION
+  static constexpr guided_t guided(std::size_t min_chunk_size = 1)
+  {
+    return guided_t{min_chunk_size};
+  }
+
+  __AGENCY_ANNOTATION
+  constexpr schedule_t()
+    : which_{0}, chunk_size_{0}
+  {}
+
+  __AGENCY_ANNOTATION
+  constexpr schedule_t(const uniform_t&)
+    : which_{0}, chunk_size_{0}
+  {}
+
+  __AGENCY_ANNOTATION
+  constexpr schedule_t(const dynamic_t& s)
+    : which_{1}, chunk_size_{s.chunk_size()}
+  {}
+
+  __AGENCY_ANNOTATION
+  constexpr schedule_t(const guided_t& s)
+    : which_{2}, chunk_size_{s.chunk_size()}
+  {}
+
+  __AGENCY_ANNOTATION
+  constexpr bool is_uniform() const
+  {
+    return which_ == 0;
+  }
+
+  __AGENCY_ANNOTATION
+  constexpr bool is_dynamic() const
+  {
+    return which_ == 1;
+  }
+
+  __AGENCY_ANNOTATION
+  constexpr bool is_guided() const
+  {
+    return which_ == 2;
+  }
+
+  // for the guided schedule, chunk_size() is the minimum size of a chunk
+  __AGENCY_ANNOTATION
+  constexpr std::size_t chunk_size() const
+  {
+    return chunk_size_;
+  }
+
+  __AGENCY_ANNOTATION
+  friend constexpr bool operator==(const schedule_t& a, const schedule_t& b)
+  {
+    return a.which_ == b.which_ && a.chunk_size_ == b.chunk_size_;
+  }
+
+  __AGENCY_ANNOTATION
+  friend constexpr bool operator!=(const schedule_t& a, const schedule_t& b)
+  {
+    return !(a == b);
+  }
+
+  private:
+    unsigned int which_;
+    std::size_t chunk_size_;
+};
+
+
+namespace detail
+{
+
+
+template<class T>
+struct is_schedule : std::integral_constant<
+  bool,
+  std::is_same<T, schedule_t>::value or
+  std::is_same<T, schedule_t::uniform_t>::value or
+  std::is_same<T, schedule_t::dynamic_t>::value or
+  std::is_same<T, schedule_t::guided_t>::value
+>
+{};
+
+
+} // end detail
+
+
+namespace
+{
+
+
+// define the property object
+
+#ifndef __CUDA_ARCH__
+constexpr schedule_t schedule{};
+#else
+// CUDA __device__ functions cannot access global variables so make schedule a __device__ variable in __device__ code
+const __device__ schedule_t schedule;
+#endif
+
+
+} // end anonymous namespace
+
+
+} // end agency
+
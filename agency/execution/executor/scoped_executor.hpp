@@ -17,9 +17,9 @@ class scoped_executor : public executor_array<Executor2,Executor1>
     using outer_executor_type = Executor1;
     using inner_executor_type = Executor2;
 
-    scoped_executor(const outer_executor_type&,
+    scoped_executor(const outer_executor_type& outer_ex,
                     const inner_executor_type& inner_ex)
-      : super_t(1, inner_ex)
+      : super_t(outer_ex, 1, inner_ex)
     {}
 
     scoped_executor() :
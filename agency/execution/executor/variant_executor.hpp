@@ -382,7 +382,7 @@ class variant_executor
     future<T> make_ready_future(Args&&... args) const
     {
       auto args_tuple = agency::forward_as_tuple(std::forward<Args>(args)...);
-      auto visitor = make_ready_future_visitor<T,Args&&...>{args_tuple};
+      auto visitor = make_ready_future_visitor<T,Args&&...>{std::move(args_tuple)};
       return experimental::visit(visitor, variant_);
     }
 
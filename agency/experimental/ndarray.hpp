@@ -1,5 +1,6 @@
 #pragma once
 
+#include <agency/experimental/ndarray/layout.hpp>
 #include <agency/experimental/ndarray/ndarray.hpp>
 #include <agency/experimental/ndarray/ndarray_ref.hpp>
 #include <agency/experimental/ndarray/shape.hpp>
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/bulk_invoke.hpp>
+#include <agency/execution/execution_policy/execution_policy_traits.hpp>
+#include <agency/memory/allocator/detail/allocator_traits.hpp>
+#include <agency/experimental/ndarray/layout.hpp>
+#include <iterator>
+#include <cstddef>
+
+namespace agency
+{
+namespace experimental
+{
+namespace detail
+{
+
+
+// iterator_array presents an iterator as an array whose elements are arranged in row-major order
+template<class Iterator, class Shape>
+class iterator_array
+{
+  public:
+    using reference = typename std::iterator_traits<Iterator>::reference;
+
+    __AGENCY_ANNOTATION
+    iterator_array(Iterator first, const Shape& shape)
+      : first_(first), mapping_(shape)
+    {}
+
+    template<class Index>
+    __AGENCY_ANNOTATION
+    reference operator[](const Index& idx) const
+    {
+      return first_[mapping_(idx)];
+    }
+
+  private:
+    Iterator first_;
+    layout_right::mapping<Shape> mapping_;
+};
+
+
+template<class Shape, class Iterator>
+__AGENCY_ANNOTATION
+iterator_array<Iterator,Shape> make_iterator_array(Iterator first, const Shape& shape)
+{
+  return iterator_array<Iterator,Shape>(first, shape);
+}
+
+
+__agency_exec_check_disable__
+template<class Index, class Allocator, class Pointer, class Mapping, class... ArrayViews>
+__AGENCY_ANNOTATION
+void construct_at_offset(Allocator& alloc, std::size_t offset, Pointer data, const Mapping& mapping, const ArrayViews&... arrays)
+{
+  Index idx;
+
+  // offsets which map to no element, e.g. padding, are left uninitialized
+  if(mapping.index_of(offset, idx))
+  {
+    agency::detail::allocator_traits<Allocator>::construct(alloc, &data[offset], arrays[idx]...);
+  }
+}
+
+
+template<class Allocator, class Mapping, class Index>
+struct construct_in_storage_order_functor
+{
+  // mutable because allocator_traits::construct() requires a mutable allocator
+  mutable Allocator alloc_;
+  Mapping mapping_;
+
+  __agency_exec_check_disable__
+  __AGENCY_ANNOTATION
+  construct_in_storage_order_functor(const Allocator& alloc, const Mapping& mapping)
+    : alloc_(alloc), mapping_(mapping)
+  {}
+
+  __AGENCY_ANNOTATION
+  construct_in_storage_order_functor(const construct_in_storage_order_functor& other)
+    : construct_in_storage_order_functor(other.alloc_, other.mapping_)
+  {}
+
+  __agency_exec_check_disable__
+  __AGENCY_ANNOTATION
+  ~construct_in_storage_order_functor() {}
+
+  template<class Agent, class Pointer, class... ArrayViews>
+  __AGENCY_ANNOTATION
+  void operator()(Agent& self, Pointer data, ArrayViews... arrays) const
+  {
+    detail::construct_at_offset<Index>(alloc_, self.rank(), data, mapping_, arrays...);
+  }
+};
+
+
+// construct_in_storage_order() constructs the elements of an array whose layout is described by mapping.
+// Each element at index idx is constructed from arrays[idx]..., and elements are visited in the order that
+// the mapping arranges them in memory, rather than in the order of their indices. Each execution agent
+// created by policy handles a single offset into the array's storage.
+template<class Index, class Allocator, class ExecutionPolicy, class Pointer, class Mapping, class... ArrayViews,
+         __AGENCY_REQUIRES(
+           is_execution_policy<agency::detail::decay_t<ExecutionPolicy>>::value
+         )>
+__AGENCY_ANNOTATION
+void construct_in_storage_order(Allocator& alloc, ExecutionPolicy&& policy, Pointer data, const Mapping& mapping, const ArrayViews&... arrays)
+{
+  std::size_t span = mapping.required_span_size();
+
+  if(span > 0)
+  {
+    agency::bulk_invoke(
+      policy(span),
+      construct_in_storage_order_functor<Allocator,Mapping,Index>{alloc, mapping},
+      data,
+      arrays...
+    );
+  }
+}
+
+
+template<class Index, class Allocator, class Pointer, class Mapping, class... ArrayViews,
+         __AGENCY_REQUIRES(
+           !is_execution_policy<Pointer>::value
+         )>
+__AGENCY_ANNOTATION
+void construct_in_storage_order(Allocator& alloc, Pointer data, const Mapping& mapping, const ArrayViews&... arrays)
+{
+  std::size_t span = mapping.required_span_size();
+
+  for(std::size_t offset = 0; offset < span; ++offset)
+  {
+    detail::construct_at_offset<Index>(alloc, offset, data, mapping, arrays...);
+  }
+}
+
+
+} // end detail
+} // end experimental
+} // end agency
+
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/experimental/ndarray/layout.hpp>
+#include <iterator>
+#include <memory>
+#include <cstddef>
+
+namespace agency
+{
+namespace experimental
+{
+namespace detail
+{
+
+
+// layout_iterator traverses the elements of an array in the lexicographic order of their indices,
+// regardless of the order in which the array's layout arranges them in memory
+template<class Pointer, class Mapping, class Index>
+class layout_iterator
+{
+  public:
+    using value_type = typename std::pointer_traits<Pointer>::element_type;
+    using reference = typename std::iterator_traits<Pointer>::reference;
+    using pointer = Pointer;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    layout_iterator() = default;
+
+    layout_iterator(const layout_iterator&) = default;
+
+    __AGENCY_ANNOTATION
+    layout_iterator(Pointer data, const Mapping& mapping, std::size_t position)
+      : data_(data), mapping_(mapping), position_(position)
+    {}
+
+    // dereference
+    __AGENCY_ANNOTATION
+    reference operator*() const
+    {
+      return (*this)[0];
+    }
+
+    // subscript
+    __AGENCY_ANNOTATION
+    reference operator[](difference_type n) const
+    {
+      Index idx;
+      layout_right::mapping<typename Mapping::shape_type>(mapping_.shape()).index_of(position_ + n, idx);
+
+      return data_[mapping_(idx)];
+    }
+
+    // equal
+    __AGENCY_ANNOTATION
+    bool operator==(const layout_iterator& rhs) const
+    {
+      return position_ == rhs.position_;
+    }
+
+    // not equal
+    __AGENCY_ANNOTATION
+    bool operator!=(const layout_iterator& rhs) const
+    {
+      return position_ != rhs.position_;
+    }
+
+    // less
+    __AGENCY_ANNOTATION
+    bool operator<(const layout_iterator& rhs) const
+    {
+      return position_ < rhs.position_;
+    }
+
+    // pre-increment
+    __AGENCY_ANNOTATION
+    layout_iterator& operator++()
+    {
+      ++position_;
+      return *this;
+    }
+
+    // post-increment
+    __AGENCY_ANNOTATION
+    layout_iterator operator++(int)
+    {
+      layout_iterator result = *this;
+      ++position_;
+      return result;
+    }
+
+    // pre-decrement
+    __AGENCY_ANNOTATION
+    layout_iterator& operator--()
+    {
+      --position_;
+      return *this;
+    }
+
+    // post-decrement
+    __AGENCY_ANNOTATION
+    layout_iterator operator--(int)
+    {
+      layout_iterator result = *this;
+      --position_;
+      return result;
+    }
+
+    // plus-equal
+    __AGENCY_ANNOTATION
+    layout_iterator& operator+=(difference_type n)
+    {
+      position_ += n;
+      return *this;
+    }
+
+    // plus
+    __AGENCY_ANNOTATION
+    layout_iterator operator+(difference_type n) const
+    {
+      layout_iterator result = *this;
+      result += n;
+      return result;
+    }
+
+    // minus-equal
+    __AGENCY_ANNOTATION
+    layout_iterator& operator-=(difference_type n)
+    {
+      position_ -= n;
+      return *this;
+    }
+
+    // minus
+    __AGENCY_ANNOTATION
+    layout_iterator operator-(difference_type n) const
+    {
+      layout_iterator result = *this;
+      result -= n;
+      return result;
+    }
+
+    // difference
+    __AGENCY_ANNOTATION
+    difference_type operator-(const layout_iterator& rhs) const
+    {
+      return position_ - rhs.position_;
+    }
+
+  private:
+    Pointer data_;
+    Mapping mapping_;
+    std::size_t position_;
+};
+
+
+} // end detail
+} // end experimental
+} // end agency
+
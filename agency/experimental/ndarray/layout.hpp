@@ -0,0 +1,618 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/shape.hpp>
+#include <agency/detail/shape_cast.hpp>
+#include <agency/detail/index_lexicographical_rank.hpp>
+#include <agency/coordinate/lattice.hpp>
+#include <agency/coordinate/point.hpp>
+#include <cstddef>
+#include <type_traits>
+
+
+namespace agency
+{
+namespace experimental
+{
+
+
+// A layout is a policy describing how the elements of a multidimensional array are arranged in memory.
+// Each layout has a nested class template mapping<Shape>, which maps the index of an element
+// to its offset in storage. A mapping provides the following members:
+//
+//   shape()                 returns the shape of the array
+//   operator()(idx)         returns the offset of the element at idx
+//   required_span_size()    returns the number of elements of storage the array requires
+//   is_always_exhaustive()  is true when every offset in [0, required_span_size()) maps to an element
+//   index_of(offset, idx)   finds the index of the element at offset, and returns false when offset maps to no element
+//   stride(dimension)       returns the distance in storage between neighboring elements along dimension
+//
+// Layouts other than layout_right require a flat Shape, i.e. an integer or a tuple of integers.
+// Only layouts which have strides provide stride().
+
+
+namespace layout_detail
+{
+
+
+template<class Shape>
+using extents_t = point<std::size_t, agency::detail::index_size<Shape>::value>;
+
+
+template<class Shape>
+__AGENCY_ANNOTATION
+extents_t<Shape> extents(const Shape& shape)
+{
+  return agency::detail::shape_cast<extents_t<Shape>>(shape);
+}
+
+
+// returns the offset of idx in a row-major array of the given extents
+template<class Extents>
+__AGENCY_ANNOTATION
+std::size_t linearize_right(const Extents& idx, const Extents& extents)
+{
+  std::size_t result = 0;
+
+  for(std::size_t d = 0; d < extents.size(); ++d)
+  {
+    result = result * extents[d] + idx[d];
+  }
+
+  return result;
+}
+
+
+// returns the index of offset in a row-major array of the given extents
+template<class Extents>
+__AGENCY_ANNOTATION
+Extents delinearize_right(std::size_t offset, const Extents& extents)
+{
+  Extents result;
+
+  for(std::size_t d = extents.size(); d > 0; --d)
+  {
+    result[d-1] = offset % extents[d-1];
+    offset /= extents[d-1];
+  }
+
+  return result;
+}
+
+
+template<class Extents>
+__AGENCY_ANNOTATION
+bool is_in_bounds(const Extents& idx, const Extents& extents)
+{
+  for(std::size_t d = 0; d < extents.size(); ++d)
+  {
+    if(idx[d] >= extents[d]) return false;
+  }
+
+  return true;
+}
+
+
+template<class Extents>
+__AGENCY_ANNOTATION
+std::size_t product(const Extents& extents)
+{
+  std::size_t result = 1;
+
+  for(std::size_t d = 0; d < extents.size(); ++d)
+  {
+    result *= extents[d];
+  }
+
+  return result;
+}
+
+
+} // end layout_detail
+
+
+/// layout_right arranges elements in row-major order, i.e. the lexicographic order of their indices.
+/// The last dimension varies fastest. This is the default layout of basic_ndarray and basic_ndarray_ref.
+struct layout_right
+{
+  template<class Shape>
+  class mapping
+  {
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      mapping() : mapping(shape_type{}) {}
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape) : shape_(shape) {}
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return shape_;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      std::size_t operator()(const Index& idx) const
+      {
+        return agency::detail::index_lexicographical_rank(idx, shape_);
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t required_span_size() const
+      {
+        return agency::detail::index_space_size(shape_);
+      }
+
+      __AGENCY_ANNOTATION
+      static constexpr bool is_always_exhaustive()
+      {
+        return true;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t offset, Index& idx) const
+      {
+        idx = agency::detail::shape_cast<Index>(layout_detail::delinearize_right(offset, layout_detail::extents(shape_)));
+        return offset < required_span_size();
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t stride(std::size_t dimension) const
+      {
+        auto e = layout_detail::extents(shape_);
+
+        std::size_t result = 1;
+        for(std::size_t d = dimension + 1; d < e.size(); ++d)
+        {
+          result *= e[d];
+        }
+
+        return result;
+      }
+
+    private:
+      shape_type shape_;
+  };
+};
+
+
+/// layout_left arranges elements in column-major order. The first dimension varies fastest.
+struct layout_left
+{
+  template<class Shape>
+  class mapping
+  {
+    private:
+      using extents_type = layout_detail::extents_t<Shape>;
+
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      mapping() : mapping(shape_type{}) {}
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape) : shape_(shape) {}
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return shape_;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      std::size_t operator()(const Index& idx) const
+      {
+        extents_type i = layout_detail::extents(idx);
+        extents_type e = layout_detail::extents(shape_);
+
+        std::size_t result = 0;
+        for(std::size_t d = e.size(); d > 0; --d)
+        {
+          result = result * e[d-1] + i[d-1];
+        }
+
+        return result;
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t required_span_size() const
+      {
+        return agency::detail::index_space_size(shape_);
+      }
+
+      __AGENCY_ANNOTATION
+      static constexpr bool is_always_exhaustive()
+      {
+        return true;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t offset, Index& idx) const
+      {
+        extents_type e = layout_detail::extents(shape_);
+        extents_type result;
+
+        std::size_t remainder = offset;
+        for(std::size_t d = 0; d < e.size(); ++d)
+        {
+          result[d] = remainder % e[d];
+          remainder /= e[d];
+        }
+
+        idx = agency::detail::shape_cast<Index>(result);
+        return offset < required_span_size();
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t stride(std::size_t dimension) const
+      {
+        extents_type e = layout_detail::extents(shape_);
+
+        std::size_t result = 1;
+        for(std::size_t d = 0; d < dimension; ++d)
+        {
+          result *= e[d];
+        }
+
+        return result;
+      }
+
+    private:
+      shape_type shape_;
+  };
+};
+
+
+/// layout_stride arranges elements at arbitrary strides along each dimension.
+/// Subarrays of arrays with strided layouts have layout_stride.
+struct layout_stride
+{
+  template<class Shape>
+  class mapping
+  {
+    public:
+      using shape_type = Shape;
+      using strides_type = layout_detail::extents_t<Shape>;
+
+      __AGENCY_ANNOTATION
+      mapping() : mapping(shape_type{}) {}
+
+      /// Creates a mapping whose strides are those of layout_right.
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape)
+        : mapping(layout_right::mapping<Shape>(shape))
+      {}
+
+      __AGENCY_ANNOTATION
+      mapping(const shape_type& shape, const strides_type& strides)
+        : shape_(shape), strides_(strides)
+      {}
+
+      /// Creates a mapping with the same shape and strides as another mapping which provides stride().
+      template<class OtherMapping,
+               class = decltype(std::declval<const OtherMapping&>().stride(0))
+              >
+      __AGENCY_ANNOTATION
+      explicit mapping(const OtherMapping& other)
+        : shape_(other.shape())
+      {
+        for(std::size_t d = 0; d < strides_.size(); ++d)
+        {
+          strides_[d] = other.stride(d);
+        }
+      }
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return shape_;
+      }
+
+      __AGENCY_ANNOTATION
+      strides_type strides() const
+      {
+        return strides_;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      std::size_t operator()(const Index& idx) const
+      {
+        strides_type i = layout_detail::extents(idx);
+
+        std::size_t result = 0;
+        for(std::size_t d = 0; d < i.size(); ++d)
+        {
+          result += i[d] * strides_[d];
+        }
+
+        return result;
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t required_span_size() const
+      {
+        strides_type e = layout_detail::extents(shape_);
+
+        if(layout_detail::product(e) == 0) return 0;
+
+        // the span reaches one past the element with the greatest index
+        std::size_t result = 1;
+        for(std::size_t d = 0; d < e.size(); ++d)
+        {
+          result += (e[d] - 1) * strides_[d];
+        }
+
+        return result;
+      }
+
+      __AGENCY_ANNOTATION
+      static constexpr bool is_always_exhaustive()
+      {
+        return false;
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t stride(std::size_t dimension) const
+      {
+        return strides_[dimension];
+      }
+
+    private:
+      shape_type shape_;
+      strides_type strides_;
+  };
+};
+
+
+/// layout_blocked arranges elements in tiles whose extents are given by TileExtents.
+/// The tiles are arranged in row-major order, and each tile's elements are arranged in row-major order.
+/// When a dimension of the array is not a multiple of the corresponding tile extent, the array's
+/// storage is padded to a whole number of tiles.
+template<std::size_t... TileExtents>
+struct layout_blocked
+{
+  template<class Shape>
+  class mapping
+  {
+    private:
+      using extents_type = layout_detail::extents_t<Shape>;
+
+      static_assert(sizeof...(TileExtents) == agency::detail::index_size<Shape>::value, "The number of tile extents must equal the rank of Shape.");
+
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      mapping() : mapping(shape_type{}) {}
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape)
+        : shape_(shape)
+      {
+        extents_type e = layout_detail::extents(shape_);
+        extents_type t = tile_extents();
+
+        for(std::size_t d = 0; d < e.size(); ++d)
+        {
+          num_tiles_[d] = (e[d] + t[d] - 1) / t[d];
+        }
+      }
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return shape_;
+      }
+
+      __AGENCY_ANNOTATION
+      static extents_type tile_extents()
+      {
+        return extents_type{TileExtents...};
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      std::size_t operator()(const Index& idx) const
+      {
+        extents_type i = layout_detail::extents(idx);
+        extents_type t = tile_extents();
+
+        extents_type tile, element;
+        for(std::size_t d = 0; d < i.size(); ++d)
+        {
+          tile[d] = i[d] / t[d];
+          element[d] = i[d] % t[d];
+        }
+
+        return layout_detail::linearize_right(tile, num_tiles_) * tile_size() + layout_detail::linearize_right(element, t);
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t required_span_size() const
+      {
+        return layout_detail::product(num_tiles_) * tile_size();
+      }
+
+      __AGENCY_ANNOTATION
+      static constexpr bool is_always_exhaustive()
+      {
+        return false;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t offset, Index& idx) const
+      {
+        extents_type t = tile_extents();
+        extents_type tile = layout_detail::delinearize_right(offset / tile_size(), num_tiles_);
+        extents_type element = layout_detail::delinearize_right(offset % tile_size(), t);
+
+        extents_type result;
+        for(std::size_t d = 0; d < result.size(); ++d)
+        {
+          result[d] = tile[d] * t[d] + element[d];
+        }
+
+        idx = agency::detail::shape_cast<Index>(result);
+
+        // offsets in the padding of partial tiles map to no element
+        return offset < required_span_size() && layout_detail::is_in_bounds(result, layout_detail::extents(shape_));
+      }
+
+    private:
+      __AGENCY_ANNOTATION
+      static std::size_t tile_size()
+      {
+        return layout_detail::product(tile_extents());
+      }
+
+      shape_type shape_;
+      extents_type num_tiles_;
+  };
+};
+
+
+/// layout_morton arranges elements in Z-order, i.e. in the order of their Morton codes.
+/// An element's Morton code interleaves the bits of its index, with the last dimension in the least significant position.
+/// A dimension stops participating once its own bits are exhausted, so the high bits of the longer dimensions follow uninterleaved.
+/// Z-order keeps neighboring elements close in storage along every dimension.
+/// When the array's extents are not powers of two, the array's storage includes gaps,
+/// but it is never larger than the product of the extents rounded up to powers of two.
+struct layout_morton
+{
+  template<class Shape>
+  class mapping
+  {
+    private:
+      using extents_type = layout_detail::extents_t<Shape>;
+
+      static constexpr std::size_t rank = agency::detail::index_size<Shape>::value;
+
+    public:
+      using shape_type = Shape;
+
+      __AGENCY_ANNOTATION
+      mapping() : mapping(shape_type{}) {}
+
+      __AGENCY_ANNOTATION
+      explicit mapping(const shape_type& shape)
+        : shape_(shape), num_bits_(0), span_(0)
+      {
+        extents_type e = layout_detail::extents(shape_);
+
+        // find the number of bits required by each dimension's largest coordinate
+        for(std::size_t d = 0; d < rank; ++d)
+        {
+          bits_[d] = 0;
+          while(e[d] > 1 && ((e[d] - 1) >> bits_[d]) != 0)
+          {
+            ++bits_[d];
+          }
+
+          num_bits_ = bits_[d] > num_bits_ ? bits_[d] : num_bits_;
+        }
+
+        if(layout_detail::product(e) > 0)
+        {
+          // Morton codes increase along each dimension, so the element with the greatest index has the greatest code
+          extents_type last;
+          for(std::size_t d = 0; d < rank; ++d)
+          {
+            last[d] = e[d] - 1;
+          }
+
+          span_ = operator()(last) + 1;
+        }
+      }
+
+      __AGENCY_ANNOTATION
+      shape_type shape() const
+      {
+        return shape_;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      std::size_t operator()(const Index& idx) const
+      {
+        extents_type i = layout_detail::extents(idx);
+
+        std::size_t result = 0;
+        std::size_t position = 0;
+        for(std::size_t bit = 0; bit < num_bits_; ++bit)
+        {
+          for(std::size_t d = rank; d-- > 0;)
+          {
+            if(bit < bits_[d])
+            {
+              result |= ((i[d] >> bit) & 1) << position;
+              ++position;
+            }
+          }
+        }
+
+        return result;
+      }
+
+      __AGENCY_ANNOTATION
+      std::size_t required_span_size() const
+      {
+        return span_;
+      }
+
+      __AGENCY_ANNOTATION
+      static constexpr bool is_always_exhaustive()
+      {
+        return false;
+      }
+
+      template<class Index>
+      __AGENCY_ANNOTATION
+      bool index_of(std::size_t offset, Index& idx) const
+      {
+        extents_type result;
+        for(std::size_t d = 0; d < rank; ++d)
+        {
+          result[d] = 0;
+        }
+
+        std::size_t position = 0;
+        for(std::size_t bit = 0; bit < num_bits_; ++bit)
+        {
+          for(std::size_t d = rank; d-- > 0;)
+          {
+            if(bit < bits_[d])
+            {
+              result[d] |= ((offset >> position) & 1) << bit;
+              ++position;
+            }
+          }
+        }
+
+        idx = agency::detail::shape_cast<Index>(result);
+
+        // offsets in the gaps of the Z-order curve map to no element
+        return offset < span_ && layout_detail::is_in_bounds(result, layout_detail::extents(shape_));
+      }
+
+    private:
+      shape_type shape_;
+      extents_type bits_;
+      std::size_t num_bits_;
+      std::size_t span_;
+  };
+};
+
+
+} // end experimental
+} // end agency
+
@@ -4,7 +4,10 @@
 #include <agency/detail/requires.hpp>
 #include <agency/detail/default_shape.hpp>
 #include <agency/experimental/ndarray/ndarray_ref.hpp>
+#include <agency/experimental/ndarray/layout.hpp>
+#include <agency/experimental/ndarray/detail/construct_in_storage_order.hpp>
 #include <agency/memory/allocator/allocator.hpp>
+#include <agency/memory/detail/storage.hpp>
 #include <agency/detail/iterator/constant_iterator.hpp>
 #include <agency/execution/execution_policy/detail/simple_sequenced_policy.hpp>
 #include <agency/detail/algorithm/construct_n.hpp>
@@ -24,11 +27,14 @@ namespace experimental
 {
 
 
-template<class T, class Shape = size_t, class Alloc = agency::allocator<T>, class Index = Shape>
+// basic_ndarray is a container of a multidimensional array of elements.
+// The arrangement of the array elements in memory is given by Layout. By default, the layout is row-major.
+// When the layout is not row-major, basic_ndarray constructs its elements in the order that they are arranged in memory.
+template<class T, class Shape = size_t, class Alloc = agency::allocator<T>, class Index = Shape, class Layout = layout_right>
 class basic_ndarray
 {
   private:
-    using storage_type = agency::detail::storage<T,Alloc,Shape>;
+    using storage_type = agency::detail::storage<T,Alloc>;
 
   public:
     using value_type = T;
@@ -37,11 +43,13 @@ class basic_ndarray
     using pointer = typename std::allocator_traits<allocator_type>::pointer;
     using const_pointer = typename std::allocator_traits<allocator_type>::const_pointer;
 
-    using shape_type = typename storage_type::shape_type;
+    using shape_type = Shape;
     using index_type = Index;
+    using layout_type = Layout;
+    using mapping_type = typename layout_type::template mapping<shape_type>;
 
-    using iterator = pointer;
-    using const_iterator = const_pointer;
+    using iterator = typename basic_ndarray_ref<pointer,shape_type,index_type,layout_type>::iterator;
+    using const_iterator = typename basic_ndarray_ref<const_pointer,shape_type,index_type,layout_type>::iterator;
 
     using reference = typename std::iterator_traits<iterator>::reference;
     using const_reference = typename std::iterator_traits<const_iterator>::reference;
@@ -55,7 +63,8 @@ class basic_ndarray
     template<class... Args, __AGENCY_REQUIRES(std::is_constructible<T, const Args&...>::value)>
     __AGENCY_ANNOTATION
     basic_ndarray(const shape_type& shape, const allocator_type& alloc, const Args&... constructor_args)
-      : storage_(shape, alloc)
+      : storage_(mapping_type(shape).required_span_size(), alloc),
+        mapping_(shape)
     {
       construct_elements_from_arrays(constant_ndarray<Args,Shape>(shape, constructor_args)...);
     }
@@ -71,7 +80,8 @@ class basic_ndarray
     __agency_exec_check_disable__
     __AGENCY_ANNOTATION
     explicit basic_ndarray(const shape_type& shape, const allocator_type& alloc = allocator_type())
-      : storage_(shape, alloc)
+      : storage_(mapping_type(shape).required_span_size(), alloc),
+        mapping_(shape)
     {
       construct_elements_from_arrays();
     }
@@ -85,13 +95,14 @@ class basic_ndarray
     __agency_exec_check_disable__
     template<class ArrayView,
              __AGENCY_REQUIRES(
-               std::is_constructible<
-                 storage_type, decltype(std::declval<ArrayView>().shape()), allocator_type
+               std::is_convertible<
+                 decltype(std::declval<ArrayView>().shape()), shape_type
                >::value
              )>
     __AGENCY_ANNOTATION
     explicit basic_ndarray(const ArrayView& array, const allocator_type& alloc = allocator_type())
-      : storage_(array.shape(), alloc)
+      : storage_(mapping_type(array.shape()).required_span_size(), alloc),
+        mapping_(array.shape())
     {
       construct_elements_from_arrays(array);
     }
@@ -106,7 +117,8 @@ class basic_ndarray
                std::is_convertible<typename std::iterator_traits<Iterator>::value_type, value_type>::value
              )>
     basic_ndarray(ExecutionPolicy&& policy, Iterator first, shape_type shape, const allocator_type& alloc = allocator_type())
-      : storage_(shape, alloc)
+      : storage_(mapping_type(shape).required_span_size(), alloc),
+        mapping_(shape)
     {
       construct_elements(std::forward<ExecutionPolicy>(policy), first);
     }
@@ -138,7 +150,8 @@ class basic_ndarray
              )>
     __AGENCY_ANNOTATION
     basic_ndarray(ExecutionPolicy&& policy, const basic_ndarray& other)
-      : storage_(other.shape(), other.get_allocator())
+      : storage_(other.mapping_.required_span_size(), other.get_allocator()),
+        mapping_(other.mapping_)
     {
       construct_elements_from_arrays(std::forward<ExecutionPolicy>(policy), other.all());
     }
@@ -146,7 +159,8 @@ class basic_ndarray
     __agency_exec_check_disable__
     __AGENCY_ANNOTATION
     basic_ndarray(const basic_ndarray& other)
-      : storage_(other.shape(), other.get_allocator())
+      : storage_(other.mapping_.required_span_size(), other.get_allocator()),
+        mapping_(other.mapping_)
     {
       construct_elements_from_arrays(other.all());
     }
@@ -154,7 +168,8 @@ class basic_ndarray
     __agency_exec_check_disable__
     __AGENCY_ANNOTATION
     basic_ndarray(basic_ndarray&& other)
-      : storage_{}
+      : storage_{},
+        mapping_{}
     {
       swap(other);
     }
@@ -186,6 +201,7 @@ class basic_ndarray
     void swap(basic_ndarray& other)
     {
       storage_.swap(other.storage_);
+      agency::detail::adl_swap(mapping_, other.mapping_);
     }
 
 
@@ -211,13 +227,19 @@ class basic_ndarray
     __AGENCY_ANNOTATION
     shape_type shape() const
     {
-      return storage_.shape();
+      return mapping_.shape();
+    }
+
+    __AGENCY_ANNOTATION
+    mapping_type mapping() const
+    {
+      return mapping_;
     }
 
     __AGENCY_ANNOTATION
     std::size_t size() const
     {
-      return storage_.size();
+      return agency::detail::index_space_size(shape());
     }
 
     __AGENCY_ANNOTATION
@@ -233,21 +255,21 @@ class basic_ndarray
     }
 
     __AGENCY_ANNOTATION
-    basic_ndarray_ref<const_pointer,shape_type,index_type> all() const
+    basic_ndarray_ref<const_pointer,shape_type,index_type,layout_type> all() const
     {
-      return basic_ndarray_ref<const_pointer,shape_type,index_type>(data(), shape());
+      return basic_ndarray_ref<const_pointer,shape_type,index_type,layout_type>(data(), mapping_);
     }
 
     __AGENCY_ANNOTATION
-    basic_ndarray_ref<pointer,shape_type,index_type> all()
+    basic_ndarray_ref<pointer,shape_type,index_type,layout_type> all()
     {
-      return basic_ndarray_ref<pointer,shape_type,index_type>(data(), shape());
+      return basic_ndarray_ref<pointer,shape_type,index_type,layout_type>(data(), mapping_);
     }
 
     __AGENCY_ANNOTATION
     iterator begin()
     {
-      return all().data();
+      return all().begin();
     }
 
     __AGENCY_ANNOTATION
@@ -288,6 +310,7 @@ class basic_ndarray
 
       // reset the storage to empty
       storage_ = storage_type(std::move(storage_.allocator()));
+      mapping_ = mapping_type();
     }
 
     __agency_exec_check_disable__
@@ -314,6 +337,8 @@ class basic_ndarray
     }
 
   private:
+    using layout_is_row_major = std::is_same<layout_type, layout_right>;
+
     template<class ExecutionPolicy, class... Iterators,
              __AGENCY_REQUIRES(
                is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value
@@ -321,9 +346,26 @@ class basic_ndarray
     __AGENCY_ANNOTATION
     void construct_elements(ExecutionPolicy&& policy, Iterators... iters)
     {
+      construct_elements_impl(layout_is_row_major(), std::forward<ExecutionPolicy>(policy), iters...);
+    }
+
+    template<class ExecutionPolicy, class... Iterators>
+    __AGENCY_ANNOTATION
+    void construct_elements_impl(std::true_type, ExecutionPolicy&& policy, Iterators... iters)
+    {
+      // storage order and index order coincide, so the iterators may be traversed linearly
       agency::detail::construct_n(std::forward<ExecutionPolicy>(policy), storage_.allocator(), begin(), size(), iters...);
     }
 
+    template<class ExecutionPolicy, class... Iterators>
+    __AGENCY_ANNOTATION
+    void construct_elements_impl(std::false_type, ExecutionPolicy&& policy, Iterators... iters)
+    {
+      // walk storage in order and index each iterator as a row-major array
+      // XXX this requires random access iterators
+      detail::construct_in_storage_order<index_type>(storage_.allocator(), std::forward<ExecutionPolicy>(policy), data(), mapping_, detail::make_iterator_array(iters, shape())...);
+    }
+
     template<class... Iterators>
     __AGENCY_ANNOTATION
     void construct_elements(Iterators... iters)
@@ -339,18 +381,49 @@ class basic_ndarray
              )>
     __AGENCY_ANNOTATION
     void construct_elements_from_arrays(ExecutionPolicy&& policy, const ArrayViews&... arrays)
+    {
+      construct_elements_from_arrays_impl(layout_is_row_major(), std::forward<ExecutionPolicy>(policy), arrays...);
+    }
+
+    template<class ExecutionPolicy, class... ArrayViews>
+    __AGENCY_ANNOTATION
+    void construct_elements_from_arrays_impl(std::true_type, ExecutionPolicy&& policy, const ArrayViews&... arrays)
     {
       agency::detail::bulk_construct(storage_.allocator(), std::forward<ExecutionPolicy>(policy), all(), arrays...);
     }
 
+    template<class ExecutionPolicy, class... ArrayViews>
+    __AGENCY_ANNOTATION
+    void construct_elements_from_arrays_impl(std::false_type, ExecutionPolicy&& policy, const ArrayViews&... arrays)
+    {
+      // visit the elements in the order that the layout arranges them in memory
+      detail::construct_in_storage_order<index_type>(storage_.allocator(), std::forward<ExecutionPolicy>(policy), data(), mapping_, arrays...);
+    }
+
     template<class... ArrayViews>
     __AGENCY_ANNOTATION
     void construct_elements_from_arrays(const ArrayViews&... arrays)
+    {
+      construct_elements_from_arrays_sequentially(layout_is_row_major(), arrays...);
+    }
+
+    template<class... ArrayViews>
+    __AGENCY_ANNOTATION
+    void construct_elements_from_arrays_sequentially(std::true_type, const ArrayViews&... arrays)
     {
       agency::detail::bulk_construct(storage_.allocator(), all(), arrays...);
     }
 
+    template<class... ArrayViews>
+    __AGENCY_ANNOTATION
+    void construct_elements_from_arrays_sequentially(std::false_type, const ArrayViews&... arrays)
+    {
+      // visit the elements in the order that the layout arranges them in memory
+      detail::construct_in_storage_order<index_type>(storage_.allocator(), data(), mapping_, arrays...);
+    }
+
     storage_type storage_;
+    mapping_type mapping_;
 };
 
 
@@ -6,6 +6,8 @@
 #include <agency/detail/index_lexicographical_rank.hpp>
 #include <agency/coordinate/detail/shape/shape_size.hpp>
 #include <agency/coordinate.hpp>
+#include <agency/experimental/ndarray/layout.hpp>
+#include <agency/experimental/ndarray/detail/layout_iterator.hpp>
 #include <cstddef>
 #include <tuple>
 #include <memory>
@@ -18,7 +20,8 @@ namespace experimental
 
 
 // basic_ndarray_ref is a mutable view of a multidimensional array of elements.
-// The layout of the array elements is in row-major, i.e. the lexicographic order of their multidimensional indices.
+// The arrangement of the array elements in memory is given by Layout. By default, the layout is row-major,
+// i.e. the lexicographic order of their multidimensional indices. See layout.hpp for the other layouts.
 //
 // The dimensionality of the array is given by Shape, which is a generalized shape type.
 // A type is an Shape if
@@ -30,7 +33,7 @@ namespace experimental
 //     the type of their index and the type of the shape of their group
 //     Consistency is important here, but we ought to consider whether it's actually important for agents
 //     to make this distinction
-template<class Pointer, class Shape, class Index = Shape>
+template<class Pointer, class Shape, class Index = Shape, class Layout = layout_right>
 class basic_ndarray_ref
 {
   static_assert(agency::detail::index_size<Shape>::value == agency::detail::index_size<Index>::value, "Shape rank must equal Index rank.");
@@ -42,32 +45,48 @@ class basic_ndarray_ref
     using size_type = decltype(agency::detail::index_space_size(std::declval<shape_type>()));
     using pointer = Pointer;
     using reference = typename std::iterator_traits<pointer>::reference;
+    using layout_type = Layout;
+    using mapping_type = typename layout_type::template mapping<shape_type>;
 
     // this iterator traverses in row-major order
-    using iterator = pointer;
+    // when the layout is also row-major, the iterator is simply a pointer
+    using iterator = typename std::conditional<
+      std::is_same<layout_type, layout_right>::value,
+      pointer,
+      detail::layout_iterator<pointer, mapping_type, index_type>
+    >::type;
 
     __AGENCY_ANNOTATION
     basic_ndarray_ref() : basic_ndarray_ref(nullptr) {}
 
     basic_ndarray_ref(const basic_ndarray_ref&) = default;
 
+    // views of the same layout convert to one another, and views of layouts with strides convert to layout_stride
     template<class OtherPointer,
              class OtherShape,
              class OtherIndex,
+             class OtherLayout,
              __AGENCY_REQUIRES(std::is_convertible<OtherPointer,pointer>::value),
              __AGENCY_REQUIRES(std::is_convertible<OtherShape,shape_type>::value),
-             __AGENCY_REQUIRES(agency::detail::shape_size<shape_type>::value == agency::detail::shape_size<OtherShape>::value)
+             __AGENCY_REQUIRES(agency::detail::shape_size<shape_type>::value == agency::detail::shape_size<OtherShape>::value),
+             __AGENCY_REQUIRES(
+               std::is_same<OtherLayout,layout_type>::value ||
+               std::is_constructible<mapping_type, const typename OtherLayout::template mapping<OtherShape>&>::value
+             )
             >
     __AGENCY_ANNOTATION
-    basic_ndarray_ref(const basic_ndarray_ref<OtherPointer,OtherShape,OtherIndex>& other)
-      : basic_ndarray_ref(other.data(), other.shape())
+    basic_ndarray_ref(const basic_ndarray_ref<OtherPointer,OtherShape,OtherIndex,OtherLayout>& other)
+      : basic_ndarray_ref(other.data(), convert_mapping(other.mapping()))
     {}
 
     __AGENCY_ANNOTATION
     explicit basic_ndarray_ref(std::nullptr_t) : basic_ndarray_ref(nullptr, shape_type{}) {}
 
     __AGENCY_ANNOTATION
-    basic_ndarray_ref(pointer ptr, shape_type shape) : data_(ptr), shape_(shape) {}
+    basic_ndarray_ref(pointer ptr, shape_type shape) : basic_ndarray_ref(ptr, mapping_type(shape)) {}
+
+    __AGENCY_ANNOTATION
+    basic_ndarray_ref(pointer ptr, const mapping_type& mapping) : data_(ptr), mapping_(mapping) {}
 
     __AGENCY_ANNOTATION
     constexpr std::size_t rank() const
@@ -80,7 +99,24 @@ class basic_ndarray_ref
     __AGENCY_ANNOTATION
     shape_type shape() const
     {
-      return shape_;
+      return mapping_.shape();
+    }
+
+    /// \brief Returns the mapping from indices to offsets in memory.
+    /// \return The layout mapping of this `basic_ndarray_ref`.
+    __AGENCY_ANNOTATION
+    mapping_type mapping() const
+    {
+      return mapping_;
+    }
+
+    /// \brief Returns the distance in memory between neighboring elements along the dimension of interest.
+    /// \note Only layouts with strides provide `stride()`.
+    /// \return `mapping().stride(dimension)`
+    __AGENCY_ANNOTATION
+    size_type stride(const size_type& dimension) const
+    {
+      return mapping_.stride(dimension);
     }
 
     /// \brief Returns the total number of elements.
@@ -110,14 +146,26 @@ class basic_ndarray_ref
     __AGENCY_ANNOTATION
     reference operator[](const index_type& idx) const
     {
-      auto rank = agency::detail::index_lexicographical_rank(idx, shape());
-      return data_[rank];
+      return data_[mapping_(idx)];
+    }
+
+    /// \brief Returns a view of a rectangular region of this `basic_ndarray_ref` without copying its elements.
+    /// \param origin The index of the first element of the region.
+    /// \param shape The shape of the region.
+    /// \note Only layouts with strides provide `subarray()`.
+    /// \return A view whose element at `idx` is the element of this `basic_ndarray_ref` at `origin + idx`.
+    __AGENCY_ANNOTATION
+    basic_ndarray_ref<pointer,shape_type,index_type,layout_stride> subarray(const index_type& origin, const shape_type& shape) const
+    {
+      using result_mapping_type = layout_stride::mapping<shape_type>;
+
+      return basic_ndarray_ref<pointer,shape_type,index_type,layout_stride>(data_ + mapping_(origin), result_mapping_type(shape, result_mapping_type(mapping_).strides()));
     }
 
     __AGENCY_ANNOTATION
     iterator begin() const
     {
-      return data_;
+      return make_iterator(std::is_same<iterator,pointer>());
     }
 
     __AGENCY_ANNOTATION
@@ -127,8 +175,38 @@ class basic_ndarray_ref
     }
 
   private:
+    __AGENCY_ANNOTATION
+    iterator make_iterator(std::true_type) const
+    {
+      return data_;
+    }
+
+    __AGENCY_ANNOTATION
+    iterator make_iterator(std::false_type) const
+    {
+      return iterator(data_, mapping_, 0);
+    }
+
+    template<class OtherMapping,
+             __AGENCY_REQUIRES(std::is_constructible<mapping_type, const OtherMapping&>::value)
+            >
+    __AGENCY_ANNOTATION
+    static mapping_type convert_mapping(const OtherMapping& other)
+    {
+      return mapping_type(other);
+    }
+
+    template<class OtherMapping,
+             __AGENCY_REQUIRES(!std::is_constructible<mapping_type, const OtherMapping&>::value)
+            >
+    __AGENCY_ANNOTATION
+    static mapping_type convert_mapping(const OtherMapping& other)
+    {
+      return mapping_type(other.shape());
+    }
+
     pointer data_;
-    shape_type shape_;
+    mapping_type mapping_;
 };
 
 
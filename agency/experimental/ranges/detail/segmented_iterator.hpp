@@ -0,0 +1,333 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/experimental/ranges/range_traits.hpp>
+#include <agency/experimental/ranges/all.hpp>
+#include <iterator>
+#include <type_traits>
+
+
+namespace agency
+{
+namespace experimental
+{
+namespace detail
+{
+
+
+// segmented_iterator traverses a range of segments as if it were a single range
+//
+// it tracks the current segment and its position within that segment, so dereference costs O(1)
+// and increment costs O(1) amortized, rather than a search through the segments for each element
+// advancing by n visits each segment in between
+//
+// Segments is a random access range of ranges which the iterator keeps a copy of, so Segments should be a view
+template<class Segments>
+class segmented_iterator
+{
+  public:
+    // the type of a view of a single segment
+    using segment_type = all_t<range_reference_t<const Segments>>;
+
+    // local_iterator traverses the elements of a single segment
+    using local_iterator = range_iterator_t<segment_type>;
+
+    using value_type = range_value_t<segment_type>;
+    using reference = range_reference_t<segment_type>;
+    using difference_type = range_difference_t<segment_type>;
+    using pointer = value_type*;
+    using iterator_category = std::random_access_iterator_tag;
+    using size_type = range_size_t<segment_type>;
+
+    segmented_iterator() = default;
+
+    segmented_iterator(const segmented_iterator&) = default;
+
+    // creates an iterator pointing to the element at position local_position of the given segment
+    // position is that element's position within the entire range of segments
+    __AGENCY_ANNOTATION
+    segmented_iterator(const Segments& segments, size_type segment, size_type local_position, size_type position)
+      : segments_(segments),
+        segment_(segment),
+        local_position_(local_position),
+        position_(position)
+    {
+      skip_finished_segments();
+    }
+
+    segmented_iterator& operator=(const segmented_iterator&) = default;
+
+    // dereference
+    __AGENCY_ANNOTATION
+    reference operator*() const
+    {
+      return segments_[segment_][local_position_];
+    }
+
+    // pre-increment
+    __AGENCY_ANNOTATION
+    segmented_iterator& operator++()
+    {
+      ++local_position_;
+      ++position_;
+      skip_finished_segments();
+      return *this;
+    }
+
+    // pre-decrement
+    __AGENCY_ANNOTATION
+    segmented_iterator& operator--()
+    {
+      // find the nearest preceding segment which is not empty
+      while(local_position_ == 0)
+      {
+        --segment_;
+        local_position_ = segment_size(segment_);
+      }
+
+      --local_position_;
+      --position_;
+      return *this;
+    }
+
+    // post-increment
+    __AGENCY_ANNOTATION
+    segmented_iterator operator++(int)
+    {
+      segmented_iterator result = *this;
+      ++(*this);
+      return result;
+    }
+
+    // post-decrement
+    __AGENCY_ANNOTATION
+    segmented_iterator operator--(int)
+    {
+      segmented_iterator result = *this;
+      --(*this);
+      return result;
+    }
+
+    // add-assign
+    __AGENCY_ANNOTATION
+    segmented_iterator& operator+=(difference_type n)
+    {
+      if(n < 0) return *this -= -n;
+
+      size_type remaining = n;
+      position_ += remaining;
+
+      // skip whole segments until the destination lies within the current segment
+      while(segment_ < num_segments() && remaining >= segment_size(segment_) - local_position_)
+      {
+        remaining -= segment_size(segment_) - local_position_;
+        ++segment_;
+        local_position_ = 0;
+      }
+
+      local_position_ += remaining;
+      return *this;
+    }
+
+    // minus-assign
+    __AGENCY_ANNOTATION
+    segmented_iterator& operator-=(difference_type n)
+    {
+      if(n < 0) return *this += -n;
+
+      size_type remaining = n;
+      position_ -= remaining;
+
+      // skip whole segments backward until the destination lies within the current segment
+      while(remaining > local_position_)
+      {
+        remaining -= local_position_;
+        --segment_;
+        local_position_ = segment_size(segment_);
+      }
+
+      local_position_ -= remaining;
+      return *this;
+    }
+
+    // add
+    __AGENCY_ANNOTATION
+    segmented_iterator operator+(difference_type n) const
+    {
+      segmented_iterator result = *this;
+      result += n;
+      return result;
+    }
+
+    // minus
+    __AGENCY_ANNOTATION
+    segmented_iterator operator-(difference_type n) const
+    {
+      segmented_iterator result = *this;
+      result -= n;
+      return result;
+    }
+
+    // bracket
+    __AGENCY_ANNOTATION
+    reference operator[](difference_type n) const
+    {
+      return *(*this + n);
+    }
+
+    // equal
+    __AGENCY_ANNOTATION
+    bool operator==(const segmented_iterator& rhs) const
+    {
+      // we assume that *this and rhs traverse the same segments,
+      // so we do not compare their segments_ members
+      return position_ == rhs.position_;
+    }
+
+    // not equal
+    __AGENCY_ANNOTATION
+    bool operator!=(const segmented_iterator& rhs) const
+    {
+      return !(*this == rhs);
+    }
+
+    // less
+    __AGENCY_ANNOTATION
+    bool operator<(const segmented_iterator& rhs) const
+    {
+      return position_ < rhs.position_;
+    }
+
+    // difference
+    __AGENCY_ANNOTATION
+    difference_type operator-(const segmented_iterator& rhs) const
+    {
+      return difference_type(position_) - difference_type(rhs.position_);
+    }
+
+    // the following functions allow algorithms to traverse a segmented_iterator's
+    // range one segment at a time, see for_each_segment() below
+
+    // returns the index of the segment this iterator points into
+    // an iterator at the end of its range points one past the last segment
+    __AGENCY_ANNOTATION
+    size_type segment_index() const
+    {
+      return segment_;
+    }
+
+    // returns the position of this iterator within its segment
+    __AGENCY_ANNOTATION
+    size_type segment_position() const
+    {
+      return local_position_;
+    }
+
+    // returns a view of the segment with the given index
+    __AGENCY_ANNOTATION
+    segment_type segment(size_type i) const
+    {
+      return agency::experimental::all(segments_[i]);
+    }
+
+    // returns an iterator pointing to this iterator's element within its segment
+    // requires: *this is dereferenceable
+    __AGENCY_ANNOTATION
+    local_iterator local() const
+    {
+      return segment(segment_).begin() + local_position_;
+    }
+
+  private:
+    __AGENCY_ANNOTATION
+    size_type num_segments() const
+    {
+      return segments_.size();
+    }
+
+    __AGENCY_ANNOTATION
+    size_type segment_size(size_type i) const
+    {
+      return segments_[i].size();
+    }
+
+    // maintains the invariant that a dereferenceable iterator points into a segment which is not finished,
+    // and that an iterator at the end of its range points one past the last segment
+    __AGENCY_ANNOTATION
+    void skip_finished_segments()
+    {
+      while(segment_ < num_segments() && local_position_ == segment_size(segment_))
+      {
+        ++segment_;
+        local_position_ = 0;
+      }
+    }
+
+    Segments segments_;
+    size_type segment_;
+    size_type local_position_;
+    size_type position_;
+};
+
+
+template<class Iterator>
+struct is_segmented_iterator : std::false_type {};
+
+template<class Segments>
+struct is_segmented_iterator<segmented_iterator<Segments>> : std::true_type {};
+
+
+// for_each_segment() calls f(local_first, local_last) for each segment's portion of the range [first, last)
+// so that algorithms may run a simple loop over the contiguous elements of each segment
+// rather than stepping a segmented_iterator one element at a time
+//
+// an iterator which is not segmented is treated as a single segment
+__agency_exec_check_disable__
+template<class Iterator, class Function>
+__AGENCY_ANNOTATION
+void for_each_segment(Iterator first, Iterator last, Function f)
+{
+  f(first, last);
+}
+
+
+__agency_exec_check_disable__
+template<class Segments, class Function>
+__AGENCY_ANNOTATION
+void for_each_segment(segmented_iterator<Segments> first, segmented_iterator<Segments> last, Function f)
+{
+  if(first == last) return;
+
+  if(first.segment_index() == last.segment_index())
+  {
+    // the range lies within a single segment
+    f(first.local(), last.local());
+    return;
+  }
+
+  // the range begins in the middle of its first segment
+  f(first.local(), first.segment(first.segment_index()).end());
+
+  for(auto i = first.segment_index() + 1; i < last.segment_index(); ++i)
+  {
+    auto segment = first.segment(i);
+
+    // skip empty segments
+    if(segment.size() > 0)
+    {
+      f(segment.begin(), segment.end());
+    }
+  }
+
+  // the range ends in the middle of its last segment, unless last is at the beginning of a segment or at the end of all segments
+  if(last.segment_position() > 0)
+  {
+    f(last.segment(last.segment_index()).begin(), last.local());
+  }
+}
+
+
+} // end detail
+} // end experimental
+} // end agency
+
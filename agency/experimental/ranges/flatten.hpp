@@ -4,6 +4,8 @@
 #include <agency/detail/requires.hpp>
 #include <agency/experimental/ranges/range_traits.hpp>
 #include <agency/experimental/ranges/all.hpp>
+#include <agency/experimental/ranges/detail/segmented_iterator.hpp>
+#include <agency/experimental/span.hpp>
 #include <type_traits>
 #include <utility>
 
@@ -14,10 +16,46 @@ namespace experimental
 {
 
 
+namespace detail
+{
+
+
+// returns a Container holding a table of the positions at which each segment of a flattened range of ranges begins
+// the table has an additional final entry holding the total number of elements
+template<class Container, class RangeOfRanges>
+Container make_segment_offsets(const RangeOfRanges& segments)
+{
+  using size_type = typename Container::value_type;
+
+  Container offsets;
+  offsets.reserve(segments.size() + 1);
+
+  size_type offset = 0;
+  offsets.push_back(offset);
+
+  for(auto& segment : segments)
+  {
+    offset += segment.size();
+    offsets.push_back(offset);
+  }
+
+  return offsets;
+}
+
+
+} // end detail
+
+
 // flatten_view does not assume the size of the segments are the same
-// operator[] and size() would have more efficient implementations if
-// we made that assumption
-// we should consider another kind of fancy range that would "un-tile" a collection of tiles
+//
+// a segmented container may keep a table of the position at which each segment begins
+// (see detail::make_segment_offsets()) and create its views with a span of that table, so that
+// size() costs O(1) and operator[] costs O(log S) for S segments
+// the table belongs to the container, so the container should outlive its views
+// without a table, size() and operator[] scan the segments, which costs O(S)
+//
+// iterators track their current segment, and algorithms may traverse them segment by segment
+// with detail::for_each_segment()
 template<class RangeOfRanges>
 class flatten_view
 {
@@ -33,6 +71,9 @@ class flatten_view
     using value_type = range_value_t<inner_range_type>;
     using reference = range_reference_t<inner_range_type>;
 
+    // a view of a table of segment positions
+    using offsets_type = span<const size_type>;
+
     flatten_view() = default;
     flatten_view(const flatten_view&) = default;
 
@@ -52,7 +93,24 @@ class flatten_view
             >
     __AGENCY_ANNOTATION
     flatten_view(OtherRangeOfRanges&& ranges)
-      : segments_(agency::experimental::all(std::forward<OtherRangeOfRanges>(ranges)))
+      : segments_(agency::experimental::all(std::forward<OtherRangeOfRanges>(ranges))),
+        offsets_()
+    {}
+
+    // creates a view of the given ranges using a table of segment positions computed by detail::make_segment_offsets()
+    // the table must outlive the view
+    template<class OtherRangeOfRanges,
+             __AGENCY_REQUIRES(
+               std::is_convertible<
+                 experimental::all_t<OtherRangeOfRanges>,
+                 segments_t
+               >::value
+             )
+            >
+    __AGENCY_ANNOTATION
+    flatten_view(OtherRangeOfRanges&& ranges, offsets_type offsets)
+      : segments_(agency::experimental::all(std::forward<OtherRangeOfRanges>(ranges))),
+        offsets_(offsets)
     {}
 
     // converting copy constructor
@@ -62,193 +120,109 @@ class flatten_view
                  segments_t,
                  typename flatten_view<OtherRangeOfRanges>::segments_t
                >::value
+             ),
+             __AGENCY_REQUIRES(
+               std::is_same<
+                 size_type,
+                 typename flatten_view<OtherRangeOfRanges>::size_type
+               >::value
              )>
     __AGENCY_ANNOTATION
     flatten_view(const flatten_view<OtherRangeOfRanges>& other)
-      : segments_(other.segments_)
+      : segments_(other.segments_),
+        offsets_(other.offsets_)
     {}
 
   private:
     __AGENCY_ANNOTATION
-    reference bracket_operator(size_type element_idx, size_t current_segment_idx) const
+    bool has_offsets() const
     {
-      auto& segment = segments_[current_segment_idx];
-      auto size = segment.size();
-
-      // if the element is within the current segment, return it
-      // otherwise, recurse
-      // note that attempting to index an element that lies beyond the end of this view
-      // will not terminate the recursion
-      return element_idx < size ?
-        segment[element_idx] :
-        bracket_operator(element_idx - size, current_segment_idx + 1);
+      return offsets_.size() > 0;
     }
 
-  public:
+    // returns the index of the segment containing the element at position i
+    // binary search the table for the last segment which begins at or before i
+    // an empty segment begins where its successor does, so the segment found is never empty
+    // note that attempting to find an element that lies beyond the end of this view
+    // will return the last segment
     __AGENCY_ANNOTATION
-    reference operator[](size_type i) const
+    size_type find_segment(size_type i) const
     {
-      // seems like we have to do a linear search through the segments
-      // so, it't not clear this can be computed in O(1)
-      // OTOH, it's not O(N) either (N being the total number of elements viewed by this view)
-      return bracket_operator(i, 0);
-    }
+      size_type first = 0;
+      size_type last = offsets_.size() - 1;
 
-    __AGENCY_ANNOTATION
-    size_type size() const
-    {
-      size_type result = 0;
-      for(auto& segment : segments_)
+      while(last - first > 1)
       {
-        result += segment.size();
-      }
-
-      return result;
-    }
-
-    class iterator
-    {
-      public:
-        using value_type = typename flatten_view::value_type;
-        using reference = typename flatten_view::reference;
-        using difference_type = typename flatten_view::difference_type;
-        using pointer = value_type*;
-        using iterator_category = std::random_access_iterator_tag;
-
-        // dereference
-        __AGENCY_ANNOTATION
-        reference operator*() const
-        {
-          return self_[current_position_];
-        }
-
-        // pre-increment
-        __AGENCY_ANNOTATION
-        iterator operator++()
-        {
-          ++current_position_;
-          return *this;
-        }
+        size_type middle = first + (last - first) / 2;
 
-        // pre-decrement
-        __AGENCY_ANNOTATION
-        iterator operator--()
+        if(offsets_[middle] <= i)
         {
-          --current_position_;
-          return *this;
+          first = middle;
         }
-
-        // post-increment
-        __AGENCY_ANNOTATION
-        iterator operator++(int)
-        {
-          iterator result = *this;
-          current_position_++;
-          return result;
-        }
-
-        // post-decrement
-        __AGENCY_ANNOTATION
-        iterator operator--(int)
-        {
-          iterator result = *this;
-          current_position_--;
-          return result;
-        }
-
-        // add-assign
-        __AGENCY_ANNOTATION
-        iterator operator+=(size_type n)
+        else
         {
-          current_position_ += n;
-          return *this;
-        }
-
-        // minus-assign
-        __AGENCY_ANNOTATION
-        iterator operator-=(size_type n)
-        {
-          current_position_ -= n;
-          return *this;
+          last = middle;
         }
+      }
 
-        // add
-        __AGENCY_ANNOTATION
-        iterator operator+(size_type n)
-        {
-          iterator result = *this;
-          result += n;
-          return result;
-        }
+      return first;
+    }
 
-        // minus
-        __AGENCY_ANNOTATION
-        iterator operator-(size_type n)
-        {
-          iterator result = *this;
-          result -= n;
-          return result;
-        }
+  public:
+    __AGENCY_ANNOTATION
+    reference operator[](size_type i) const
+    {
+      if(has_offsets())
+      {
+        size_type segment = find_segment(i);
 
-        // bracket
-        __AGENCY_ANNOTATION
-        reference operator[](size_type n)
-        {
-          iterator tmp = *this + n;
-          return *tmp;
-        }
+        return segments_[segment][i - offsets_[segment]];
+      }
 
-        // equal
-        __AGENCY_ANNOTATION
-        bool operator==(const iterator& rhs) const
-        {
-          // we assume that *this and rhs came from the same flattened_view,
-          // so we do not compare their self_ members
-          return current_position_ == rhs.current_position_;
-        }
+      // without a table, walk the segments until we reach the one containing i
+      // note that attempting to index an element that lies beyond the end of this view
+      // will index past the end of the last segment
+      size_type segment = 0;
+      size_type last_segment = segments_.size() - 1;
 
-        // not equal
-        __AGENCY_ANNOTATION
-        bool operator!=(const iterator& rhs) const
-        {
-          return !(*this == rhs);
-        }
+      while(segment < last_segment && i >= static_cast<size_type>(segments_[segment].size()))
+      {
+        i -= segments_[segment].size();
+        ++segment;
+      }
 
-        // difference
-        __AGENCY_ANNOTATION
-        difference_type operator-(const iterator& rhs) const
-        {
-          return current_position_ - rhs.current_position_;
-        }
+      return segments_[segment][i];
+    }
 
-      private:
-        friend flatten_view;
+    __AGENCY_ANNOTATION
+    size_type size() const
+    {
+      if(has_offsets())
+      {
+        return offsets_[offsets_.size() - 1];
+      }
 
-        __AGENCY_ANNOTATION
-        iterator(size_type current_position, const flatten_view& self)
-          : current_position_(current_position),
-            self_(self)
-        {}
+      size_type result = 0;
+      for(auto& segment : segments_)
+      {
+        result += segment.size();
+      }
 
-        // XXX a more efficient implementation would track the current segment
-        // XXX and the current position within the segment
-        //     could keep an iterator to the current segment
-        //     would make operator- and operator+= less efficient because they would involve linear searches
-        size_type current_position_;
+      return result;
+    }
 
-        flatten_view self_;
-    };
+    using iterator = detail::segmented_iterator<segments_t>;
 
     __AGENCY_ANNOTATION
     iterator begin() const
     {
-      return iterator(0, *this);
+      return iterator(segments_, 0, 0, 0);
     }
 
     __AGENCY_ANNOTATION
     iterator end() const
     {
-      return iterator(size(), *this);
+      return iterator(segments_, segments_.size(), 0, size());
     }
 
     __AGENCY_ANNOTATION
@@ -259,6 +233,7 @@ class flatten_view
 
   private:
     segments_t segments_;
+    offsets_type offsets_;
 
   public:
     __AGENCY_ANNOTATION
@@ -273,6 +248,13 @@ class flatten_view
     {
       return segments_;
     }
+
+    // returns the table of segment positions, which is empty if this view was created without one
+    __AGENCY_ANNOTATION
+    offsets_type segment_offsets() const
+    {
+      return offsets_;
+    }
 };
 
 
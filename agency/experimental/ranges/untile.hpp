@@ -5,6 +5,7 @@
 #include <agency/experimental/ranges/range_traits.hpp>
 #include <agency/experimental/ranges/all.hpp>
 #include <agency/experimental/ranges/transformed.hpp>
+#include <agency/experimental/ranges/detail/segmented_iterator.hpp>
 #include <agency/experimental/short_vector.hpp>
 #include <type_traits>
 #include <utility>
@@ -95,153 +96,19 @@ class small_untiled_view
       return tile_size_ * (tiles_.size() - 1) + tiles_.back().size();
     }
 
-    // this iterator type is trivial:
-    // it just copies the view it came from (self_) and tracks its current position
-    // XXX might want to refactor this into detail::view_iterator or something because
-    //     it is repeated inside of flattened_view
-    class iterator
-    {
-      public:
-        using value_type = typename small_untiled_view::value_type;
-        using reference = typename small_untiled_view::reference;
-        using difference_type = typename small_untiled_view::difference_type;
-        using pointer = value_type*;
-        using iterator_category = std::random_access_iterator_tag;
-
-        // dereference
-        __AGENCY_ANNOTATION
-        reference operator*() const
-        {
-          return self_[current_position_];
-        }
-
-        // pre-increment
-        __AGENCY_ANNOTATION
-        iterator operator++()
-        {
-          ++current_position_;
-          return *this;
-        }
-
-        // pre-decrement
-        __AGENCY_ANNOTATION
-        iterator operator--()
-        {
-          --current_position_;
-          return *this;
-        }
-
-        // post-increment
-        __AGENCY_ANNOTATION
-        iterator operator++(int)
-        {
-          iterator result = *this;
-          current_position_++;
-          return result;
-        }
-
-        // post-decrement
-        __AGENCY_ANNOTATION
-        iterator operator--(int)
-        {
-          iterator result = *this;
-          current_position_--;
-          return result;
-        }
-
-        // add-assign
-        __AGENCY_ANNOTATION
-        iterator operator+=(size_type n)
-        {
-          current_position_ += n;
-          return *this;
-        }
-
-        // minus-assign
-        __AGENCY_ANNOTATION
-        iterator operator-=(size_type n)
-        {
-          current_position_ -= n;
-          return *this;
-        }
-
-        // add
-        __AGENCY_ANNOTATION
-        iterator operator+(size_type n)
-        {
-          iterator result = *this;
-          result += n;
-          return result;
-        }
-
-        // minus
-        __AGENCY_ANNOTATION
-        iterator operator-(size_type n)
-        {
-          iterator result = *this;
-          result -= n;
-          return result;
-        }
-
-        // bracket
-        __AGENCY_ANNOTATION
-        reference operator[](size_type n)
-        {
-          iterator tmp = *this + n;
-          return *tmp;
-        }
-
-        // equal
-        __AGENCY_ANNOTATION
-        bool operator==(const iterator& rhs) const
-        {
-          // we assume that *this and rhs came from the same flattened_view,
-          // so we do not compare their self_ members
-          return current_position_ == rhs.current_position_;
-        }
-
-        // not equal
-        __AGENCY_ANNOTATION
-        bool operator!=(const iterator& rhs) const
-        {
-          return !(*this == rhs);
-        }
-
-        // difference
-        __AGENCY_ANNOTATION
-        difference_type operator-(const iterator& rhs) const
-        {
-          return current_position_ - rhs.current_position_;
-        }
-
-      private:
-        friend small_untiled_view;
-
-        __AGENCY_ANNOTATION
-        iterator(size_type current_position, const small_untiled_view& self)
-          : current_position_(current_position),
-            self_(self)
-        {}
-
-        // XXX a more efficient implementation would track the current tile
-        // XXX and the current position within the tile
-        //     could keep an iterator to the current tile
-        //     would make operator- and operator+= less efficient because they would involve linear searches
-        size_type current_position_;
-
-        small_untiled_view self_;
-    };
+    // iterators track their current tile, so iterating over the view does not search for each element's tile
+    using iterator = detail::segmented_iterator<short_vector<tile_view_type,max_tile_count>>;
 
     __AGENCY_ANNOTATION
     iterator begin() const
     {
-      return iterator(0, *this);
+      return iterator(tiles_, 0, 0, 0);
     }
 
     __AGENCY_ANNOTATION
     iterator end() const
     {
-      return iterator(size(), *this);
+      return iterator(tiles_, tiles_.size(), 0, size());
     }
 
     __AGENCY_ANNOTATION
@@ -77,6 +77,8 @@ class segmented_array
           segments_.emplace_back(1, val, *alloc);
         }
       }
+
+      segment_offsets_ = detail::make_segment_offsets<offsets_container>(segments_);
     }
 
     // constructs a segmented_array with a single segment
@@ -92,19 +94,24 @@ class segmented_array
     using outer_container = vector<inner_container, outer_allocator_type>;
     outer_container segments_;
 
+    // the segments' positions are cached so that views of this array need not visit each segment
+    // they are stored alongside the segments so that views used in device code may read them
+    using offsets_container = vector<size_type, OuterAlloc<size_type>>;
+    offsets_container segment_offsets_;
+
   public:
     using all_t = flatten_view<outer_container>;
 
     all_t all()
     {
-      return flatten(segments_);
+      return all_t(segments_, typename all_t::offsets_type(segment_offsets_.data(), segment_offsets_.size()));
     }
 
     using const_all_t = flatten_view<const outer_container>;
 
     const_all_t all() const
     {
-      return flatten(segments_);
+      return const_all_t(segments_, typename const_all_t::offsets_type(segment_offsets_.data(), segment_offsets_.size()));
     }
 
     size_type size() const
@@ -173,6 +180,7 @@ class segmented_array
     void clear()
     {
       segments_.clear();
+      segment_offsets_.clear();
     }
 
     bool operator==(const segmented_array& rhs) const
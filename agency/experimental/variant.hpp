@@ -372,14 +372,36 @@ class variant : private detail::variant_detail::variant_storage<Types...>
       void operator()(Args&&...) const {}
     };
 
+    // variant's copy and move operations exist only when each alternative supports them
+    //
+    // these operations cannot be constrained templates, because a template is never a copy or move constructor
+    // or assignment operator, and the implicitly-declared ones would copy the storage bitwise.
+    // instead, each operation is declared twice: once with a parameter naming variant when it is enabled,
+    // and once, deleted, with a parameter naming variant when it is disabled.
+    // the other declaration of each pair names the unused type disabled_operation and is never selected
+    struct disabled_operation {};
+
+    static constexpr bool is_copyable = agency::detail::conjunction<std::is_copy_constructible<Types>...>::value;
+    static constexpr bool is_movable = agency::detail::conjunction<std::is_move_constructible<Types>...>::value;
+    // assigning to a variant whose alternative is not assignable destroys and reconstructs the alternative,
+    // so assignment requires only that each alternative be constructible
+    static constexpr bool is_copy_assignable = is_copyable;
+    static constexpr bool is_move_assignable = is_movable;
+
+    template<bool enabled, class T>
+    using enabled_parameter_t = agency::detail::conditional_t<enabled, T, disabled_operation>;
+
+    template<bool enabled, class T>
+    using disabled_parameter_t = agency::detail::conditional_t<enabled, disabled_operation, T>;
+
   public:
-    template<__AGENCY_REQUIRES(
-               agency::detail::conjunction<
-                 std::is_move_constructible<Types>...
-               >::value
-             )>
+    variant(const disabled_parameter_t<is_copyable, variant>&) = delete;
+    variant(disabled_parameter_t<is_movable, variant>&&) = delete;
+    variant& operator=(const disabled_parameter_t<is_copy_assignable, variant>&) = delete;
+    variant& operator=(disabled_parameter_t<is_move_assignable, variant>&&) = delete;
+
     __AGENCY_ANNOTATION
-    variant(variant&& other)
+    variant(enabled_parameter_t<is_movable, variant>&& other)
       : index_(other.index())
     {
       auto visitor = binary_move_construct_visitor();
@@ -403,13 +425,8 @@ class variant : private detail::variant_detail::variant_storage<Types...>
     };
 
   public:
-    template<__AGENCY_REQUIRES(
-               agency::detail::conjunction<
-                 std::is_copy_constructible<Types>...
-               >::value
-             )>
     __AGENCY_ANNOTATION
-    variant(const variant& other)
+    variant(const enabled_parameter_t<is_copyable, variant>& other)
       : index_(other.index())
     {
       auto visitor = binary_copy_construct_visitor();
@@ -503,13 +520,26 @@ class variant : private detail::variant_detail::variant_storage<Types...>
     struct copy_assign_visitor
     {
       __agency_exec_check_disable__
-      template<class T>
+      template<class T,
+               __AGENCY_REQUIRES(std::is_copy_assignable<T>::value)
+              >
       __AGENCY_ANNOTATION
       void operator()(T& self, const T& other) const
       {
         self = other;
       }
 
+      // alternatives which are copy constructible but not copy assignable are destroyed and copy constructed
+      __agency_exec_check_disable__
+      template<class T,
+               __AGENCY_REQUIRES(!std::is_copy_assignable<T>::value)
+              >
+      __AGENCY_ANNOTATION
+      void operator()(T& self, const T& other) const
+      {
+        destroy_and_copy_construct_visitor()(self, other);
+      }
+
       template<class... Args>
       __AGENCY_ANNOTATION
       void operator()(Args&&...) const {}
@@ -551,13 +581,8 @@ class variant : private detail::variant_detail::variant_storage<Types...>
     };
 
   public:
-    template<__AGENCY_REQUIRES(
-               agency::detail::conjunction<
-                 std::is_copy_assignable<Types>...
-               >::value
-            )>
     __AGENCY_ANNOTATION
-    variant& operator=(const variant& other)
+    variant& operator=(const enabled_parameter_t<is_copy_assignable, variant>& other)
     {
       if(index() == other.index())
       {
@@ -576,13 +601,26 @@ class variant : private detail::variant_detail::variant_storage<Types...>
     struct move_assign_visitor
     {
       __agency_exec_check_disable__
-      template<class T>
+      template<class T,
+               __AGENCY_REQUIRES(std::is_move_assignable<T>::value)
+              >
       __AGENCY_ANNOTATION
       void operator()(T& self, T& other) const
       {
         self = std::move(other);
       }
 
+      // alternatives which are move constructible but not move assignable are destroyed and move constructed
+      __agency_exec_check_disable__
+      template<class T,
+               __AGENCY_REQUIRES(!std::is_move_assignable<T>::value)
+              >
+      __AGENCY_ANNOTATION
+      void operator()(T& self, T& other) const
+      {
+        destroy_and_move_construct_visitor()(self, std::move(other));
+      }
+
       template<class... Args>
       __AGENCY_ANNOTATION
       void operator()(Args&&...) const {}
@@ -590,13 +628,8 @@ class variant : private detail::variant_detail::variant_storage<Types...>
 
 
   public:
-    template<__AGENCY_REQUIRES(
-               agency::detail::conjunction<
-                 std::is_move_assignable<Types>...
-               >::value
-            )>
     __AGENCY_ANNOTATION
-    variant& operator=(variant&& other)
+    variant& operator=(enabled_parameter_t<is_move_assignable, variant>&& other)
     {
       if(index() == other.index())
       {
@@ -8,6 +8,7 @@
 #include <agency/future/future_traits/future_rebind_value.hpp>
 #include <agency/future/future_traits/future_result.hpp>
 #include <agency/future/detail/monadic_then.hpp>
+#include <agency/future/future.hpp>
 #include <agency/detail/has_member.hpp>
 #include <agency/detail/unit.hpp>
 
@@ -97,27 +98,6 @@ inline std::shared_future<void> make_ready_shared_future()
 }
 
 
-// XXX when_all is supposed to return a future<vector>
-template<typename ForwardIterator>
-std::future<void> when_all(ForwardIterator first, ForwardIterator last)
-{
-  exception_list exceptions = flatten_into_exception_list(first, last);
-
-  std::promise<void> p;
-
-  if(exceptions.size() > 0)
-  {
-    p.set_exception(std::make_exception_ptr(exceptions));
-  }
-  else
-  {
-    p.set_value();
-  }
-
-  return p.get_future();
-}
-
-
 // then() with launch policy for std::future
 template<class T, class Function>
 std::future<detail::result_of_t<Function(std::future<T>&)>>
@@ -921,7 +901,7 @@ template<class Future,
         >
 __AGENCY_ANNOTATION
 future_result_t<Future>
-  get_value(Future& fut)
+  get_result(Future& fut)
 {
   return fut.get();
 }
@@ -969,6 +949,17 @@ template<class... Futures>
 using when_all_result_t = typename when_all_result<Futures...>::type;
 
 
+// the arguments of when_all() & when_any() must be futures which can be forwarded into the operation,
+// which excludes lvalues of move-only futures
+template<class... Futures>
+struct are_forwardable_futures
+  : conjunction<
+      is_future<decay_t<Futures>>...,
+      std::is_constructible<decay_t<Futures>,Futures&&>...
+    >
+{};
+
+
 } // end detail
 } // end agency
 
@@ -0,0 +1,378 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/unit.hpp>
+#include <agency/detail/unique_function.hpp>
+#include <agency/detail/concurrency/synchronic>
+#include <agency/memory/detail/resource/pooled_resource.hpp>
+
+#include <atomic>
+#include <exception>
+#include <future>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// a future_continuation is a node of a future_state's stack of continuations
+struct future_continuation
+{
+  template<class Function>
+  explicit future_continuation(Function&& f)
+    : f(std::forward<Function>(f)),
+      next(nullptr)
+  {}
+
+  unique_function<void()> f;
+  future_continuation* next;
+};
+
+
+template<class Function>
+inline future_continuation* new_future_continuation(Function&& f)
+{
+  void* ptr = system_pooled_resource().allocate(sizeof(future_continuation));
+
+  if(ptr == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+
+  return ::new(ptr) future_continuation(std::forward<Function>(f));
+}
+
+
+inline void delete_future_continuation(future_continuation* c)
+{
+  c->~future_continuation();
+  system_pooled_resource().deallocate(c, sizeof(future_continuation));
+}
+
+
+// continuation_trampoline runs the continuations of the states which become ready on a thread
+//
+// a continuation usually makes another state ready, e.g. by fulfilling the promise of a then(),
+// so calling each newly ready state's continuations from within the continuation which readied it
+// would nest one stack frame per link of a chain of pending futures
+// instead, while a thread runs continuations, the continuations of states it makes ready are queued
+// and run by the outermost call to run(), so a chain of any length runs in constant stack space
+//
+// the continuations of a newly ready state are queued ahead of those which were already pending,
+// so continuations run in the same depth-first order as they would if they nested
+class continuation_trampoline
+{
+  public:
+    // runs the list of continuations [first, last] and deletes them
+    inline static void run(future_continuation* first, future_continuation* last)
+    {
+      continuation_trampoline& self = this_thread_trampoline();
+
+      // the list goes after those made ready by the running continuation, but ahead of the rest
+      last->next = *self.insertion_point_;
+      *self.insertion_point_ = first;
+      self.insertion_point_ = &last->next;
+
+      // a continuation is running further up this thread's stack, so it will run the list
+      if(self.is_running_) return;
+
+      self.is_running_ = true;
+
+      try
+      {
+        self.drain();
+      }
+      catch(...)
+      {
+        self.is_running_ = false;
+        throw;
+      }
+
+      self.is_running_ = false;
+    }
+
+    // runs the continuations this thread has queued but not yet run
+    // a continuation which blocks on a state must call this first,
+    // because the continuation which makes that state ready may be queued behind it
+    inline static void run_pending()
+    {
+      continuation_trampoline& self = this_thread_trampoline();
+
+      if(self.is_running_)
+      {
+        self.drain();
+      }
+    }
+
+  private:
+    inline continuation_trampoline()
+      : pending_(nullptr),
+        insertion_point_(&pending_),
+        is_running_(false)
+    {}
+
+    inline void drain()
+    {
+      while(future_continuation* c = pending_)
+      {
+        pending_ = c->next;
+        insertion_point_ = &pending_;
+
+        try
+        {
+          c->f();
+        }
+        catch(...)
+        {
+          // continuations should not throw, but if one does, leave the rest for the next call to run()
+          delete_future_continuation(c);
+          insertion_point_ = &pending_;
+          throw;
+        }
+
+        delete_future_continuation(c);
+      }
+    }
+
+    inline static continuation_trampoline& this_thread_trampoline()
+    {
+      static thread_local continuation_trampoline result;
+      return result;
+    }
+
+    future_continuation* pending_;
+    future_continuation** insertion_point_;
+    bool is_running_;
+};
+
+
+// future_state is the state shared by a promise and the futures which refer to its result
+//
+// continuations are kept in a lock-free stack which is closed when the state becomes ready
+// a continuation added before then runs on the thread which makes the state ready,
+// after the continuation which made the state ready, if any, has returned
+// a continuation added afterwards runs immediately on the thread which adds it
+// either way, no thread blocks on behalf of a continuation
+//
+// future_states and their continuations are allocated from the system_pooled_resource,
+// so chaining continuations performs no allocation in the steady state
+template<class T>
+class future_state
+{
+  public:
+    // the result of a void state is stored as a unit
+    using value_type = typename std::conditional<std::is_void<T>::value, unit, T>::type;
+
+    // creates a pending state with a single reference
+    inline static future_state* make()
+    {
+      void* ptr = system_pooled_resource().allocate(sizeof(future_state));
+
+      if(ptr == nullptr)
+      {
+        throw std::bad_alloc();
+      }
+
+      return ::new(ptr) future_state();
+    }
+
+    inline void add_reference()
+    {
+      reference_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    inline void release()
+    {
+      if(reference_count_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        this->~future_state();
+        system_pooled_resource().deallocate(this, sizeof(future_state));
+      }
+    }
+
+    inline bool is_ready() const
+    {
+      return status_.load(std::memory_order_acquire) != pending;
+    }
+
+    inline bool has_exception() const
+    {
+      return status_.load(std::memory_order_acquire) == exceptional;
+    }
+
+    inline void wait() const
+    {
+      int status = status_.load(std::memory_order_acquire);
+
+      if(status == pending)
+      {
+        // if this thread is running a continuation, the one which makes this state ready may be queued behind it
+        continuation_trampoline::run_pending();
+
+        status = status_.load(std::memory_order_acquire);
+      }
+
+      while(status == pending)
+      {
+        // spin briefly and then park until the state becomes ready
+        notifier_.wait_for_change(status_, status);
+
+        status = status_.load(std::memory_order_acquire);
+      }
+    }
+
+    template<class... Args>
+    void set_value(Args&&... args)
+    {
+      if(is_ready())
+      {
+        throw std::future_error(std::future_errc::promise_already_satisfied);
+      }
+
+      ::new(&value_) value_type(std::forward<Args>(args)...);
+
+      become_ready(has_value);
+    }
+
+    inline void set_exception(std::exception_ptr e)
+    {
+      if(is_ready())
+      {
+        throw std::future_error(std::future_errc::promise_already_satisfied);
+      }
+
+      exception_ = e;
+
+      become_ready(exceptional);
+    }
+
+    // returns a reference to the value of a ready state
+    // throws the state's exception if it has one
+    inline value_type& value()
+    {
+      if(has_exception())
+      {
+        std::rethrow_exception(exception_);
+      }
+
+      return *reinterpret_cast<value_type*>(&value_);
+    }
+
+    inline std::exception_ptr exception() const
+    {
+      return exception_;
+    }
+
+    // arranges for f() to be called once this state is ready
+    // f() should not throw
+    template<class Function>
+    void add_continuation(Function&& f)
+    {
+      if(is_ready())
+      {
+        std::forward<Function>(f)();
+        return;
+      }
+
+      continuation* c = new_future_continuation(std::forward<Function>(f));
+
+      continuation* head = continuations_.load(std::memory_order_acquire);
+
+      do
+      {
+        if(head == closed())
+        {
+          // the state became ready while we were pushing, so call the continuation ourself
+          c->f();
+          delete_future_continuation(c);
+          return;
+        }
+
+        c->next = head;
+      }
+      while(!continuations_.compare_exchange_weak(head, c, std::memory_order_release, std::memory_order_acquire));
+    }
+
+  private:
+    enum status_type : int
+    {
+      pending,
+      has_value,
+      exceptional
+    };
+
+    using continuation = future_continuation;
+
+    inline future_state()
+      : reference_count_(1),
+        status_(pending),
+        continuations_(nullptr)
+    {}
+
+    inline ~future_state()
+    {
+      if(status_.load(std::memory_order_relaxed) == has_value)
+      {
+        reinterpret_cast<value_type*>(&value_)->~value_type();
+      }
+
+      // continuations which never ran still need to be destroyed
+      continuation* c = continuations_.load(std::memory_order_relaxed);
+
+      while(c != nullptr && c != closed())
+      {
+        continuation* next = c->next;
+        delete_future_continuation(c);
+        c = next;
+      }
+    }
+
+    // the address of the state itself marks a stack of continuations which has been closed
+    // it is never dereferenced
+    inline continuation* closed()
+    {
+      return reinterpret_cast<continuation*>(this);
+    }
+
+    inline void become_ready(status_type status)
+    {
+      // wake any waiting threads
+      notifier_.notify_all(status_, static_cast<int>(status));
+
+      // close the stack so that later continuations run immediately
+      continuation* c = continuations_.exchange(closed(), std::memory_order_acq_rel);
+
+      if(c == nullptr) return;
+
+      // the stack holds the continuations newest-first, so reverse it to run them in the order they were added
+      continuation* last = c;
+      continuation* reversed = nullptr;
+
+      while(c != nullptr)
+      {
+        continuation* next = c->next;
+        c->next = reversed;
+        reversed = c;
+        c = next;
+      }
+
+      continuation_trampoline::run(reversed, last);
+    }
+
+    std::atomic<int> reference_count_;
+    std::atomic<int> status_;
+    std::experimental::synchronic<int, std::experimental::synchronic_option::optimize_for_short_wait> notifier_;
+    std::atomic<continuation*> continuations_;
+    typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type value_;
+    std::exception_ptr exception_;
+};
+
+
+} // end detail
+} // end agency
+
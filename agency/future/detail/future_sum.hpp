@@ -1,7 +1,9 @@
 #pragma once
 
 #include <agency/detail/config.hpp>
+#include <agency/detail/type_traits.hpp>
 #include <agency/future/variant_future.hpp>
+#include <type_traits>
 
 namespace agency
 {
@@ -28,6 +30,25 @@ struct future_sum2<Future,Future>
   using type = Future;
 };
 
+template<class Future, class... Futures>
+struct future_sum2<Future,variant_future<Futures...>>
+{
+  // when the second Future type is a variant_future, the result is a variant_future
+  // whose alternatives are the unique types among Future and the variant_future's alternatives
+  using type = conditional_t<
+    disjunction<std::is_same<Future,Futures>...>::value,
+    variant_future<Futures...>,
+    variant_future<Future,Futures...>
+  >;
+};
+
+template<class... Futures>
+struct future_sum2<variant_future<Futures...>,variant_future<Futures...>>
+{
+  // when the Future types are the same type, the result is that type
+  using type = variant_future<Futures...>;
+};
+
 template<class Future1, class Future2>
 using future_sum2_t = typename future_sum2<Future1,Future2>::type;
 
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/future/always_ready_future.hpp>
+#include <agency/detail/concurrency/concurrent_thread_pool.hpp>
+
+#include <utility>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+template<class Future, class Function>
+using on_ready_member_t = decltype(std::declval<const Future&>().on_ready(std::declval<Function>()));
+
+template<class Future, class Function>
+using has_on_ready_member = is_detected<on_ready_member_t, Future, Function>;
+
+
+// waits on a future and then calls a function
+// FutureOrReference is either a copy of a future or a reference to one
+template<class FutureOrReference, class Function>
+struct wait_and_call
+{
+  FutureOrReference future;
+  Function f;
+
+  void operator()()
+  {
+    future.wait();
+    f();
+  }
+};
+
+
+// on_ready() arranges for f() to be called once the given future is ready, without blocking the caller
+// f() should not throw
+//
+// futures which can notify a continuation, such as agency::future, call f() on the thread which makes them ready,
+// or immediately, if they are already ready
+
+
+template<class Future, class Function,
+         __AGENCY_REQUIRES(has_on_ready_member<Future, Function&&>::value)
+        >
+void on_ready(const Future& future, Function&& f)
+{
+  future.on_ready(std::forward<Function>(f));
+}
+
+
+// always_ready_futures are always ready, so call f() immediately
+template<class T, class Function>
+void on_ready(const always_ready_future<T>&, Function&& f)
+{
+  std::forward<Function>(f)();
+}
+
+
+// other futures, such as std::future, offer no way to notify a continuation,
+// so a thread of the system_concurrent_thread_pool waits on the future on our behalf
+// a copyable future is waited on through a copy of it. otherwise, the caller must keep the future
+// alive until f() is called
+
+template<class Future, class Function>
+void on_ready_impl(std::true_type, const Future& future, Function&& f)
+{
+  system_concurrent_thread_pool().submit(wait_and_call<Future, decay_t<Function>>{future, std::forward<Function>(f)});
+}
+
+template<class Future, class Function>
+void on_ready_impl(std::false_type, const Future& future, Function&& f)
+{
+  system_concurrent_thread_pool().submit(wait_and_call<const Future&, decay_t<Function>>{future, std::forward<Function>(f)});
+}
+
+template<class Future, class Function,
+         __AGENCY_REQUIRES(!has_on_ready_member<Future, Function&&>::value)
+        >
+void on_ready(const Future& future, Function&& f)
+{
+  detail::on_ready_impl(std::is_copy_constructible<Future>(), future, std::forward<Function>(f));
+}
+
+
+} // end detail
+} // end agency
+
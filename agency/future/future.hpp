@@ -0,0 +1,521 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/utility.hpp>
+#include <agency/future/detail/future_state.hpp>
+
+#include <exception>
+#include <future>
+#include <type_traits>
+#include <utility>
+
+
+namespace agency
+{
+
+
+template<class T>
+class future;
+
+template<class T>
+class shared_future;
+
+template<class T>
+class promise;
+
+
+namespace detail
+{
+
+
+// the type of the result of a continuation attached to a future<T>
+// the continuation receives the predecessor's value as an lvalue, or nothing, if the predecessor is void
+template<class T, class Function>
+struct future_continuation_result
+{
+  using type = result_of_t<Function(T&)>;
+};
+
+template<class Function>
+struct future_continuation_result<void,Function>
+{
+  using type = result_of_t<Function()>;
+};
+
+template<class T, class Function>
+using future_continuation_result_t = typename future_continuation_result<T,Function>::type;
+
+
+// then_continuation fulfills a promise with the result of calling a function with the value of a ready predecessor
+// if the predecessor is exceptional, the function is not called and the promise receives the predecessor's exception
+template<class T, class Function, class Result>
+class then_continuation
+{
+  public:
+    // the continuation adopts a reference to the predecessor
+    then_continuation(future_state<T>* predecessor, Function&& f)
+      : predecessor_(predecessor),
+        f_(std::move(f))
+    {}
+
+    then_continuation(then_continuation&& other) noexcept(std::is_nothrow_move_constructible<Function>::value)
+      : predecessor_(other.predecessor_),
+        f_(std::move(other.f_)),
+        promise_(std::move(other.promise_))
+    {
+      other.predecessor_ = nullptr;
+    }
+
+    ~then_continuation()
+    {
+      if(predecessor_)
+      {
+        predecessor_->release();
+      }
+    }
+
+    agency::future<Result> get_future()
+    {
+      return promise_.get_future();
+    }
+
+    void operator()()
+    {
+      if(predecessor_->has_exception())
+      {
+        promise_.set_exception(predecessor_->exception());
+        return;
+      }
+
+      try
+      {
+        invoke_and_set_value(std::is_void<T>(), std::is_void<Result>());
+      }
+      catch(...)
+      {
+        promise_.set_exception(std::current_exception());
+      }
+    }
+
+  private:
+    void invoke_and_set_value(std::false_type, std::false_type)
+    {
+      promise_.set_value(f_(predecessor_->value()));
+    }
+
+    void invoke_and_set_value(std::false_type, std::true_type)
+    {
+      f_(predecessor_->value());
+      promise_.set_value();
+    }
+
+    void invoke_and_set_value(std::true_type, std::false_type)
+    {
+      promise_.set_value(f_());
+    }
+
+    void invoke_and_set_value(std::true_type, std::true_type)
+    {
+      f_();
+      promise_.set_value();
+    }
+
+    future_state<T>* predecessor_;
+    Function f_;
+    agency::promise<Result> promise_;
+};
+
+
+} // end detail
+
+
+// future is a handle to the result of an asynchronous operation which a promise fulfills
+//
+// unlike std::future, a future does not need a thread to wait on its behalf in order to chain further work:
+// then() attaches a continuation which runs on the thread which fulfills the promise,
+// or immediately on the calling thread, if the future is already ready
+template<class T>
+class future
+{
+  public:
+    // Postcondition: !valid()
+    future() noexcept
+      : state_(nullptr)
+    {}
+
+    future(future&& other) noexcept
+      : state_(other.state_)
+    {
+      other.state_ = nullptr;
+    }
+
+    ~future()
+    {
+      invalidate();
+    }
+
+    future& operator=(future&& other) noexcept
+    {
+      invalidate();
+      std::swap(state_, other.state_);
+      return *this;
+    }
+
+    template<class... Args>
+    static future make_ready(Args&&... args)
+    {
+      future result(detail::future_state<T>::make());
+      result.state_->set_value(std::forward<Args>(args)...);
+      return result;
+    }
+
+    static future make_exceptional(std::exception_ptr e)
+    {
+      future result(detail::future_state<T>::make());
+      result.state_->set_exception(e);
+      return result;
+    }
+
+    bool valid() const noexcept
+    {
+      return state_ != nullptr;
+    }
+
+    bool is_ready() const
+    {
+      return valid() && state_->is_ready();
+    }
+
+    void wait() const
+    {
+      if(!valid())
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      state_->wait();
+    }
+
+    // Postcondition: !valid()
+    T get()
+    {
+      // take the state so that it is released even if the result is exceptional
+      future ready = std::move(*this);
+      ready.wait();
+
+      return static_cast<T>(std::move(ready.state_->value()));
+    }
+
+    // Postcondition: !valid()
+    shared_future<T> share()
+    {
+      return shared_future<T>(std::move(*this));
+    }
+
+    // Postcondition: !valid()
+    template<class Function>
+    future<detail::future_continuation_result_t<T, detail::decay_t<Function>>>
+      then(Function&& f)
+    {
+      using result_type = detail::future_continuation_result_t<T, detail::decay_t<Function>>;
+
+      if(!valid())
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      detail::future_state<T>* state = state_;
+      state_ = nullptr;
+
+      // the continuation takes over our reference to the state
+      detail::then_continuation<T, detail::decay_t<Function>, result_type> continuation(state, detail::decay_copy(std::forward<Function>(f)));
+
+      future<result_type> result = continuation.get_future();
+
+      state->add_continuation(std::move(continuation));
+
+      return result;
+    }
+
+    // calls f() once *this is ready, on the thread which makes it ready, or immediately, if *this is already ready
+    // f() should not throw
+    // unlike then(), on_ready() leaves *this valid
+    template<class Function>
+    void on_ready(Function&& f) const
+    {
+      if(!valid())
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      state_->add_continuation(std::forward<Function>(f));
+    }
+
+  private:
+    template<class> friend class future;
+    template<class> friend class shared_future;
+    template<class> friend class promise;
+
+    // adopts a reference to the given state
+    explicit future(detail::future_state<T>* state)
+      : state_(state)
+    {}
+
+    void invalidate()
+    {
+      if(state_)
+      {
+        state_->release();
+        state_ = nullptr;
+      }
+    }
+
+    detail::future_state<T>* state_;
+};
+
+
+// shared_future is a copyable future whose result may be retrieved any number of times
+template<class T>
+class shared_future
+{
+  private:
+    using get_result_type = typename std::conditional<
+      std::is_void<T>::value,
+      void,
+      typename std::add_lvalue_reference<const T>::type
+    >::type;
+
+  public:
+    // Postcondition: !valid()
+    shared_future() noexcept
+      : state_(nullptr)
+    {}
+
+    shared_future(const shared_future& other) noexcept
+      : state_(other.state_)
+    {
+      if(state_)
+      {
+        state_->add_reference();
+      }
+    }
+
+    shared_future(shared_future&& other) noexcept
+      : state_(other.state_)
+    {
+      other.state_ = nullptr;
+    }
+
+    // Postcondition: !other.valid()
+    shared_future(future<T>&& other) noexcept
+      : state_(other.state_)
+    {
+      other.state_ = nullptr;
+    }
+
+    ~shared_future()
+    {
+      invalidate();
+    }
+
+    shared_future& operator=(const shared_future& other) noexcept
+    {
+      shared_future(other).swap(*this);
+      return *this;
+    }
+
+    shared_future& operator=(shared_future&& other) noexcept
+    {
+      shared_future(std::move(other)).swap(*this);
+      return *this;
+    }
+
+    void swap(shared_future& other) noexcept
+    {
+      std::swap(state_, other.state_);
+    }
+
+    template<class... Args>
+    static shared_future make_ready(Args&&... args)
+    {
+      return future<T>::make_ready(std::forward<Args>(args)...);
+    }
+
+    static shared_future make_exceptional(std::exception_ptr e)
+    {
+      return future<T>::make_exceptional(e);
+    }
+
+    bool valid() const noexcept
+    {
+      return state_ != nullptr;
+    }
+
+    bool is_ready() const
+    {
+      return valid() && state_->is_ready();
+    }
+
+    void wait() const
+    {
+      if(!valid())
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      state_->wait();
+    }
+
+    get_result_type get() const
+    {
+      wait();
+
+      return static_cast<get_result_type>(state_->value());
+    }
+
+    // unlike future::then(), shared_future::then() leaves *this valid
+    template<class Function>
+    future<detail::future_continuation_result_t<T, detail::decay_t<Function>>>
+      then(Function&& f) const
+    {
+      using result_type = detail::future_continuation_result_t<T, detail::decay_t<Function>>;
+
+      if(!valid())
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      detail::then_continuation<T, detail::decay_t<Function>, result_type> continuation(state_, detail::decay_copy(std::forward<Function>(f)));
+
+      // the continuation keeps a reference of its own to the state
+      state_->add_reference();
+
+      future<result_type> result = continuation.get_future();
+
+      state_->add_continuation(std::move(continuation));
+
+      return result;
+    }
+
+    // calls f() once *this is ready, on the thread which makes it ready, or immediately, if *this is already ready
+    // f() should not throw
+    template<class Function>
+    void on_ready(Function&& f) const
+    {
+      if(!valid())
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      state_->add_continuation(std::forward<Function>(f));
+    }
+
+  private:
+    void invalidate()
+    {
+      if(state_)
+      {
+        state_->release();
+        state_ = nullptr;
+      }
+    }
+
+    detail::future_state<T>* state_;
+};
+
+
+// promise fulfills the future it returns from get_future()
+// a promise destroyed before it is fulfilled fulfills its future with a broken_promise error
+template<class T>
+class promise
+{
+  public:
+    promise()
+      : state_(detail::future_state<T>::make()),
+        future_retrieved_(false)
+    {}
+
+    promise(promise&& other) noexcept
+      : state_(other.state_),
+        future_retrieved_(other.future_retrieved_)
+    {
+      other.state_ = nullptr;
+    }
+
+    ~promise()
+    {
+      abandon();
+    }
+
+    promise& operator=(promise&& other) noexcept
+    {
+      abandon();
+      std::swap(state_, other.state_);
+      std::swap(future_retrieved_, other.future_retrieved_);
+      return *this;
+    }
+
+    future<T> get_future()
+    {
+      if(!state_)
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      if(future_retrieved_)
+      {
+        throw std::future_error(std::future_errc::future_already_retrieved);
+      }
+
+      future_retrieved_ = true;
+
+      state_->add_reference();
+      return future<T>(state_);
+    }
+
+    // the continuations of the future execute on the calling thread before set_value() returns
+    template<class... Args>
+    void set_value(Args&&... args)
+    {
+      if(!state_)
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      state_->set_value(std::forward<Args>(args)...);
+    }
+
+    // the continuations of the future execute on the calling thread before set_exception() returns
+    void set_exception(std::exception_ptr e)
+    {
+      if(!state_)
+      {
+        throw std::future_error(std::future_errc::no_state);
+      }
+
+      state_->set_exception(e);
+    }
+
+  private:
+    void abandon()
+    {
+      if(state_)
+      {
+        if(!state_->is_ready())
+        {
+          state_->set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+
+        state_->release();
+        state_ = nullptr;
+      }
+    }
+
+    detail::future_state<T>* state_;
+    bool future_retrieved_;
+};
+
+
+} // end agency
+
@@ -6,6 +6,7 @@
 #include <agency/future/future_traits.hpp>
 #include <agency/experimental/variant.hpp>
 #include <agency/future.hpp>
+#include <agency/future/detail/on_ready.hpp>
 
 #include <type_traits>
 
@@ -167,6 +168,29 @@ class variant_future
       return agency::experimental::visit(visitor, variant_);
     }
 
+  private:
+    template<class FunctionRef>
+    struct on_ready_visitor
+    {
+      FunctionRef f;
+
+      template<class T>
+      void operator()(const T& future) const
+      {
+        detail::on_ready(future, std::forward<FunctionRef>(f));
+      }
+    };
+
+  public:
+    // calls f() once this variant_future is ready without blocking the caller
+    // f() is called however the active alternative notifies detail::on_ready()
+    template<class Function>
+    void on_ready(Function&& f) const
+    {
+      auto visitor = on_ready_visitor<Function&&>{std::forward<Function>(f)};
+      agency::experimental::visit(visitor, variant_);
+    }
+
   private:
     variant_type variant_;
 };
@@ -0,0 +1,289 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/integer_sequence.hpp>
+#include <agency/detail/tuple/tuple_utility.hpp>
+#include <agency/exception_list.hpp>
+#include <agency/experimental/optional.hpp>
+#include <agency/future.hpp>
+#include <agency/future/detail/on_ready.hpp>
+#include <agency/tuple.hpp>
+
+#include <atomic>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace agency
+{
+namespace detail
+{
+
+
+// returns the result of a ready future, or nullopt after collecting the future's exceptions
+template<class Future>
+experimental::optional<typename void_to_unit<future_result_t<Future>>::type>
+  try_get_result(Future& future, exception_list& exceptions)
+{
+  try
+  {
+    return detail::get_result(future);
+  }
+  catch(exception_list& e)
+  {
+    move_exceptions(exceptions, e);
+  }
+  catch(...)
+  {
+    add_current_exception(exceptions);
+  }
+
+  return experimental::nullopt;
+}
+
+
+// each future given to when_all() receives a when_all_continuation
+// the continuation of the last future to become ready completes the when_all() operation
+template<class State>
+struct when_all_continuation
+{
+  std::shared_ptr<State> state;
+
+  void operator()() const
+  {
+    if(state->num_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      state->complete();
+    }
+  }
+};
+
+
+template<class Future>
+struct when_all_range_state
+{
+  using value_type = future_result_t<Future>;
+
+  using result_type = typename std::conditional<
+    std::is_void<value_type>::value,
+    void,
+    std::vector<value_type>
+  >::type;
+
+  std::vector<Future> futures;
+  std::atomic<size_t> num_pending;
+  agency::promise<result_type> promise;
+
+  void complete()
+  {
+    exception_list exceptions;
+    std::vector<typename void_to_unit<value_type>::type> values;
+    values.reserve(futures.size());
+
+    for(auto& future : futures)
+    {
+      auto result = detail::try_get_result(future, exceptions);
+
+      if(result)
+      {
+        values.push_back(std::move(*result));
+      }
+    }
+
+    if(exceptions.size() > 0)
+    {
+      promise.set_exception(std::make_exception_ptr(std::move(exceptions)));
+    }
+    else
+    {
+      set_result(std::is_void<value_type>(), values);
+    }
+  }
+
+  void set_result(std::true_type, std::vector<unit>&)
+  {
+    promise.set_value();
+  }
+
+  template<class Vector>
+  void set_result(std::false_type, Vector& values)
+  {
+    promise.set_value(std::move(values));
+  }
+};
+
+
+template<class... Futures>
+struct when_all_state
+{
+  using result_type = when_all_result_t<Futures...>;
+
+  agency::tuple<Futures...> futures;
+  std::atomic<size_t> num_pending;
+  agency::promise<result_type> promise;
+
+  template<class... Args>
+  when_all_state(Args&&... futures)
+    : futures(std::forward<Args>(futures)...),
+      num_pending(sizeof...(Futures))
+  {}
+
+  void complete()
+  {
+    complete_impl(index_sequence_for<Futures...>());
+  }
+
+  // when_all() of no futures is a ready future<void>
+  void complete_impl(index_sequence<>)
+  {
+    promise.set_value();
+  }
+
+  template<size_t... Indices>
+  void complete_impl(index_sequence<Indices...>)
+  {
+    exception_list exceptions;
+    size_t num_retrieved = 0;
+
+    try
+    {
+      // braced initialization retrieves the results in order, so num_retrieved identifies the future which throws, if any
+      set_result(std::is_void<result_type>(), tuple_of_future_results<Futures...>{
+        retrieve_result(agency::get<Indices>(futures), num_retrieved)...
+      });
+
+      return;
+    }
+    catch(exception_list& e)
+    {
+      move_exceptions(exceptions, e);
+    }
+    catch(...)
+    {
+      add_current_exception(exceptions);
+    }
+
+    // collect the exceptions of the futures following the one which threw
+    using ints = int[];
+    (void) ints{0, (Indices < num_retrieved ? 0 : (detail::try_get_result(agency::get<Indices>(futures), exceptions), 0))...};
+
+    promise.set_exception(std::make_exception_ptr(std::move(exceptions)));
+  }
+
+  template<class Future>
+  static typename void_to_unit<future_result_t<Future>>::type retrieve_result(Future& future, size_t& num_retrieved)
+  {
+    ++num_retrieved;
+    return detail::get_result(future);
+  }
+
+  template<class Tuple>
+  void set_result(std::true_type, Tuple&&)
+  {
+    promise.set_value();
+  }
+
+  template<class Tuple>
+  void set_result(std::false_type, Tuple&& results)
+  {
+    promise.set_value(detail::unwrap_small_tuple(detail::tuple_filter<is_not_unit>(std::move(results))));
+  }
+};
+
+
+// attaches a when_all_continuation to each future of a when_all_state
+template<class State>
+struct attach_when_all_continuation
+{
+  std::shared_ptr<State> state;
+
+  template<class Future>
+  void operator()(Future& future) const
+  {
+    detail::on_ready(future, when_all_continuation<State>{state});
+  }
+};
+
+
+} // end detail
+
+
+// when_all() returns a future which becomes ready once all of the futures in the range [first, last) are ready
+//
+// the futures are moved into the operation, and no thread blocks waiting on them:
+// each future notifies a continuation, and the last continuation to run fulfills the result
+// futures which cannot notify a continuation, such as std::future, are waited on by a thread of the system_concurrent_thread_pool
+//
+// the result is a future<vector<T>> holding the futures' values in order, or a future<void> if T is void
+// if any of the futures is exceptional, the result is exceptional with an exception_list of all of their exceptions
+template<class ForwardIterator,
+         __AGENCY_REQUIRES(!is_future<ForwardIterator>::value)
+        >
+future<typename detail::when_all_range_state<typename std::iterator_traits<ForwardIterator>::value_type>::result_type>
+  when_all(ForwardIterator first, ForwardIterator last)
+{
+  using state_type = detail::when_all_range_state<typename std::iterator_traits<ForwardIterator>::value_type>;
+
+  auto state = std::make_shared<state_type>();
+
+  // the futures must not move once their continuations are attached
+  state->futures.reserve(std::distance(first, last));
+
+  for(; first != last; ++first)
+  {
+    state->futures.push_back(std::move(*first));
+  }
+
+  auto result = state->promise.get_future();
+
+  state->num_pending = state->futures.size();
+
+  if(state->futures.empty())
+  {
+    state->complete();
+  }
+
+  for(auto& future : state->futures)
+  {
+    detail::on_ready(future, detail::when_all_continuation<state_type>{state});
+  }
+
+  return result;
+}
+
+
+// when_all() returns a future which becomes ready once all of the given futures are ready
+// the futures are forwarded into the operation, so move-only futures such as agency::future must be passed as rvalues
+//
+// the result's type is the tuple of the non-void results of the futures, unwrapped when it has fewer than two elements
+// if any of the futures is exceptional, the result is exceptional with an exception_list of all of their exceptions
+template<class... Futures,
+         __AGENCY_REQUIRES(detail::are_forwardable_futures<Futures...>::value)
+        >
+future<detail::when_all_result_t<detail::decay_t<Futures>...>>
+  when_all(Futures&&... futures)
+{
+  using state_type = detail::when_all_state<detail::decay_t<Futures>...>;
+
+  auto state = std::make_shared<state_type>(std::forward<Futures>(futures)...);
+
+  auto result = state->promise.get_future();
+
+  if(sizeof...(Futures) == 0)
+  {
+    state->complete();
+  }
+
+  __tu::tuple_for_each(detail::attach_when_all_continuation<state_type>{state}, state->futures);
+
+  return result;
+}
+
+
+} // end agency
+
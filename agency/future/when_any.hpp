@@ -0,0 +1,234 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/detail/integer_sequence.hpp>
+#include <agency/detail/type_list.hpp>
+#include <agency/future.hpp>
+#include <agency/future/detail/on_ready.hpp>
+#include <agency/tuple.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+
+namespace agency
+{
+
+
+// when_any_result is the result of when_any()
+// index identifies the first future to become ready, and value is its result
+template<class T>
+struct when_any_result
+{
+  std::size_t index;
+  T value;
+};
+
+template<>
+struct when_any_result<void>
+{
+  std::size_t index;
+};
+
+
+namespace detail
+{
+
+
+template<class T>
+struct when_any_state_base
+{
+  using result_type = when_any_result<T>;
+
+  std::atomic<bool> done;
+  agency::promise<result_type> promise;
+
+  when_any_state_base()
+    : done(false)
+  {}
+
+  // fulfills the promise with the result of the first future to become ready
+  // if that future is exceptional, so is the result
+  template<class Future>
+  void complete(std::size_t index, Future& future)
+  {
+    try
+    {
+      set_result(std::is_void<T>(), index, future);
+    }
+    catch(...)
+    {
+      promise.set_exception(std::current_exception());
+    }
+  }
+
+  template<class Future>
+  void set_result(std::true_type, std::size_t index, Future& future)
+  {
+    future.get();
+    promise.set_value(result_type{index});
+  }
+
+  template<class Future>
+  void set_result(std::false_type, std::size_t index, Future& future)
+  {
+    promise.set_value(result_type{index, future.get()});
+  }
+};
+
+
+template<class Future>
+struct when_any_range_state : when_any_state_base<future_result_t<Future>>
+{
+  std::vector<Future> futures;
+};
+
+
+// the result type of the futures given to when_any() is the result type of the first future
+template<class... Futures>
+using when_any_value_t = future_result_t<type_list_element<0, type_list<Futures...>>>;
+
+
+template<class... Futures>
+struct when_any_state : when_any_state_base<when_any_value_t<Futures...>>
+{
+  // the result of whichever future becomes ready first is stored as when_any_value_t, so no conversion may occur
+  static_assert(conjunction<std::is_same<future_result_t<Futures>, when_any_value_t<Futures...>>...>::value,
+                "when_any(): all futures must have the same result type.");
+
+  agency::tuple<Futures...> futures;
+
+  template<class... Args>
+  when_any_state(Args&&... futures)
+    : futures(std::forward<Args>(futures)...)
+  {}
+};
+
+
+// each future given to when_any() receives a when_any_continuation
+// only the continuation of the first future to become ready completes the when_any() operation
+template<class Future>
+struct when_any_range_continuation
+{
+  std::shared_ptr<when_any_range_state<Future>> state;
+  std::size_t index;
+
+  void operator()() const
+  {
+    if(!state->done.exchange(true, std::memory_order_acq_rel))
+    {
+      state->complete(index, state->futures[index]);
+    }
+  }
+};
+
+
+template<std::size_t Index, class... Futures>
+struct when_any_continuation
+{
+  std::shared_ptr<when_any_state<Futures...>> state;
+
+  void operator()() const
+  {
+    if(!state->done.exchange(true, std::memory_order_acq_rel))
+    {
+      state->complete(Index, agency::get<Index>(state->futures));
+    }
+  }
+};
+
+
+template<std::size_t... Indices, class... Futures>
+void attach_when_any_continuations(index_sequence<Indices...>, const std::shared_ptr<when_any_state<Futures...>>& state)
+{
+  // unpacking into an init list attaches the continuations in order
+  using ints = int[];
+  (void) ints{0, (detail::on_ready(agency::get<Indices>(state->futures), when_any_continuation<Indices,Futures...>{state}), 0)...};
+}
+
+
+template<class... Futures>
+struct when_any_requirements
+  : std::integral_constant<
+      bool,
+      (sizeof...(Futures) > 0) && are_forwardable_futures<Futures...>::value
+    >
+{};
+
+
+} // end detail
+
+
+// when_any() returns a future which becomes ready once any of the futures in the range [first, last) is ready
+//
+// the futures are moved into the operation, and no thread blocks waiting on them:
+// each future notifies a continuation, and the first continuation to run fulfills the result
+// futures which cannot notify a continuation, such as std::future, are waited on by a thread of the system_concurrent_thread_pool
+//
+// the result is a future<when_any_result<T>> holding the position of the first ready future and its value
+// if that future is exceptional, so is the result
+// an empty range produces a future which is exceptional with a broken_promise error
+template<class ForwardIterator,
+         __AGENCY_REQUIRES(!is_future<ForwardIterator>::value)
+        >
+future<when_any_result<future_result_t<typename std::iterator_traits<ForwardIterator>::value_type>>>
+  when_any(ForwardIterator first, ForwardIterator last)
+{
+  using future_type = typename std::iterator_traits<ForwardIterator>::value_type;
+  using state_type = detail::when_any_range_state<future_type>;
+
+  auto state = std::make_shared<state_type>();
+
+  // the futures must not move once their continuations are attached
+  state->futures.reserve(std::distance(first, last));
+
+  for(; first != last; ++first)
+  {
+    state->futures.push_back(std::move(*first));
+  }
+
+  auto result = state->promise.get_future();
+
+  if(state->futures.empty())
+  {
+    state->promise.set_exception(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+  }
+
+  for(std::size_t i = 0; i < state->futures.size(); ++i)
+  {
+    detail::on_ready(state->futures[i], detail::when_any_range_continuation<future_type>{state, i});
+  }
+
+  return result;
+}
+
+
+// when_any() returns a future which becomes ready once any of the given futures is ready
+// the futures must all have the same result type
+// they are forwarded into the operation, so move-only futures such as agency::future must be passed as rvalues
+template<class... Futures,
+         __AGENCY_REQUIRES(detail::when_any_requirements<Futures...>::value)
+        >
+future<when_any_result<detail::when_any_value_t<detail::decay_t<Futures>...>>>
+  when_any(Futures&&... futures)
+{
+  auto state = std::make_shared<detail::when_any_state<detail::decay_t<Futures>...>>(std::forward<Futures>(futures)...);
+
+  auto result = state->promise.get_future();
+
+  detail::attach_when_any_continuations(detail::index_sequence_for<Futures...>(), state);
+
+  return result;
+}
+
+
+} // end agency
+
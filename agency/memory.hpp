@@ -2,6 +2,7 @@
 
 #include <agency/detail/config.hpp>
 #include <agency/memory/allocator.hpp>
+#include <agency/memory/is_trivially_relocatable.hpp>
 #include <agency/memory/pointer_adaptor.hpp>
 #include <agency/memory/to_address.hpp>
 
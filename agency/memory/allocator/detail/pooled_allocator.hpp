@@ -0,0 +1,23 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/memory/allocator/detail/allocator_adaptor.hpp>
+#include <agency/memory/detail/resource/pooled_resource.hpp>
+#include <agency/memory/detail/resource/malloc_resource.hpp>
+
+namespace agency
+{
+namespace detail
+{
+
+
+// pooled_allocator allocates from a process-wide pooled_resource
+// it is a drop-in replacement for agency::allocator in containers which
+// frequently allocate and deallocate small blocks, e.g. agency::vector<T, pooled_allocator<T>>
+template<class T, class MemoryResource = malloc_resource>
+using pooled_allocator = allocator_adaptor<T,globally_pooled_resource<MemoryResource>>;
+
+
+} // end detail
+} // end agency
+
@@ -174,16 +174,53 @@ class variant_allocator
       return experimental::visit(max_size_visitor{}, variant_);
     }
 
+  private:
+    template<class A>
+    using equal_t = decltype(std::declval<const A&>() == std::declval<const A&>());
+
+    struct equal_visitor
+    {
+      template<class A1, class A2>
+      __AGENCY_ANNOTATION
+      bool operator()(const A1&, const A2&) const
+      {
+        return false;
+      }
+
+      __agency_exec_check_disable__
+      template<class A,
+               __AGENCY_REQUIRES(detail::is_detected<equal_t, A>::value)
+              >
+      __AGENCY_ANNOTATION
+      bool operator()(const A& lhs, const A& rhs) const
+      {
+        return lhs == rhs;
+      }
+
+      // an allocator without operator== is equal to another of its type when it is stateless,
+      // as std::allocator_traits<A>::is_always_equal assumes
+      template<class A,
+               __AGENCY_REQUIRES(!detail::is_detected<equal_t, A>::value)
+              >
+      __AGENCY_ANNOTATION
+      bool operator()(const A&, const A&) const
+      {
+        return std::is_empty<A>::value;
+      }
+    };
+
+  public:
     __AGENCY_ANNOTATION
     bool operator==(const variant_allocator& other) const
     {
-      return variant_ == other.variant_;
+      auto visitor = equal_visitor();
+      return variant_.index() == other.variant_.index() && experimental::visit(visitor, variant_, other.variant_);
     }
 
     __AGENCY_ANNOTATION
     bool operator!=(const variant_allocator& other) const
     {
-      return variant_ != other.variant_;
+      return !operator==(other);
     }
 
   private:
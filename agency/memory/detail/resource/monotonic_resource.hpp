@@ -0,0 +1,281 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/memory/detail/resource/malloc_resource.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace agency
+{
+namespace detail
+{
+
+
+// monotonic_resource is a C++ "memory resource" which allocates memory by bumping a pointer
+// through a chain of geometrically growing blocks
+//
+// the first block may be a buffer provided by the caller. when a block is exhausted,
+// the next block is obtained from the upstream resource and is twice as large as the last
+// deallocating the most recent allocation makes its memory available again. once every allocation
+// has been deallocated, all blocks but the largest are returned to the upstream resource, and the
+// largest block is reused from its beginning. all blocks are returned when the resource is destroyed
+//
+// this makes monotonic_resource suitable for the temporary storage of a group of agents, which is
+// typically allocated and deallocated in stack order and discarded along with the group
+template<class MemoryResource = malloc_resource, std::size_t alignment = alignof(std::max_align_t)>
+class monotonic_resource : private MemoryResource
+{
+  private:
+    using upstream_resource_type = MemoryResource;
+
+    // each block obtained from the upstream resource begins with a header
+    struct block_header
+    {
+      block_header* previous;
+      std::size_t size;
+    };
+
+  public:
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    monotonic_resource() noexcept
+      : monotonic_resource(nullptr, 0)
+    {}
+
+    // the caller's buffer must outlive the monotonic_resource
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    monotonic_resource(void* buffer, std::size_t size, const upstream_resource_type& upstream = upstream_resource_type()) noexcept
+      : upstream_resource_type(upstream),
+        initial_buffer_begin_(align_up(reinterpret_cast<char*>(buffer))),
+        initial_buffer_end_(reinterpret_cast<char*>(buffer) + size),
+        blocks_(nullptr),
+        next_block_size_(2 * size < minimum_block_size() ? minimum_block_size() : 2 * size),
+        num_allocations_(0)
+    {
+      if(initial_buffer_begin_ > initial_buffer_end_)
+      {
+        // the buffer is too small to hold even a single aligned byte
+        initial_buffer_begin_ = initial_buffer_end_;
+      }
+
+      current_ = initial_buffer_begin_;
+      end_ = initial_buffer_end_;
+    }
+
+    __AGENCY_ANNOTATION
+    monotonic_resource(const monotonic_resource&) = delete;
+
+    __AGENCY_ANNOTATION
+    monotonic_resource& operator=(const monotonic_resource&) = delete;
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    ~monotonic_resource()
+    {
+      release();
+    }
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    void* allocate(std::size_t n)
+    {
+      std::size_t aligned_n = align_up(n == 0 ? 1 : n);
+
+      if(num_remaining_bytes() < aligned_n && !grow(aligned_n))
+      {
+        return nullptr;
+      }
+
+      void* result = current_;
+      current_ += aligned_n;
+      ++num_allocations_;
+
+      return result;
+    }
+
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    void deallocate(void* ptr, std::size_t n)
+    {
+      if(ptr == nullptr) return;
+
+      char* p = reinterpret_cast<char*>(ptr);
+
+      if(p + align_up(n == 0 ? 1 : n) == current_)
+      {
+        // ptr is the most recent allocation, so reclaim its storage
+        current_ = p;
+      }
+
+      if(--num_allocations_ == 0)
+      {
+        reuse_largest_block();
+      }
+    }
+
+    // returns every block to the upstream resource
+    // any outstanding allocations become invalid
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    void release()
+    {
+      while(blocks_)
+      {
+        block_header* previous = blocks_->previous;
+        upstream_resource_type::deallocate(blocks_, blocks_->size);
+        blocks_ = previous;
+      }
+
+      current_ = initial_buffer_begin_;
+      end_ = initial_buffer_end_;
+      num_allocations_ = 0;
+    }
+
+    __AGENCY_ANNOTATION
+    bool owns(void* ptr, std::size_t) const noexcept
+    {
+      const char* p = reinterpret_cast<const char*>(ptr);
+
+      if(initial_buffer_begin_ <= p && p < initial_buffer_end_) return true;
+
+      for(block_header* block = blocks_; block; block = block->previous)
+      {
+        const char* begin = reinterpret_cast<const char*>(block);
+
+        if(begin <= p && p < begin + block->size) return true;
+      }
+
+      return false;
+    }
+
+    __AGENCY_ANNOTATION
+    const upstream_resource_type& upstream_resource() const
+    {
+      return *this;
+    }
+
+    __AGENCY_ANNOTATION
+    bool operator==(const monotonic_resource& other) const
+    {
+      return this == &other;
+    }
+
+    __AGENCY_ANNOTATION
+    bool operator!=(const monotonic_resource& other) const
+    {
+      return this != &other;
+    }
+
+  private:
+    __AGENCY_ANNOTATION
+    static constexpr std::size_t minimum_block_size()
+    {
+      return 1024;
+    }
+
+    __AGENCY_ANNOTATION
+    static std::size_t align_up(std::size_t n) noexcept
+    {
+      return (n + (alignment-1)) & ~(alignment-1);
+    }
+
+    __AGENCY_ANNOTATION
+    static char* align_up(char* ptr) noexcept
+    {
+      return reinterpret_cast<char*>(align_up(reinterpret_cast<std::uintptr_t>(ptr)));
+    }
+
+    __AGENCY_ANNOTATION
+    static std::size_t header_size() noexcept
+    {
+      return align_up(sizeof(block_header));
+    }
+
+    __AGENCY_ANNOTATION
+    std::size_t num_remaining_bytes() const noexcept
+    {
+      return end_ - current_;
+    }
+
+    // obtains a new block large enough to hold n bytes from the upstream resource
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    bool grow(std::size_t n)
+    {
+      std::size_t size = next_block_size_;
+      if(size < header_size() + n)
+      {
+        size = header_size() + n;
+      }
+
+      block_header* block = reinterpret_cast<block_header*>(upstream_resource_type::allocate(size));
+      if(!block) return false;
+
+      block->previous = blocks_;
+      block->size = size;
+      blocks_ = block;
+
+      current_ = reinterpret_cast<char*>(block) + header_size();
+      end_ = reinterpret_cast<char*>(block) + size;
+
+      next_block_size_ = 2 * size;
+
+      return true;
+    }
+
+    // when nothing is allocated, keep only the most recent block, which is the largest
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    void reuse_largest_block()
+    {
+      if(!blocks_)
+      {
+        current_ = initial_buffer_begin_;
+        return;
+      }
+
+      block_header* largest = blocks_;
+      blocks_ = largest->previous;
+
+      release();
+
+      largest->previous = nullptr;
+      blocks_ = largest;
+
+      current_ = reinterpret_cast<char*>(largest) + header_size();
+      end_ = reinterpret_cast<char*>(largest) + largest->size;
+    }
+
+    char* initial_buffer_begin_;
+    char* initial_buffer_end_;
+    block_header* blocks_;
+    char* current_;
+    char* end_;
+    std::size_t next_block_size_;
+    std::size_t num_allocations_;
+};
+
+
+// inline_monotonic_resource is a monotonic_resource whose first block is a buffer of N bytes stored within the resource itself
+template<std::size_t N, class MemoryResource = malloc_resource, std::size_t alignment = alignof(std::max_align_t)>
+class inline_monotonic_resource : public monotonic_resource<MemoryResource, alignment>
+{
+  private:
+    using super_t = monotonic_resource<MemoryResource, alignment>;
+
+  public:
+    __agency_exec_check_disable__
+    __AGENCY_ANNOTATION
+    inline_monotonic_resource(const MemoryResource& upstream = MemoryResource()) noexcept
+      : super_t(buffer_, N, upstream)
+    {}
+
+  private:
+    alignas(alignment) char buffer_[N];
+};
+
+
+} // end detail
+} // end agency
+
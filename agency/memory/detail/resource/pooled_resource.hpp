@@ -0,0 +1,614 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/singleton.hpp>
+#include <agency/memory/detail/resource/malloc_resource.hpp>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+namespace agency
+{
+namespace detail
+{
+
+
+// pooled_size_classes maps allocation sizes onto a small set of size classes
+// sizes up to 64 bytes are rounded up to a multiple of 16 bytes
+// larger sizes are rounded up to one of four evenly-spaced sizes between consecutive powers of two,
+// so rounding never wastes more than 25% of a block
+struct pooled_size_classes
+{
+  enum
+  {
+    // the largest size which belongs to a size class is 1 GiB
+    max_log2_size = 30,
+    num_classes = 4 * (max_log2_size - 5)
+  };
+
+  static size_t max_size()
+  {
+    return size_t(1) << max_log2_size;
+  }
+
+  // returns the size class of allocations of num_bytes
+  // num_bytes must not exceed max_size()
+  static size_t size_class(size_t num_bytes)
+  {
+    if(num_bytes <= 64)
+    {
+      return num_bytes == 0 ? 0 : (num_bytes - 1) / 16;
+    }
+
+    // 2^k < num_bytes <= 2^(k+1)
+    size_t k = floor_log2(num_bytes - 1);
+
+    // which quarter of (2^k, 2^(k+1)] contains num_bytes
+    size_t quarter = ((num_bytes - 1) >> (k - 2)) - 4;
+
+    return 4 * (k - 5) + quarter;
+  }
+
+  // returns the size of the blocks belonging to the given size class
+  static size_t size(size_t size_class)
+  {
+    if(size_class < 4)
+    {
+      return 16 * (size_class + 1);
+    }
+
+    size_t k = size_class / 4 + 5;
+    size_t quarter = size_class % 4;
+
+    return (quarter + 5) << (k - 2);
+  }
+
+  // returns the number of blocks of the given size class which move
+  // between a thread's cache and the central depot at a time
+  static size_t batch_size(size_t size_class)
+  {
+    size_t result = (32 * 1024) / size(size_class);
+
+    return result < 1 ? 1 : (result > 64 ? 64 : result);
+  }
+
+  // returns the number of batches carved from each chunk of memory obtained from the upstream resource
+  // blocks larger than 32 KiB get a chunk of their own
+  static size_t batches_per_chunk(size_t size_class)
+  {
+    size_t result = (64 * 1024) / (batch_size(size_class) * size(size_class));
+
+    return result < 1 ? 1 : result;
+  }
+
+  static size_t floor_log2(size_t x)
+  {
+#if defined(__GNUC__)
+    return 8 * sizeof(unsigned long long) - 1 - __builtin_clzll(x);
+#else
+    size_t result = 0;
+    while(x >>= 1) ++result;
+    return result;
+#endif
+  }
+};
+
+
+// pooled_resource is a memory resource which rounds each allocation up to a size class and
+// recycles deallocated blocks instead of returning them to its upstream resource
+//
+// each thread allocates from and deallocates to a cache of its own, so the common case takes no locks
+// and performs no atomic operations. caches exchange batches of blocks with a central depot, which
+// keeps a lock-free stack of batches per size class. when the depot runs dry, a chunk obtained from the
+// upstream resource is carved into new batches. allocations larger than pooled_size_classes::max_size()
+// go directly to the upstream resource
+//
+// pooled_resource is safe to use from multiple threads. a block may be deallocated by a thread other than
+// the one which allocated it. blocks are linked through their first bytes while they are free, so the
+// upstream resource must allocate memory which is accessible from the host
+//
+// memory is returned to the upstream resource only when the pooled_resource is destroyed
+template<class MemoryResource = malloc_resource>
+class pooled_resource : private MemoryResource
+{
+  public:
+    using resource_type = MemoryResource;
+
+    pooled_resource()
+      : pooled_resource(resource_type())
+    {}
+
+    explicit pooled_resource(const resource_type& resource)
+      : resource_type(resource),
+        id_(register_pool()),
+        upstream_bytes_(0)
+    {}
+
+    pooled_resource(const pooled_resource&) = delete;
+
+    ~pooled_resource()
+    {
+      // after this point, exiting threads no longer return their cached blocks to this pool
+      deregister_pool(id_);
+
+      for(auto& chunk : chunks_)
+      {
+        // swallow any exceptions thrown by the upstream resource
+        // in order to avoid propagating exceptions out of destructors
+        try
+        {
+          resource_type::deallocate(chunk.first, chunk.second);
+        }
+        catch(...)
+        {
+        }
+      }
+    }
+
+    void* allocate(size_t num_bytes)
+    {
+      if(num_bytes > pooled_size_classes::max_size())
+      {
+        return resource_type::allocate(num_bytes);
+      }
+
+      size_t size_class = pooled_size_classes::size_class(num_bytes);
+      free_list& list = local_cache().lists[size_class];
+
+      if(list.head == nullptr && !refill(size_class, list))
+      {
+        return nullptr;
+      }
+
+      void* result = list.head;
+      list.head = next_block(result);
+      --list.size;
+
+      return result;
+    }
+
+    void deallocate(void* ptr, size_t num_bytes)
+    {
+      if(num_bytes > pooled_size_classes::max_size())
+      {
+        resource_type::deallocate(ptr, num_bytes);
+        return;
+      }
+
+      size_t size_class = pooled_size_classes::size_class(num_bytes);
+      free_list& list = local_cache().lists[size_class];
+
+      next_block(ptr) = list.head;
+      list.head = ptr;
+      ++list.size;
+
+      // keep at most two batches in the cache so that blocks freed by one thread
+      // may be reused by others
+      size_t batch_size = pooled_size_classes::batch_size(size_class);
+      if(list.size >= 2 * batch_size)
+      {
+        depots_[size_class].push(take_batch(list, batch_size));
+      }
+    }
+
+    // returns the number of bytes this pool currently holds from its upstream resource
+    size_t upstream_bytes() const
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      return upstream_bytes_;
+    }
+
+    const resource_type& upstream_resource() const
+    {
+      return *this;
+    }
+
+    bool operator==(const pooled_resource& other) const
+    {
+      return this == &other;
+    }
+
+    bool operator!=(const pooled_resource& other) const
+    {
+      return this != &other;
+    }
+
+  private:
+    // a free block's first pointer links it to the next block of its batch or list
+    // the second pointer of a batch's first block links the batch to the next batch in a depot
+    static void*& next_block(void* block)
+    {
+      return reinterpret_cast<void**>(block)[0];
+    }
+
+    static void*& next_batch(void* block)
+    {
+      return reinterpret_cast<void**>(block)[1];
+    }
+
+    struct free_list
+    {
+      void* head = nullptr;
+      size_t size = 0;
+    };
+
+    // a thread's cache of free blocks, one list per size class
+    struct thread_cache
+    {
+      free_list lists[pooled_size_classes::num_classes];
+    };
+
+    // a depot is a stack of batches
+    // pushes are lock-free. pops are serialized with each other, which rules out the ABA problem
+    // without tagged pointers because a batch cannot be popped and pushed again in the middle of a pop
+    struct depot
+    {
+      depot()
+        : batches(nullptr)
+      {}
+
+      void push(void* batch)
+      {
+        void* head = batches.load(std::memory_order_relaxed);
+
+        do
+        {
+          next_batch(batch) = head;
+        }
+        while(!batches.compare_exchange_weak(head, batch, std::memory_order_release, std::memory_order_relaxed));
+      }
+
+      void* pop()
+      {
+        // avoid the lock when there is nothing to pop
+        if(batches.load(std::memory_order_relaxed) == nullptr) return nullptr;
+
+        std::lock_guard<std::mutex> guard(pop_mutex);
+
+        void* head = batches.load(std::memory_order_acquire);
+
+        while(head != nullptr && !batches.compare_exchange_weak(head, next_batch(head), std::memory_order_acquire, std::memory_order_acquire))
+        {
+        }
+
+        return head;
+      }
+
+      std::atomic<void*> batches;
+      std::mutex pop_mutex;
+
+      // keep depots on separate cache lines
+      char padding[64];
+    };
+
+    // removes up to batch_size blocks from the front of list and returns them as a batch
+    static void* take_batch(free_list& list, size_t batch_size)
+    {
+      void* batch = list.head;
+      void* last = batch;
+
+      size_t n = 1;
+      for(; n < batch_size && next_block(last) != nullptr; ++n)
+      {
+        last = next_block(last);
+      }
+
+      list.head = next_block(last);
+      list.size -= n;
+      next_block(last) = nullptr;
+
+      return batch;
+    }
+
+    // refills an empty list with a batch from the depot or from a new chunk
+    // returns false if the upstream resource could not provide a new chunk
+    bool refill(size_t size_class, free_list& list)
+    {
+      void* batch = depots_[size_class].pop();
+
+      if(batch == nullptr)
+      {
+        batch = carve_new_chunk(size_class);
+
+        if(batch == nullptr) return false;
+      }
+
+      list.head = batch;
+      list.size = 0;
+      for(void* block = batch; block != nullptr; block = next_block(block))
+      {
+        ++list.size;
+      }
+
+      return true;
+    }
+
+    // obtains a new chunk from the upstream resource, carves it into batches, and
+    // pushes all but the first batch to the depot
+    // returns the first batch, or nullptr if the upstream resource failed
+    void* carve_new_chunk(size_t size_class)
+    {
+      size_t block_size = pooled_size_classes::size(size_class);
+      size_t batch_size = pooled_size_classes::batch_size(size_class);
+      size_t num_batches = pooled_size_classes::batches_per_chunk(size_class);
+      size_t chunk_size = num_batches * batch_size * block_size;
+
+      char* chunk = nullptr;
+
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+
+        chunk = reinterpret_cast<char*>(resource_type::allocate(chunk_size));
+        if(chunk == nullptr) return nullptr;
+
+        chunks_.push_back(std::make_pair(chunk, chunk_size));
+        upstream_bytes_ += chunk_size;
+      }
+
+      for(size_t b = 0; b < num_batches; ++b)
+      {
+        char* batch = chunk + b * batch_size * block_size;
+
+        for(size_t i = 0; i + 1 < batch_size; ++i)
+        {
+          next_block(batch + i * block_size) = batch + (i + 1) * block_size;
+        }
+
+        next_block(batch + (batch_size - 1) * block_size) = nullptr;
+
+        if(b > 0)
+        {
+          depots_[size_class].push(batch);
+        }
+      }
+
+      return chunk;
+    }
+
+    // returns every block in the cache to the depots
+    void drain(thread_cache& cache)
+    {
+      for(size_t size_class = 0; size_class < pooled_size_classes::num_classes; ++size_class)
+      {
+        free_list& list = cache.lists[size_class];
+        size_t batch_size = pooled_size_classes::batch_size(size_class);
+
+        while(list.head != nullptr)
+        {
+          depots_[size_class].push(take_batch(list, batch_size));
+        }
+      }
+    }
+
+    // the registry tracks which pools are alive so that threads which exit
+    // only return their cached blocks to pools which still exist
+    struct registry
+    {
+      std::mutex mutex;
+      std::set<size_t> live_pools;
+      size_t next_id = 0;
+    };
+
+    static registry& the_registry()
+    {
+      // the registry is never destroyed because threads may exit after static destructors have run
+      static registry* result = new registry;
+      return *result;
+    }
+
+    static size_t register_pool()
+    {
+      registry& r = the_registry();
+      std::lock_guard<std::mutex> guard(r.mutex);
+
+      size_t id = r.next_id++;
+      r.live_pools.insert(id);
+
+      return id;
+    }
+
+    static void deregister_pool(size_t id)
+    {
+      registry& r = the_registry();
+      std::lock_guard<std::mutex> guard(r.mutex);
+
+      r.live_pools.erase(id);
+    }
+
+    // the caches owned by a thread, one per pool the thread has used
+    class thread_caches
+    {
+      public:
+        ~thread_caches()
+        {
+          registry& r = the_registry();
+          std::lock_guard<std::mutex> guard(r.mutex);
+
+          for(auto& entry : entries_)
+          {
+            if(r.live_pools.count(entry.id))
+            {
+              entry.pool->drain(*entry.cache);
+            }
+          }
+        }
+
+        thread_cache& find_or_create(pooled_resource* pool)
+        {
+          // most threads use a single pool, so check the most recently used entry first
+          if(!entries_.empty() && entries_.back().id == pool->id_)
+          {
+            return *entries_.back().cache;
+          }
+
+          for(auto& entry : entries_)
+          {
+            if(entry.id == pool->id_)
+            {
+              std::swap(entry, entries_.back());
+              return *entries_.back().cache;
+            }
+          }
+
+          forget_destroyed_pools();
+
+          entries_.push_back(entry{pool->id_, pool, std::unique_ptr<thread_cache>(new thread_cache)});
+          return *entries_.back().cache;
+        }
+
+      private:
+        void forget_destroyed_pools()
+        {
+          registry& r = the_registry();
+          std::lock_guard<std::mutex> guard(r.mutex);
+
+          std::vector<entry> live_entries;
+
+          for(auto& e : entries_)
+          {
+            if(r.live_pools.count(e.id))
+            {
+              live_entries.push_back(std::move(e));
+            }
+          }
+
+          entries_.swap(live_entries);
+        }
+
+        struct entry
+        {
+          size_t id;
+          pooled_resource* pool;
+          std::unique_ptr<thread_cache> cache;
+        };
+
+        std::vector<entry> entries_;
+    };
+
+    thread_cache& local_cache()
+    {
+      static thread_local thread_caches caches;
+      return caches.find_or_create(this);
+    }
+
+    size_t id_;
+    depot depots_[pooled_size_classes::num_classes];
+
+    // mutex_ guards chunks_ and upstream_bytes_
+    mutable std::mutex mutex_;
+    std::vector<std::pair<void*,size_t>> chunks_;
+    size_t upstream_bytes_;
+};
+
+
+template<class MemoryResource>
+struct pooled_resources_singleton_t
+{
+  std::mutex mutex;
+
+  // there are few distinct upstream resources, so a linear search suffices
+  // this also avoids requiring MemoryResource to be ordered
+  std::vector<std::pair<MemoryResource, std::unique_ptr<pooled_resource<MemoryResource>>>> pooled_resources;
+};
+
+
+template<class MemoryResource>
+inline pooled_resources_singleton_t<MemoryResource>* pooled_resources_singleton()
+{
+  return agency::detail::singleton<pooled_resources_singleton_t<MemoryResource>>();
+}
+
+
+// returns the pooled_resource associated with the given resource, creating it if necessary
+// returns nullptr after the singleton has been destroyed
+template<class MemoryResource>
+inline pooled_resource<MemoryResource>* pooled_resource_from_singleton(const MemoryResource& resource)
+{
+  pooled_resources_singleton_t<MemoryResource>* resources_ptr = pooled_resources_singleton<MemoryResource>();
+
+  if(!resources_ptr) return nullptr;
+
+  std::lock_guard<std::mutex> guard(resources_ptr->mutex);
+
+  for(auto& r : resources_ptr->pooled_resources)
+  {
+    if(r.first == resource)
+    {
+      return r.second.get();
+    }
+  }
+
+  std::unique_ptr<pooled_resource<MemoryResource>> pool(new pooled_resource<MemoryResource>(resource));
+  pooled_resource<MemoryResource>* result = pool.get();
+
+  resources_ptr->pooled_resources.push_back(std::make_pair(resource, std::move(pool)));
+
+  return result;
+}
+
+
+// globally_pooled_resource allocates from a pooled_resource shared by every globally_pooled_resource
+// with an equal upstream resource
+// unlike globally_cached_resource, allocation and deallocation take no global lock
+template<class MemoryResource = malloc_resource>
+class globally_pooled_resource
+{
+  public:
+    globally_pooled_resource(const MemoryResource& resource)
+      : resource_(resource),
+        pool_(pooled_resource_from_singleton(resource))
+    {}
+
+    globally_pooled_resource()
+      : globally_pooled_resource(MemoryResource())
+    {}
+
+    globally_pooled_resource(const globally_pooled_resource&) = default;
+
+    inline void* allocate(size_t num_bytes)
+    {
+      // the pool may have been destroyed along with the singleton during program exit
+      return pool_ && pooled_resources_singleton<MemoryResource>() ? pool_->allocate(num_bytes) : nullptr;
+    }
+
+    inline void deallocate(void *ptr, size_t num_bytes)
+    {
+      if(pool_ && pooled_resources_singleton<MemoryResource>())
+      {
+        pool_->deallocate(ptr, num_bytes);
+      }
+    }
+
+    bool operator==(const globally_pooled_resource& other) const
+    {
+      return resource_ == other.resource_;
+    }
+
+    bool operator!=(const globally_pooled_resource& other) const
+    {
+      return resource_ != other.resource_;
+    }
+
+  private:
+    MemoryResource resource_;
+    pooled_resource<MemoryResource>* pool_;
+};
+
+
+// system_pooled_resource() returns a pooled_resource which is never destroyed
+// objects which may be destroyed during program exit, e.g. the tasks queued by a static thread pool,
+// allocate from it so that their deallocation never finds the pool gone
+inline pooled_resource<malloc_resource>& system_pooled_resource()
+{
+  static pooled_resource<malloc_resource>* resource = new pooled_resource<malloc_resource>();
+  return *resource;
+}
+
+
+} // end detail
+} // end agency
+
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <type_traits>
+
+
+namespace agency
+{
+
+
+// is_trivially_relocatable<T> is true when moving an object of type T into new storage
+// and then destroying the original is equivalent to copying the original's bytes into new storage
+// and then forgetting about the original
+//
+// containers such as agency::vector use this trait to relocate their elements with memcpy when they grow
+//
+// by default, the trait is true for trivially copyable types
+// users may specialize it for types which are trivially relocatable but not trivially copyable,
+// e.g., types which hold a unique owning pointer to a heap-allocated object
+template<class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+
+} // end agency
+
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/concurrency/barrier.hpp>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace agency
+{
+namespace omp
+{
+namespace detail
+{
+
+
+// team_barrier synchronizes a group of agents executing as the threads of an OpenMP team with #pragma omp barrier
+//
+// a team_barrier is created before the team which uses it, so the team executes one nesting level deeper than the
+// team_barrier's creator. when the agents synchronizing through a team_barrier do not make up such a team (e.g., because
+// OpenMP could not create a team of the requested size and the agents were launched on other threads instead), the
+// team_barrier synchronizes them with agency::detail::barrier instead
+class team_barrier
+{
+  public:
+    inline explicit team_barrier(std::size_t count)
+      : count_(count),
+        level_(current_level()),
+        fallback_barrier_(count)
+    {}
+
+    inline std::size_t count() const
+    {
+      return count_;
+    }
+
+    inline void arrive_and_wait()
+    {
+#ifdef _OPENMP
+      if(current_level() == level_ + 1 && static_cast<std::size_t>(omp_get_num_threads()) == count_)
+      {
+        #pragma omp barrier
+        return;
+      }
+#endif
+
+      fallback_barrier_.arrive_and_wait();
+    }
+
+  private:
+    inline static int current_level()
+    {
+#ifdef _OPENMP
+      return omp_get_level();
+#else
+      return 0;
+#endif
+    }
+
+    std::size_t count_;
+    int level_;
+    agency::detail::barrier fallback_barrier_;
+};
+
+
+} // end detail
+} // end omp
+} // end agency
+
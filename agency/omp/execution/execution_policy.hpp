@@ -0,0 +1,7 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/omp/execution/execution_policy/concurrent_execution_policy.hpp>
+#include <agency/omp/execution/execution_policy/parallel_execution_policy.hpp>
+#include <agency/omp/execution/execution_policy/unsequenced_execution_policy.hpp>
+
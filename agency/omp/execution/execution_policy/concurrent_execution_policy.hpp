@@ -0,0 +1,36 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/execution/execution_policy/basic_execution_policy.hpp>
+#include <agency/execution/execution_agent/concurrent_agent.hpp>
+#include <agency/omp/execution/executor/concurrent_executor.hpp>
+#include <agency/omp/detail/concurrency/team_barrier.hpp>
+#include <cstddef>
+
+
+namespace agency
+{
+namespace omp
+{
+
+
+// omp::concurrent_agent synchronizes its group with #pragma omp barrier
+using concurrent_agent = agency::detail::basic_concurrent_agent<std::size_t, omp::detail::team_barrier, agency::detail::default_concurrent_resource>;
+
+
+class concurrent_execution_policy : public basic_execution_policy<omp::concurrent_agent, omp::concurrent_executor, concurrent_execution_policy>
+{
+  private:
+    using super_t = basic_execution_policy<omp::concurrent_agent, omp::concurrent_executor, concurrent_execution_policy>;
+
+  public:
+    using super_t::basic_execution_policy;
+};
+
+
+const concurrent_execution_policy con{};
+
+
+} // end omp
+} // end agency
+
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/execution/execution_policy/basic_execution_policy.hpp>
+#include <agency/omp/execution/executor/simd_executor.hpp>
+
+
+namespace agency
+{
+namespace omp
+{
+
+
+class unsequenced_execution_policy : public basic_execution_policy<unsequenced_agent, omp::unsequenced_executor, unsequenced_execution_policy>
+{
+  private:
+    using super_t = basic_execution_policy<unsequenced_agent, omp::unsequenced_executor, unsequenced_execution_policy>;
+
+  public:
+    using super_t::basic_execution_policy;
+};
+
+
+const unsequenced_execution_policy unseq{};
+
+
+} // end omp
+} // end agency
+
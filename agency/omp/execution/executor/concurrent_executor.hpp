@@ -0,0 +1,88 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/future.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/detail/concurrency/concurrent_thread_pool.hpp>
+#include <agency/omp/execution/executor/detail/parallel_for.hpp>
+#include <agency/omp/execution/executor/detail/bulk_then_execute.hpp>
+#include <utility>
+
+
+namespace agency
+{
+namespace omp
+{
+
+
+// concurrent_executor executes each group of n agents as the n threads of an OpenMP team created with
+// #pragma omp parallel num_threads(n). agents which synchronize through omp::concurrent_agent::wait()
+// use #pragma omp barrier
+//
+// OpenMP may create a smaller team than requested, e.g. when n exceeds OMP_THREAD_LIMIT or when the launch
+// is nested within another parallel region. such groups are executed on agency's concurrent thread pool instead,
+// so that all n agents are still guaranteed to make progress concurrently
+class concurrent_executor
+{
+  public:
+    template<class T>
+    using future = agency::future<T>;
+
+    constexpr static bulk_guarantee_t::concurrent_t query(const bulk_guarantee_t&)
+    {
+      return bulk_guarantee_t::concurrent_t();
+    }
+
+    size_t unit_shape() const
+    {
+      return detail::max_num_threads();
+    }
+
+    template<class Function, class ResultFactory, class SharedFactory>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, size_t n, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+#ifndef _OPENMP
+      static_assert(sizeof(Function) && false, "agency::omp::concurrent_executor requires C++ OpenMP language extensions (typically enabled with -fopenmp or /openmp).");
+#endif
+
+      auto result = result_factory();
+      auto shared_parm = shared_factory();
+
+      auto execute_agent = [&](size_t i)
+      {
+        f(i, result, shared_parm);
+      };
+
+      if(n > 0 && !detail::parallel_team(n, execute_agent))
+      {
+        agency::detail::system_concurrent_thread_pool().bulk_invoke(execute_agent, n);
+      }
+
+      return future<agency::detail::result_of_t<ResultFactory()>>::make_ready(std::move(result));
+    }
+
+    // the agents execute on a dedicated thread after the predecessor becomes ready
+    template<class Function, class Future, class ResultFactory, class SharedFactory>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+      return detail::bulk_then_execute_via_bulk_twoway_execute(*this, f, n, predecessor, result_factory, shared_factory);
+    }
+
+    friend constexpr bool operator==(const concurrent_executor&, const concurrent_executor&) noexcept
+    {
+      return true;
+    }
+
+    friend constexpr bool operator!=(const concurrent_executor&, const concurrent_executor&) noexcept
+    {
+      return false;
+    }
+};
+
+
+} // end omp
+} // end agency
+
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/invoke.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/future.hpp>
+#include <agency/future/detail/on_ready.hpp>
+#include <agency/detail/concurrency/concurrent_thread_pool.hpp>
+#include <memory>
+#include <exception>
+
+
+namespace agency
+{
+namespace omp
+{
+namespace detail
+{
+
+
+// executes f on a thread of its own after predecessor becomes ready and returns a future to its result
+// no thread waits on predecessor: the thread which makes it ready submits f to the concurrent thread pool
+// OpenMP parallel regions begun by f are independent of any region the caller is executing
+template<class SharedFuture, class Function>
+agency::future<agency::detail::result_of_t<Function()>> async_execute_after(const SharedFuture& predecessor, Function f)
+{
+  using result_type = agency::detail::result_of_t<Function()>;
+
+  auto shared_promise_ptr = std::make_shared<agency::promise<result_type>>();
+  auto result_future = shared_promise_ptr->get_future();
+
+  agency::detail::on_ready(predecessor, [=]
+  {
+    agency::detail::system_concurrent_thread_pool().submit([=]() mutable
+    {
+      try
+      {
+        shared_promise_ptr->set_value(f());
+      }
+      catch(...)
+      {
+        shared_promise_ptr->set_exception(std::current_exception());
+      }
+    });
+  });
+
+  return result_future;
+}
+
+
+// passes a predecessor argument to a function in the slot following the agent's index
+template<class Function, class Predecessor>
+struct bind_predecessor
+{
+  mutable Function f;
+  Predecessor* predecessor;
+
+  template<class Index, class... Args>
+  void operator()(const Index& idx, Args&... args) const
+  {
+    agency::detail::invoke(f, idx, *predecessor, args...);
+  }
+};
+
+
+// these functions implement an executor's asynchronous bulk_then_execute() with its blocking bulk_twoway_execute()
+// once the predecessor is ready, a dedicated thread executes the blocking launch
+// the thread is parked & reused after the launch completes, so OpenMP's thread team also persists across launches
+template<class Executor, class Function, class Shape, class Future, class ResultFactory, class... Factories,
+         __AGENCY_REQUIRES(
+           !std::is_void<future_result_t<Future>>::value
+         )>
+agency::future<agency::detail::result_of_t<ResultFactory()>>
+  bulk_then_execute_via_bulk_twoway_execute(const Executor& ex, Function f, Shape shape, Future& predecessor, ResultFactory result_factory, Factories... shared_factories)
+{
+  using predecessor_type = future_result_t<Future>;
+
+  auto shared_predecessor = future_traits<Future>::share(predecessor);
+
+  return async_execute_after(shared_predecessor, [=]() mutable
+  {
+    predecessor_type& predecessor_arg = const_cast<predecessor_type&>(shared_predecessor.get());
+
+    return ex.bulk_twoway_execute(bind_predecessor<Function,predecessor_type>{f, &predecessor_arg}, shape, result_factory, shared_factories...).get();
+  });
+}
+
+
+template<class Executor, class Function, class Shape, class Future, class ResultFactory, class... Factories,
+         __AGENCY_REQUIRES(
+           std::is_void<future_result_t<Future>>::value
+         )>
+agency::future<agency::detail::result_of_t<ResultFactory()>>
+  bulk_then_execute_via_bulk_twoway_execute(const Executor& ex, Function f, Shape shape, Future& predecessor, ResultFactory result_factory, Factories... shared_factories)
+{
+  auto shared_predecessor = future_traits<Future>::share(predecessor);
+
+  return async_execute_after(shared_predecessor, [=]() mutable
+  {
+    shared_predecessor.get();
+
+    return ex.bulk_twoway_execute(f, shape, result_factory, shared_factories...).get();
+  });
+}
+
+
+} // end detail
+} // end omp
+} // end agency
+
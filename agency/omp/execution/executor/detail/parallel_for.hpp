@@ -0,0 +1,212 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/execution/executor/properties/schedule.hpp>
+#include <atomic>
+#include <exception>
+#include <utility>
+#include <cstddef>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+namespace agency
+{
+namespace omp
+{
+namespace detail
+{
+
+
+// returns the number of threads an OpenMP parallel region creates by default
+inline std::size_t max_num_threads()
+{
+#ifdef _OPENMP
+  return static_cast<std::size_t>(omp_get_max_threads());
+#else
+  return 1;
+#endif
+}
+
+
+// exceptions may not escape an OpenMP structured block, so
+// exception_catcher catches the first exception thrown by any call to f and
+// rethrows it after the block completes
+class exception_catcher
+{
+  public:
+    exception_catcher()
+      : has_exception_(false)
+    {}
+
+    template<class Function, class... Args>
+    void invoke(Function& f, Args&&... args)
+    {
+      try
+      {
+        f(std::forward<Args>(args)...);
+      }
+      catch(...)
+      {
+        if(!has_exception_.exchange(true))
+        {
+          exception_ = std::current_exception();
+        }
+      }
+    }
+
+    void rethrow_if_caught()
+    {
+      if(exception_)
+      {
+        std::rethrow_exception(exception_);
+      }
+    }
+
+  private:
+    std::atomic<bool> has_exception_;
+    std::exception_ptr exception_;
+};
+
+
+// calls f(i) for each i in [0, n) with #pragma omp parallel for
+// the given schedule selects the loop's schedule clause:
+//
+// uniform:  schedule(static)
+// dynamic:  schedule(dynamic, chunk_size)
+// guided:   schedule(guided, chunk_size)
+template<class Function>
+void parallel_for(const schedule_t& schedule, std::size_t n, Function f)
+{
+  exception_catcher catcher;
+
+  long chunk_size = static_cast<long>(schedule.chunk_size());
+
+  if(schedule.is_dynamic())
+  {
+    #pragma omp parallel for schedule(dynamic, chunk_size)
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      catcher.invoke(f, i);
+    }
+  }
+  else if(schedule.is_guided())
+  {
+    #pragma omp parallel for schedule(guided, chunk_size)
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      catcher.invoke(f, i);
+    }
+  }
+  else
+  {
+    #pragma omp parallel for schedule(static)
+    for(std::size_t i = 0; i < n; ++i)
+    {
+      catcher.invoke(f, i);
+    }
+  }
+
+  catcher.rethrow_if_caught();
+}
+
+
+// calls f(i, j) for each i in [0, m) and j in [0, n) with #pragma omp parallel for simd
+// the iterations of both loops are collapsed into a single iteration space
+template<class Function>
+void parallel_for_simd(const schedule_t& schedule, std::size_t m, std::size_t n, Function f)
+{
+  long chunk_size = static_cast<long>(schedule.chunk_size());
+
+  if(schedule.is_dynamic())
+  {
+    #pragma omp parallel for simd collapse(2) schedule(dynamic, chunk_size)
+    for(std::size_t i = 0; i < m; ++i)
+    {
+      for(std::size_t j = 0; j < n; ++j)
+      {
+        f(i, j);
+      }
+    }
+  }
+  else if(schedule.is_guided())
+  {
+    #pragma omp parallel for simd collapse(2) schedule(guided, chunk_size)
+    for(std::size_t i = 0; i < m; ++i)
+    {
+      for(std::size_t j = 0; j < n; ++j)
+      {
+        f(i, j);
+      }
+    }
+  }
+  else
+  {
+    #pragma omp parallel for simd collapse(2) schedule(static)
+    for(std::size_t i = 0; i < m; ++i)
+    {
+      for(std::size_t j = 0; j < n; ++j)
+      {
+        f(i, j);
+      }
+    }
+  }
+}
+
+
+// calls f(i) for each i in [0, n) with #pragma omp simd
+template<class Function>
+void simd_for(std::size_t n, Function f)
+{
+  #pragma omp simd
+  for(std::size_t i = 0; i < n; ++i)
+  {
+    f(i);
+  }
+}
+
+
+// calls f(i) for each i in [0, n) on a team of n OpenMP threads, one call per thread
+// returns false without calling f if OpenMP could not create a team of n threads
+// this happens, e.g., when n exceeds the thread limit or when nested parallelism is disabled
+template<class Function>
+bool parallel_team(std::size_t n, Function f)
+{
+  exception_catcher catcher;
+
+  bool created_team = false;
+
+  #pragma omp parallel num_threads(n)
+  {
+#ifdef _OPENMP
+    std::size_t team_size = static_cast<std::size_t>(omp_get_num_threads());
+    std::size_t thread_num = static_cast<std::size_t>(omp_get_thread_num());
+#else
+    std::size_t team_size = 1;
+    std::size_t thread_num = 0;
+#endif
+
+    // every thread observes the same team size, so either all threads call f or none do
+    if(team_size == n)
+    {
+      catcher.invoke(f, thread_num);
+    }
+
+    if(thread_num == 0)
+    {
+      created_team = (team_size == n);
+    }
+  }
+
+  catcher.rethrow_if_caught();
+
+  return created_team;
+}
+
+
+} // end detail
+} // end omp
+} // end agency
+
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/requires.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/future.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/execution/executor/properties/schedule.hpp>
+#include <agency/omp/execution/executor/detail/parallel_for.hpp>
+#include <agency/omp/execution/executor/detail/bulk_then_execute.hpp>
+#include <utility>
+
+
+namespace agency
+{
+namespace omp
+{
+
+
+// parallel_for_executor executes its agents with #pragma omp parallel for
+// the schedule property selects the loop's schedule clause, e.g.
+//
+//   agency::require(omp::parallel_for_executor(), schedule.dynamic(64))
+//
+// creates an executor whose loops use schedule(dynamic, 64)
+class parallel_for_executor
+{
+  public:
+    template<class T>
+    using future = agency::future<T>;
+
+    constexpr parallel_for_executor()
+      : schedule_()
+    {}
+
+    explicit constexpr parallel_for_executor(schedule_t schedule)
+      : schedule_(schedule)
+    {}
+
+    constexpr static bulk_guarantee_t::parallel_t query(const bulk_guarantee_t&)
+    {
+      return bulk_guarantee_t::parallel_t();
+    }
+
+    constexpr schedule_t query(const schedule_t&) const
+    {
+      return schedule_;
+    }
+
+    template<class Schedule,
+             __AGENCY_REQUIRES(agency::detail::is_schedule<Schedule>::value)
+            >
+    parallel_for_executor require(const Schedule& schedule) const
+    {
+      return parallel_for_executor(schedule);
+    }
+
+    size_t unit_shape() const
+    {
+      return detail::max_num_threads();
+    }
+
+    template<class Function, class ResultFactory, class SharedFactory>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, size_t n, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+#ifndef _OPENMP
+      static_assert(sizeof(Function) && false, "agency::omp::parallel_for_executor requires C++ OpenMP language extensions (typically enabled with -fopenmp or /openmp).");
+#endif
+
+      auto result = result_factory();
+      auto shared_parm = shared_factory();
+
+      detail::parallel_for(schedule_, n, [&](size_t i)
+      {
+        f(i, result, shared_parm);
+      });
+
+      return future<agency::detail::result_of_t<ResultFactory()>>::make_ready(std::move(result));
+    }
+
+    // the agents execute on a dedicated thread after the predecessor becomes ready
+    template<class Function, class Future, class ResultFactory, class SharedFactory>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_then_execute(Function f, size_t n, Future& predecessor, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+      return detail::bulk_then_execute_via_bulk_twoway_execute(*this, f, n, predecessor, result_factory, shared_factory);
+    }
+
+    friend bool operator==(const parallel_for_executor& a, const parallel_for_executor& b) noexcept
+    {
+      return a.schedule_ == b.schedule_;
+    }
+
+    friend bool operator!=(const parallel_for_executor& a, const parallel_for_executor& b) noexcept
+    {
+      return !(a == b);
+    }
+
+  private:
+    schedule_t schedule_;
+};
+
+
+using parallel_executor = parallel_for_executor;
+
+
+} // end omp
+} // end agency
+
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/future.hpp>
+#include <agency/execution/executor/scoped_executor.hpp>
+#include <agency/omp/execution/executor/parallel_for_executor.hpp>
+#include <agency/omp/execution/executor/simd_executor.hpp>
+#include <agency/omp/execution/executor/detail/parallel_for.hpp>
+#include <agency/omp/execution/executor/detail/bulk_then_execute.hpp>
+#include <type_traits>
+#include <utility>
+
+
+namespace agency
+{
+
+
+// this specialization executes groups created by e.g. omp::par(n, omp::unseq(m))
+// with a single #pragma omp parallel for simd loop nest rather than a parallel loop
+// whose iterations each launch a separate simd loop
+template<>
+class scoped_executor<omp::parallel_for_executor, omp::simd_executor>
+  : public executor_array<omp::simd_executor, omp::parallel_for_executor>
+{
+  private:
+    using super_t = executor_array<omp::simd_executor, omp::parallel_for_executor>;
+
+  public:
+    using outer_executor_type = omp::parallel_for_executor;
+    using inner_executor_type = omp::simd_executor;
+
+    using typename super_t::shape_type;
+    using typename super_t::index_type;
+
+    scoped_executor(const outer_executor_type& outer_ex,
+                    const inner_executor_type& inner_ex)
+      : super_t(outer_ex, 1, inner_ex)
+    {}
+
+    scoped_executor() :
+      scoped_executor(outer_executor_type(), inner_executor_type())
+    {}
+
+    template<class Function, class ResultFactory, class OuterFactory, class InnerFactory>
+    agency::future<detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, shape_type shape, ResultFactory result_factory, OuterFactory outer_factory, InnerFactory inner_factory) const
+    {
+#if _OPENMP < 201307
+      static_assert(sizeof(Function) && false, "agency::scoped_executor<omp::parallel_for_executor, omp::simd_executor> requires C++ OpenMP 4.0 or better language extensions (typically enabled with -fopenmp or /openmp).");
+#endif
+
+      using inner_shared_arg_type = detail::result_of_t<InnerFactory()>;
+
+      return bulk_twoway_execute_impl(
+        std::integral_constant<
+          bool,
+          std::is_empty<inner_shared_arg_type>::value and std::is_trivially_destructible<inner_shared_arg_type>::value
+        >(),
+        f, shape, result_factory, outer_factory, inner_factory
+      );
+    }
+
+    template<class Function, class Future, class ResultFactory, class OuterFactory, class InnerFactory>
+    agency::future<detail::result_of_t<ResultFactory()>>
+      bulk_then_execute(Function f, shape_type shape, Future& predecessor, ResultFactory result_factory, OuterFactory outer_factory, InnerFactory inner_factory) const
+    {
+      return omp::detail::bulk_then_execute_via_bulk_twoway_execute(*this, f, shape, predecessor, result_factory, outer_factory, inner_factory);
+    }
+
+  private:
+    // when the inner shared parameter carries no state, every group may share a single one,
+    // so all agents execute within one collapsed parallel for simd loop nest
+    template<class Function, class ResultFactory, class OuterFactory, class InnerFactory>
+    agency::future<detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute_impl(std::true_type, Function f, shape_type shape, ResultFactory result_factory, OuterFactory outer_factory, InnerFactory inner_factory) const
+    {
+      auto result = result_factory();
+      auto outer_shared_arg = outer_factory();
+      auto inner_shared_arg = inner_factory();
+
+      omp::detail::parallel_for_simd(this->outer_executor().query(schedule), agency::get<0>(shape), agency::get<1>(shape), [&](size_t i, size_t j)
+      {
+        f(index_type(i,j), result, outer_shared_arg, inner_shared_arg);
+      });
+
+      return agency::future<detail::result_of_t<ResultFactory()>>::make_ready(std::move(result));
+    }
+
+    // otherwise, each group creates its own inner shared parameter before executing its simd loop
+    template<class Function, class ResultFactory, class OuterFactory, class InnerFactory>
+    agency::future<detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute_impl(std::false_type, Function f, shape_type shape, ResultFactory result_factory, OuterFactory outer_factory, InnerFactory inner_factory) const
+    {
+      auto result = result_factory();
+      auto outer_shared_arg = outer_factory();
+
+      size_t inner_size = agency::get<1>(shape);
+
+      omp::detail::parallel_for(this->outer_executor().query(schedule), agency::get<0>(shape), [&](size_t i)
+      {
+        auto inner_shared_arg = inner_factory();
+
+        omp::detail::simd_for(inner_size, [&](size_t j)
+        {
+          f(index_type(i,j), result, outer_shared_arg, inner_shared_arg);
+        });
+      });
+
+      return agency::future<detail::result_of_t<ResultFactory()>>::make_ready(std::move(result));
+    }
+}; // end scoped_executor
+
+
+} // end agency
+
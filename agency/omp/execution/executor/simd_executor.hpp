@@ -0,0 +1,53 @@
+#pragma once
+
+#include <agency/detail/config.hpp>
+#include <agency/detail/type_traits.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/future/always_ready_future.hpp>
+#include <agency/omp/execution/executor/detail/parallel_for.hpp>
+
+
+namespace agency
+{
+namespace omp
+{
+
+
+class simd_executor
+{
+  public:
+    template<class T>
+    using future = always_ready_future<T>;
+
+    constexpr static bulk_guarantee_t::unsequenced_t query(const bulk_guarantee_t&)
+    {
+      return bulk_guarantee_t::unsequenced_t();
+    }
+
+    template<class Function, class ResultFactory, class SharedFactory>
+    future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, size_t n, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+#if _OPENMP < 201307
+      static_assert(sizeof(Function) && false, "agency::omp::simd_executor requires C++ OpenMP 4.0 or better language extensions (typically enabled with -fopenmp or /openmp).");
+#endif
+
+      auto result = result_factory();
+      auto shared_parm = shared_factory();
+
+      detail::simd_for(n, [&](size_t i)
+      {
+        f(i, result, shared_parm);
+      });
+
+      return agency::make_always_ready_future(std::move(result));
+    }
+};
+
+
+using unsequenced_executor = simd_executor;
+
+
+} // end omp
+} // end agency
+
@@ -31,10 +31,8 @@ T* collective_new(ConcurrentAgent& self, Args&&... args)
     ::new(ptr) T(std::forward<Args>(args)...);
   }
 
-  // we wait because .broadcast() may do side effects on self.memory_resource()
-  // XXX we can eliminate this barrier in cases where we can prove that .broadcast() does not use self.memory_resource()
-  self.wait();
-
+  // a pointer fits inside the broadcast channel, so broadcasting it leaves self.memory_resource() untouched,
+  // and the broadcast's barrier is the only one needed
   using namespace agency::experimental;
   return self.broadcast(ptr ? make_optional(ptr) : nullopt);
 }
@@ -53,6 +51,7 @@ void collective_delete(ConcurrentAgent& self, T* ptr)
     self.memory_resource().deallocate(ptr, sizeof(T));
   }
 
+  // we wait because other agents may use self.memory_resource() as soon as they return
   self.wait();
 }
 
@@ -143,10 +142,8 @@ T* collective_new_array(ConcurrentAgent& self, size_t n, Args&&... args)
     }
   }
 
-  // we wait because .broadcast() may do side effects on self.memory_resource()
-  // XXX we can eliminate this barrier in cases where we can prove that .broadcast() does not use self.memory_resource()
-  self.wait();
-
+  // a pointer fits inside the broadcast channel, so broadcasting it leaves self.memory_resource() untouched,
+  // and the broadcast's barrier is the only one needed
   using namespace agency::experimental;
   return self.broadcast(ptr ? make_optional(ptr) : nullopt);
 }
@@ -169,6 +166,7 @@ void collective_delete_array(ConcurrentAgent& self, T* ptr, size_t n)
     self.memory_resource().deallocate(ptr, n * sizeof(T));
   }
 
+  // we wait because other agents may use self.memory_resource() as soon as they return
   self.wait();
 }
 
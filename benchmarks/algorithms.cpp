@@ -0,0 +1,202 @@
+// This program compares the algorithms of <agency/algorithm.hpp> with the sequential algorithms of the C++ standard library.
+//
+// For each algorithm, the table reports the time taken by the standard algorithm and by the Agency algorithm
+// executed with seq, par, and a scoped par(seq) policy whose inner groups hold four partitions.
+// Each time is the best of several trials, in milliseconds.
+//
+// usage: algorithms [num_elements] [num_trials]
+
+#include <agency/algorithm.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <limits>
+#include <cstdlib>
+
+
+// returns the time taken by the fastest of num_trials calls to f, in milliseconds
+// setup() is called before each trial and is not timed
+template<class Setup, class Function>
+double best_time(size_t num_trials, Setup setup, Function f)
+{
+  double result = std::numeric_limits<double>::infinity();
+
+  for(size_t i = 0; i < num_trials; ++i)
+  {
+    setup();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result = std::min(result, std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  return result;
+}
+
+
+// prevents the compiler from discarding a result
+volatile long long sink;
+
+
+// each algorithm provides run_std(), which calls the standard algorithm,
+// and run(policy), which calls the Agency algorithm
+struct algorithm
+{
+  std::vector<int> input;
+  std::vector<int> data;
+  std::vector<int> result;
+
+  algorithm(size_t n)
+    : input(n), data(n), result(n)
+  {
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<int> dist(0, 1000);
+    std::generate(input.begin(), input.end(), [&]{ return dist(gen); });
+  }
+
+  void reset()
+  {
+    data = input;
+  }
+};
+
+
+struct for_each_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  struct increment
+  {
+    void operator()(int& x) const { x += 1; }
+  };
+
+  void run_std() { std::for_each(data.begin(), data.end(), increment()); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { agency::for_each(policy, data.begin(), data.end(), increment()); }
+};
+
+
+struct transform_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  struct square
+  {
+    int operator()(int x) const { return x * x; }
+  };
+
+  void run_std() { std::transform(data.begin(), data.end(), result.begin(), square()); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { agency::transform(policy, data.begin(), data.end(), result.begin(), square()); }
+};
+
+
+struct reduce_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  void run_std() { sink = std::accumulate(data.begin(), data.end(), 0ll); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { sink = agency::reduce(policy, data.begin(), data.end(), 0ll); }
+};
+
+
+struct transform_reduce_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  void run_std() { sink = std::inner_product(data.begin(), data.end(), input.begin(), 0ll); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { sink = agency::transform_reduce(policy, data.begin(), data.end(), input.begin(), 0ll); }
+};
+
+
+struct inclusive_scan_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  void run_std() { std::partial_sum(data.begin(), data.end(), result.begin()); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { agency::inclusive_scan(policy, data.begin(), data.end(), result.begin()); }
+};
+
+
+struct sort_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  void run_std() { std::sort(data.begin(), data.end()); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { agency::sort(policy, data.begin(), data.end()); }
+};
+
+
+struct partition_algorithm : algorithm
+{
+  using algorithm::algorithm;
+
+  struct is_even
+  {
+    bool operator()(int x) const { return x % 2 == 0; }
+  };
+
+  void run_std() { std::partition(data.begin(), data.end(), is_even()); }
+
+  template<class ExecutionPolicy>
+  void run(ExecutionPolicy policy) { agency::partition(policy, data.begin(), data.end(), is_even()); }
+};
+
+
+template<class Algorithm>
+void print_row(const std::string& name, size_t n, size_t num_trials)
+{
+  Algorithm a(n);
+
+  auto reset = [&]{ a.reset(); };
+
+  std::cout << std::setw(20) << name << std::fixed << std::setprecision(2)
+            << std::setw(12) << best_time(num_trials, reset, [&]{ a.run_std(); })
+            << std::setw(12) << best_time(num_trials, reset, [&]{ a.run(agency::seq); })
+            << std::setw(12) << best_time(num_trials, reset, [&]{ a.run(agency::par); })
+            << std::setw(16) << best_time(num_trials, reset, [&]{ a.run(agency::par(1, agency::seq(4))); })
+            << std::endl;
+}
+
+
+int main(int argc, char** argv)
+{
+  size_t n = argc > 1 ? std::atoi(argv[1]) : 1 << 24;
+  size_t num_trials = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::cout << "milliseconds to process " << n << " ints" << std::endl;
+  std::cout << std::setw(20) << "algorithm"
+            << std::setw(12) << "std"
+            << std::setw(12) << "seq"
+            << std::setw(12) << "par"
+            << std::setw(16) << "par(seq(4))"
+            << std::endl;
+
+  print_row<for_each_algorithm>("for_each", n, num_trials);
+  print_row<transform_algorithm>("transform", n, num_trials);
+  print_row<reduce_algorithm>("reduce", n, num_trials);
+  print_row<transform_reduce_algorithm>("transform_reduce", n, num_trials);
+  print_row<inclusive_scan_algorithm>("inclusive_scan", n, num_trials);
+  print_row<sort_algorithm>("sort", n, num_trials);
+  print_row<partition_algorithm>("partition", n, num_trials);
+
+  return 0;
+}
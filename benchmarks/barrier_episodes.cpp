@@ -0,0 +1,109 @@
+// This program compares the barriers in agency/detail/concurrency/barrier.hpp by measuring
+// the number of barrier episodes per second completed by groups of threads of increasing size.
+// It also measures concurrent_agent::wait(), which uses the default barrier.
+//
+// usage: barrier_episodes [num_episodes] [max_group_size]
+
+#include <agency/agency.hpp>
+#include <agency/detail/concurrency/barrier.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <string>
+#include <cstdlib>
+
+
+template<class Barrier>
+double episodes_per_second(size_t group_size, size_t num_episodes)
+{
+  Barrier barrier(group_size);
+
+  auto body = [&]
+  {
+    for(size_t i = 0; i < num_episodes; ++i)
+    {
+      barrier.arrive_and_wait();
+    }
+  };
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  std::vector<std::thread> threads;
+  for(size_t i = 1; i < group_size; ++i)
+  {
+    threads.emplace_back(body);
+  }
+
+  body();
+
+  for(auto& t : threads)
+  {
+    t.join();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return num_episodes / std::chrono::duration<double>(end - start).count();
+}
+
+
+double concurrent_agent_episodes_per_second(size_t group_size, size_t num_episodes)
+{
+  using namespace agency;
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  bulk_invoke(con(group_size), [=](concurrent_agent& self)
+  {
+    for(size_t i = 0; i < num_episodes; ++i)
+    {
+      self.wait();
+    }
+  });
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return num_episodes / std::chrono::duration<double>(end - start).count();
+}
+
+
+int main(int argc, char** argv)
+{
+  using namespace agency::detail;
+
+  size_t num_episodes = argc > 1 ? std::atoi(argv[1]) : 10000;
+  size_t max_group_size = argc > 2 ? std::atoi(argv[2]) : 2 * std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "barrier episodes per second" << std::endl;
+  std::cout << std::setw(8) << "threads"
+            << std::setw(20) << "blocking_barrier"
+            << std::setw(20) << "spinning_barrier"
+            << std::setw(20) << "synchronic_barrier"
+            << std::setw(20) << "concurrent_agent"
+            << std::endl;
+
+  for(size_t group_size = 1; group_size <= max_group_size; group_size *= 2)
+  {
+    std::cout << std::setw(8) << group_size << std::fixed << std::setprecision(0)
+              << std::setw(20) << episodes_per_second<blocking_barrier>(group_size, num_episodes);
+
+    // spinning_barrier never yields, so it livelocks when there are more threads than cpus
+    if(group_size <= std::thread::hardware_concurrency())
+    {
+      std::cout << std::setw(20) << episodes_per_second<spinning_barrier>(group_size, num_episodes);
+    }
+    else
+    {
+      std::cout << std::setw(20) << "-";
+    }
+
+    std::cout << std::setw(20) << episodes_per_second<synchronic_barrier>(group_size, num_episodes)
+              << std::setw(20) << concurrent_agent_episodes_per_second(group_size, num_episodes)
+              << std::endl;
+  }
+
+  return 0;
+}
+
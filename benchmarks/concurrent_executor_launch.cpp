@@ -0,0 +1,91 @@
+// This program measures the latency of launching groups of concurrent agents with bulk_invoke(con(n), ...)
+// for group sizes 2 through 1024. For comparison, it also measures the latency of creating & joining
+// a new thread per agent, which is how concurrent_executor formerly launched its agents.
+//
+// usage: concurrent_executor_launch [num_launches]
+
+#include <agency/agency.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+
+
+// returns the mean time in microseconds of the given launch
+template<class Function>
+double time_launch(Function launch, size_t num_launches)
+{
+  // warm up
+  launch();
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(size_t i = 0; i < num_launches; ++i)
+  {
+    launch();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::micro>(end - start).count() / num_launches;
+}
+
+
+int main(int argc, char** argv)
+{
+  using namespace agency;
+
+  size_t num_launches = argc > 1 ? std::atoi(argv[1]) : 100;
+
+  std::cout << "mean launch latency in microseconds" << std::endl;
+  std::cout << std::setw(8) << "agents"
+            << std::setw(16) << "con(n)"
+            << std::setw(20) << "con(n) + wait()"
+            << std::setw(20) << "thread per agent"
+            << std::endl;
+
+  for(size_t n = 2; n <= 1024; n *= 2)
+  {
+    double con_time = time_launch([=]
+    {
+      bulk_invoke(con(n), [](concurrent_agent&)
+      {
+      });
+    }, num_launches);
+
+    // each agent synchronizes once with the rest of its group
+    double barrier_time = time_launch([=]
+    {
+      bulk_invoke(con(n), [](concurrent_agent& self)
+      {
+        self.wait();
+      });
+    }, num_launches);
+
+    double thread_time = time_launch([=]
+    {
+      std::vector<std::thread> threads;
+
+      for(size_t i = 1; i < n; ++i)
+      {
+        threads.emplace_back([]{});
+      }
+
+      for(auto& t : threads)
+      {
+        t.join();
+      }
+    }, num_launches);
+
+    std::cout << std::setw(8) << n
+              << std::setw(16) << std::fixed << std::setprecision(1) << con_time
+              << std::setw(20) << barrier_time
+              << std::setw(20) << thread_time
+              << std::endl;
+  }
+
+  return 0;
+}
+
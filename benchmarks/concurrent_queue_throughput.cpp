@@ -0,0 +1,155 @@
+// This program compares the concurrent queues in agency/detail/concurrency/concurrent_queue.hpp
+// by measuring the throughput of pushes & pops and the latency between pushing an item and popping it
+// for increasing numbers of producers & consumers.
+//
+// usage: concurrent_queue_throughput [num_items_per_producer]
+
+#include <agency/detail/concurrency/concurrent_queue.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+
+
+using clock_type = std::chrono::steady_clock;
+
+
+struct measurement
+{
+  double items_per_second;
+  double median_latency;
+  double p99_latency;
+  double max_latency;
+};
+
+
+template<class Queue>
+measurement measure(size_t num_producers, size_t num_consumers, size_t num_items_per_producer)
+{
+  // each item is the time at which it was pushed
+  Queue queue;
+
+  std::atomic<size_t> num_popped(0);
+  size_t num_items = num_producers * num_items_per_producer;
+
+  std::vector<std::vector<double>> latencies(num_consumers);
+
+  std::vector<std::thread> consumers;
+  for(size_t i = 0; i < num_consumers; ++i)
+  {
+    consumers.emplace_back([&,i]
+    {
+      latencies[i].reserve(num_items / num_consumers + 1);
+
+      clock_type::time_point pushed;
+      while(queue.wait_and_pop(pushed))
+      {
+        latencies[i].push_back(std::chrono::duration<double, std::nano>(clock_type::now() - pushed).count());
+        ++num_popped;
+      }
+    });
+  }
+
+  auto start = clock_type::now();
+
+  std::vector<std::thread> producers;
+  for(size_t i = 0; i < num_producers; ++i)
+  {
+    producers.emplace_back([&]
+    {
+      for(size_t j = 0; j < num_items_per_producer; ++j)
+      {
+        queue.emplace(clock_type::now());
+      }
+    });
+  }
+
+  for(auto& t : producers)
+  {
+    t.join();
+  }
+
+  while(num_popped < num_items)
+  {
+    std::this_thread::yield();
+  }
+
+  auto end = clock_type::now();
+
+  queue.close();
+
+  for(auto& t : consumers)
+  {
+    t.join();
+  }
+
+  std::vector<double> all_latencies;
+  for(auto& l : latencies)
+  {
+    all_latencies.insert(all_latencies.end(), l.begin(), l.end());
+  }
+
+  std::sort(all_latencies.begin(), all_latencies.end());
+
+  measurement result;
+  result.items_per_second = num_items / std::chrono::duration<double>(end - start).count();
+  result.median_latency = all_latencies[all_latencies.size() / 2];
+  result.p99_latency = all_latencies[(all_latencies.size() * 99) / 100];
+  result.max_latency = all_latencies.back();
+
+  return result;
+}
+
+
+template<class Queue>
+void report(const std::string& name, size_t max_num_threads, size_t num_items_per_producer)
+{
+  for(size_t num_producers = 1; num_producers <= max_num_threads; num_producers *= 2)
+  {
+    for(size_t num_consumers = 1; num_consumers <= max_num_threads; num_consumers *= 2)
+    {
+      measurement m = measure<Queue>(num_producers, num_consumers, num_items_per_producer);
+
+      std::cout << std::setw(38) << name
+                << std::setw(10) << num_producers
+                << std::setw(10) << num_consumers
+                << std::setw(14) << std::fixed << std::setprecision(0) << m.items_per_second
+                << std::setw(12) << m.median_latency
+                << std::setw(12) << m.p99_latency
+                << std::setw(12) << m.max_latency
+                << std::endl;
+    }
+  }
+}
+
+
+int main(int argc, char** argv)
+{
+  using namespace agency::detail;
+
+  size_t num_items_per_producer = argc > 1 ? std::atoi(argv[1]) : 1 << 16;
+
+  size_t max_num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "push/pop throughput in items per second and push-to-pop latency in nanoseconds" << std::endl;
+  std::cout << std::setw(38) << "queue"
+            << std::setw(10) << "producers"
+            << std::setw(10) << "consumers"
+            << std::setw(14) << "items/s"
+            << std::setw(12) << "median"
+            << std::setw(12) << "p99"
+            << std::setw(12) << "max"
+            << std::endl;
+
+  report<synchronic_concurrent_queue<clock_type::time_point>>("synchronic_concurrent_queue", max_num_threads, num_items_per_producer);
+  report<condition_variable_concurrent_queue<clock_type::time_point>>("condition_variable_concurrent_queue", max_num_threads, num_items_per_producer);
+  report<lock_free_concurrent_queue<clock_type::time_point>>("lock_free_concurrent_queue", max_num_threads, num_items_per_producer);
+
+  return 0;
+}
+
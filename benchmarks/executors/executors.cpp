@@ -0,0 +1,284 @@
+// This program measures the cost of creating execution agents with Agency's execution policies and executors.
+//
+// For each execution policy, the program measures
+//   * the latency of bulk_invoke, bulk_async, and bulk_then launching a single agent which does nothing,
+//   * the number of agents per second executed by a bulk_invoke of many agents which do nothing, and
+//   * the time per link to create and wait on chains of bulk_then continuations of increasing depth.
+// For execution policies whose agents are concurrent, the program also measures
+//   * the number of barrier episodes per second completed by a group of agents, and
+//   * the time for one agent of a group to broadcast a value to the rest of the group.
+//
+// Each measurement is the median of several trials. The measurements are printed to standard output
+// as a JSON document, so that the results of different versions of Agency may be compared by other programs.
+//
+// usage: executors [num_trials]
+
+#include <agency/agency.hpp>
+#include <agency/execution/executor/executor_array.hpp>
+#include <agency/execution/executor/flattened_executor.hpp>
+#include <agency/execution/executor/variant_executor.hpp>
+#include <agency/omp.hpp>
+#include <agency/version.hpp>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+
+struct result
+{
+  std::string executor;
+  std::string benchmark;
+  std::string unit;
+  size_t num_agents;
+  size_t depth;
+  double value;
+};
+
+
+// prints results as a JSON document
+void print_json(std::ostream& os, const std::vector<result>& results, size_t num_trials)
+{
+  os << "{" << std::endl;
+  os << "  \"agency_version\": \"" << AGENCY_MAJOR_VERSION << "." << AGENCY_MINOR_VERSION << "." << AGENCY_SUBMINOR_VERSION << "\"," << std::endl;
+  os << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << "," << std::endl;
+  os << "  \"num_trials\": " << num_trials << "," << std::endl;
+  os << "  \"results\": [" << std::endl;
+
+  for(size_t i = 0; i < results.size(); ++i)
+  {
+    const result& r = results[i];
+
+    os << "    {"
+       << "\"executor\": \"" << r.executor << "\", "
+       << "\"benchmark\": \"" << r.benchmark << "\", "
+       << "\"num_agents\": " << r.num_agents << ", ";
+
+    if(r.depth > 0)
+    {
+      os << "\"depth\": " << r.depth << ", ";
+    }
+
+    os << "\"unit\": \"" << r.unit << "\", "
+       << "\"value\": " << r.value
+       << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+
+  os << "  ]" << std::endl;
+  os << "}" << std::endl;
+}
+
+
+// returns the median over num_trials of the time taken by a call to f, in microseconds
+// each trial calls f num_repetitions times and reports the average
+template<class Function>
+double median_microseconds(size_t num_trials, size_t num_repetitions, Function f)
+{
+  std::vector<double> times;
+
+  for(size_t trial = 0; trial < num_trials; ++trial)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for(size_t i = 0; i < num_repetitions; ++i)
+    {
+      f();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    times.push_back(std::chrono::duration<double, std::micro>(end - start).count() / num_repetitions);
+  }
+
+  std::sort(times.begin(), times.end());
+
+  return times[times.size() / 2];
+}
+
+
+struct empty_function
+{
+  template<class Agent>
+  void operator()(Agent&) const
+  {
+    // keep the compiler from eliding agents which do nothing
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+  }
+};
+
+
+void barrier(agency::concurrent_agent& self)
+{
+  self.wait();
+}
+
+void barrier(agency::parallel_group<agency::concurrent_agent>& self)
+{
+  self.inner().wait();
+}
+
+
+int broadcast(agency::concurrent_agent& self, int value)
+{
+  return self.broadcast(self.rank() == 0 ? agency::experimental::make_optional(value) : agency::experimental::nullopt);
+}
+
+int broadcast(agency::parallel_group<agency::concurrent_agent>& self, int value)
+{
+  return broadcast(self.inner(), value);
+}
+
+
+struct barrier_function
+{
+  size_t num_episodes;
+
+  template<class Agent>
+  void operator()(Agent& self) const
+  {
+    for(size_t i = 0; i < num_episodes; ++i)
+    {
+      barrier(self);
+    }
+  }
+};
+
+
+struct broadcast_function
+{
+  size_t num_broadcasts;
+
+  template<class Agent>
+  void operator()(Agent& self) const
+  {
+    for(size_t i = 0; i < num_broadcasts; ++i)
+    {
+      int value = broadcast(self, int(i));
+
+      if(value != int(i))
+      {
+        std::cerr << "broadcast_function: received the wrong value" << std::endl;
+        std::abort();
+      }
+    }
+  }
+};
+
+
+// PolicyFactory is a function which returns an execution policy creating a given number of agents
+template<class PolicyFactory>
+void measure_launches(std::vector<result>& results, const std::string& executor, PolicyFactory policy, size_t num_agents, size_t num_trials)
+{
+  results.push_back(result{executor, "bulk_invoke_latency", "microseconds", 1, 0, median_microseconds(num_trials, 100, [&]
+  {
+    agency::bulk_invoke(policy(1), empty_function());
+  })});
+
+  results.push_back(result{executor, "bulk_async_latency", "microseconds", 1, 0, median_microseconds(num_trials, 100, [&]
+  {
+    agency::bulk_async(policy(1), empty_function()).wait();
+  })});
+
+  results.push_back(result{executor, "bulk_then_latency", "microseconds", 1, 0, median_microseconds(num_trials, 100, [&]
+  {
+    auto predecessor = agency::make_ready_future<void>(policy(1).executor());
+    agency::bulk_then(policy(1), empty_function(), predecessor).wait();
+  })});
+
+  double microseconds = median_microseconds(num_trials, 1, [&]
+  {
+    agency::bulk_invoke(policy(num_agents), empty_function());
+  });
+
+  results.push_back(result{executor, "agents_per_second", "agents/second", num_agents, 0, num_agents / (microseconds / 1000000)});
+
+  for(size_t depth = 1; depth <= 1024; depth *= 32)
+  {
+    double microseconds = median_microseconds(num_trials, 1024 / depth, [&]
+    {
+      auto future = agency::make_ready_future<void>(policy(1).executor());
+
+      for(size_t i = 0; i < depth; ++i)
+      {
+        future = agency::bulk_then(policy(1), empty_function(), future);
+      }
+
+      future.wait();
+    });
+
+    results.push_back(result{executor, "future_chaining", "microseconds/link", 1, depth, microseconds / depth});
+  }
+}
+
+
+template<class PolicyFactory>
+void measure_collectives(std::vector<result>& results, const std::string& executor, PolicyFactory policy, size_t group_size, size_t num_trials)
+{
+  const size_t num_episodes = 1000;
+
+  double microseconds = median_microseconds(num_trials, 1, [&]
+  {
+    agency::bulk_invoke(policy(group_size), barrier_function{num_episodes});
+  });
+
+  results.push_back(result{executor, "barrier_episodes_per_second", "episodes/second", group_size, 0, num_episodes / (microseconds / 1000000)});
+
+  microseconds = median_microseconds(num_trials, 1, [&]
+  {
+    agency::bulk_invoke(policy(group_size), broadcast_function{num_episodes});
+  });
+
+  results.push_back(result{executor, "broadcast_latency", "microseconds", group_size, 0, microseconds / num_episodes});
+}
+
+
+int main(int argc, char** argv)
+{
+  using namespace agency;
+
+  size_t num_trials = argc > 1 ? std::atoi(argv[1]) : 5;
+
+  // each concurrent agent requires a thread, so fewer are created
+  const size_t num_agents = 1 << 20;
+  const size_t num_concurrent_agents = 1 << 10;
+  const size_t group_size = std::max(2u, std::thread::hardware_concurrency());
+
+  // executor_array's inner executors execute groups of concurrent agents, and its outer executor executes the groups in parallel
+  using executor_array_type = executor_array<concurrent_executor, parallel_executor>;
+  executor_array_type array(group_size);
+
+  flattened_executor<executor_array_type> flattened(array);
+
+  // the sequenced and parallel alternatives of variant_executor have only the unsequenced guarantee in common
+  variant_executor<sequenced_executor, parallel_executor> variant = parallel_executor();
+
+  std::vector<result> results;
+
+  measure_launches(results, "seq",   [](size_t n){ return seq(n); },   num_agents, num_trials);
+  measure_launches(results, "par",   [](size_t n){ return par(n); },   num_agents, num_trials);
+  measure_launches(results, "con",   [](size_t n){ return con(n); },   num_concurrent_agents, num_trials);
+  measure_launches(results, "unseq", [](size_t n){ return unseq(n); }, num_agents, num_trials);
+  measure_launches(results, "omp::par", [](size_t n){ return omp::par(n); }, num_agents, num_trials);
+
+  // executor_array creates groups of at most group_size agents
+  auto array_policy = [&](size_t n)
+  {
+    return par((n + group_size - 1) / group_size, con(std::min(n, group_size))).on(array);
+  };
+
+  measure_launches(results, "executor_array", array_policy, num_concurrent_agents, num_trials);
+  measure_launches(results, "flattened_executor", [&](size_t n){ return par(n).on(flattened); }, num_concurrent_agents, num_trials);
+  measure_launches(results, "variant_executor", [&](size_t n){ return unseq(n).on(variant); }, num_agents, num_trials);
+
+  measure_collectives(results, "con", [](size_t n){ return con(n); }, group_size, num_trials);
+  measure_collectives(results, "executor_array", array_policy, group_size, num_trials);
+
+  print_json(std::cout, results, num_trials);
+
+  return 0;
+}
+
@@ -0,0 +1,211 @@
+// This program compares pooled_resource with cached_resource and with plain malloc.
+//
+// The throughput table reports millions of allocate/deallocate pairs per second completed by groups of threads
+// of increasing size. Each thread keeps a window of live blocks and repeatedly replaces a random block of the window
+// with a new block of random size. Most sizes are small, as they are for the storage of containers of agent-shared parameters.
+//
+// The fragmentation table runs the same workload on a single thread and reports the number of bytes each resource holds
+// from its upstream resource, relative to the peak number of bytes which were live at once.
+//
+// usage: memory_resource_throughput [num_operations_per_thread] [max_num_threads]
+
+#include <agency/memory/detail/resource/malloc_resource.hpp>
+#include <agency/memory/detail/resource/cached_resource.hpp>
+#include <agency/memory/detail/resource/pooled_resource.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <random>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+
+
+// globally_cached_resource requires its upstream resource to be ordered
+struct ordered_malloc_resource : agency::detail::malloc_resource
+{
+  bool operator==(const ordered_malloc_resource&) const { return true; }
+  bool operator!=(const ordered_malloc_resource&) const { return false; }
+  bool operator<(const ordered_malloc_resource&) const { return false; }
+};
+
+
+// counts the bytes held from malloc
+struct counting_malloc_resource : agency::detail::malloc_resource
+{
+  static std::atomic<size_t>& bytes()
+  {
+    static std::atomic<size_t> result(0);
+    return result;
+  }
+
+  void* allocate(size_t num_bytes)
+  {
+    bytes() += num_bytes;
+    return agency::detail::malloc_resource::allocate(num_bytes);
+  }
+
+  void deallocate(void* ptr, size_t num_bytes)
+  {
+    bytes() -= num_bytes;
+    agency::detail::malloc_resource::deallocate(ptr, num_bytes);
+  }
+};
+
+
+struct workload
+{
+  // each operation replaces the block in slots[i] with a new block of sizes[i]
+  std::vector<size_t> slots;
+  std::vector<size_t> sizes;
+  size_t window;
+
+  workload(size_t num_operations, size_t window, unsigned int seed)
+    : slots(num_operations), sizes(num_operations), window(window)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<size_t> slot(0, window - 1);
+
+    // 80% of blocks are at most 256 bytes, 18% are at most 4 KiB, and 2% are at most 64 KiB
+    std::uniform_int_distribution<int> percent(0, 99);
+    std::uniform_int_distribution<size_t> small(8, 256), medium(257, 4096), large(4097, 65536);
+
+    for(size_t i = 0; i < num_operations; ++i)
+    {
+      slots[i] = slot(gen);
+
+      int p = percent(gen);
+      sizes[i] = p < 80 ? small(gen) : (p < 98 ? medium(gen) : large(gen));
+    }
+  }
+
+  // runs the workload and returns the peak number of bytes which were live at once
+  template<class MemoryResource>
+  size_t run(MemoryResource& resource) const
+  {
+    std::vector<std::pair<void*,size_t>> live(window, std::make_pair(nullptr, 0));
+
+    size_t live_bytes = 0;
+    size_t peak_live_bytes = 0;
+
+    for(size_t i = 0; i < slots.size(); ++i)
+    {
+      auto& block = live[slots[i]];
+
+      if(block.first)
+      {
+        resource.deallocate(block.first, block.second);
+        live_bytes -= block.second;
+      }
+
+      block = std::make_pair(resource.allocate(sizes[i]), sizes[i]);
+      live_bytes += sizes[i];
+      peak_live_bytes = std::max(peak_live_bytes, live_bytes);
+    }
+
+    for(auto& block : live)
+    {
+      if(block.first) resource.deallocate(block.first, block.second);
+    }
+
+    return peak_live_bytes;
+  }
+};
+
+
+template<class MemoryResource>
+double millions_of_operations_per_second(size_t num_threads, size_t num_operations)
+{
+  std::vector<workload> workloads;
+  for(size_t t = 0; t < num_threads; ++t)
+  {
+    workloads.emplace_back(num_operations, 1024, t);
+  }
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  std::vector<std::thread> threads;
+  for(size_t t = 0; t < num_threads; ++t)
+  {
+    threads.emplace_back([&,t]
+    {
+      MemoryResource resource;
+      workloads[t].run(resource);
+    });
+  }
+
+  for(auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return num_threads * num_operations / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+
+template<class MemoryResource>
+double fragmentation(const workload& w)
+{
+  size_t peak_live_bytes = 0;
+  size_t held_bytes = 0;
+
+  {
+    MemoryResource resource;
+    peak_live_bytes = w.run(resource);
+
+    // both resources hold on to every block until they are destroyed
+    held_bytes = counting_malloc_resource::bytes();
+  }
+
+  return double(held_bytes) / peak_live_bytes;
+}
+
+
+int main(int argc, char** argv)
+{
+  using namespace agency::detail;
+
+  size_t num_operations = argc > 1 ? std::atoi(argv[1]) : 200000;
+  size_t max_num_threads = argc > 2 ? std::atoi(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "millions of allocate/deallocate pairs per second" << std::endl;
+  std::cout << std::setw(8) << "threads"
+            << std::setw(16) << "malloc"
+            << std::setw(28) << "globally_cached_resource"
+            << std::setw(28) << "globally_pooled_resource"
+            << std::endl;
+
+  for(size_t num_threads = 1; num_threads <= max_num_threads; num_threads *= 2)
+  {
+    std::cout << std::setw(8) << num_threads << std::fixed << std::setprecision(2)
+              << std::setw(16) << millions_of_operations_per_second<malloc_resource>(num_threads, num_operations)
+              << std::setw(28) << millions_of_operations_per_second<globally_cached_resource<ordered_malloc_resource>>(num_threads, num_operations)
+              << std::setw(28) << millions_of_operations_per_second<globally_pooled_resource<malloc_resource>>(num_threads, num_operations)
+              << std::endl;
+  }
+
+  std::cout << std::endl;
+
+  std::cout << "bytes held from upstream / peak live bytes" << std::endl;
+  std::cout << std::setw(12) << "operations"
+            << std::setw(20) << "cached_resource"
+            << std::setw(20) << "pooled_resource"
+            << std::endl;
+
+  for(size_t n = 1000; n <= num_operations; n *= 10)
+  {
+    workload w(n, 1024, 0);
+
+    std::cout << std::setw(12) << n << std::fixed << std::setprecision(2)
+              << std::setw(20) << fragmentation<cached_resource<counting_malloc_resource>>(w)
+              << std::setw(20) << fragmentation<pooled_resource<counting_malloc_resource>>(w)
+              << std::endl;
+  }
+
+  return 0;
+}
+
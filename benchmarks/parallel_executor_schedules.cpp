@@ -0,0 +1,111 @@
+// This program compares the uniform, dynamic and guided schedules of agency::parallel_executor
+// on workloads whose agents have uniform and skewed costs.
+//
+// usage: parallel_executor_schedules [num_agents] [num_trials]
+
+#include <agency/agency.hpp>
+#include <agency/execution/executor/parallel_executor.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+
+// performs an amount of work proportional to cost and returns a value which depends on it
+inline double work(size_t cost)
+{
+  double result = 0;
+  for(size_t i = 0; i < cost; ++i)
+  {
+    result += 1.0 / (i + 1);
+  }
+
+  return result;
+}
+
+
+// returns the mean time in milliseconds of a launch whose agent i performs cost(i) work
+template<class Executor, class CostFunction>
+double time_launch(Executor exec, size_t num_agents, size_t num_trials, CostFunction cost)
+{
+  using namespace agency;
+
+  std::vector<double> results(num_agents);
+
+  auto launch = [&]
+  {
+    bulk_invoke(par(num_agents).on(exec), [&](parallel_agent& self)
+    {
+      results[self.index()] = work(cost(self.index()));
+    });
+  };
+
+  // warm up
+  launch();
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(size_t i = 0; i < num_trials; ++i)
+  {
+    launch();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::milli>(end - start).count() / num_trials;
+}
+
+
+template<class CostFunction>
+void compare_schedules(const std::string& workload_name, size_t num_agents, size_t num_trials, CostFunction cost)
+{
+  using namespace agency;
+
+  parallel_executor uniform_exec;
+  auto dynamic_exec = require(uniform_exec, schedule.dynamic(16));
+  auto guided_exec  = require(uniform_exec, schedule.guided(4));
+
+  double uniform_time = time_launch(uniform_exec, num_agents, num_trials, cost);
+  double dynamic_time = time_launch(dynamic_exec, num_agents, num_trials, cost);
+  double guided_time  = time_launch(guided_exec,  num_agents, num_trials, cost);
+
+  std::cout << std::setw(12) << workload_name
+            << std::setw(12) << std::fixed << std::setprecision(3) << uniform_time
+            << std::setw(12) << dynamic_time
+            << std::setw(12) << guided_time
+            << std::endl;
+}
+
+
+int main(int argc, char** argv)
+{
+  size_t num_agents = argc > 1 ? std::atoi(argv[1]) : 1 << 14;
+  size_t num_trials = argc > 2 ? std::atoi(argv[2]) : 20;
+
+  size_t num_threads = agency::detail::system_thread_pool().size();
+
+  std::cout << "bulk_invoke(par(" << num_agents << "), ...) mean launch time in milliseconds on " << num_threads << " threads" << std::endl;
+  std::cout << std::setw(12) << "workload" << std::setw(12) << "uniform" << std::setw(12) << "dynamic(16)" << std::setw(12) << "guided(4)" << std::endl;
+
+  // every agent performs the same amount of work
+  compare_schedules("uniform", num_agents, num_trials, [](size_t)
+  {
+    return size_t(1000);
+  });
+
+  // the agents of the first block perform nearly all of the work
+  compare_schedules("skewed", num_agents, num_trials, [=](size_t i)
+  {
+    return i < num_agents / 8 ? size_t(7000) : size_t(100);
+  });
+
+  // the cost of each agent grows with its index
+  compare_schedules("triangular", num_agents, num_trials, [=](size_t i)
+  {
+    return (2000 * i) / num_agents;
+  });
+
+  return 0;
+}
@@ -0,0 +1,78 @@
+// This program compares the shared_queue and work_stealing scheduling policies of
+// agency::detail::thread_pool by timing fine-grained bulk_invoke(par(n), ...) launches
+// on thread pools of increasing size.
+//
+// usage: thread_pool_scheduling [num_agents_per_launch] [num_launches]
+
+#include <agency/agency.hpp>
+#include <agency/execution/executor/parallel_executor.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+
+// returns the mean time in nanoseconds of a fine-grained launch on a pool with the given configuration
+double time_launch(size_t num_threads, agency::detail::thread_pool::scheduling_policy policy, size_t num_agents, size_t num_launches)
+{
+  using namespace agency;
+
+  detail::thread_pool pool(num_threads, policy);
+
+  // compose an executor like agency::parallel_executor whose outer executor uses our pool
+  using base_executor_type = scoped_executor<detail::thread_pool_executor, this_thread::parallel_executor>;
+  detail::parallel_thread_pool_executor exec{base_executor_type(detail::thread_pool_executor(pool), this_thread::parallel_executor())};
+
+  std::vector<int> data(num_agents, 1);
+
+  auto launch = [&]
+  {
+    bulk_invoke(par(num_agents).on(exec), [&](parallel_agent& self)
+    {
+      // a tiny amount of work per agent
+      data[self.index()] += 1;
+    });
+  };
+
+  // warm up
+  launch();
+
+  auto start = std::chrono::high_resolution_clock::now();
+
+  for(size_t i = 0; i < num_launches; ++i)
+  {
+    launch();
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+
+  return std::chrono::duration<double, std::nano>(end - start).count() / num_launches;
+}
+
+
+int main(int argc, char** argv)
+{
+  size_t num_agents = argc > 1 ? std::atoi(argv[1]) : 1 << 10;
+  size_t num_launches = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+  size_t max_num_threads = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "bulk_invoke(par(" << num_agents << "), ...) mean launch latency in nanoseconds" << std::endl;
+  std::cout << std::setw(10) << "threads" << std::setw(16) << "shared_queue" << std::setw(16) << "work_stealing" << std::setw(10) << "speedup" << std::endl;
+
+  for(size_t num_threads = 1; num_threads <= max_num_threads; num_threads *= 2)
+  {
+    double shared_queue_time = time_launch(num_threads, agency::detail::thread_pool::shared_queue, num_agents, num_launches);
+    double work_stealing_time = time_launch(num_threads, agency::detail::thread_pool::work_stealing, num_agents, num_launches);
+
+    std::cout << std::setw(10) << num_threads
+              << std::setw(16) << std::fixed << std::setprecision(0) << shared_queue_time
+              << std::setw(16) << work_stealing_time
+              << std::setw(10) << std::setprecision(2) << shared_queue_time / work_stealing_time
+              << std::endl;
+  }
+
+  return 0;
+}
@@ -0,0 +1,125 @@
+// This program measures how the order in which a two-dimensional par2d launch creates its agents affects
+// the time taken by a 2D stencil and a matrix transpose over row-major arrays.
+//
+// Each kernel runs on the parallel_executor directly, which creates agents with the first dimension of their index
+// varying fastest, and through experimental::traversal_executor with lexicographic, tiled, and Morton traversals.
+// Each agent processes a single element, and its index is the same regardless of traversal.
+// Each time is the best of several trials, in milliseconds.
+//
+// usage: traversal_order [n] [num_trials]
+//   n is the extent of each dimension of the square arrays
+
+#include <agency/agency.hpp>
+#include <agency/execution/executor/experimental/traversal_executor.hpp>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <limits>
+#include <string>
+#include <cstdlib>
+
+
+// returns the time taken by the fastest of num_trials calls to f, in milliseconds
+template<class Function>
+double best_time(size_t num_trials, Function f)
+{
+  double result = std::numeric_limits<double>::infinity();
+
+  for(size_t i = 0; i < num_trials; ++i)
+  {
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result = std::min(result, std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  return result;
+}
+
+
+// each element of out becomes the average of the corresponding element of in and its four neighbors
+template<class Executor>
+void stencil(const Executor& exec, size_t n, const std::vector<float>& in, std::vector<float>& out)
+{
+  const float* in_ptr = in.data();
+  float* out_ptr = out.data();
+
+  agency::bulk_invoke(agency::par2d(agency::size2(0,0), agency::size2(n,n)).on(exec), [=](agency::parallel_agent_2d& self)
+  {
+    size_t i = self.index()[0];
+    size_t j = self.index()[1];
+
+    float sum = in_ptr[i * n + j];
+    sum += i > 0     ? in_ptr[(i - 1) * n + j] : 0.f;
+    sum += i + 1 < n ? in_ptr[(i + 1) * n + j] : 0.f;
+    sum += j > 0     ? in_ptr[i * n + j - 1]   : 0.f;
+    sum += j + 1 < n ? in_ptr[i * n + j + 1]   : 0.f;
+
+    out_ptr[i * n + j] = sum / 5.f;
+  });
+}
+
+
+template<class Executor>
+void transpose(const Executor& exec, size_t n, const std::vector<float>& in, std::vector<float>& out)
+{
+  const float* in_ptr = in.data();
+  float* out_ptr = out.data();
+
+  agency::bulk_invoke(agency::par2d(agency::size2(0,0), agency::size2(n,n)).on(exec), [=](agency::parallel_agent_2d& self)
+  {
+    size_t i = self.index()[0];
+    size_t j = self.index()[1];
+
+    out_ptr[j * n + i] = in_ptr[i * n + j];
+  });
+}
+
+
+template<class Executor>
+void report(const std::string& name, const Executor& exec, size_t n, size_t num_trials, const std::vector<float>& in, std::vector<float>& out)
+{
+  std::cout << std::setw(24) << name << std::fixed << std::setprecision(2)
+            << std::setw(12) << best_time(num_trials, [&]{ stencil(exec, n, in, out); })
+            << std::setw(12) << best_time(num_trials, [&]{ transpose(exec, n, in, out); })
+            << std::endl;
+}
+
+
+template<class Traversal>
+agency::experimental::traversal_executor<agency::parallel_executor, Traversal> traverse()
+{
+  return agency::experimental::traversal_executor<agency::parallel_executor, Traversal>();
+}
+
+
+int main(int argc, char** argv)
+{
+  using namespace agency::experimental;
+
+  size_t n = argc > 1 ? std::atoi(argv[1]) : 2048;
+  size_t num_trials = argc > 2 ? std::atoi(argv[2]) : 5;
+
+  std::vector<float> in(n * n), out(n * n);
+  for(size_t i = 0; i < in.size(); ++i)
+  {
+    in[i] = static_cast<float>(i % 101);
+  }
+
+  std::cout << "milliseconds to process " << n << " x " << n << " floats" << std::endl;
+  std::cout << std::setw(24) << "traversal"
+            << std::setw(12) << "stencil"
+            << std::setw(12) << "transpose"
+            << std::endl;
+
+  report("parallel_executor",  agency::parallel_executor(),                     n, num_trials, in, out);
+  report("lexicographic",      traverse<lexicographic_traversal>(),             n, num_trials, in, out);
+  report("tiled<16,16>",       traverse<tiled_traversal<16,16>>(),              n, num_trials, in, out);
+  report("tiled<64,64>",       traverse<tiled_traversal<64,64>>(),              n, num_trials, in, out);
+  report("morton",             traverse<morton_traversal>(),                    n, num_trials, in, out);
+
+  return 0;
+}
+
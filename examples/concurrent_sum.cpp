@@ -1,5 +1,6 @@
 #include <agency/agency.hpp>
 #include <vector>
+#include <functional>
 
 int sum(const std::vector<int>& data)
 {
@@ -38,6 +39,26 @@ int sum(const std::vector<int>& data)
   });
 }
 
+int sum_with_reduce(const std::vector<int>& data)
+{
+  using namespace agency;
+
+  return bulk_invoke(con(data.size()), [&](concurrent_agent& self) -> single_result<int>
+  {
+    // combine each agent's element with a collective reduction
+    experimental::optional<int> result = self.reduce(data[self.index()], std::plus<int>());
+
+    // only the first agent receives the result
+    if(result)
+    {
+      return *result;
+    }
+
+    // all other agents return an ignored value 
+    return std::ignore;
+  });
+}
+
 int main()
 {
   int n = 10;
@@ -50,6 +71,8 @@ int main()
 
   assert(result == n);
 
+  assert(sum_with_reduce(data) == n);
+
   std::cout << "OK" << std::endl;
 
   return 0;
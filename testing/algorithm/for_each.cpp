@@ -0,0 +1,43 @@
+#include <agency/algorithm/for_each.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  for(size_t n : {0, 1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> data(n);
+    std::iota(data.begin(), data.end(), 0);
+
+    agency::for_each(policy, data.begin(), data.end(), [](int& x)
+    {
+      x *= 2;
+    });
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(data[i] == 2 * int(i));
+    }
+  }
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,120 @@
+#include <agency/algorithm/partition.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+
+// counts its live instances
+struct counted
+{
+  static int num_instances;
+
+  counted()
+  {
+    ++num_instances;
+  }
+
+  counted(counted&&)
+  {
+    ++num_instances;
+  }
+
+  ~counted()
+  {
+    --num_instances;
+  }
+};
+
+int counted::num_instances = 0;
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  auto is_even = [](int x)
+  {
+    return x % 2 == 0;
+  };
+
+  for(size_t n : {0, 1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> data(n);
+    std::iota(data.begin(), data.end(), 0);
+
+    auto middle = agency::partition(policy, data.begin(), data.end(), is_even);
+
+    assert(middle - data.begin() == std::ptrdiff_t((n + 1) / 2));
+    assert(std::is_partitioned(data.begin(), data.end(), is_even));
+
+    std::sort(data.begin(), data.end());
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(data[i] == int(i));
+    }
+  }
+
+  {
+    // move-only elements
+    std::vector<std::unique_ptr<int>> data;
+
+    for(int i = 0; i < 10000; ++i)
+    {
+      data.emplace_back(new int(i));
+    }
+
+    auto middle = agency::partition(policy, data.begin(), data.end(), [](const std::unique_ptr<int>& x)
+    {
+      return *x < 100;
+    });
+
+    assert(middle - data.begin() == 100);
+
+    for(auto i = data.begin(); i != data.end(); ++i)
+    {
+      assert((**i < 100) == (i < middle));
+    }
+  }
+}
+
+
+void test_partition_buffer()
+{
+  // the elements remaining in partition()'s temporary buffer are destroyed with it, e.g. when an exception escapes partition()
+  {
+    agency::detail::partition_buffer<counted> buffer(10);
+
+    for(std::size_t i = 0; i < 10; i += 2)
+    {
+      buffer.construct(i, counted());
+    }
+
+    buffer.destroy(4);
+
+    assert(counted::num_instances == 4);
+  }
+
+  assert(counted::num_instances == 0);
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  test_partition_buffer();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,63 @@
+#include <agency/algorithm/reduce.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  {
+    // empty range
+    std::vector<int> data;
+
+    assert(agency::reduce(policy, data.begin(), data.end(), 13) == 13);
+    assert(agency::reduce(policy, data.begin(), data.end()) == 0);
+  }
+
+  for(size_t n : {1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> data(n);
+    std::iota(data.begin(), data.end(), 0);
+
+    int expected = std::accumulate(data.begin(), data.end(), 13);
+
+    assert(agency::reduce(policy, data.begin(), data.end(), 13) == expected);
+    assert(agency::reduce(policy, data.begin(), data.end()) == expected - 13);
+    assert(agency::reduce(policy, data.begin(), data.end(), 13, std::plus<int>()) == expected);
+  }
+
+  {
+    // a non-commutative operation
+    std::vector<std::string> data(10000);
+
+    for(size_t i = 0; i < data.size(); ++i)
+    {
+      data[i] = std::to_string(i % 10);
+    }
+
+    std::string expected = std::accumulate(data.begin(), data.end(), std::string("x"));
+
+    assert(agency::reduce(policy, data.begin(), data.end(), std::string("x")) == expected);
+  }
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,107 @@
+#include <agency/algorithm/scan.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  for(size_t n : {0, 1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> data(n);
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      data[i] = int(i % 5);
+    }
+
+    std::vector<int> expected(n);
+    std::partial_sum(data.begin(), data.end(), expected.begin());
+
+    {
+      // inclusive
+      std::vector<int> result(n);
+
+      assert(agency::inclusive_scan(policy, data.begin(), data.end(), result.begin()) == result.end());
+      assert(result == expected);
+    }
+
+    {
+      // inclusive with init
+      std::vector<int> result(n);
+
+      agency::inclusive_scan(policy, data.begin(), data.end(), result.begin(), std::plus<int>(), 13);
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        assert(result[i] == expected[i] + 13);
+      }
+    }
+
+    {
+      // exclusive
+      std::vector<int> result(n);
+
+      assert(agency::exclusive_scan(policy, data.begin(), data.end(), result.begin(), 13) == result.end());
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        assert(result[i] == 13 + (i == 0 ? 0 : expected[i-1]));
+      }
+    }
+
+    {
+      // in place
+      std::vector<int> inclusive = data;
+      agency::inclusive_scan(policy, inclusive.begin(), inclusive.end(), inclusive.begin());
+      assert(inclusive == expected);
+
+      std::vector<int> exclusive = data;
+      agency::exclusive_scan(policy, exclusive.begin(), exclusive.end(), exclusive.begin(), 0, std::plus<int>());
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        assert(exclusive[i] == (i == 0 ? 0 : expected[i-1]));
+      }
+    }
+  }
+
+  {
+    // a non-commutative operation
+    std::vector<std::string> data(10000);
+
+    for(size_t i = 0; i < data.size(); ++i)
+    {
+      data[i] = std::to_string(i % 10);
+    }
+
+    std::vector<std::string> expected(data.size());
+    std::partial_sum(data.begin(), data.end(), expected.begin());
+
+    std::vector<std::string> result(data.size());
+    agency::inclusive_scan(policy, data.begin(), data.end(), result.begin());
+
+    assert(result == expected);
+  }
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,48 @@
+#include <agency/algorithm/sort.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  std::default_random_engine rng;
+
+  for(size_t n : {0, 1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> data(n);
+    std::generate(data.begin(), data.end(), rng);
+
+    std::vector<int> expected = data;
+    std::sort(expected.begin(), expected.end());
+
+    agency::sort(policy, data.begin(), data.end());
+    assert(data == expected);
+
+    std::reverse(expected.begin(), expected.end());
+
+    agency::sort(policy, data.begin(), data.end(), std::greater<int>());
+    assert(data == expected);
+  }
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,67 @@
+#include <agency/algorithm/transform.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <cassert>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  for(size_t n : {0, 1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> x(n);
+    std::iota(x.begin(), x.end(), 0);
+
+    std::vector<int> y(n, 13);
+
+    {
+      // unary
+      std::vector<int> result(n);
+
+      auto end = agency::transform(policy, x.begin(), x.end(), result.begin(), [](int x)
+      {
+        return 2 * x;
+      });
+
+      assert(end == result.end());
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        assert(result[i] == 2 * int(i));
+      }
+    }
+
+    {
+      // binary, in place
+      auto end = agency::transform(policy, x.begin(), x.end(), y.begin(), y.begin(), [](int x, int y)
+      {
+        return x + y;
+      });
+
+      assert(end == y.end());
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        assert(y[i] == int(i) + 13);
+      }
+    }
+  }
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
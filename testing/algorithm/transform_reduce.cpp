@@ -0,0 +1,61 @@
+#include <agency/algorithm/transform_reduce.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  for(size_t n : {0, 1, 10, 4097, 1 << 16})
+  {
+    std::vector<int> x(n);
+    std::iota(x.begin(), x.end(), 0);
+
+    std::vector<int> y(n, 3);
+
+    {
+      // unary
+      int expected = 13;
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        expected += int(i % 7);
+      }
+
+      int result = agency::transform_reduce(policy, x.begin(), x.end(), 13, std::plus<int>(), [](int x)
+      {
+        return x % 7;
+      });
+
+      assert(result == expected);
+    }
+
+    {
+      // binary
+      int expected = std::inner_product(x.begin(), x.end(), y.begin(), 13);
+
+      assert(agency::transform_reduce(policy, x.begin(), x.end(), y.begin(), 13) == expected);
+      assert(agency::transform_reduce(policy, x.begin(), x.end(), y.begin(), 13, std::plus<int>(), std::multiplies<int>()) == expected);
+    }
+  }
+}
+
+
+int main()
+{
+  test(agency::seq);
+  test(agency::unseq);
+  test(agency::par);
+  test(agency::con);
+  test(agency::par(1, agency::seq(4)));
+  test(agency::con(1, agency::seq(3)));
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,291 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <agency/container/vector.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <agency/memory/is_trivially_relocatable.hpp>
+
+
+// counts the number of live objects of its type
+struct counted
+{
+  static int num_live_objects;
+
+  int value;
+
+  counted(int v = 0) : value(v) { ++num_live_objects; }
+  counted(const counted& other) : value(other.value) { ++num_live_objects; }
+  counted(counted&& other) : value(other.value) { other.value = -1; ++num_live_objects; }
+  counted& operator=(const counted&) = default;
+  ~counted() { --num_live_objects; }
+};
+
+int counted::num_live_objects = 0;
+
+
+// a type which is not trivially copyable, but which may be relocated with memcpy
+// the default move constructor would leave a null pointer behind
+struct boxed
+{
+  static int num_live_boxes;
+
+  int* ptr;
+
+  boxed(int v = 0) : ptr(new int(v)) { ++num_live_boxes; }
+  boxed(const boxed& other) : ptr(new int(*other.ptr)) { ++num_live_boxes; }
+  boxed(boxed&& other) : ptr(other.ptr) { other.ptr = nullptr; }
+  ~boxed() { if(ptr) { delete ptr; --num_live_boxes; } }
+};
+
+int boxed::num_live_boxes = 0;
+
+
+// a type whose move constructor may throw, and whose copy constructor throws after a number of copies
+struct throwing_move
+{
+  static int num_live_objects;
+  static int num_copies_until_throw;
+
+  int value;
+
+  throwing_move(int v = 0) : value(v) { ++num_live_objects; }
+
+  throwing_move(const throwing_move& other) : value(other.value)
+  {
+    if(num_copies_until_throw > 0 && --num_copies_until_throw == 0)
+    {
+      throw std::runtime_error("throwing_move");
+    }
+
+    ++num_live_objects;
+  }
+
+  throwing_move(throwing_move&& other) : value(other.value) { other.value = -1; ++num_live_objects; }
+  throwing_move& operator=(const throwing_move&) = default;
+  ~throwing_move() { --num_live_objects; }
+};
+
+int throwing_move::num_live_objects = 0;
+int throwing_move::num_copies_until_throw = 0;
+
+
+namespace agency
+{
+
+
+template<>
+struct is_trivially_relocatable<boxed> : std::true_type {};
+
+
+} // end agency
+
+
+static_assert(agency::is_trivially_relocatable<int>::value, "int should be trivially relocatable");
+static_assert(!agency::is_trivially_relocatable<counted>::value, "counted should not be trivially relocatable");
+static_assert(agency::detail::relocation_is_bitwise<agency::allocator<int>, int*, int*>::value, "relocating ints should be bitwise");
+static_assert(agency::detail::relocation_is_bitwise<agency::allocator<boxed>, boxed*, boxed*>::value, "relocating boxed should be bitwise");
+static_assert(!agency::detail::relocation_is_bitwise<agency::allocator<counted>, counted*, counted*>::value, "relocating counted should not be bitwise");
+
+
+template<class ExecutionPolicy>
+void test_relocation(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  {
+    // test that growth destroys the original elements
+
+    {
+      vector<counted> v;
+
+      for(int i = 0; i < 100; ++i)
+      {
+        v.emplace_back(i);
+        assert(counted::num_live_objects == static_cast<int>(v.size()));
+      }
+
+      v.reserve(policy, 1000);
+      assert(counted::num_live_objects == static_cast<int>(v.size()));
+
+      for(int i = 0; i < 100; ++i)
+      {
+        assert(v[i].value == i);
+      }
+    }
+
+    assert(counted::num_live_objects == 0);
+  }
+
+  {
+    // test growth through insertion in the middle of the vector
+
+    {
+      vector<counted> v(10, counted(13));
+
+      v.insert(policy, v.begin() + 5, 100, counted(7));
+
+      assert(counted::num_live_objects == static_cast<int>(v.size()));
+      assert(v.size() == 110);
+      assert(std::count_if(v.begin(), v.begin() + 5, [](const counted& x){ return x.value == 13; }) == 5);
+      assert(std::count_if(v.begin() + 5, v.begin() + 105, [](const counted& x){ return x.value == 7; }) == 100);
+      assert(std::count_if(v.begin() + 105, v.end(), [](const counted& x){ return x.value == 13; }) == 5);
+    }
+
+    assert(counted::num_live_objects == 0);
+  }
+
+  {
+    // test growth when the new element refers to an existing element
+
+    vector<std::string> v(1, "hello");
+
+    for(int i = 0; i < 100; ++i)
+    {
+      v.push_back(v[0]);
+    }
+
+    assert(std::count(v.begin(), v.end(), "hello") == 101);
+  }
+
+  {
+    // test growth of a user type which is trivially relocatable
+
+    {
+      vector<boxed> v;
+
+      for(int i = 0; i < 100; ++i)
+      {
+        v.emplace_back(i);
+        assert(boxed::num_live_boxes == static_cast<int>(v.size()));
+      }
+
+      v.reserve(policy, 1000);
+      assert(boxed::num_live_boxes == static_cast<int>(v.size()));
+
+      for(int i = 0; i < 100; ++i)
+      {
+        assert(*v[i].ptr == i);
+      }
+    }
+
+    assert(boxed::num_live_boxes == 0);
+  }
+
+  {
+    // test that growth copies elements whose move constructors may throw, so that they remain intact when a copy throws
+
+    for(int num_copies_until_throw : {1, 5, 10})
+    {
+      vector<throwing_move> v;
+      v.reserve(10);
+
+      for(int i = 0; i < 10; ++i)
+      {
+        v.emplace_back(i);
+      }
+
+      throwing_move::num_copies_until_throw = num_copies_until_throw;
+
+      bool caught = false;
+
+      try
+      {
+        v.reserve(policy, 100);
+      }
+      catch(std::runtime_error&)
+      {
+        caught = true;
+      }
+
+      assert(caught);
+      assert(throwing_move::num_live_objects == 10);
+      assert(v.size() == 10 && v.capacity() == 10);
+
+      for(int i = 0; i < 10; ++i)
+      {
+        assert(v[i].value == i);
+      }
+    }
+
+    // the first copy constructs the inserted element, the next five copy the elements after the insertion,
+    // and the rest copy the elements before the insertion
+    for(int num_copies_until_throw : {2, 4, 6, 7, 11})
+    {
+      vector<throwing_move> v;
+      v.reserve(10);
+
+      for(int i = 0; i < 10; ++i)
+      {
+        v.emplace_back(i);
+      }
+
+      throwing_move::num_copies_until_throw = num_copies_until_throw;
+
+      bool caught = false;
+
+      try
+      {
+        v.insert(policy, v.begin() + 5, 1, throwing_move(13));
+      }
+      catch(std::runtime_error&)
+      {
+        caught = true;
+      }
+
+      assert(caught);
+      assert(throwing_move::num_live_objects == 10);
+      assert(v.size() == 10 && v.capacity() == 10);
+
+      for(int i = 0; i < 10; ++i)
+      {
+        assert(v[i].value == i);
+      }
+    }
+
+    throwing_move::num_copies_until_throw = 0;
+    assert(throwing_move::num_live_objects == 0);
+  }
+
+  {
+    // test large reallocations, which relocate in parallel when the policy permits
+
+    size_t n = 1 << 20;
+
+    vector<int> v(policy, n);
+    std::iota(v.begin(), v.end(), 0);
+
+    v.reserve(policy, 4 * n);
+    assert(v.capacity() >= 4 * n);
+    assert(v.size() == n);
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(v[i] == static_cast<int>(i));
+    }
+
+    v.insert(policy, v.begin() + 13, 4 * n, 7);
+    assert(v.size() == 5 * n);
+
+    assert(std::equal(v.begin(), v.begin() + 13, std::vector<int>({0,1,2,3,4,5,6,7,8,9,10,11,12}).begin()));
+    assert(std::count(v.begin() + 13, v.begin() + 13 + 4 * n, 7) == static_cast<int>(4 * n));
+
+    for(size_t i = 13; i < n; ++i)
+    {
+      assert(v[4 * n + i] == static_cast<int>(i));
+    }
+  }
+}
+
+int main()
+{
+  test_relocation(agency::seq);
+  test_relocation(agency::par);
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <cassert>
+#include <algorithm>
+#include <string>
+#include <agency/container/vector.hpp>
+#include <agency/execution/execution_policy.hpp>
+
+void test_enlarging_resize_default_init()
+{
+  using namespace agency;
+
+  size_t old_size = 10;
+
+  vector<int> v(old_size, 13);
+
+  size_t new_size = old_size + 5;
+  v.resize_default_init(new_size);
+
+  assert(v.size() == new_size);
+  assert(v.capacity() >= new_size);
+  assert(std::count(v.begin(), v.begin() + old_size, 13) == static_cast<int>(old_size));
+
+  // the new elements are writable
+  std::fill(v.begin() + old_size, v.end(), 7);
+  assert(std::count(v.begin() + old_size, v.end(), 7) == static_cast<int>(new_size - old_size));
+}
+
+template<class ExecutionPolicy>
+void test_enlarging_resize_default_init(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  size_t old_size = 10;
+
+  vector<int> v(old_size, 13);
+
+  size_t new_size = 1 << 20;
+  v.resize_default_init(policy, new_size);
+
+  assert(v.size() == new_size);
+  assert(v.capacity() >= new_size);
+  assert(std::count(v.begin(), v.begin() + old_size, 13) == static_cast<int>(old_size));
+
+  // the new elements are writable
+  std::fill(v.begin() + old_size, v.end(), 7);
+  assert(std::count(v.begin() + old_size, v.end(), 7) == static_cast<int>(new_size - old_size));
+}
+
+template<class ExecutionPolicy>
+void test_enlarging_resize_default_init_nontrivial(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  size_t old_size = 10;
+
+  vector<std::string> v(old_size, "hello");
+
+  size_t new_size = old_size + 5;
+  v.resize_default_init(policy, new_size);
+
+  // elements which are not trivially default constructible are constructed
+  assert(v.size() == new_size);
+  assert(std::count(v.begin(), v.begin() + old_size, "hello") == static_cast<int>(old_size));
+  assert(std::count(v.begin() + old_size, v.end(), "") == static_cast<int>(new_size - old_size));
+}
+
+void test_shrinking_resize_default_init()
+{
+  using namespace agency;
+
+  size_t old_size = 10;
+
+  vector<int> v(old_size, 13);
+
+  size_t new_size = old_size - 5;
+  v.resize_default_init(new_size);
+
+  assert(v.size() == new_size);
+  assert(std::count(v.begin(), v.end(), 13) == static_cast<int>(new_size));
+}
+
+template<class ExecutionPolicy>
+void test_shrinking_resize_default_init(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  size_t old_size = 10;
+
+  vector<int> v(old_size, 13);
+
+  size_t new_size = old_size - 5;
+  v.resize_default_init(policy, new_size);
+
+  assert(v.size() == new_size);
+  assert(std::count(v.begin(), v.end(), 13) == static_cast<int>(new_size));
+}
+
+int main()
+{
+  test_enlarging_resize_default_init();
+  test_enlarging_resize_default_init(agency::seq);
+  test_enlarging_resize_default_init(agency::par);
+
+  test_enlarging_resize_default_init_nontrivial(agency::seq);
+  test_enlarging_resize_default_init_nontrivial(agency::par);
+
+  test_shrinking_resize_default_init();
+  test_shrinking_resize_default_init(agency::seq);
+  test_shrinking_resize_default_init(agency::par);
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,122 @@
+#include <agency/agency.hpp>
+#include <agency/detail/index_cast.hpp>
+#include <random>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cassert>
+
+
+template<class ToIndex, class FromIndex, class FromShape, class ToShape>
+void test_index_caster(const FromShape& from_shape, const ToShape& to_shape, size_t num_indices)
+{
+  agency::detail::index_caster<ToIndex, FromIndex, FromShape, ToShape> caster(from_shape, to_shape);
+
+  for(size_t i = 0; i < num_indices; ++i)
+  {
+    FromIndex from_idx = agency::detail::index_cast<FromIndex>(i, num_indices, from_shape);
+
+    ToIndex reference = agency::detail::index_cast<ToIndex>(from_idx, from_shape, to_shape);
+
+    assert(reference == caster(from_idx));
+  }
+}
+
+
+void test()
+{
+  using namespace agency;
+
+  std::default_random_engine rng(13);
+
+  for(int trial = 0; trial < 10; ++trial)
+  {
+    size_t shape0 = rng() % 10 + 1;
+    size_t shape1 = rng() % 10 + 1;
+    size_t shape2 = rng() % 10 + 1;
+
+    // identical types
+    test_index_caster<size_t, size_t>(shape0, shape0, shape0);
+    test_index_caster<size2, size2>(size2(shape0,shape1), size2(shape0,shape1), shape0 * shape1);
+
+    // lift a scalar into a point
+    test_index_caster<size2, size_t>(shape0 * shape1, size2(shape0,shape1), shape0 * shape1);
+    test_index_caster<size3, size_t>(shape0 * shape1 * shape2, size3(shape0,shape1,shape2), shape0 * shape1 * shape2);
+    test_index_caster<int3, size_t>(shape0 * shape1 * shape2, int3(shape0,shape1,shape2), shape0 * shape1 * shape2);
+
+    // project a point into a scalar
+    test_index_caster<size_t, size2>(size2(shape0,shape1), shape0 * shape1, shape0 * shape1);
+
+    // cast between tuples
+    using tuple_type = agency::tuple<size_t,size_t>;
+    test_index_caster<tuple_type, tuple_type>(tuple_type(shape0,shape1), tuple_type(shape0,shape1), shape0 * shape1);
+  }
+
+  {
+    // lift indices whose shapes exceed 32 bits
+    size_t shape0 = size_t(1) << 33;
+    size_t shape1 = 3;
+
+    agency::detail::index_caster<size2, size_t, size_t, size2> caster(shape0 * shape1, size2(shape0, shape1));
+
+    for(size_t i : {size_t(0), size_t(1), shape0 - 1, shape0, shape0 + 1, 2 * shape0 + 7})
+    {
+      assert(caster(i) == detail::index_cast<size2>(i, shape0 * shape1, size2(shape0, shape1)));
+    }
+  }
+}
+
+
+template<class ExecutionPolicy>
+void test_2d_agents(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  using agent_type = typename ExecutionPolicy::execution_agent_type;
+
+  // two-dimensional agents executed by a one-dimensional executor lift their executor's index
+  size2 shape(7,5);
+
+  {
+    // test bulk_invoke()
+    std::vector<std::atomic<int>> visited(shape[0] * shape[1]);
+
+    bulk_invoke(policy(size2(0,0), shape), [&](agent_type& self)
+    {
+      ++visited[self.index()[1] * shape[0] + self.index()[0]];
+    });
+
+    assert(std::all_of(visited.begin(), visited.end(), [](const std::atomic<int>& x){ return x == 1; }));
+  }
+
+  {
+    // test bulk_then()
+    std::vector<std::atomic<int>> visited(shape[0] * shape[1]);
+
+    auto predecessor = agency::make_ready_future<int>(policy.executor(), 13);
+
+    bulk_then(policy(size2(0,0), shape), [&](agent_type& self, int& value)
+    {
+      visited[self.index()[1] * shape[0] + self.index()[0]] += value;
+    },
+    predecessor).wait();
+
+    assert(std::all_of(visited.begin(), visited.end(), [](const std::atomic<int>& x){ return x == 13; }));
+  }
+}
+
+
+int main()
+{
+  test();
+
+  test_2d_agents(agency::seq2d);
+  test_2d_agents(agency::par2d);
+  test_2d_agents(agency::con2d);
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
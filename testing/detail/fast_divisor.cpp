@@ -0,0 +1,74 @@
+#include <agency/detail/fast_divisor.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+
+
+void test(std::size_t divisor, std::size_t dividend)
+{
+  agency::detail::fast_divisor d(divisor);
+
+  std::size_t remainder = 0;
+  std::size_t quotient = d.divide(dividend, remainder);
+
+  assert(quotient == dividend / divisor);
+  assert(remainder == dividend % divisor);
+}
+
+
+int main()
+{
+  std::vector<std::size_t> divisors;
+
+  // small divisors, powers of two and their neighbors, and divisors near the 32b limit
+  for(std::size_t d = 1; d <= 1024; ++d)
+  {
+    divisors.push_back(d);
+  }
+
+  for(std::size_t i = 1; i < 40; ++i)
+  {
+    std::size_t power_of_two = std::size_t(1) << i;
+    divisors.push_back(power_of_two - 1);
+    divisors.push_back(power_of_two);
+    divisors.push_back(power_of_two + 1);
+  }
+
+  divisors.push_back(UINT32_MAX - 1);
+  divisors.push_back(UINT32_MAX);
+
+  std::vector<std::size_t> dividends = {0, 1, 2, 3, 1023, 1024, 1025, UINT32_MAX - 1, UINT32_MAX, std::size_t(UINT32_MAX) + 1, std::size_t(1) << 40};
+
+  std::default_random_engine rng(13);
+  std::uniform_int_distribution<std::uint32_t> dist;
+
+  for(int i = 0; i < 1000; ++i)
+  {
+    dividends.push_back(dist(rng));
+  }
+
+  for(std::size_t divisor : divisors)
+  {
+    for(std::size_t dividend : dividends)
+    {
+      test(divisor, dividend);
+    }
+
+    // each divisor's multiples and their neighbors
+    for(std::size_t multiple = 1; multiple < 64; ++multiple)
+    {
+      std::size_t dividend = multiple * divisor;
+
+      test(divisor, dividend - 1);
+      test(divisor, dividend);
+      test(divisor, dividend + 1);
+    }
+  }
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
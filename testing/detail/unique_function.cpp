@@ -0,0 +1,313 @@
+#include <agency/execution/executor/parallel_executor.hpp>
+#include <agency/detail/unique_function.hpp>
+#include <agency/detail/concurrency/thread_pool.hpp>
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <cassert>
+
+
+// count every call to the global operator new
+std::atomic<size_t> num_allocations(0);
+
+void* operator new(std::size_t n)
+{
+  ++num_allocations;
+
+  void* result = std::malloc(n > 0 ? n : 1);
+  if(result == nullptr) throw std::bad_alloc();
+
+  return result;
+}
+
+// operator new above allocates with std::malloc, so std::free is the matching deallocation
+// gcc can't see that once a replacement operator delete is inlined, and reports a mismatch
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && (__GNUC__ >= 11)
+#pragma GCC diagnostic pop
+#endif
+
+
+struct move_only_callable
+{
+  std::unique_ptr<int> value;
+
+  int operator()() const
+  {
+    return *value;
+  }
+};
+
+
+// this callable is too large to be stored inline
+struct large_callable
+{
+  int values[32];
+
+  int operator()() const
+  {
+    return values[31];
+  }
+};
+
+
+// this callable throws when copied
+struct throwing_copy_callable
+{
+  throwing_copy_callable() = default;
+
+  throwing_copy_callable(const throwing_copy_callable&)
+  {
+    throw std::runtime_error("copy");
+  }
+
+  int operator()() const
+  {
+    return 13;
+  }
+};
+
+
+// the number of allocations made through counting_allocator which have not yet been deallocated
+int num_outstanding_allocations = 0;
+
+template<class T>
+struct counting_allocator
+{
+  using value_type = T;
+
+  counting_allocator() = default;
+
+  template<class U>
+  counting_allocator(const counting_allocator<U>&) {}
+
+  T* allocate(size_t n)
+  {
+    ++num_outstanding_allocations;
+    return std::allocator<T>().allocate(n);
+  }
+
+  void deallocate(T* ptr, size_t n)
+  {
+    --num_outstanding_allocations;
+    std::allocator<T>().deallocate(ptr, n);
+  }
+};
+
+struct throwing_move_callable
+{
+  throwing_move_callable() = default;
+
+  throwing_move_callable(const throwing_move_callable&) {}
+
+  int operator()() const
+  {
+    return 13;
+  }
+};
+
+
+void test_unique_function()
+{
+  using namespace agency::detail;
+
+  static_assert(sizeof(unique_function<void()>) <= 64, "unique_function should be no larger than a cache line");
+
+  {
+    // default construction
+    unique_function<int()> f;
+    assert(!f);
+
+    bool caught_exception = false;
+
+    try
+    {
+      f();
+    }
+    catch(bad_function_call&)
+    {
+      caught_exception = true;
+    }
+
+    assert(caught_exception);
+  }
+
+  {
+    // small callables, such as the lambdas an executor submits to a thread pool, are stored without allocating
+    int a = 1, b = 2, c = 3;
+    std::atomic<int> counter(0);
+
+    size_t num_allocations_before = num_allocations;
+
+    unique_function<int(int)> f = [&a,&b,&c,&counter](int x)
+    {
+      ++counter;
+      return a + b + c + x;
+    };
+
+    unique_function<int(int)> g = std::move(f);
+    assert(!f);
+
+    f = std::move(g);
+    assert(!g);
+
+    assert(f(4) == 10);
+    assert(counter == 1);
+
+    assert(num_allocations == num_allocations_before);
+  }
+
+  {
+    // move-only callables
+    unique_function<int()> f = move_only_callable{std::unique_ptr<int>(new int(7))};
+
+    size_t num_allocations_before = num_allocations;
+
+    unique_function<int()> g = std::move(f);
+    assert(g() == 7);
+
+    assert(num_allocations == num_allocations_before);
+  }
+
+  {
+    // large callables & callables whose move constructor may throw are allocated from a pool
+    large_callable large;
+    large.values[31] = 13;
+
+    // warm up this thread's cache
+    {
+      unique_function<int()> f = large;
+      unique_function<int()> g = throwing_move_callable();
+    }
+
+    size_t num_allocations_before = num_allocations;
+
+    for(int i = 0; i < 1000; ++i)
+    {
+      unique_function<int()> f = large;
+      unique_function<int()> g = throwing_move_callable();
+
+      unique_function<int()> h = std::move(f);
+      assert(h() == 13);
+      assert(g() == 13);
+    }
+
+    assert(num_allocations == num_allocations_before);
+  }
+
+  {
+    // the storage of a callable which throws while being copied into it is deallocated
+    throwing_copy_callable callable;
+    bool caught = false;
+
+    try
+    {
+      unique_function<int()> f(std::allocator_arg, counting_allocator<throwing_copy_callable>(), callable);
+    }
+    catch(std::runtime_error&)
+    {
+      caught = true;
+    }
+
+    assert(caught);
+    assert(num_outstanding_allocations == 0);
+  }
+
+  {
+    // assignment destroys the previous target
+    std::shared_ptr<int> ptr = std::make_shared<int>(7);
+
+    unique_function<int()> f = [ptr]{ return *ptr; };
+    assert(ptr.use_count() == 2);
+
+    f = nullptr;
+    assert(!f);
+    assert(ptr.use_count() == 1);
+  }
+}
+
+
+// submits a series of bursts of tasks to a thread pool and waits for each burst to complete
+// returns the number of allocations performed during the final half of the bursts
+size_t count_steady_state_allocations(agency::detail::thread_pool& pool)
+{
+  const int num_bursts = 2000;
+  const int burst_size = 64;
+
+  std::atomic<int> num_completed(0);
+  int sum = 0;
+
+  size_t num_allocations_before = 0;
+
+  for(int burst = 0; burst < num_bursts; ++burst)
+  {
+    if(burst == num_bursts / 2)
+    {
+      num_allocations_before = num_allocations;
+    }
+
+    num_completed = 0;
+
+    for(int i = 0; i < burst_size; ++i)
+    {
+      // a typical executor lambda captures a few references and indices
+      pool.submit([&num_completed,&sum,burst,i]
+      {
+        if(burst < 0) sum += i;
+
+        ++num_completed;
+      });
+    }
+
+    while(num_completed < burst_size)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  return num_allocations - num_allocations_before;
+}
+
+
+void test_thread_pool()
+{
+  using namespace agency::detail;
+
+  {
+    thread_pool pool(4, thread_pool::work_stealing);
+    assert(count_steady_state_allocations(pool) == 0);
+  }
+
+  {
+    thread_pool pool(4, thread_pool::shared_queue);
+    assert(count_steady_state_allocations(pool) == 0);
+  }
+}
+
+
+int main()
+{
+  test_unique_function();
+  test_thread_pool();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,298 @@
+#include <agency/agency.hpp>
+#include <agency/detail/concurrency/barrier.hpp>
+#include <agency/shared.hpp>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <functional>
+#include <atomic>
+#include <cassert>
+
+
+template<class Barrier>
+using concurrent_agent_with_barrier = agency::detail::basic_concurrent_agent<std::size_t, Barrier, agency::detail::default_concurrent_resource>;
+
+
+template<class Agent>
+class concurrent_execution_policy_with_agent : public agency::basic_execution_policy<Agent, agency::concurrent_executor, concurrent_execution_policy_with_agent<Agent>>
+{
+  private:
+    using super_t = agency::basic_execution_policy<Agent, agency::concurrent_executor, concurrent_execution_policy_with_agent<Agent>>;
+
+  public:
+    using super_t::basic_execution_policy;
+};
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  using agent_type = typename ExecutionPolicy::execution_agent_type;
+
+  for(size_t n : {1, 2, 3, 16, 33})
+  {
+    std::vector<int> data(n, 0);
+
+    bulk_invoke(policy(n), [&](agent_type& self)
+    {
+      size_t i = self.index();
+
+      // each iteration, every agent reads its neighbor's element from the previous iteration
+      for(int iteration = 0; iteration < 20; ++iteration)
+      {
+        assert(data[(i + 1) % n] == iteration);
+
+        self.wait();
+
+        data[i] = iteration + 1;
+
+        self.wait();
+      }
+    });
+
+    assert(std::vector<int>(n, 20) == data);
+  }
+}
+
+
+template<class ExecutionPolicy>
+void test_collectives(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  using agent_type = typename ExecutionPolicy::execution_agent_type;
+
+  for(size_t n : {1, 2, 3, 16, 100})
+  {
+    std::vector<int> reductions(n), all_reductions(n), inclusive_scans(n), exclusive_scans(n);
+    std::vector<std::string> concatenations(n);
+
+    bulk_invoke(policy(n), [&](agent_type& self)
+    {
+      size_t i = self.index();
+      int value = i + 1;
+
+      experimental::optional<int> reduction = self.reduce(value, std::plus<int>());
+      assert(bool(reduction) == self.elect());
+      reductions[i] = reduction ? *reduction : -1;
+
+      all_reductions[i] = self.all_reduce(value, std::plus<int>());
+      inclusive_scans[i] = self.inclusive_scan(value, std::plus<int>());
+      exclusive_scans[i] = self.exclusive_scan(value, 10, std::plus<int>());
+
+      // a non-commutative operation must be applied in rank order
+      concatenations[i] = self.all_reduce(std::to_string(i) + ",", std::plus<std::string>());
+    });
+
+    std::string expected_concatenation;
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      int sum_through_i = (i + 1) * (i + 2) / 2;
+
+      assert(reductions[i] == (i == 0 ? int(n * (n + 1) / 2) : -1));
+      assert(all_reductions[i] == int(n * (n + 1) / 2));
+      assert(inclusive_scans[i] == sum_through_i);
+      assert(exclusive_scans[i] == 10 + sum_through_i - int(i + 1));
+
+      expected_concatenation += std::to_string(i) + ",";
+    }
+
+    assert(std::vector<std::string>(n, expected_concatenation) == concatenations);
+
+    // all_reduce() combines the group's values once rather than once per agent
+    std::atomic<size_t> num_combinations(0);
+
+    bulk_invoke(policy(n), [&](agent_type& self)
+    {
+      self.all_reduce(1, [&](int x, int y)
+      {
+        ++num_combinations;
+        return x + y;
+      });
+    });
+
+    assert(num_combinations == n - 1);
+  }
+}
+
+
+template<class ExecutionPolicy>
+void test_large_shared_temporaries(ExecutionPolicy policy)
+{
+  using namespace agency;
+
+  using agent_type = typename ExecutionPolicy::execution_agent_type;
+
+  size_t n = 8;
+  std::vector<int> sums(n);
+
+  bulk_invoke(policy(n), [&](agent_type& self)
+  {
+    // these are much larger than the group's inline buffer
+    for(size_t size : {1000, 10000, 100000})
+    {
+      shared_vector<int, agent_type> scratch(self, size, 0);
+
+      for(size_t j = self.index(); j < size; j += n)
+      {
+        scratch[j] = 1;
+      }
+
+      self.wait();
+
+      int sum = 0;
+      for(size_t j = 0; j < size; ++j)
+      {
+        sum += scratch[j];
+      }
+
+      sums[self.index()] += sum;
+    }
+  });
+
+  assert(std::vector<int>(n, 111000) == sums);
+}
+
+
+// counting_barrier counts the barrier episodes of every group which uses it
+struct counting_barrier : agency::detail::synchronic_barrier
+{
+  static std::atomic<int> num_arrivals;
+
+  counting_barrier(std::size_t count)
+    : agency::detail::synchronic_barrier(count)
+  {}
+
+  void arrive_and_wait()
+  {
+    ++num_arrivals;
+    agency::detail::synchronic_barrier::arrive_and_wait();
+  }
+};
+
+std::atomic<int> counting_barrier::num_arrivals(0);
+
+
+// counted tracks the number of its objects which are alive
+// its size is sizeof(int) plus at least padding_size bytes
+template<std::size_t padding_size>
+struct counted
+{
+  static std::atomic<int> num_live_objects;
+
+  int value;
+  char padding[padding_size + 1];
+
+  counted(int v) : value(v) { ++num_live_objects; }
+  counted(const counted& other) : value(other.value) { ++num_live_objects; }
+  ~counted() { --num_live_objects; }
+};
+
+template<std::size_t padding_size>
+std::atomic<int> counted<padding_size>::num_live_objects(0);
+
+
+template<class T>
+void test_broadcast()
+{
+  using namespace agency;
+
+  using agent_type = concurrent_agent_with_barrier<counting_barrier>;
+  using policy_type = concurrent_execution_policy_with_agent<agent_type>;
+
+  for(size_t n : {1, 2, 3, 16})
+  {
+    std::vector<int> sums(n);
+    int num_broadcasts = 20;
+
+    counting_barrier::num_arrivals = 0;
+
+    bulk_invoke(policy_type()(n), [&](agent_type& self)
+    {
+      int sum = 0;
+
+      for(int i = 0; i < num_broadcasts; ++i)
+      {
+        // a different agent broadcasts each time
+        experimental::optional<T> value;
+        if(self.rank() == i % n)
+        {
+          value = T(i);
+        }
+
+        sum += self.broadcast(value).value;
+      }
+
+      sums[self.rank()] = sum;
+    });
+
+    assert(std::vector<int>(n, num_broadcasts * (num_broadcasts - 1) / 2) == sums);
+
+    // each broadcast costs a single barrier episode
+    assert(counting_barrier::num_arrivals == int(n) * num_broadcasts);
+
+    // every broadcast object is destroyed
+    assert(T::num_live_objects == 0);
+  }
+}
+
+
+void test_shared_construction()
+{
+  using namespace agency;
+
+  using agent_type = concurrent_agent_with_barrier<counting_barrier>;
+  using policy_type = concurrent_execution_policy_with_agent<agent_type>;
+
+  size_t n = 8;
+
+  counting_barrier::num_arrivals = 0;
+
+  bulk_invoke(policy_type()(n), [&](agent_type& self)
+  {
+    shared<int, agent_type> x(self, 13);
+
+    // constructing a shared object costs a single barrier episode
+    assert(counting_barrier::num_arrivals >= int(n));
+    assert(x.value() == 13);
+
+    self.wait();
+  });
+
+  // one episode for construction, one for the explicit wait(), and two for destruction
+  assert(counting_barrier::num_arrivals == 4 * int(n));
+}
+
+
+int main()
+{
+  using namespace agency;
+
+  static_assert(std::is_same<detail::barrier, detail::synchronic_barrier>::value,
+    "synchronic_barrier should be the default barrier");
+
+  // test the default concurrent_agent
+  test(con);
+
+  // test each barrier type
+  test(concurrent_execution_policy_with_agent<concurrent_agent_with_barrier<detail::blocking_barrier>>());
+  test(concurrent_execution_policy_with_agent<concurrent_agent_with_barrier<detail::synchronic_barrier>>());
+
+  test_collectives(con);
+  test_collectives(concurrent_execution_policy_with_agent<concurrent_agent_with_barrier<detail::blocking_barrier>>());
+
+  test_large_shared_temporaries(con);
+
+  // test a type which fits inside the broadcast channel and a type which does not
+  test_broadcast<counted<0>>();
+  test_broadcast<counted<100>>();
+
+  test_shared_construction();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
@@ -7,6 +7,10 @@
 #include <agency/execution/executor/executor_traits.hpp>
 #include <agency/execution/executor/executor_traits/detail/is_bulk_then_executor.hpp>
 #include <agency/execution/executor/customization_points.hpp>
+#include <agency/bulk_invoke.hpp>
+#include <agency/execution/execution_policy.hpp>
+#include <atomic>
+#include <stdexcept>
 
 int main()
 {
@@ -27,15 +31,15 @@ int main()
   static_assert(detail::is_detected_exact<size_t, executor_index_t, concurrent_executor>::value,
     "concurrent_executor should have size_t index_type");
 
-  static_assert(detail::is_detected_exact<std::future<int>, executor_future_t, concurrent_executor, int>::value,
-    "concurrent_executor should have std::future future");
+  static_assert(detail::is_detected_exact<agency::future<int>, executor_future_t, concurrent_executor, int>::value,
+    "concurrent_executor should have agency::future future");
 
   static_assert(executor_execution_depth<concurrent_executor>::value == 1,
     "concurrent_executor should have execution_depth == 1");
 
   concurrent_executor exec;
 
-  std::future<int> fut = agency::make_ready_future<int>(exec, 7);
+  agency::future<int> fut = agency::make_ready_future<int>(exec, 7);
 
   size_t shape = 10;
   
@@ -54,6 +58,120 @@ int main()
   
   assert(std::vector<int>(10, 7 + 13) == result);
 
+  {
+    // test that all agents of a group execute concurrently
+    for(size_t n : {1, 2, 7, 64})
+    {
+      for(int launch = 0; launch < 3; ++launch)
+      {
+        // each agent waits for every other agent to arrive, which would deadlock
+        // if the agents of the group did not execute concurrently
+        std::atomic<size_t> num_arrived(0);
+
+        bulk_invoke(con(n), [&](concurrent_agent&)
+        {
+          ++num_arrived;
+
+          while(num_arrived < n)
+          {
+            std::this_thread::yield();
+          }
+        });
+
+        assert(num_arrived == n);
+      }
+    }
+
+    // threads are reused across launches
+    assert(exec.pool().size() <= 2 * 64);
+  }
+
+  {
+    // test that concurrent_agent::wait() synchronizes the group
+    std::vector<int> data(100, 0);
+
+    bulk_invoke(con(data.size()), [&](concurrent_agent& self)
+    {
+      size_t i = self.index();
+      data[i] = i;
+
+      self.wait();
+
+      // read a neighbor's element written before the barrier
+      assert(data[(i + 1) % data.size()] == int((i + 1) % data.size()));
+    });
+  }
+
+  {
+    // test that a long pipeline of launches, none of whose predecessors are ready when it is launched,
+    // does not occupy a thread per launch
+    size_t num_threads_before = exec.pool().size();
+
+    agency::promise<void> start;
+    agency::future<void> start_fut = start.get_future();
+
+    auto f = exec.bulk_then_execute(
+      [](size_t idx, int& result, int&)
+      {
+        if(idx == 0) result = 0;
+      },
+      2,
+      start_fut,
+      []{ return 0; },
+      []{ return 0; }
+    );
+
+    for(int i = 0; i < 1000; ++i)
+    {
+      f = exec.bulk_then_execute(
+        [](size_t idx, int& predecessor, int& result, int&)
+        {
+          if(idx == 0) result = predecessor + 1;
+        },
+        2,
+        f,
+        []{ return 0; },
+        []{ return 0; }
+      );
+    }
+
+    assert(exec.pool().size() == num_threads_before);
+
+    start.set_value();
+
+    assert(f.get() == 1000);
+    assert(exec.pool().size() < num_threads_before + 16);
+  }
+
+  {
+    // test that an exception thrown by an agent is reported through the future
+    agency::future<void> ready = agency::make_ready_future<void>(exec);
+
+    auto f = exec.bulk_then_execute(
+      [](size_t idx, int&, int&)
+      {
+        if(idx == 3) throw std::runtime_error("error");
+      },
+      8,
+      ready,
+      []{ return 0; },
+      []{ return 0; }
+    );
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(std::runtime_error&)
+    {
+      caught = true;
+    }
+
+    assert(caught);
+  }
+
   std::cout << "OK" << std::endl;
 
   return 0;
@@ -0,0 +1,278 @@
+#include <agency/agency.hpp>
+#include <agency/execution/executor/experimental/adaptive_executor.hpp>
+#include <agency/execution/executor/executor_traits.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+#include <cassert>
+
+
+template<class ExecutionPolicy, class AdaptiveExecutor>
+void test_policy(ExecutionPolicy policy, AdaptiveExecutor exec, size_t n)
+{
+  using namespace agency;
+
+  auto adaptive_policy = policy(n).on(exec);
+
+  {
+    // test bulk_invoke()
+    std::vector<std::atomic<int>> visited(n);
+
+    bulk_invoke(adaptive_policy, [&](typename ExecutionPolicy::execution_agent_type& self)
+    {
+      ++visited[self.rank()];
+    });
+
+    assert(std::all_of(visited.begin(), visited.end(), [](const std::atomic<int>& x){ return x == 1; }));
+  }
+
+  {
+    // test bulk_async()
+    std::vector<std::atomic<int>> visited(n);
+
+    bulk_async(adaptive_policy, [&](typename ExecutionPolicy::execution_agent_type& self)
+    {
+      ++visited[self.rank()];
+    }).wait();
+
+    assert(std::all_of(visited.begin(), visited.end(), [](const std::atomic<int>& x){ return x == 1; }));
+  }
+
+  {
+    // test bulk_then()
+    std::vector<std::atomic<int>> visited(n);
+
+    auto predecessor = agency::make_ready_future<int>(exec, 13);
+
+    bulk_then(adaptive_policy, [&](typename ExecutionPolicy::execution_agent_type& self, int& value)
+    {
+      visited[self.rank()] += value;
+    },
+    predecessor).wait();
+
+    assert(std::all_of(visited.begin(), visited.end(), [](const std::atomic<int>& x){ return x == 13; }));
+  }
+
+  {
+    // test bulk_invoke() with results
+    auto results = bulk_invoke(adaptive_policy, [](typename ExecutionPolicy::execution_agent_type& self)
+    {
+      return self.rank();
+    });
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(results[i] == i);
+    }
+  }
+}
+
+
+void test_selection()
+{
+  using namespace agency;
+  using executor_type = experimental::adaptive_executor<sequenced_executor, parallel_executor>;
+
+  static_assert(detail::is_bulk_twoway_executor<executor_type>::value, "adaptive_executor should be a bulk twoway executor");
+  static_assert(detail::is_bulk_then_executor<executor_type>::value, "adaptive_executor should be a bulk then executor");
+  static_assert(bulk_guarantee_t::static_query<executor_type>() == bulk_guarantee_t::parallel_t(), "adaptive_executor<sequenced_executor, parallel_executor> should be parallel");
+
+  executor_type exec(std::vector<size_t>{100});
+
+  assert(exec.thresholds() == std::vector<size_t>({100}));
+  assert(exec.alternative(0) == 0);
+  assert(exec.alternative(99) == 0);
+  assert(exec.alternative(100) == 1);
+  assert(exec.alternative(1000) == 1);
+
+  // copies share thresholds
+  executor_type copy = exec;
+  copy.set_thresholds({10});
+  assert(exec.thresholds() == std::vector<size_t>({10}));
+
+  test_policy(par, exec, 5);
+  test_policy(par, exec, 1000);
+}
+
+
+void test_three_alternatives()
+{
+  using namespace agency;
+  using executor_type = experimental::adaptive_executor<sequenced_executor, unsequenced_executor, parallel_executor>;
+
+  static_assert(bulk_guarantee_t::static_query<executor_type>() == bulk_guarantee_t::unsequenced_t(), "adaptive_executor<sequenced_executor, unsequenced_executor, parallel_executor> should be unsequenced");
+
+  executor_type exec(std::vector<size_t>{10, 1000});
+
+  assert(exec.alternative(5) == 0);
+  assert(exec.alternative(10) == 1);
+  assert(exec.alternative(999) == 1);
+  assert(exec.alternative(1000) == 2);
+
+  // thresholds are kept nondecreasing
+  exec.set_thresholds({50, 10});
+  assert(exec.thresholds() == std::vector<size_t>({50, 50}));
+
+  // missing thresholds select alternatives which are never chosen
+  exec.set_thresholds({50});
+  assert(exec.alternative(size_t(1) << 40) == 1);
+
+  exec.set_thresholds({10, 1000});
+
+  test_policy(unseq, exec, 5);
+  test_policy(unseq, exec, 100);
+  test_policy(unseq, exec, 2000);
+}
+
+
+void test_calibration()
+{
+  using namespace agency;
+  using executor_type = experimental::adaptive_executor<sequenced_executor, parallel_executor>;
+
+  executor_type exec(std::vector<size_t>{100});
+
+  std::vector<size_t> thresholds = exec.calibrate(1 << 10);
+  assert(thresholds.size() == 1);
+  assert(thresholds[0] == size_t(-1) || thresholds[0] <= (1 << 10));
+
+  // default construction calibrates once and shares the result
+  executor_type calibrated1;
+  executor_type calibrated2;
+  calibrated1.set_thresholds({13});
+  assert(calibrated2.thresholds() == std::vector<size_t>({13}));
+
+  test_policy(par, calibrated1, 100);
+}
+
+
+void test_tuning_file()
+{
+  using namespace agency;
+
+  std::stringstream file;
+  experimental::write_adaptive_thresholds(file, {10, 1000});
+
+  assert(experimental::read_adaptive_thresholds(file) == std::vector<size_t>({10, 1000}));
+
+  std::stringstream handwritten("# tuned for this machine\n 64\n# comment\n4096 \n");
+  assert(experimental::read_adaptive_thresholds(handwritten) == std::vector<size_t>({64, 4096}));
+}
+
+
+void test_refinement()
+{
+  using namespace agency;
+  using namespace std::chrono;
+
+  {
+    // alternative 1 is faster for launches of 32 agents, so the threshold falls to 32
+    experimental::detail::adaptive_state state(2, {64});
+
+    for(size_t i = 0; i < experimental::detail::adaptive_state::min_num_samples; ++i)
+    {
+      state.record(0, 32, nanoseconds(100));
+      state.record(1, 32, nanoseconds(10));
+    }
+
+    assert(state.thresholds() == std::vector<size_t>({32}));
+  }
+
+  {
+    // alternative 0 is faster for launches of 100 agents, so the threshold rises to 128
+    experimental::detail::adaptive_state state(2, {64});
+
+    for(size_t i = 0; i < experimental::detail::adaptive_state::min_num_samples; ++i)
+    {
+      state.record(0, 100, nanoseconds(10));
+      state.record(1, 100, nanoseconds(100));
+    }
+
+    assert(state.thresholds() == std::vector<size_t>({128}));
+  }
+
+  {
+    // launches near a threshold occasionally explore the neighboring alternative when refinement is enabled
+    experimental::detail::adaptive_state state(2, {64});
+
+    size_t num_explorations = 0;
+    for(size_t i = 0; i < 4 * experimental::detail::adaptive_state::exploration_period; ++i)
+    {
+      num_explorations += state.select(32);
+    }
+
+    assert(num_explorations == 0);
+
+    state.enable_refinement(true);
+
+    for(size_t i = 0; i < 4 * experimental::detail::adaptive_state::exploration_period; ++i)
+    {
+      num_explorations += state.select(32);
+    }
+
+    assert(num_explorations == 4);
+
+    // launches far from a threshold do not explore
+    for(size_t i = 0; i < 4 * experimental::detail::adaptive_state::exploration_period; ++i)
+    {
+      assert(state.select(1) == 0);
+    }
+  }
+
+  {
+    // an alternative which calibration never found faster is explored at every size, and refinement lowers its threshold
+    experimental::detail::adaptive_state state(2, {size_t(-1)});
+    state.enable_refinement(true);
+
+    size_t num_explorations = 0;
+    for(size_t i = 0; i < 4 * experimental::detail::adaptive_state::exploration_period; ++i)
+    {
+      num_explorations += state.select(1000);
+    }
+
+    assert(num_explorations == 4);
+
+    for(size_t i = 0; i < experimental::detail::adaptive_state::min_num_samples; ++i)
+    {
+      state.record(0, 1000, nanoseconds(100));
+      state.record(1, 1000, nanoseconds(10));
+    }
+
+    assert(state.thresholds() == std::vector<size_t>({512}));
+  }
+
+  {
+    // launches are timed when refinement is enabled
+    using executor_type = experimental::adaptive_executor<sequenced_executor, parallel_executor>;
+
+    executor_type exec(std::vector<size_t>{64});
+    exec.enable_online_refinement();
+    assert(exec.online_refinement());
+
+    for(int i = 0; i < 100; ++i)
+    {
+      test_policy(par, exec, 32);
+      test_policy(par, exec, 128);
+    }
+
+    exec.enable_online_refinement(false);
+    assert(!exec.online_refinement());
+  }
+}
+
+
+int main()
+{
+  test_selection();
+  test_three_alternatives();
+  test_calibration();
+  test_tuning_file();
+  test_refinement();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
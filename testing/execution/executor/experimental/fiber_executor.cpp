@@ -0,0 +1,195 @@
+#include <agency/agency.hpp>
+#include <agency/execution/executor/experimental/fiber_executor.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_twoway_executor.hpp>
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <stdexcept>
+
+
+void test_executor()
+{
+  using namespace agency;
+  using executor_type = experimental::fiber_executor;
+
+  static_assert(is_executor<executor_type>::value,
+    "fiber_executor should be an executor");
+
+  static_assert(detail::is_bulk_twoway_executor<executor_type>::value,
+    "fiber_executor should be a bulk twoway executor");
+
+  static_assert(bulk_guarantee_t::static_query<executor_type>() == bulk_guarantee_t::concurrent_t(),
+    "fiber_executor should have concurrent static bulk guarantee");
+
+  static_assert(detail::is_detected_exact<size_t, executor_shape_t, executor_type>::value,
+    "fiber_executor should have size_t shape_type");
+
+  executor_type exec(3);
+  assert(exec.num_threads() == 3);
+
+  size_t shape = 10;
+
+  auto f = exec.bulk_twoway_execute(
+    [](size_t idx, std::vector<int>& results, std::vector<int>& shared_arg)
+    {
+      results[idx] = shared_arg[idx];
+    },
+    shape,
+    [=]{ return std::vector<int>(shape); },     // results
+    [=]{ return std::vector<int>(shape, 13); }  // shared_arg
+  );
+
+  assert(std::vector<int>(shape, 13) == f.get());
+}
+
+
+// each agent of the group repeatedly passes a value to its neighbor through shared memory, waiting at the group's barrier
+// between steps, and returns the value it holds at the end
+std::vector<int> rotate(const agency::experimental::fiber_executor& exec, size_t group_size, size_t num_steps)
+{
+  using namespace agency;
+
+  std::vector<int> result(group_size);
+
+  bulk_invoke(con(group_size).on(exec), [&](concurrent_agent& self, std::vector<int>& values)
+  {
+    size_t i = self.rank();
+    values[i] = static_cast<int>(i);
+    self.wait();
+
+    for(size_t step = 0; step < num_steps; ++step)
+    {
+      int neighbor_value = values[(i + 1) % group_size];
+      self.wait();
+
+      values[i] = neighbor_value;
+      self.wait();
+    }
+
+    result[i] = values[i];
+  },
+  share<std::vector<int>>(group_size));
+
+  return result;
+}
+
+
+void test_barriers()
+{
+  using namespace agency;
+
+  for(size_t num_threads : {1, 2, 4})
+  {
+    experimental::fiber_executor exec(num_threads);
+
+    // groups much larger than the number of threads synchronize through their barrier
+    size_t group_size = 1024;
+    size_t num_steps = 5;
+
+    std::vector<int> result = rotate(exec, group_size, num_steps);
+
+    for(size_t i = 0; i < group_size; ++i)
+    {
+      assert(result[i] == static_cast<int>((i + num_steps) % group_size));
+    }
+  }
+}
+
+
+void test_collectives()
+{
+  using namespace agency;
+
+  size_t group_size = 512;
+
+  std::vector<int> sums(group_size), broadcasts(group_size);
+
+  bulk_invoke(con(group_size).on(experimental::fiber_executor(2)), [&](concurrent_agent& self)
+  {
+    experimental::optional<int> value;
+    if(self.elect())
+    {
+      value = 42;
+    }
+
+    broadcasts[self.rank()] = self.broadcast(value);
+    sums[self.rank()] = self.all_reduce(static_cast<int>(self.rank()), std::plus<int>());
+  });
+
+  assert(broadcasts == std::vector<int>(group_size, 42));
+  assert(sums == std::vector<int>(group_size, static_cast<int>(group_size * (group_size - 1) / 2)));
+}
+
+
+void test_scoped()
+{
+  using namespace agency;
+
+  size_t num_groups = 8;
+  size_t group_size = 256;
+
+  std::vector<int> result(num_groups * group_size);
+
+  // each group executes its fibers on the thread of its parallel agent
+  bulk_invoke(par(num_groups, con(group_size).on(experimental::fiber_executor(1))), [&](parallel_group<concurrent_agent>& self, int& shared_counter)
+  {
+    self.inner().wait();
+
+    if(self.inner().elect())
+    {
+      shared_counter = 0;
+    }
+
+    self.inner().wait();
+
+    // the fibers of each group share a single thread, so they increment the counter one at a time
+    ++shared_counter;
+
+    self.inner().wait();
+
+    result[self.outer().index() * group_size + self.inner().index()] = shared_counter;
+  },
+  share_at_scope<1>(0));
+
+  assert(result == std::vector<int>(num_groups * group_size, static_cast<int>(group_size)));
+}
+
+
+void test_exceptions()
+{
+  using namespace agency;
+
+  bool caught = false;
+
+  try
+  {
+    bulk_invoke(con(16).on(experimental::fiber_executor(2)), [](concurrent_agent& self)
+    {
+      if(self.rank() == 7)
+      {
+        throw std::runtime_error("error");
+      }
+    });
+  }
+  catch(std::runtime_error&)
+  {
+    caught = true;
+  }
+
+  assert(caught);
+}
+
+
+int main()
+{
+  test_executor();
+  test_barriers();
+  test_collectives();
+  test_scoped();
+  test_exceptions();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,189 @@
+#include <agency/agency.hpp>
+#include <agency/execution/executor/experimental/tracing_executor.hpp>
+#include <agency/execution/executor/executor_traits.hpp>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cassert>
+
+
+// returns the number of launches, and the number of agents executed by worker threads, recorded in the trace
+void count_events(size_t& num_launches, size_t& num_agents_executed)
+{
+  num_launches = 0;
+  num_agents_executed = 0;
+
+  for(auto& thread : agency::experimental::detail::trace_registry::instance().events())
+  {
+    for(auto& e : thread.second)
+    {
+      if(e.kind == agency::experimental::detail::trace_event::launch_event)
+      {
+        ++num_launches;
+      }
+      else
+      {
+        num_agents_executed += e.num_agents;
+      }
+    }
+  }
+}
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy, size_t n)
+{
+  using namespace agency;
+
+  auto traced_policy = policy.on(experimental::make_tracing_executor(policy.executor()));
+
+  using executor_type = typename std::decay<decltype(traced_policy.executor())>::type;
+
+  static_assert(std::is_same<executor_shape_t<executor_type>, executor_shape_t<typename std::decay<decltype(policy.executor())>::type>>::value,
+    "tracing_executor should have the same shape_type as its base executor");
+
+  experimental::clear_trace();
+
+  {
+    // test bulk_invoke()
+    std::atomic<size_t> counter{0};
+
+    bulk_invoke(traced_policy, [&](typename ExecutionPolicy::execution_agent_type&)
+    {
+      ++counter;
+    });
+
+    assert(counter == n);
+
+    size_t num_launches = 0, num_agents_executed = 0;
+    count_events(num_launches, num_agents_executed);
+
+    assert(num_launches == 1);
+    assert(num_agents_executed == n);
+  }
+
+  {
+    // test bulk_async()
+    std::atomic<size_t> counter{0};
+
+    bulk_async(traced_policy, [&](typename ExecutionPolicy::execution_agent_type&)
+    {
+      ++counter;
+    }).wait();
+
+    assert(counter == n);
+
+    size_t num_launches = 0, num_agents_executed = 0;
+    count_events(num_launches, num_agents_executed);
+
+    assert(num_launches == 2);
+    assert(num_agents_executed == 2 * n);
+  }
+
+  {
+    // test write_chrome_trace()
+    std::stringstream trace;
+    experimental::write_chrome_trace(trace);
+
+    assert(trace.str().find("\"traceEvents\"") != std::string::npos);
+    assert(trace.str().find("\"cat\": \"launch\"") != std::string::npos);
+    assert(trace.str().find("\"cat\": \"agents\"") != std::string::npos);
+    assert(trace.str().find("\"queueing_delay_us\"") != std::string::npos);
+  }
+
+  {
+    // test write_trace_summary()
+    std::stringstream summary;
+    experimental::write_trace_summary(summary);
+
+    assert(summary.str().find("launches: 2\n") != std::string::npos);
+    assert(summary.str().find("agents: " + std::to_string(2 * n) + "\n") != std::string::npos);
+  }
+
+  {
+    // test clear_trace()
+    experimental::clear_trace();
+
+    size_t num_launches = 0, num_agents_executed = 0;
+    count_events(num_launches, num_agents_executed);
+
+    assert(num_launches == 0);
+    assert(num_agents_executed == 0);
+  }
+}
+
+
+int main()
+{
+  using namespace agency;
+
+  {
+    using executor_type = experimental::tracing_executor<parallel_executor>;
+
+    static_assert(detail::is_bulk_then_executor<executor_type>::value,
+      "tracing_executor<parallel_executor> should be a bulk then executor");
+
+    static_assert(bulk_guarantee_t::static_query<executor_type>() == bulk_guarantee_t::static_query<parallel_executor>(),
+      "tracing_executor should have the same static bulk guarantee as its base executor");
+  }
+
+  test(seq(10), 10);
+  test(par(10), 10);
+  test(con(10), 10);
+  test(par(2, seq(3)), 6);
+
+  {
+    // test that the shape of a scoped launch is recorded
+    auto policy = par(2, seq(3));
+
+    experimental::clear_trace();
+
+    bulk_invoke(policy.on(experimental::make_tracing_executor(policy.executor())), [](parallel_group<sequenced_agent>&){});
+
+    std::vector<size_t> shape;
+
+    for(auto& thread : experimental::detail::trace_registry::instance().events())
+    {
+      for(auto& e : thread.second)
+      {
+        if(e.kind == experimental::detail::trace_event::launch_event)
+        {
+          shape.assign(e.shape, e.shape + e.shape_rank);
+        }
+      }
+    }
+
+    assert(shape == std::vector<size_t>({2, 3}));
+  }
+
+  {
+    // test that clear_trace() discards the buffers of exited threads
+    experimental::clear_trace();
+
+    size_t num_threads = experimental::detail::trace_registry::instance().events().size();
+
+    std::thread t([]
+    {
+      auto policy = seq(10);
+      bulk_invoke(policy.on(experimental::make_tracing_executor(policy.executor())), [](sequenced_agent&){});
+    });
+
+    t.join();
+
+    // the work of the exited thread remains in the trace until it is cleared
+    assert(experimental::detail::trace_registry::instance().events().size() == num_threads + 1);
+
+    experimental::clear_trace();
+
+    assert(experimental::detail::trace_registry::instance().events().size() == num_threads);
+  }
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
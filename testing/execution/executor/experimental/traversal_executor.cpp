@@ -0,0 +1,188 @@
+#include <agency/agency.hpp>
+#include <agency/execution/executor/experimental/traversal_executor.hpp>
+#include <agency/execution/executor/executor_traits.hpp>
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cassert>
+
+
+// checks that a traversal visits each index of shape exactly once
+template<class Traversal, class Shape>
+void test_traversal(const Shape& shape)
+{
+  using namespace agency;
+
+  typename Traversal::template mapping<Shape> mapping(shape);
+
+  std::vector<int> visits(detail::index_space_size(shape), 0);
+
+  for(size_t position = 0; position < mapping.size(); ++position)
+  {
+    Shape idx;
+    if(mapping.index_of(position, idx))
+    {
+      ++visits[detail::index_lexicographical_rank(idx, shape)];
+    }
+  }
+
+  assert(std::all_of(visits.begin(), visits.end(), [](int x){ return x == 1; }));
+}
+
+
+void test_traversals()
+{
+  using namespace agency;
+  using namespace agency::experimental;
+
+  test_traversal<lexicographic_traversal>(size2(5,7));
+
+  test_traversal<tiled_traversal<2,4>>(size2(8,8));
+  test_traversal<tiled_traversal<2,4>>(size2(5,7));
+  test_traversal<tiled_traversal<3,3>>(size2(1,1));
+  test_traversal<tiled_traversal<2,3,4>>(size3(5,6,7));
+
+  test_traversal<morton_traversal>(size2(8,8));
+  test_traversal<morton_traversal>(size2(5,7));
+  test_traversal<morton_traversal>(size3(3,4,5));
+
+  {
+    // tiles are visited one at a time
+    tiled_traversal<2,2>::mapping<size2> mapping(size2(4,5));
+
+    std::vector<size2> expected = {
+      {0,0}, {0,1}, {1,0}, {1,1}, // first tile
+      {0,2}, {0,3}, {1,2}, {1,3}, // second tile
+      {0,4}, {1,4},               // clipped tile
+      {2,0}, {2,1}, {3,0}, {3,1}  // first tile of the second row of tiles
+    };
+
+    for(size_t position = 0; position < expected.size(); ++position)
+    {
+      size2 idx;
+      assert(mapping.index_of(position, idx));
+      assert(idx == expected[position]);
+    }
+
+    size2 idx;
+    assert(!mapping.index_of(mapping.size(), idx));
+  }
+}
+
+
+template<class Traversal, class ExecutionPolicy>
+void test_executor(ExecutionPolicy policy)
+{
+  using namespace agency;
+  using executor_type = experimental::traversal_executor<typename ExecutionPolicy::executor_type, Traversal>;
+
+  static_assert(std::is_same<executor_shape_t<executor_type>, size2>::value, "traversal_executor should have a two-dimensional shape");
+  static_assert(bulk_guarantee_t::static_query<executor_type>() == bulk_guarantee_t::static_query<typename ExecutionPolicy::executor_type>(), "traversal_executor should have the bulk guarantee of its base executor");
+
+  size2 shape(13,21);
+
+  auto traversal_policy = policy(shape).on(executor_type());
+
+  {
+    // test bulk_invoke()
+    std::vector<std::atomic<int>> visits(shape[0] * shape[1]);
+
+    bulk_invoke(traversal_policy, [&](typename ExecutionPolicy::execution_agent_type& self)
+    {
+      auto idx = self.index();
+      ++visits[idx[0] * shape[1] + idx[1]];
+    });
+
+    assert(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& x){ return x == 1; }));
+  }
+
+  {
+    // test bulk_invoke() with results
+    auto results = bulk_invoke(traversal_policy, [](typename ExecutionPolicy::execution_agent_type& self)
+    {
+      return self.index();
+    });
+
+    for(auto idx : lattice<size2>(shape))
+    {
+      assert(results[idx] == idx);
+    }
+  }
+
+  {
+    // test bulk_invoke() with a shared parameter
+    auto results = bulk_invoke(traversal_policy, [](typename ExecutionPolicy::execution_agent_type& self, int& shared_value)
+    {
+      return shared_value + static_cast<int>(self.rank());
+    },
+    share<int>(13));
+
+    for(auto idx : lattice<size2>(shape))
+    {
+      assert(results[idx] == static_cast<int>(13 + idx[0] * shape[1] + idx[1]));
+    }
+  }
+
+  {
+    // test bulk_then()
+    std::vector<std::atomic<int>> visits(shape[0] * shape[1]);
+
+    auto predecessor = agency::make_ready_future<int>(executor_type(), 13);
+
+    bulk_then(traversal_policy, [&](typename ExecutionPolicy::execution_agent_type& self, int& value)
+    {
+      auto idx = self.index();
+      visits[idx[0] * shape[1] + idx[1]] += value;
+    },
+    predecessor).wait();
+
+    assert(std::all_of(visits.begin(), visits.end(), [](const std::atomic<int>& x){ return x == 13; }));
+  }
+}
+
+
+void test_order()
+{
+  using namespace agency;
+  using executor_type = experimental::traversal_executor<sequenced_executor, experimental::tiled_traversal<2,2>>;
+
+  // sequenced agents are created in the order of the traversal
+  std::vector<size2> visited;
+
+  bulk_invoke(seq2d(size2(0,0), size2(4,4)).on(executor_type()), [&](sequenced_agent_2d& self)
+  {
+    visited.push_back(self.index());
+  });
+
+  std::vector<size2> expected = {
+    {0,0}, {0,1}, {1,0}, {1,1},
+    {0,2}, {0,3}, {1,2}, {1,3},
+    {2,0}, {2,1}, {3,0}, {3,1},
+    {2,2}, {2,3}, {3,2}, {3,3}
+  };
+
+  assert(visited == expected);
+}
+
+
+int main()
+{
+  using namespace agency;
+  using namespace agency::experimental;
+
+  test_traversals();
+
+  test_executor<lexicographic_traversal>(par2d);
+  test_executor<tiled_traversal<4,4>>(par2d);
+  test_executor<morton_traversal>(par2d);
+  test_executor<tiled_traversal<4,4>>(seq2d);
+  test_executor<morton_traversal>(unseq2d);
+
+  test_order();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,307 @@
+#include <iostream>
+#include <type_traits>
+#include <vector>
+#include <stdexcept>
+#include <cassert>
+
+#include <agency/execution/executor/executor_array.hpp>
+#include <agency/execution/executor/sequenced_executor.hpp>
+#include <agency/execution/executor/parallel_executor.hpp>
+#include <agency/execution/executor/inner_executor_selection.hpp>
+
+
+// the id of the inner executor which most recently began executing a group on this thread
+thread_local int current_executor_id = -1;
+
+
+// identified_executor is a sequenced_executor which records its id before executing a group
+class identified_executor : public agency::sequenced_executor
+{
+  public:
+    identified_executor(int id = -1) : id_(id) {}
+
+    template<class Function, class ResultFactory, class SharedFactory>
+    agency::always_ready_future<agency::detail::result_of_t<ResultFactory()>>
+      bulk_twoway_execute(Function f, size_t n, ResultFactory result_factory, SharedFactory shared_factory) const
+    {
+      current_executor_id = id_;
+      return agency::sequenced_executor::bulk_twoway_execute(f, n, result_factory, shared_factory);
+    }
+
+    friend bool operator==(const identified_executor& a, const identified_executor& b) noexcept
+    {
+      return a.id_ == b.id_;
+    }
+
+    friend bool operator!=(const identified_executor& a, const identified_executor& b) noexcept
+    {
+      return !(a == b);
+    }
+
+  private:
+    int id_;
+};
+
+
+// executes num_groups groups of group_size agents on exec, and returns the id of the inner executor which executed each group
+template<class ExecutorArray>
+std::vector<int> executor_of_each_group(const ExecutorArray& exec, size_t num_groups, size_t group_size = 2)
+{
+  using shape_type = agency::executor_shape_t<ExecutorArray>;
+  using index_type = agency::executor_index_t<ExecutorArray>;
+
+  auto predecessor = agency::make_ready_future<void>(exec);
+
+  auto fut = exec.bulk_then_execute(
+    [](index_type idx, std::vector<int>& results, int&, int&)
+    {
+      results[agency::get<0>(idx)] = current_executor_id;
+    },
+    shape_type(num_groups, group_size),
+    predecessor,
+    [=]{ return std::vector<int>(num_groups, -1); }, // results
+    []{ return 0; },                                 // outer_shared_arg
+    []{ return 0; }                                  // inner_shared_arg
+  );
+
+  return fut.get();
+}
+
+
+std::vector<identified_executor> make_executors(size_t n)
+{
+  std::vector<identified_executor> result;
+  for(size_t i = 0; i < n; ++i)
+  {
+    result.push_back(identified_executor(i));
+  }
+
+  return result;
+}
+
+
+void test_round_robin_selection()
+{
+  using namespace agency;
+
+  static_assert(std::is_same<executor_array<sequenced_executor>::selection_policy_type, round_robin_selection>::value,
+    "executor_array should select inner executors round-robin by default");
+
+  auto executors = make_executors(3);
+  executor_array<identified_executor, sequenced_executor> exec(executors.begin(), executors.end());
+
+  assert(executor_of_each_group(exec, 7) == std::vector<int>({0, 1, 2, 0, 1, 2, 0}));
+}
+
+
+void test_least_loaded_selection()
+{
+  using namespace agency;
+
+  {
+    // test select() and release() directly
+    least_loaded_selection policy(3);
+
+    // idle executors are selected starting from the rank of the group
+    assert(policy.select(1, 3) == 1);
+    assert(policy.select(1, 3) == 2);
+    assert(policy.select(1, 3) == 0);
+
+    // executor 2 is the only idle executor once its group completes
+    policy.release(2);
+    assert(policy.select(0, 3) == 2);
+    assert(policy.occupancy(2).outstanding == 1);
+    assert(policy.occupancy(2).assigned == 2);
+
+    // executors 0 & 1 become idle, and ties go to the first candidate at or after the rank
+    policy.release(0);
+    policy.release(1);
+    assert(policy.select(4, 3) == 1);
+    assert(policy.occupancy(0).outstanding == 0);
+    assert(policy.occupancy(0).assigned == 1);
+  }
+
+  {
+    // test that copies share occupancy
+    least_loaded_selection policy(2);
+    least_loaded_selection copy = policy;
+
+    copy.select(0, 2);
+    assert(policy.occupancy(0).outstanding == 1);
+  }
+
+  {
+    // test that a default-constructed policy selects round-robin
+    least_loaded_selection policy;
+    assert(policy.select(5, 3) == 2);
+    assert(policy.occupancy(2).assigned == 0);
+  }
+
+  {
+    // test with a sequenced outer executor
+    // each group completes before the next is selected, so every executor is idle and groups are assigned round-robin
+    auto executors = make_executors(3);
+    executor_array<identified_executor, sequenced_executor, least_loaded_selection> exec(executors.begin(), executors.end());
+
+    assert(executor_of_each_group(exec, 7) == std::vector<int>({0, 1, 2, 0, 1, 2, 0}));
+
+    assert(exec.selection_policy().occupancy(0).assigned == 3);
+    assert(exec.selection_policy().occupancy(1).assigned == 2);
+    assert(exec.selection_policy().occupancy(2).assigned == 2);
+
+    for(size_t i = 0; i < exec.size(); ++i)
+    {
+      assert(exec.selection_policy().occupancy(i).outstanding == 0);
+    }
+  }
+
+  {
+    // test that a group whose agents throw releases its executor
+    auto executors = make_executors(3);
+    executor_array<identified_executor, sequenced_executor, least_loaded_selection> exec(executors.begin(), executors.end());
+
+    using index_type = executor_index_t<decltype(exec)>;
+    using shape_type = executor_shape_t<decltype(exec)>;
+
+    bool caught = false;
+
+    try
+    {
+      auto predecessor = make_ready_future<void>(exec);
+
+      exec.bulk_then_execute(
+        [](index_type, std::vector<int>&, int&, int&)
+        {
+          throw std::runtime_error("error");
+        },
+        shape_type(1, 2),
+        predecessor,
+        []{ return std::vector<int>(1); }, // results
+        []{ return 0; },                   // outer_shared_arg
+        []{ return 0; }                    // inner_shared_arg
+      ).get();
+    }
+    catch(std::runtime_error&)
+    {
+      caught = true;
+    }
+
+    assert(caught);
+
+    for(size_t i = 0; i < exec.size(); ++i)
+    {
+      assert(exec.selection_policy().occupancy(i).outstanding == 0);
+    }
+  }
+
+  {
+    // test with parallel executors
+    executor_array<parallel_executor, parallel_executor, least_loaded_selection> exec(4);
+
+    using index_type = executor_index_t<decltype(exec)>;
+    using shape_type = executor_shape_t<decltype(exec)>;
+
+    auto predecessor = make_ready_future<void>(exec);
+
+    auto fut = exec.bulk_then_execute(
+      [](index_type idx, std::vector<int>& results, int&, int&)
+      {
+        results[agency::get<0>(idx)] += 1;
+      },
+      shape_type(100, 1),
+      predecessor,
+      []{ return std::vector<int>(100); }, // results
+      []{ return 0; },                     // outer_shared_arg
+      []{ return 0; }                      // inner_shared_arg
+    );
+
+    assert(fut.get() == std::vector<int>(100, 1));
+
+    // every group has been released
+    size_t num_assigned = 0;
+    for(size_t i = 0; i < exec.size(); ++i)
+    {
+      assert(exec.selection_policy().occupancy(i).outstanding == 0);
+      num_assigned += exec.selection_policy().occupancy(i).assigned;
+    }
+
+    assert(num_assigned == 100);
+  }
+}
+
+
+void test_affinity_selection()
+{
+  using namespace agency;
+
+  // executors 0 & 2 are in domain 0, and executors 1 & 3 are in domain 1
+  std::vector<size_t> domains = {0, 1, 0, 1};
+
+  // the data of groups [0, 4) live in domain 1, and the data of the remaining groups live in domain 0
+  auto policy = make_affinity_selection(domains, [](size_t rank) { return rank < 4 ? 1 : 0; });
+
+  {
+    // test select() directly
+    auto copy = policy;
+
+    assert(copy.domain(2) == 0);
+
+    size_t a = copy.select(0, 4);
+    size_t b = copy.select(0, 4);
+    assert(domains[a] == 1 && domains[b] == 1 && a != b);
+
+    copy.release(a);
+    copy.release(b);
+  }
+
+  {
+    // test with a sequenced outer executor
+    auto executors = make_executors(4);
+    executor_array<identified_executor, sequenced_executor, decltype(policy)> exec(executors.begin(), executors.end(), policy);
+
+    std::vector<int> result = executor_of_each_group(exec, 8);
+
+    for(size_t rank = 0; rank < result.size(); ++rank)
+    {
+      assert(domains[result[rank]] == (rank < 4 ? 1u : 0u));
+    }
+  }
+
+  {
+    // test that groups whose domain has no executor may go to any executor
+    auto elsewhere = make_affinity_selection(domains, [](size_t) { return 7; });
+
+    assert(elsewhere.select(3, 4) == 3);
+  }
+}
+
+
+void test_mapped_selection()
+{
+  using namespace agency;
+
+  // send every group to the last executor
+  auto policy = make_mapped_selection([](size_t) { return 3; });
+
+  auto executors = make_executors(4);
+  executor_array<identified_executor, sequenced_executor, decltype(policy)> exec(executors.begin(), executors.end(), policy);
+
+  assert(executor_of_each_group(exec, 5) == std::vector<int>(5, 3));
+
+  // results wrap around
+  assert(make_mapped_selection([](size_t rank) { return rank + 1; }).select(3, 4) == 0);
+}
+
+
+int main()
+{
+  test_round_robin_selection();
+  test_least_loaded_selection();
+  test_affinity_selection();
+  test_mapped_selection();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,139 @@
+#include <iostream>
+#include <type_traits>
+#include <vector>
+#include <cassert>
+
+// XXX use parallel_executor.hpp instead of thread_pool.hpp due to circular #inclusion problems
+#include <agency/execution/executor/parallel_executor.hpp>
+#include <agency/execution/executor/executor_traits.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_then_executor.hpp>
+#include <agency/execution/executor/customization_points.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/bulk_invoke.hpp>
+#include <agency/execution/execution_policy.hpp>
+
+
+void test(agency::detail::numa_thread_pool_executor exec)
+{
+  using namespace agency;
+
+  {
+    // bulk_then_execute() with non-void predecessor
+    
+    agency::future<int> predecessor_fut = agency::make_ready_future<int>(exec, 7);
+
+    size_t shape = 100;
+    
+    auto f = exec.bulk_then_execute(
+      [](size_t idx, int& predecessor, std::vector<int>& results, std::vector<int>& shared_arg)
+      {
+        results[idx] = predecessor + shared_arg[idx];
+      },
+      shape,
+      predecessor_fut,
+      [=]{ return std::vector<int>(shape); },     // results
+      [=]{ return std::vector<int>(shape, 13); }  // shared_arg
+    );
+    
+    auto result = f.get();
+    
+    assert(std::vector<int>(shape, 7 + 13) == result);
+  }
+
+
+  {
+    // bulk_then_execute() with void predecessor
+    
+    agency::future<void> predecessor_fut = agency::make_ready_future<void>(exec);
+
+    size_t shape = 100;
+    
+    auto f = exec.bulk_then_execute(
+      [](size_t idx, std::vector<int>& results, std::vector<int>& shared_arg)
+      {
+        results[idx] = shared_arg[idx];
+      },
+      shape,
+      predecessor_fut,
+      [=]{ return std::vector<int>(shape); },     // results
+      [=]{ return std::vector<int>(shape, 13); }  // shared_arg
+    );
+    
+    auto result = f.get();
+    
+    assert(std::vector<int>(shape, 13) == result);
+  }
+
+
+  {
+    // bulk_invoke() with a parallel executor composed from exec
+
+    detail::parallel_numa_thread_pool_executor par_exec{
+      scoped_executor<detail::numa_thread_pool_executor, this_thread::parallel_executor>(exec, this_thread::parallel_executor())
+    };
+
+    for(size_t n : {0, 1, 7, 1000})
+    {
+      std::vector<int> data(n, 0);
+
+      bulk_invoke(par(n).on(par_exec), [&](parallel_agent& self)
+      {
+        data[self.index()] += 1;
+      });
+
+      assert(std::vector<int>(n, 1) == data);
+    }
+  }
+}
+
+
+int main()
+{
+  using namespace agency;
+
+  static_assert(detail::is_bulk_then_executor<detail::numa_thread_pool_executor>::value,
+    "numa_thread_pool_executor should be a bulk then executor");
+
+  static_assert(bulk_guarantee_t::static_query<detail::numa_thread_pool_executor>() == bulk_guarantee_t::parallel_t(),
+    "numa_thread_pool_executor should have parallel static bulk guarantee");
+
+  static_assert(detail::is_detected_exact<size_t, executor_shape_t, detail::numa_thread_pool_executor>::value,
+    "numa_thread_pool_executor should have size_t shape_type");
+
+  static_assert(executor_execution_depth<detail::numa_thread_pool_executor>::value == 1,
+    "numa_thread_pool_executor should have execution_depth == 1");
+
+  {
+    // test the system_numa_thread_pool
+    detail::numa_thread_pool_executor exec;
+    test(exec);
+  }
+
+  {
+    // test a numa_thread_pool on a two-node topology built from the first available cpu
+    int cpu = detail::cpu_topology::system().node(0)[0];
+    detail::cpu_topology topology({{cpu}, {cpu}});
+
+    detail::numa_thread_pool pool(detail::thread_pool_config(3, detail::thread_pool_config::compact), detail::thread_pool::work_stealing, topology);
+
+    assert(pool.num_nodes() == 2);
+    assert(pool.node(0).size() == 2);
+    assert(pool.node(1).size() == 1);
+    assert(pool.size() == 3);
+
+    // indices are divided among nodes in proportion to their size
+    auto partitions = pool.partitions(9);
+    assert(partitions.size() == 2);
+    assert(partitions[0].pool == &pool.node(0) && partitions[0].begin == 0 && partitions[0].end == 6);
+    assert(partitions[1].pool == &pool.node(1) && partitions[1].begin == 6 && partitions[1].end == 9);
+
+    detail::numa_thread_pool_executor exec(pool);
+    test(exec);
+
+    test(exec.require(schedule.dynamic(4)));
+  }
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
@@ -24,15 +24,15 @@ int main()
   static_assert(detail::is_detected_exact<size_t, executor_index_t, parallel_executor>::value,
     "parallel_executor should have size_t index_type");
 
-  static_assert(detail::is_detected_exact<std::future<int>, executor_future_t, parallel_executor, int>::value,
-    "parallel_executor should have std::future future");
+  static_assert(detail::is_detected_exact<agency::future<int>, executor_future_t, parallel_executor, int>::value,
+    "parallel_executor should have agency::future future");
 
   static_assert(executor_execution_depth<parallel_executor>::value == 1,
     "parallel_executor should have execution_depth == 1");
 
   parallel_executor exec;
 
-  std::future<int> fut = agency::make_ready_future<int>(exec, 7);
+  agency::future<int> fut = agency::make_ready_future<int>(exec, 7);
 
   size_t shape = 10;
   
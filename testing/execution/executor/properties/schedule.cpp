@@ -0,0 +1,131 @@
+#include <agency/agency.hpp>
+#include <agency/execution/executor.hpp>
+#include <iostream>
+#include <vector>
+#include <cassert>
+
+
+template<class Executor>
+void test(Executor exec)
+{
+  using namespace agency;
+
+  for(size_t n : {0, 1, 7, 100, 10007})
+  {
+    {
+      // test that every agent executes exactly once
+      std::vector<int> counts(n, 0);
+
+      bulk_invoke(par(n).on(exec), [&](parallel_agent& self)
+      {
+        counts[self.index()] += 1;
+      });
+
+      assert(std::vector<int>(n, 1) == counts);
+    }
+
+    {
+      // test that results are collected at the agents' indices
+      auto results = bulk_invoke(par(n).on(exec), [](parallel_agent& self)
+      {
+        return self.index();
+      });
+
+      for(size_t i = 0; i < n; ++i)
+      {
+        assert(results[i] == i);
+      }
+    }
+  }
+}
+
+
+int main()
+{
+  using namespace agency;
+
+  {
+    // test property values
+
+    static_assert(schedule_t(schedule.uniform()).is_uniform(), "Schedule should be uniform.");
+    static_assert(schedule_t(schedule.dynamic()).is_dynamic(), "Schedule should be dynamic.");
+    static_assert(schedule_t(schedule.guided()).is_guided(), "Schedule should be guided.");
+
+    static_assert(schedule.dynamic(16).chunk_size() == 16, "Chunk size should be 16.");
+    static_assert(schedule.dynamic(0).chunk_size() == 1, "Chunk size should be at least 1.");
+
+    static_assert(schedule_t(schedule.dynamic(16)) != schedule_t(schedule.dynamic(8)), "Schedules with different chunk sizes should not be equal.");
+    static_assert(schedule_t(schedule.dynamic(16)) != schedule_t(schedule.guided(16)), "Schedules of different kinds should not be equal.");
+  }
+
+  {
+    // test query()
+
+    parallel_executor par_ex;
+    assert(query(par_ex, schedule) == schedule.uniform());
+
+    detail::thread_pool_executor pool_ex;
+    assert(query(pool_ex, schedule) == schedule.uniform());
+  }
+
+  {
+    // uniform -> dynamic
+    auto ex = require(parallel_executor(), schedule.dynamic(4));
+
+    static_assert(std::is_same<parallel_executor, decltype(ex)>::value, "Result is not the same type as the original.");
+    assert(query(ex, schedule) == schedule.dynamic(4));
+
+    test(ex);
+  }
+
+  {
+    // uniform -> guided
+    auto ex = require(parallel_executor(), schedule.guided(2));
+
+    static_assert(std::is_same<parallel_executor, decltype(ex)>::value, "Result is not the same type as the original.");
+    assert(query(ex, schedule) == schedule.guided(2));
+
+    test(ex);
+  }
+
+  {
+    // guided -> uniform
+    auto ex = require(require(parallel_executor(), schedule.guided()), schedule.uniform());
+
+    assert(query(ex, schedule) == schedule.uniform());
+    assert(ex == parallel_executor());
+
+    test(ex);
+  }
+
+  {
+    // test thread_pool_executor's schedules directly
+    detail::thread_pool pool(3);
+    detail::thread_pool_executor pool_ex(pool);
+
+    for(auto ex : {pool_ex, require(pool_ex, schedule.dynamic(3)), require(pool_ex, schedule.guided())})
+    {
+      for(size_t n : {0, 1, 2, 3, 4, 100, 1001})
+      {
+        auto ready = make_ready_future<void>(ex);
+
+        auto f = ex.bulk_then_execute(
+          [](size_t idx, std::vector<int>& results, int&)
+          {
+            results[idx] += 1;
+          },
+          n,
+          ready,
+          [=]{ return std::vector<int>(n); }, // results
+          []{ return 0; }                     // shared_arg
+        );
+
+        assert(std::vector<int>(n, 1) == f.get());
+      }
+    }
+  }
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
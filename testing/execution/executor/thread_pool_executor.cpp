@@ -1,6 +1,8 @@
 #include <iostream>
 #include <type_traits>
 #include <vector>
+#include <atomic>
+#include <thread>
 
 // XXX use parallel_executor.hpp instead of thread_pool.hpp due to circular #inclusion problems
 #include <agency/execution/executor/parallel_executor.hpp>
@@ -10,35 +12,14 @@
 #include <agency/execution/executor/properties/bulk_guarantee.hpp>
 
 
-int main()
+void test(agency::detail::thread_pool_executor exec)
 {
   using namespace agency;
 
-  static_assert(detail::is_bulk_then_executor<detail::thread_pool_executor>::value,
-    "thread_pool_executor should be a bulk then executor");
-
-  static_assert(bulk_guarantee_t::static_query<detail::thread_pool_executor>() == bulk_guarantee_t::parallel_t(),
-    "thread_pool_executor should have parallel static bulk guarantee");
-
-  static_assert(detail::is_detected_exact<size_t, executor_shape_t, detail::thread_pool_executor>::value,
-    "thread_pool_executor should have size_t shape_type");
-
-  static_assert(detail::is_detected_exact<size_t, executor_index_t, detail::thread_pool_executor>::value,
-    "thread_pool_executor should have size_t index_type");
-
-  static_assert(detail::is_detected_exact<std::future<int>, executor_future_t, detail::thread_pool_executor, int>::value,
-    "thread_pool_executor should have std::future future");
-
-  static_assert(executor_execution_depth<detail::thread_pool_executor>::value == 1,
-    "thread_pool_executor should have execution_depth == 1");
-
-  detail::thread_pool_executor exec;
-
-
   {
     // bulk_then_execute() with non-void predecessor
     
-    std::future<int> predecessor_fut = agency::make_ready_future<int>(exec, 7);
+    agency::future<int> predecessor_fut = agency::make_ready_future<int>(exec, 7);
 
     size_t shape = 10;
     
@@ -62,7 +43,7 @@ int main()
   {
     // bulk_then_execute() with void predecessor
     
-    std::future<void> predecessor_fut = agency::make_ready_future<void>(exec);
+    agency::future<void> predecessor_fut = agency::make_ready_future<void>(exec);
 
     size_t shape = 10;
     
@@ -82,6 +63,160 @@ int main()
     assert(std::vector<int>(10, 13) == result);
   }
 
+
+  {
+    // a long pipeline of launches, none of whose predecessors are ready when it is launched
+
+    agency::promise<void> start;
+    agency::future<void> start_fut = start.get_future();
+
+    auto f = exec.bulk_then_execute(
+      [](size_t idx, int& result, int&)
+      {
+        if(idx == 0) result = 0;
+      },
+      4,
+      start_fut,
+      []{ return 0; }, // result
+      []{ return 0; }  // shared_arg
+    );
+
+    for(int i = 0; i < 1000; ++i)
+    {
+      f = exec.bulk_then_execute(
+        [](size_t idx, int& predecessor, int& result, int&)
+        {
+          if(idx == 0) result = predecessor + 1;
+        },
+        4,
+        f,
+        []{ return 0; }, // result
+        []{ return 0; }  // shared_arg
+      );
+    }
+
+    start.set_value();
+
+    assert(f.get() == 1000);
+  }
+}
+
+
+int main()
+{
+  using namespace agency;
+
+  static_assert(detail::is_bulk_then_executor<detail::thread_pool_executor>::value,
+    "thread_pool_executor should be a bulk then executor");
+
+  static_assert(bulk_guarantee_t::static_query<detail::thread_pool_executor>() == bulk_guarantee_t::parallel_t(),
+    "thread_pool_executor should have parallel static bulk guarantee");
+
+  static_assert(detail::is_detected_exact<size_t, executor_shape_t, detail::thread_pool_executor>::value,
+    "thread_pool_executor should have size_t shape_type");
+
+  static_assert(detail::is_detected_exact<size_t, executor_index_t, detail::thread_pool_executor>::value,
+    "thread_pool_executor should have size_t index_type");
+
+  static_assert(detail::is_detected_exact<agency::future<int>, executor_future_t, detail::thread_pool_executor, int>::value,
+    "thread_pool_executor should have agency::future future");
+
+  static_assert(executor_execution_depth<detail::thread_pool_executor>::value == 1,
+    "thread_pool_executor should have execution_depth == 1");
+
+  {
+    // test the system_thread_pool
+    detail::thread_pool_executor exec;
+    test(exec);
+  }
+
+  {
+    // test a thread_pool with a shared queue
+    detail::thread_pool pool(4, detail::thread_pool::shared_queue);
+    detail::thread_pool_executor exec(pool);
+    test(exec);
+  }
+
+  {
+    // test a work-stealing thread_pool
+    detail::thread_pool pool(4, detail::thread_pool::work_stealing);
+    detail::thread_pool_executor exec(pool);
+    test(exec);
+  }
+
+  {
+    // test that the worker of a shared-queue thread_pool may post more tasks than the queue's ring holds
+    // the worker is the queue's only consumer, so it must not wait for space
+    detail::thread_pool pool(1, detail::thread_pool::shared_queue);
+
+    std::atomic<int> num_executed(0);
+
+    pool.post([&]
+    {
+      for(int i = 0; i < 10000; ++i)
+      {
+        pool.post([&]{ ++num_executed; });
+      }
+    });
+
+    while(num_executed != 10000)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  {
+    // test thread_pool_config
+    detail::cpu_topology topology({{0, 1, 2, 3}, {4, 5, 6, 7}});
+
+    assert(detail::parse_cpu_list("0-2,5, 7") == std::vector<int>({0, 1, 2, 5, 7}));
+    assert(detail::parse_cpu_list("3-1").empty());
+    assert(detail::parse_cpu_list("x").empty());
+
+    // one thread per cpu by default
+    assert(detail::thread_pool_config().resolve_num_threads(topology) == 8);
+    assert(detail::thread_pool_config(3).resolve_num_threads(topology) == 3);
+
+    // no pinning
+    auto affinities = detail::thread_pool_config(2).thread_affinities(topology);
+    assert(affinities == std::vector<std::vector<int>>(2));
+
+    // compact pinning fills a node before moving to the next
+    affinities = detail::thread_pool_config(5, detail::thread_pool_config::compact).thread_affinities(topology);
+    assert(affinities == std::vector<std::vector<int>>({{0}, {1}, {2}, {3}, {4}}));
+
+    // scatter pinning alternates between nodes
+    affinities = detail::thread_pool_config(4, detail::thread_pool_config::scatter).thread_affinities(topology);
+    assert(affinities == std::vector<std::vector<int>>({{0}, {4}, {1}, {5}}));
+
+    // an explicit list of cpus is followed in order
+    affinities = detail::thread_pool_config(0, detail::thread_pool_config::cpu_list, {6, 1, 3}).thread_affinities(topology);
+    assert(affinities == std::vector<std::vector<int>>({{6}, {1}, {3}}));
+
+    // restricting cpus without pinning lets threads float among them
+    affinities = detail::thread_pool_config(2, detail::thread_pool_config::no_pinning, {1, 2}).thread_affinities(topology);
+    assert(affinities == std::vector<std::vector<int>>({{1, 2}, {1, 2}}));
+  }
+
+  {
+    // test thread_pools created from configurations of the system topology
+    detail::thread_pool_config configs[] = {
+      detail::thread_pool_config(4),
+      detail::thread_pool_config(4, detail::thread_pool_config::compact),
+      detail::thread_pool_config(4, detail::thread_pool_config::scatter),
+      detail::thread_pool_config(4, detail::thread_pool_config::cpu_list, {0})
+    };
+
+    for(auto& config : configs)
+    {
+      detail::thread_pool pool(config);
+      assert(pool.size() == 4);
+
+      detail::thread_pool_executor exec(pool);
+      test(exec);
+    }
+  }
+
   std::cout << "OK" << std::endl;
 
   return 0;
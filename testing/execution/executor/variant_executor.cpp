@@ -30,6 +30,21 @@ int test_alternative(Executor alternative)
     assert(exec.type() == typeid(alternative));
   }
 
+  {
+    // test copy and move
+    VariantExecutor copy = exec;
+    assert(copy.type() == typeid(alternative));
+
+    VariantExecutor moved = std::move(copy);
+    assert(moved.type() == typeid(alternative));
+
+    copy = moved;
+    assert(copy.type() == typeid(alternative));
+
+    moved = std::move(copy);
+    assert(moved.type() == typeid(alternative));
+  }
+
   {
     // test twoway_execute()
     bool executed = false;
@@ -0,0 +1,277 @@
+#include <agency/agency.hpp>
+#include <agency/experimental/ndarray.hpp>
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <numeric>
+#include <set>
+
+
+// checks that a mapping sends every index of its shape to a distinct offset within its span,
+// and that index_of() inverts the mapping
+template<class Mapping>
+void test_mapping(const Mapping& mapping)
+{
+  using namespace agency;
+  using shape_type = typename Mapping::shape_type;
+
+  std::set<size_t> offsets;
+
+  for(auto idx : lattice<shape_type>(mapping.shape()))
+  {
+    size_t offset = mapping(idx);
+    assert(offset < mapping.required_span_size());
+    assert(offsets.insert(offset).second);
+
+    shape_type found;
+    assert(mapping.index_of(offset, found));
+    assert(found == idx);
+  }
+
+  // the offsets which map to no element are exactly those which index_of() rejects
+  size_t num_elements = 0;
+  for(size_t offset = 0; offset < mapping.required_span_size(); ++offset)
+  {
+    shape_type idx;
+    if(mapping.index_of(offset, idx))
+    {
+      ++num_elements;
+      assert(mapping(idx) == offset);
+    }
+  }
+
+  assert(num_elements == offsets.size());
+  assert(!Mapping::is_always_exhaustive() || num_elements == mapping.required_span_size());
+}
+
+
+void test_mappings()
+{
+  using namespace agency;
+  using namespace agency::experimental;
+  using shape_type = size2;
+
+  {
+    // test layout_right
+    layout_right::mapping<shape_type> mapping(shape_type{3,4});
+
+    test_mapping(mapping);
+    assert(mapping(shape_type{1,0}) == 4);
+    assert(mapping.stride(0) == 4);
+    assert(mapping.stride(1) == 1);
+    assert(mapping.required_span_size() == 12);
+  }
+
+  {
+    // test layout_left
+    layout_left::mapping<shape_type> mapping(shape_type{3,4});
+
+    test_mapping(mapping);
+    assert(mapping(shape_type{1,0}) == 1);
+    assert(mapping(shape_type{0,1}) == 3);
+    assert(mapping.stride(0) == 1);
+    assert(mapping.stride(1) == 3);
+    assert(mapping.required_span_size() == 12);
+  }
+
+  {
+    // test layout_stride
+    layout_stride::mapping<shape_type> mapping(shape_type{3,4}, shape_type{10,2});
+
+    assert(mapping(shape_type{2,3}) == 26);
+    assert(mapping.required_span_size() == 27);
+
+    // layout_stride copies the strides of other layouts
+    layout_stride::mapping<shape_type> left(layout_left::mapping<shape_type>(shape_type{3,4}));
+    assert(left.stride(0) == 1);
+    assert(left.stride(1) == 3);
+  }
+
+  {
+    // test layout_blocked with tiles which evenly divide the shape
+    layout_blocked<2,2>::mapping<shape_type> mapping(shape_type{4,4});
+
+    test_mapping(mapping);
+    assert(mapping.required_span_size() == 16);
+
+    // the first tile holds the first two elements of the first two rows
+    assert(mapping(shape_type{0,0}) == 0);
+    assert(mapping(shape_type{0,1}) == 1);
+    assert(mapping(shape_type{1,0}) == 2);
+    assert(mapping(shape_type{1,1}) == 3);
+    assert(mapping(shape_type{0,2}) == 4);
+  }
+
+  {
+    // test layout_blocked with partial tiles
+    layout_blocked<2,4>::mapping<shape_type> mapping(shape_type{3,5});
+
+    test_mapping(mapping);
+
+    // 2 x 2 tiles of 8 elements
+    assert(mapping.required_span_size() == 32);
+  }
+
+  {
+    // test layout_morton with a power of two shape
+    layout_morton::mapping<shape_type> mapping(shape_type{4,4});
+
+    test_mapping(mapping);
+    assert(mapping.required_span_size() == 16);
+
+    assert(mapping(shape_type{0,0}) == 0);
+    assert(mapping(shape_type{0,1}) == 1);
+    assert(mapping(shape_type{1,0}) == 2);
+    assert(mapping(shape_type{1,1}) == 3);
+    assert(mapping(shape_type{0,2}) == 4);
+    assert(mapping(shape_type{2,0}) == 8);
+    assert(mapping(shape_type{3,3}) == 15);
+  }
+
+  {
+    // test layout_morton with a shape which leaves gaps in the Z-order curve
+    layout_morton::mapping<shape_type> mapping(shape_type{3,5});
+
+    test_mapping(mapping);
+  }
+
+  {
+    // test layout_morton in three dimensions
+    layout_morton::mapping<size3> mapping(size3{2,3,4});
+
+    test_mapping(mapping);
+    assert(mapping(size3{1,1,1}) == 7);
+  }
+
+  {
+    // test layout_morton with skewed shapes, whose storage is bounded by the extents rounded up to powers of two
+    layout_morton::mapping<shape_type> tall(shape_type{1000,3});
+
+    test_mapping(tall);
+    assert(tall.required_span_size() <= 1024 * 4);
+
+    // once the short dimension runs out of bits, the long dimension's bits follow uninterleaved
+    assert(tall(shape_type{1,1}) == 3);
+    assert(tall(shape_type{2,0}) == 8);
+    assert(tall(shape_type{4,0}) == 16);
+
+    layout_morton::mapping<shape_type> wide(shape_type{3,1000});
+
+    test_mapping(wide);
+    assert(wide.required_span_size() <= 4 * 1024);
+    assert(wide(shape_type{0,4}) == 16);
+  }
+}
+
+
+template<class Layout, class ExecutionPolicy>
+void test_ndarray(ExecutionPolicy policy)
+{
+  using namespace agency;
+  using namespace agency::experimental;
+  using shape_type = size2;
+  using array_type = basic_ndarray<int, shape_type, allocator<int>, shape_type, Layout>;
+
+  shape_type shape{5,7};
+
+  {
+    // test fill construction
+    array_type array(shape, 13);
+
+    assert(array.shape() == shape);
+    assert(array.size() == 35);
+    assert(std::count(array.begin(), array.end(), 13) == 35);
+  }
+
+  {
+    // test construction from an iterator in storage order
+    std::vector<int> values(35);
+    std::iota(values.begin(), values.end(), 0);
+
+    array_type array(policy, values.begin(), shape);
+
+    // iterators traverse in row-major order regardless of layout
+    assert(std::equal(array.begin(), array.end(), values.begin()));
+
+    for(auto idx : lattice<shape_type>(shape))
+    {
+      assert(array[idx] == static_cast<int>(idx[0] * 7 + idx[1]));
+      assert(&array[idx] == array.data() + array.mapping()(idx));
+    }
+
+    // test copy construction
+    array_type copy = array;
+    assert(copy == array);
+
+    // test construction from an array with a different layout
+    basic_ndarray<int, shape_type> row_major(array.all());
+    assert(std::equal(row_major.begin(), row_major.end(), array.begin()));
+
+    array_type from_row_major(row_major.all());
+    assert(std::equal(from_row_major.begin(), from_row_major.end(), row_major.begin()));
+
+    // test move construction
+    array_type moved = std::move(copy);
+    assert(moved == array);
+    assert(copy.size() == 0);
+
+    moved.clear();
+    assert(moved.size() == 0);
+    assert(moved.shape() == shape_type());
+  }
+}
+
+
+struct counted
+{
+  static int num_live_objects;
+
+  counted() { ++num_live_objects; }
+  counted(const counted&) { ++num_live_objects; }
+  ~counted() { --num_live_objects; }
+};
+
+int counted::num_live_objects = 0;
+
+
+template<class Layout>
+void test_padding()
+{
+  using namespace agency;
+  using namespace agency::experimental;
+  using array_type = basic_ndarray<counted, size2, allocator<counted>, size2, Layout>;
+
+  {
+    // storage which maps to no element is neither constructed nor destroyed
+    array_type array(size2{3,5});
+
+    assert(counted::num_live_objects == 15);
+  }
+
+  assert(counted::num_live_objects == 0);
+}
+
+
+int main()
+{
+  using namespace agency;
+  using namespace agency::experimental;
+
+  test_mappings();
+
+  test_ndarray<layout_right>(seq);
+  test_ndarray<layout_left>(seq);
+  test_ndarray<layout_left>(par);
+  test_ndarray<layout_blocked<2,4>>(seq);
+  test_ndarray<layout_blocked<2,4>>(par);
+  test_ndarray<layout_morton>(seq);
+  test_ndarray<layout_morton>(par);
+
+  test_padding<layout_blocked<2,4>>();
+  test_padding<layout_morton>();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,79 @@
+#include <agency/agency.hpp>
+#include <agency/experimental/ndarray.hpp>
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <numeric>
+
+
+template<class Layout>
+void test_subarray()
+{
+  using namespace agency;
+  using namespace agency::experimental;
+  using shape_type = size2;
+
+  std::vector<int> values(6 * 8);
+  std::iota(values.begin(), values.end(), 0);
+
+  basic_ndarray<int, shape_type, allocator<int>, shape_type, Layout> array(values.begin(), shape_type{6,8});
+
+  auto view = array.all().subarray(shape_type{1,2}, shape_type{3,4});
+
+  static_assert(std::is_same<typename decltype(view)::layout_type, layout_stride>::value, "subarray() should return a strided view");
+
+  assert(view.shape() == (shape_type{3,4}));
+  assert(view.size() == 12);
+  assert(view.data() == &array[shape_type(1,2)]);
+
+  for(auto idx : lattice<shape_type>(view.shape()))
+  {
+    // the view refers to the original elements
+    assert(&view[idx] == &array[idx + shape_type(1,2)]);
+  }
+
+  // iterators traverse the view in row-major order
+  std::vector<int> expected;
+  for(size_t i = 1; i < 4; ++i)
+  {
+    for(size_t j = 2; j < 6; ++j)
+    {
+      expected.push_back(values[i * 8 + j]);
+    }
+  }
+
+  assert(std::equal(view.begin(), view.end(), expected.begin()));
+
+  // writes through the view modify the array
+  for(auto& x : view)
+  {
+    x = -1;
+  }
+
+  assert(std::count(array.begin(), array.end(), -1) == 12);
+
+  // a subarray of a subarray composes the strides
+  auto inner = view.subarray(shape_type{1,1}, shape_type{2,2});
+  assert(&inner[shape_type(0,0)] == &array[shape_type(2,3)]);
+  assert(&inner[shape_type(1,1)] == &array[shape_type(3,4)]);
+
+  // views with strides convert to strided views
+  basic_ndarray_ref<const int*, shape_type, shape_type, layout_stride> strided = array.all();
+  assert(strided.stride(0) == array.all().stride(0));
+  assert(strided.stride(1) == array.all().stride(1));
+  assert(std::equal(strided.begin(), strided.end(), array.begin()));
+}
+
+
+int main()
+{
+  using namespace agency::experimental;
+
+  test_subarray<layout_right>();
+  test_subarray<layout_left>();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
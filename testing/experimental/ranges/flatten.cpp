@@ -232,9 +232,135 @@ void test()
   }
 }
 
+void test_empty_segments()
+{
+  using namespace agency::experimental;
+
+  // create segments of varying sizes, including empty segments at the beginning, middle, and end
+  std::vector<std::vector<int>> v;
+  v.emplace_back();
+  v.emplace_back(std::vector<int>(3));
+  v.emplace_back();
+  v.emplace_back();
+  v.emplace_back(std::vector<int>(1));
+  v.emplace_back(std::vector<int>(4));
+  v.emplace_back();
+
+  int init = 0;
+  for(auto& segment : v)
+  {
+    std::iota(segment.begin(), segment.end(), init);
+    init += segment.size();
+  }
+
+  auto flattened = flatten(v);
+
+  assert(flattened.size() == 8);
+
+  {
+    // test operator[]
+    for(size_t i = 0; i < flattened.size(); ++i)
+    {
+      assert(flattened[i] == int(i));
+    }
+  }
+
+  {
+    // test iteration forward & backward
+    std::vector<int> expected_values(flattened.size());
+    std::iota(expected_values.begin(), expected_values.end(), 0);
+
+    assert(std::equal(flattened.begin(), flattened.end(), expected_values.begin()));
+
+    int expected = 7;
+    auto iter = flattened.end();
+    while(iter != flattened.begin())
+    {
+      --iter;
+      assert(*iter == expected);
+      --expected;
+    }
+  }
+
+  {
+    // test iterator plus & minus across segments
+    for(int i = 0; i <= 8; ++i)
+    {
+      for(int j = 0; j <= 8; ++j)
+      {
+        auto iter = flattened.begin() + i;
+        iter += j - i;
+
+        assert(iter - flattened.begin() == j);
+
+        if(j < 8)
+        {
+          assert(*iter == j);
+        }
+      }
+    }
+  }
+
+  {
+    // test for_each_segment
+    for(int i = 0; i <= 8; ++i)
+    {
+      for(int j = i; j <= 8; ++j)
+      {
+        std::vector<int> visited;
+        size_t num_segments = 0;
+
+        agency::experimental::detail::for_each_segment(flattened.begin() + i, flattened.begin() + j, [&](int* first, int* last)
+        {
+          assert(first < last);
+
+          visited.insert(visited.end(), first, last);
+          ++num_segments;
+        });
+
+        std::vector<int> expected_values(j - i);
+        std::iota(expected_values.begin(), expected_values.end(), i);
+
+        assert(visited == expected_values);
+        assert(num_segments <= 3);
+      }
+    }
+  }
+
+  {
+    // test a view which searches a table of segment positions
+    using view_type = decltype(flattened);
+    using offsets_type = typename view_type::offsets_type;
+
+    auto offsets = agency::experimental::detail::make_segment_offsets<std::vector<size_t>>(v);
+    assert(offsets == std::vector<size_t>({0, 0, 3, 3, 3, 4, 8, 8}));
+
+    view_type searched(v, offsets_type(offsets.data(), offsets.size()));
+
+    assert(searched.size() == 8);
+    assert(searched.end() - searched.begin() == 8);
+
+    for(size_t i = 0; i < searched.size(); ++i)
+    {
+      assert(searched[i] == int(i));
+    }
+  }
+
+  {
+    // test an empty view
+    std::vector<std::vector<int>> empty(3);
+
+    auto flattened_empty = flatten(empty);
+
+    assert(flattened_empty.size() == 0);
+    assert(flattened_empty.begin() == flattened_empty.end());
+  }
+}
+
 int main()
 {
   test();
+  test_empty_segments();
 
   std::cout << "OK" << std::endl;
 
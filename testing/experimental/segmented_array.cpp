@@ -4,6 +4,7 @@
 #include <cassert>
 #include <vector>
 #include <algorithm>
+#include <numeric>
 
 void test()
 {
@@ -83,9 +84,58 @@ void test()
   }
 }
 
+void test_segmented_algorithms()
+{
+  using namespace agency::experimental;
+  using namespace agency;
+
+  std::vector<allocator<int>> allocators(7);
+
+  size_t num_elements = 100;
+
+  {
+    // test copy from a segmented_array
+    segmented_array<int> array(num_elements, 0, allocators);
+
+    for(size_t i = 0; i < array.size(); ++i)
+    {
+      array[i] = i;
+    }
+
+    std::vector<int> expected_values(num_elements);
+    std::iota(expected_values.begin(), expected_values.end(), 0);
+
+    std::vector<int> result(num_elements);
+    agency::detail::copy(seq, array.begin(), array.end(), result.begin());
+    assert(result == expected_values);
+
+    std::fill(result.begin(), result.end(), 0);
+    agency::detail::copy(par, array.begin(), array.end(), result.begin());
+    assert(result == expected_values);
+
+    // copy a range which begins and ends in the middle of segments
+    std::fill(result.begin(), result.end(), 0);
+    agency::detail::copy(par, array.begin() + 3, array.end() - 5, result.begin());
+    assert(std::equal(result.begin(), result.begin() + num_elements - 8, expected_values.begin() + 3));
+  }
+
+  {
+    // test fill of a segmented_array
+    segmented_array<int> array(num_elements, 0, allocators);
+
+    agency::detail::fill(seq, array.begin(), array.end(), 7);
+    assert(std::count(array.begin(), array.end(), 7) == int(num_elements));
+
+    agency::detail::fill(par, array.begin() + 10, array.end() - 10, 13);
+    assert(std::count(array.begin(), array.end(), 13) == int(num_elements - 20));
+    assert(array[9] == 7 && array[10] == 13 && array[num_elements - 11] == 13 && array[num_elements - 10] == 7);
+  }
+}
+
 int main()
 {
   test();
+  test_segmented_algorithms();
 
   std::cout << "OK" << std::endl;
 
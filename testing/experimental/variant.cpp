@@ -0,0 +1,158 @@
+#include <agency/experimental/variant.hpp>
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+
+// counts its live instances
+struct counted
+{
+  static int num_instances;
+
+  int value;
+
+  counted(int value)
+    : value(value)
+  {
+    ++num_instances;
+  }
+
+  counted(const counted& other)
+    : value(other.value)
+  {
+    ++num_instances;
+  }
+
+  counted& operator=(const counted&) = default;
+
+  ~counted()
+  {
+    --num_instances;
+  }
+};
+
+int counted::num_instances = 0;
+
+
+// can be copy constructed but not assigned
+struct not_assignable
+{
+  const int value;
+
+  not_assignable(int value)
+    : value(value)
+  {}
+
+  not_assignable(const not_assignable&) = default;
+
+  not_assignable& operator=(const not_assignable&) = delete;
+};
+
+
+void test_traits()
+{
+  using namespace agency::experimental;
+
+  static_assert(std::is_copy_constructible<variant<int, std::string>>::value, "variant<int, std::string> should be copy constructible");
+  static_assert(std::is_copy_assignable<variant<int, std::string>>::value, "variant<int, std::string> should be copy assignable");
+
+  static_assert(!std::is_copy_constructible<variant<int, std::unique_ptr<int>>>::value, "variant<int, std::unique_ptr<int>> should not be copy constructible");
+  static_assert(!std::is_copy_assignable<variant<int, std::unique_ptr<int>>>::value, "variant<int, std::unique_ptr<int>> should not be copy assignable");
+  static_assert(std::is_move_constructible<variant<int, std::unique_ptr<int>>>::value, "variant<int, std::unique_ptr<int>> should be move constructible");
+  static_assert(std::is_move_assignable<variant<int, std::unique_ptr<int>>>::value, "variant<int, std::unique_ptr<int>> should be move assignable");
+
+  static_assert(std::is_copy_assignable<variant<int, not_assignable>>::value, "variant<int, not_assignable> should be copy assignable");
+}
+
+
+void test_copy_and_move()
+{
+  using namespace agency::experimental;
+
+  {
+    // copies of a variant own copies of its alternative
+    variant<int, counted> v1 = counted(13);
+    assert(counted::num_instances == 1);
+
+    {
+      variant<int, counted> v2 = v1;
+      assert(counted::num_instances == 2);
+      assert(get<counted>(v2).value == 13);
+
+      variant<int, counted> v3 = std::move(v2);
+      assert(counted::num_instances == 3);
+      assert(get<counted>(v3).value == 13);
+    }
+
+    assert(counted::num_instances == 1);
+  }
+
+  assert(counted::num_instances == 0);
+
+  {
+    // assignment between variants holding the same and different alternatives
+    variant<int, counted> v1 = counted(7);
+    variant<int, counted> v2 = 13;
+
+    v2 = v1;
+    assert(counted::num_instances == 2);
+    assert(get<counted>(v2).value == 7);
+
+    v1 = 42;
+    assert(counted::num_instances == 1);
+
+    v2 = std::move(v1);
+    assert(counted::num_instances == 0);
+    assert(get<int>(v2) == 42);
+  }
+
+  {
+    // move-only alternatives are moved
+    variant<int, std::unique_ptr<int>> v1 = std::unique_ptr<int>(new int(13));
+
+    variant<int, std::unique_ptr<int>> v2 = std::move(v1);
+    assert(*get<std::unique_ptr<int>>(v2) == 13);
+
+    v1 = std::move(v2);
+    assert(*get<std::unique_ptr<int>>(v1) == 13);
+  }
+
+  {
+    // alternatives which are not assignable are reconstructed
+    variant<int, not_assignable> v1 = not_assignable(7);
+    variant<int, not_assignable> v2 = not_assignable(13);
+
+    v2 = v1;
+    assert(get<not_assignable>(v2).value == 7);
+  }
+}
+
+
+void test_equality()
+{
+  using namespace agency::experimental;
+
+  variant<int, std::string> v1 = 13;
+  variant<int, std::string> v2 = 13;
+  variant<int, std::string> v3 = std::string("13");
+
+  assert(v1 == v2);
+  assert(v1 != v3);
+
+  v2 = 7;
+  assert(v1 != v2);
+}
+
+
+int main()
+{
+  test_traits();
+  test_copy_and_move();
+  test_equality();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
@@ -0,0 +1,344 @@
+#include <cassert>
+#include <agency/future.hpp>
+#include <agency/future/future_traits.hpp>
+#include <agency/future/future_traits/detail/has_then_member.hpp>
+#include <agency/future/detail/on_ready.hpp>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+int main()
+{
+  using namespace agency;
+
+  static_assert(is_future<agency::future<int>>::value, "future<int> is not a future");
+  static_assert(is_future<agency::shared_future<int>>::value, "shared_future<int> is not a future");
+
+  static_assert(detail::has_then_member<agency::future<int>, int(*)(int&)>::value, "future<int>::then() is not monadic");
+  static_assert(detail::has_then_member<agency::shared_future<int>, int(*)(int&)>::value, "shared_future<int>::then() is not monadic");
+
+  static_assert(std::is_same<future_traits<agency::future<int>>::shared_future_type, agency::shared_future<int>>::value,
+    "future<int> should share into shared_future<int>");
+
+  {
+    // default construction
+    agency::future<int> f;
+    assert(!f.valid());
+  }
+
+  {
+    // make_ready int
+    agency::future<int> f = agency::future<int>::make_ready(13);
+    assert(f.valid());
+    assert(f.is_ready());
+    assert(f.get() == 13);
+    assert(!f.valid());
+  }
+
+  {
+    // make_ready void
+    agency::future<void> f = agency::future<void>::make_ready();
+    assert(f.is_ready());
+    f.get();
+    assert(!f.valid());
+  }
+
+  {
+    // promise fulfilled by another thread
+    agency::promise<int> p;
+    agency::future<int> f = p.get_future();
+    assert(f.valid());
+
+    std::thread t([&]
+    {
+      p.set_value(13);
+    });
+
+    assert(f.get() == 13);
+
+    t.join();
+  }
+
+  {
+    // continuations attached before the promise is fulfilled run on the fulfilling thread
+    agency::promise<int> p;
+
+    std::thread::id continuation_thread_id;
+
+    agency::future<int> f = p.get_future().then([&](int& x)
+    {
+      continuation_thread_id = std::this_thread::get_id();
+      return x + 1;
+    });
+
+    assert(!f.is_ready());
+
+    std::thread t([&]
+    {
+      p.set_value(12);
+    });
+
+    std::thread::id fulfilling_thread_id = t.get_id();
+    t.join();
+
+    assert(f.is_ready());
+    assert(continuation_thread_id == fulfilling_thread_id);
+    assert(f.get() == 13);
+  }
+
+  {
+    // continuations attached to a ready future run immediately
+    agency::future<int> f0 = agency::future<int>::make_ready(6);
+
+    bool ran = false;
+
+    agency::future<void> f1 = f0.then([&](int& x)
+    {
+      ran = (x == 6);
+    });
+
+    assert(!f0.valid());
+    assert(ran);
+    assert(f1.is_ready());
+
+    agency::future<int> f2 = f1.then([]
+    {
+      return 13;
+    });
+
+    assert(f2.get() == 13);
+  }
+
+  {
+    // a chain of continuations runs in order
+    agency::promise<void> p;
+
+    agency::future<int> f = p.get_future().then([]{ return 0; });
+
+    for(int i = 0; i < 1000; ++i)
+    {
+      f = f.then([](int& x){ return x + 1; });
+    }
+
+    p.set_value();
+
+    assert(f.get() == 1000);
+  }
+
+  {
+    // a long chain of pending continuations runs without nesting a stack frame per link
+    agency::promise<int> p;
+
+    agency::future<int> f = p.get_future();
+
+    for(int i = 0; i < 100000; ++i)
+    {
+      f = f.then([](int& x){ return x + 1; });
+    }
+
+    p.set_value(0);
+
+    assert(f.get() == 100000);
+  }
+
+  {
+    // the continuations of a state made ready by a continuation run after it returns,
+    // but before the remaining continuations of the state which became ready first
+    agency::promise<void> p0, p1;
+    agency::future<void> f0 = p0.get_future();
+    agency::future<void> f1 = p1.get_future();
+
+    std::vector<int> order;
+
+    f1.on_ready([&]{ order.push_back(2); });
+
+    f0.on_ready([&]
+    {
+      order.push_back(0);
+      p1.set_value();
+      order.push_back(1);
+    });
+
+    f0.on_ready([&]{ order.push_back(3); });
+
+    p0.set_value();
+
+    assert(order == std::vector<int>({0, 1, 2, 3}));
+  }
+
+  {
+    // a continuation may block on a future which is made ready by a continuation queued behind it
+    agency::promise<void> p;
+    agency::promise<int> q;
+    agency::future<int> g = q.get_future().then([](int& x){ return x + 1; });
+
+    int result = 0;
+
+    agency::future<void> f = p.get_future().then([&]
+    {
+      q.set_value(13);
+      result = g.get();
+    });
+
+    p.set_value();
+    f.wait();
+
+    assert(result == 14);
+  }
+
+  {
+    // exceptions propagate through continuations without calling them
+    agency::promise<int> p;
+
+    bool called = false;
+
+    agency::future<int> f = p.get_future().then([&](int& x)
+    {
+      called = true;
+      return x;
+    });
+
+    p.set_exception(std::make_exception_ptr(std::runtime_error("error")));
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(std::runtime_error&)
+    {
+      caught = true;
+    }
+
+    assert(caught);
+    assert(!called);
+  }
+
+  {
+    // exceptions thrown by a continuation are reported through its future
+    agency::future<int> f = agency::future<int>::make_ready(13).then([](int&) -> int
+    {
+      throw std::runtime_error("error");
+    });
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(std::runtime_error&)
+    {
+      caught = true;
+    }
+
+    assert(caught);
+  }
+
+  {
+    // a destroyed promise breaks its future
+    agency::future<int> f;
+
+    {
+      agency::promise<int> p;
+      f = p.get_future();
+    }
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(std::future_error& e)
+    {
+      caught = (e.code() == std::future_errc::broken_promise);
+    }
+
+    assert(caught);
+  }
+
+  {
+    // shared_future
+    agency::promise<int> p;
+    agency::shared_future<int> f0 = p.get_future().share();
+    agency::shared_future<int> f1 = f0;
+
+    agency::future<int> f2 = f0.then([](int& x){ return x + 1; });
+    agency::future<int> f3 = f1.then([](int& x){ return x + 2; });
+
+    p.set_value(11);
+
+    assert(f0.get() == 11);
+    assert(f1.get() == 11);
+    assert(f0.valid());
+    assert(f2.get() == 12);
+    assert(f3.get() == 13);
+  }
+
+  {
+    // future_traits
+    using traits = future_traits<agency::future<int>>;
+
+    agency::future<int> f0 = traits::make_ready<int>(13);
+
+    agency::future<float> f1 = traits::cast<float>(f0);
+    assert(!f0.valid());
+    assert(f1.get() == 13.f);
+
+    agency::future<int> f2 = traits::make_ready<int>(12);
+    agency::future<int> f3 = traits::then(f2, [](int& x){ return x + 1; });
+    assert(f3.get() == 13);
+
+    agency::future<void> f4 = future_traits<agency::future<int>>::make_ready();
+    agency::shared_future<void> f5 = future_traits<agency::future<void>>::share(f4);
+    assert(f5.is_ready());
+  }
+
+  {
+    // on_ready() notifies without blocking a thread for futures with continuations
+    agency::promise<int> p;
+    agency::shared_future<int> f = p.get_future().share();
+
+    std::atomic<int> result(0);
+
+    agency::detail::on_ready(f, [&]
+    {
+      result = f.get();
+    });
+
+    assert(result == 0);
+
+    p.set_value(13);
+
+    assert(result == 13);
+  }
+
+  {
+    // on_ready() waits on other futures with a thread of the system_concurrent_thread_pool
+    std::promise<int> p;
+    std::shared_future<int> f = p.get_future().share();
+
+    std::atomic<int> result(0);
+
+    agency::detail::on_ready(f, [&]
+    {
+      result = f.get();
+    });
+
+    p.set_value(13);
+
+    while(result != 13)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
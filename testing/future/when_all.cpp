@@ -0,0 +1,291 @@
+#include <cassert>
+#include <agency/future.hpp>
+#include <agency/future/always_ready_future.hpp>
+#include <agency/future/variant_future.hpp>
+#include <agency/future/when_all.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+
+template<class T>
+using variant_future = agency::variant_future<agency::always_ready_future<T>, agency::future<T>>;
+
+
+void test_range()
+{
+  {
+    // empty range
+    std::vector<agency::future<int>> futures;
+
+    agency::future<std::vector<int>> f = agency::when_all(futures.begin(), futures.end());
+    assert(f.is_ready());
+    assert(f.get().empty());
+  }
+
+  {
+    // pending futures fulfilled by another thread
+    std::vector<agency::promise<int>> promises(10);
+    std::vector<agency::future<int>> futures;
+
+    for(auto& p : promises)
+    {
+      futures.push_back(p.get_future());
+    }
+
+    agency::future<std::vector<int>> f = agency::when_all(futures.begin(), futures.end());
+    assert(!f.is_ready());
+
+    std::thread t([&]
+    {
+      // fulfill the promises in reverse order
+      for(int i = 9; i >= 0; --i)
+      {
+        promises[i].set_value(i);
+      }
+    });
+
+    std::vector<int> result = f.get();
+
+    t.join();
+
+    assert(result.size() == 10);
+
+    for(int i = 0; i < 10; ++i)
+    {
+      assert(result[i] == i);
+    }
+  }
+
+  {
+    // void futures
+    agency::promise<void> p;
+
+    std::vector<agency::future<void>> futures;
+    futures.push_back(agency::future<void>::make_ready());
+    futures.push_back(p.get_future());
+
+    agency::future<void> f = agency::when_all(futures.begin(), futures.end());
+    assert(!f.is_ready());
+
+    p.set_value();
+
+    assert(f.is_ready());
+    f.get();
+  }
+
+  {
+    // always_ready_futures
+    std::vector<agency::always_ready_future<int>> futures;
+    futures.push_back(agency::always_ready_future<int>(7));
+    futures.push_back(agency::always_ready_future<int>(13));
+
+    agency::future<std::vector<int>> f = agency::when_all(futures.begin(), futures.end());
+    assert(f.is_ready());
+
+    std::vector<int> result = f.get();
+    assert(result.size() == 2 && result[0] == 7 && result[1] == 13);
+  }
+
+  {
+    // variant_futures
+    agency::promise<int> p;
+
+    std::vector<variant_future<int>> futures;
+    futures.push_back(agency::always_ready_future<int>(7));
+    futures.push_back(p.get_future());
+
+    agency::future<std::vector<int>> f = agency::when_all(futures.begin(), futures.end());
+    assert(!f.is_ready());
+
+    p.set_value(13);
+
+    std::vector<int> result = f.get();
+    assert(result.size() == 2 && result[0] == 7 && result[1] == 13);
+  }
+
+  {
+    // std::futures
+    std::vector<std::promise<int>> promises(3);
+    std::vector<std::future<int>> futures;
+
+    for(auto& p : promises)
+    {
+      futures.push_back(p.get_future());
+    }
+
+    agency::future<std::vector<int>> f = agency::when_all(futures.begin(), futures.end());
+
+    for(int i = 0; i < 3; ++i)
+    {
+      promises[i].set_value(i);
+    }
+
+    std::vector<int> result = f.get();
+    assert(result.size() == 3 && result[0] == 0 && result[1] == 1 && result[2] == 2);
+  }
+
+  {
+    // exceptions are collected into an exception_list
+    std::vector<agency::future<int>> futures;
+    futures.push_back(agency::future<int>::make_exceptional(std::make_exception_ptr(std::runtime_error("error"))));
+    futures.push_back(agency::future<int>::make_ready(13));
+    futures.push_back(agency::future<int>::make_exceptional(std::make_exception_ptr(std::logic_error("error"))));
+
+    agency::future<std::vector<int>> f = agency::when_all(futures.begin(), futures.end());
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(agency::exception_list& e)
+    {
+      caught = (e.size() == 2);
+    }
+
+    assert(caught);
+  }
+}
+
+
+template<class... Futures>
+using when_all_t = decltype(agency::when_all(std::declval<Futures>()...));
+
+
+void test_variadic()
+{
+  static_assert(agency::detail::is_detected<when_all_t, agency::future<int>, agency::future<void>>::value,
+    "when_all() should accept rvalue futures");
+
+  static_assert(!agency::detail::is_detected<when_all_t, agency::future<int>&>::value,
+    "when_all() should not accept lvalues of move-only futures");
+
+  static_assert(agency::detail::is_detected<when_all_t, agency::shared_future<int>&>::value,
+    "when_all() should accept lvalues of copyable futures");
+
+  {
+    // temporary futures
+    agency::promise<int> p;
+
+    agency::future<agency::tuple<int,int>> f = agency::when_all(p.get_future(), agency::future<int>::make_ready(13));
+
+    p.set_value(7);
+
+    agency::tuple<int,int> result = f.get();
+    assert(agency::get<0>(result) == 7);
+    assert(agency::get<1>(result) == 13);
+  }
+
+  {
+    // no futures
+    agency::future<void> f = agency::when_all();
+    assert(f.is_ready());
+  }
+
+  {
+    // a single future
+    agency::future<int> f0 = agency::future<int>::make_ready(13);
+
+    agency::future<int> f = agency::when_all(std::move(f0));
+    assert(f.get() == 13);
+  }
+
+  {
+    // mixed futures
+    agency::promise<int> p0;
+    agency::promise<void> p1;
+
+    agency::future<int> f0 = p0.get_future();
+    agency::future<void> f1 = p1.get_future();
+    agency::always_ready_future<float> f2(7.f);
+    variant_future<char> f3 = agency::always_ready_future<char>('a');
+    agency::shared_future<int> f4 = agency::shared_future<int>::make_ready(42);
+
+    agency::future<agency::tuple<int,float,char,int>> f = agency::when_all(std::move(f0), std::move(f1), f2, std::move(f3), f4);
+    assert(!f0.valid());
+
+    // copyable futures passed as lvalues are copied
+    assert(f4.valid());
+    assert(!f.is_ready());
+
+    std::thread t([&]
+    {
+      p1.set_value();
+      p0.set_value(13);
+    });
+
+    agency::tuple<int,float,char,int> result = f.get();
+
+    t.join();
+
+    assert(agency::get<0>(result) == 13);
+    assert(agency::get<1>(result) == 7.f);
+    assert(agency::get<2>(result) == 'a');
+    assert(agency::get<3>(result) == 42);
+  }
+
+  {
+    // void futures
+    agency::future<void> f0 = agency::future<void>::make_ready();
+    agency::always_ready_future<void> f1;
+
+    agency::future<void> f = agency::when_all(std::move(f0), f1);
+    assert(f.is_ready());
+    f.get();
+  }
+
+  {
+    // std::futures
+    std::promise<int> p0;
+    std::promise<int> p1;
+
+    std::future<int> f0 = p0.get_future();
+    std::future<int> f1 = p1.get_future();
+
+    agency::future<agency::tuple<int,int>> f = agency::when_all(std::move(f0), std::move(f1));
+
+    p0.set_value(7);
+    p1.set_value(13);
+
+    agency::tuple<int,int> result = f.get();
+    assert(agency::get<0>(result) == 7);
+    assert(agency::get<1>(result) == 13);
+  }
+
+  {
+    // exceptions are collected into an exception_list
+    agency::future<int> f0 = agency::future<int>::make_exceptional(std::make_exception_ptr(std::runtime_error("error")));
+    agency::future<void> f1 = agency::future<void>::make_exceptional(std::make_exception_ptr(std::logic_error("error")));
+    agency::future<int> f2 = agency::future<int>::make_ready(13);
+
+    agency::future<agency::tuple<int,int>> f = agency::when_all(std::move(f2), std::move(f0), std::move(f1));
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(agency::exception_list& e)
+    {
+      caught = (e.size() == 2);
+    }
+
+    assert(caught);
+  }
+}
+
+
+int main()
+{
+  test_range();
+  test_variadic();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
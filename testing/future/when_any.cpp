@@ -0,0 +1,222 @@
+#include <cassert>
+#include <agency/future.hpp>
+#include <agency/future/always_ready_future.hpp>
+#include <agency/future/variant_future.hpp>
+#include <agency/future/when_any.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+
+template<class T>
+using variant_future = agency::variant_future<agency::always_ready_future<T>, agency::future<T>>;
+
+
+void test_range()
+{
+  {
+    // empty range
+    std::vector<agency::future<int>> futures;
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(futures.begin(), futures.end());
+    assert(f.is_ready());
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(std::future_error& e)
+    {
+      caught = (e.code() == std::future_errc::broken_promise);
+    }
+
+    assert(caught);
+  }
+
+  {
+    // the first future to become ready determines the result
+    std::vector<agency::promise<int>> promises(10);
+    std::vector<agency::future<int>> futures;
+
+    for(auto& p : promises)
+    {
+      futures.push_back(p.get_future());
+    }
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(futures.begin(), futures.end());
+    assert(!f.is_ready());
+
+    std::thread t([&]
+    {
+      promises[7].set_value(13);
+    });
+
+    agency::when_any_result<int> result = f.get();
+
+    t.join();
+
+    assert(result.index == 7);
+    assert(result.value == 13);
+
+    // the remaining futures may still become ready
+    promises[3].set_value(3);
+  }
+
+  {
+    // void futures
+    agency::promise<void> p;
+
+    std::vector<agency::future<void>> futures;
+    futures.push_back(p.get_future());
+    futures.push_back(agency::future<void>::make_ready());
+
+    agency::future<agency::when_any_result<void>> f = agency::when_any(futures.begin(), futures.end());
+    assert(f.is_ready());
+    assert(f.get().index == 1);
+  }
+
+  {
+    // variant_futures
+    agency::promise<int> p;
+
+    std::vector<variant_future<int>> futures;
+    futures.push_back(p.get_future());
+    futures.push_back(agency::always_ready_future<int>(7));
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(futures.begin(), futures.end());
+
+    agency::when_any_result<int> result = f.get();
+    assert(result.index == 1);
+    assert(result.value == 7);
+  }
+
+  {
+    // std::futures
+    std::vector<std::promise<int>> promises(3);
+    std::vector<std::future<int>> futures;
+
+    for(auto& p : promises)
+    {
+      futures.push_back(p.get_future());
+    }
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(futures.begin(), futures.end());
+
+    promises[2].set_value(13);
+
+    agency::when_any_result<int> result = f.get();
+    assert(result.index == 2);
+    assert(result.value == 13);
+
+    // let the threads waiting on the other futures finish
+    promises[0].set_value(0);
+    promises[1].set_value(1);
+  }
+
+  {
+    // the exception of the first future to become ready is reported through the result
+    agency::promise<int> p;
+
+    std::vector<agency::future<int>> futures;
+    futures.push_back(p.get_future());
+    futures.push_back(agency::future<int>::make_exceptional(std::make_exception_ptr(std::runtime_error("error"))));
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(futures.begin(), futures.end());
+
+    bool caught = false;
+
+    try
+    {
+      f.get();
+    }
+    catch(std::runtime_error&)
+    {
+      caught = true;
+    }
+
+    assert(caught);
+  }
+}
+
+
+template<class... Futures>
+using when_any_t = decltype(agency::when_any(std::declval<Futures>()...));
+
+
+void test_variadic()
+{
+  static_assert(agency::detail::is_detected<when_any_t, agency::future<int>, agency::shared_future<int>&>::value,
+    "when_any() should accept rvalue futures and lvalues of copyable futures");
+
+  static_assert(!agency::detail::is_detected<when_any_t, agency::future<int>&, agency::future<int>>::value,
+    "when_any() should not accept lvalues of move-only futures");
+
+  {
+    // temporary futures
+    agency::promise<int> p;
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(p.get_future(), agency::future<int>::make_ready(13));
+
+    agency::when_any_result<int> result = f.get();
+    assert(result.index == 1);
+    assert(result.value == 13);
+
+    p.set_value(7);
+  }
+
+  {
+    // mixed futures
+    agency::promise<int> p;
+
+    agency::future<int> f0 = p.get_future();
+    variant_future<int> f1 = agency::always_ready_future<int>(7);
+
+    agency::future<agency::when_any_result<int>> f = agency::when_any(std::move(f0), std::move(f1));
+    assert(!f0.valid());
+
+    agency::when_any_result<int> result = f.get();
+    assert(result.index == 1);
+    assert(result.value == 7);
+
+    p.set_value(13);
+  }
+
+  {
+    // pending futures fulfilled by another thread
+    agency::promise<void> p0;
+    agency::promise<void> p1;
+
+    agency::future<void> f0 = p0.get_future();
+    agency::shared_future<void> f1 = p1.get_future().share();
+
+    agency::future<agency::when_any_result<void>> f = agency::when_any(std::move(f0), f1);
+    assert(!f.is_ready());
+
+    // copyable futures passed as lvalues are copied
+    assert(f1.valid());
+
+    std::thread t([&]
+    {
+      p0.set_value();
+    });
+
+    assert(f.get().index == 0);
+
+    t.join();
+  }
+}
+
+
+int main()
+{
+  test_range();
+  test_variadic();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
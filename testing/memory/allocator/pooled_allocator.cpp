@@ -0,0 +1,254 @@
+#include <agency/memory/allocator/detail/pooled_allocator.hpp>
+#include <agency/container/vector.hpp>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <cstdint>
+
+// counts the bytes it has outstanding so that tests can check what a pool holds
+struct counting_resource
+{
+  void* allocate(size_t num_bytes)
+  {
+    *outstanding_bytes += num_bytes;
+    return agency::detail::malloc_resource().allocate(num_bytes);
+  }
+
+  void deallocate(void* ptr, size_t num_bytes)
+  {
+    *outstanding_bytes -= num_bytes;
+    agency::detail::malloc_resource().deallocate(ptr, num_bytes);
+  }
+
+  bool operator==(const counting_resource& other) const
+  {
+    return outstanding_bytes == other.outstanding_bytes;
+  }
+
+  bool operator!=(const counting_resource& other) const
+  {
+    return !(*this == other);
+  }
+
+  std::atomic<size_t>* outstanding_bytes;
+};
+
+
+void test_size_classes()
+{
+  using namespace agency::detail;
+
+  size_t previous_size = 0;
+
+  for(size_t c = 0; c < pooled_size_classes::num_classes; ++c)
+  {
+    size_t size = pooled_size_classes::size(c);
+
+    // sizes are increasing multiples of 16
+    assert(size > previous_size);
+    assert(size % 16 == 0);
+
+    // each size belongs to its own class, and so does the size just above the previous class
+    assert(pooled_size_classes::size_class(size) == c);
+    assert(pooled_size_classes::size_class(previous_size + 1) == c);
+
+    // beyond 64 bytes, rounding up wastes less than 25%
+    assert(size <= 64 || 4 * (size - previous_size) <= size);
+
+    previous_size = size;
+  }
+
+  assert(previous_size == pooled_size_classes::max_size());
+}
+
+
+void test_single_thread()
+{
+  using namespace agency::detail;
+
+  std::atomic<size_t> outstanding_bytes(0);
+
+  {
+    pooled_resource<counting_resource> pool(counting_resource{&outstanding_bytes});
+
+    std::vector<std::pair<void*,size_t>> blocks;
+
+    for(size_t n = 1; n <= 100000; n = 3 * n / 2 + 1)
+    {
+      void* ptr = pool.allocate(n);
+      assert(ptr != nullptr);
+      assert(reinterpret_cast<std::uintptr_t>(ptr) % 16 == 0);
+
+      std::memset(ptr, 0xff, n);
+
+      blocks.push_back(std::make_pair(ptr, n));
+    }
+
+    // blocks do not overlap
+    std::vector<std::pair<void*,size_t>> sorted = blocks;
+    std::sort(sorted.begin(), sorted.end());
+    for(size_t i = 1; i < sorted.size(); ++i)
+    {
+      assert(static_cast<char*>(sorted[i-1].first) + sorted[i-1].second <= sorted[i].first);
+    }
+
+    for(auto& b : blocks)
+    {
+      pool.deallocate(b.first, b.second);
+    }
+
+    size_t held = pool.upstream_bytes();
+    assert(held == outstanding_bytes);
+
+    // a second round of the same allocations is served entirely from the pool
+    for(auto& b : blocks)
+    {
+      b.first = pool.allocate(b.second);
+    }
+
+    assert(pool.upstream_bytes() == held);
+
+    for(auto& b : blocks)
+    {
+      pool.deallocate(b.first, b.second);
+    }
+
+    // allocations too large for any size class go straight to the upstream resource
+    size_t large = pooled_size_classes::max_size() + 1;
+    void* ptr = pool.allocate(large);
+    assert(outstanding_bytes == held + large);
+    pool.deallocate(ptr, large);
+    assert(outstanding_bytes == held);
+  }
+
+  // destroying the pool returns everything to the upstream resource
+  assert(outstanding_bytes == 0);
+}
+
+
+void test_multiple_threads()
+{
+  using namespace agency::detail;
+
+  std::atomic<size_t> outstanding_bytes(0);
+
+  {
+    pooled_resource<counting_resource> pool(counting_resource{&outstanding_bytes});
+
+    const size_t num_threads = 8;
+    const size_t num_blocks = 10000;
+
+    // each thread allocates blocks which a different thread deallocates
+    std::vector<std::vector<int*>> blocks(num_threads);
+
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+      threads.emplace_back([&,t]
+      {
+        for(size_t i = 0; i < num_blocks; ++i)
+        {
+          size_t n = 1 + (i % 64);
+          int* ptr = static_cast<int*>(pool.allocate(n * sizeof(int)));
+          std::fill(ptr, ptr + n, static_cast<int>(t));
+          blocks[t].push_back(ptr);
+        }
+      });
+    }
+
+    for(auto& thread : threads) thread.join();
+    threads.clear();
+
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+      threads.emplace_back([&,t]
+      {
+        auto& others = blocks[(t + 1) % num_threads];
+
+        for(size_t i = 0; i < others.size(); ++i)
+        {
+          size_t n = 1 + (i % 64);
+
+          // no block was handed out twice
+          assert(std::count(others[i], others[i] + n, static_cast<int>((t + 1) % num_threads)) == static_cast<int>(n));
+
+          pool.deallocate(others[i], n * sizeof(int));
+        }
+      });
+    }
+
+    for(auto& thread : threads) thread.join();
+
+    // the threads have exited and returned their caches to the depot,
+    // so allocating the same blocks again needs no more memory
+    size_t held = pool.upstream_bytes();
+
+    std::vector<int*> again;
+    for(size_t t = 0; t < num_threads; ++t)
+    {
+      for(size_t i = 0; i < num_blocks; ++i)
+      {
+        again.push_back(static_cast<int*>(pool.allocate((1 + (i % 64)) * sizeof(int))));
+      }
+    }
+
+    assert(pool.upstream_bytes() == held);
+
+    for(size_t j = 0; j < again.size(); ++j)
+    {
+      pool.deallocate(again[j], (1 + ((j % num_blocks) % 64)) * sizeof(int));
+    }
+  }
+
+  assert(outstanding_bytes == 0);
+}
+
+
+void test_pooled_allocator()
+{
+  using namespace agency::detail;
+
+  {
+    agency::vector<int, pooled_allocator<int>> vec(100, 13);
+    assert(std::count(vec.begin(), vec.end(), 13) == 100);
+
+    vec.resize(1000, 7);
+    assert(std::count(vec.begin(), vec.end(), 7) == 900);
+  }
+
+  {
+    std::vector<int, pooled_allocator<int>> vec;
+
+    for(int i = 0; i < 10; ++i)
+    {
+      vec.push_back(i);
+    }
+
+    assert(vec[9] == 9);
+  }
+
+  {
+    // every pooled_allocator shares the same pool
+    pooled_allocator<int> a;
+    pooled_allocator<float> b;
+    assert(a == pooled_allocator<int>(b));
+
+    int* ptr = a.allocate(10);
+    pooled_allocator<int>(b).deallocate(ptr, 10);
+  }
+}
+
+
+int main()
+{
+  test_size_classes();
+  test_single_thread();
+  test_multiple_threads();
+  test_pooled_allocator();
+
+  std::cout << "OK" << std::endl;
+}
+
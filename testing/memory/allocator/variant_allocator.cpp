@@ -116,6 +116,16 @@ int main()
     assert(deallocate_counter == 0);
   }
 
+  {
+    // test equality of allocators, including my_allocator, which has no operator==
+    allocator<int> mine = my_allocator<int>();
+    allocator<int> standard = std::allocator<int>();
+
+    assert(mine == allocator<int>(my_allocator<int>()));
+    assert(standard == allocator<int>(std::allocator<int>()));
+    assert(mine != standard);
+  }
+
   std::cout << "OK" << std::endl;
 }
 
@@ -0,0 +1,133 @@
+#include <agency/memory/detail/resource/monotonic_resource.hpp>
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+// counts the bytes it has outstanding and the number of calls to allocate
+struct counting_resource
+{
+  void* allocate(size_t num_bytes)
+  {
+    *outstanding_bytes += num_bytes;
+    ++*num_allocations;
+    return agency::detail::malloc_resource().allocate(num_bytes);
+  }
+
+  void deallocate(void* ptr, size_t num_bytes)
+  {
+    *outstanding_bytes -= num_bytes;
+    agency::detail::malloc_resource().deallocate(ptr, num_bytes);
+  }
+
+  size_t* outstanding_bytes;
+  size_t* num_allocations;
+};
+
+
+void test_caller_provided_buffer()
+{
+  using namespace agency::detail;
+
+  size_t outstanding_bytes = 0, num_upstream_allocations = 0;
+
+  {
+    alignas(16) char buffer[256];
+    monotonic_resource<counting_resource> resource(buffer, sizeof(buffer), counting_resource{&outstanding_bytes, &num_upstream_allocations});
+
+    // small allocations come from the buffer
+    void* a = resource.allocate(100);
+    void* b = resource.allocate(100);
+    assert(a == buffer);
+    assert(resource.owns(b, 100));
+    assert(num_upstream_allocations == 0);
+
+    // deallocating the most recent allocation makes its storage available again
+    resource.deallocate(b, 100);
+    assert(resource.allocate(100) == b);
+
+    // this doesn't fit in the buffer
+    void* c = resource.allocate(200);
+    assert(resource.owns(c, 200));
+    assert(num_upstream_allocations == 1);
+    assert(reinterpret_cast<std::uintptr_t>(c) % alignof(std::max_align_t) == 0);
+
+    std::memset(c, 0, 200);
+  }
+
+  // destruction returns every block
+  assert(outstanding_bytes == 0);
+}
+
+
+void test_geometric_growth()
+{
+  using namespace agency::detail;
+
+  size_t outstanding_bytes = 0, num_upstream_allocations = 0;
+
+  {
+    inline_monotonic_resource<512, counting_resource> resource(counting_resource{&outstanding_bytes, &num_upstream_allocations});
+
+    // allocate a megabyte in small pieces
+    std::vector<void*> ptrs;
+    for(int i = 0; i < 1024; ++i)
+    {
+      ptrs.push_back(resource.allocate(1024));
+      std::memset(ptrs.back(), i, 1024);
+    }
+
+    for(int i = 0; i < 1024; ++i)
+    {
+      assert(*reinterpret_cast<unsigned char*>(ptrs[i]) == static_cast<unsigned char>(i));
+    }
+
+    // blocks double in size, so there are few upstream allocations
+    assert(num_upstream_allocations <= 12);
+
+    // deallocating everything keeps only the largest block
+    for(int i = 1023; i >= 0; --i)
+    {
+      resource.deallocate(ptrs[i], 1024);
+    }
+
+    size_t largest_block = outstanding_bytes;
+    assert(largest_block >= 512 * 1024);
+
+    // a second round fits entirely within the largest block
+    size_t num_allocations_before = num_upstream_allocations;
+
+    for(int i = 0; i < 256; ++i)
+    {
+      ptrs[i] = resource.allocate(1024);
+    }
+
+    assert(num_upstream_allocations == num_allocations_before);
+
+    for(int i = 0; i < 256; ++i)
+    {
+      resource.deallocate(ptrs[i], 1024);
+    }
+
+    // allocations larger than the next block get a block of their own
+    void* large = resource.allocate(16 * 1024 * 1024);
+    assert(large != nullptr);
+    resource.deallocate(large, 16 * 1024 * 1024);
+
+    resource.release();
+    assert(outstanding_bytes == 0);
+  }
+
+  assert(outstanding_bytes == 0);
+}
+
+
+int main()
+{
+  test_caller_provided_buffer();
+  test_geometric_growth();
+
+  std::cout << "OK" << std::endl;
+}
+
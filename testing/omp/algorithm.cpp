@@ -0,0 +1,112 @@
+#include <agency/algorithm.hpp>
+#include <agency/omp.hpp>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+template<class ExecutionPolicy>
+void test(ExecutionPolicy policy)
+{
+  size_t n = 1 << 16;
+
+  std::vector<int> data(n);
+  std::iota(data.begin(), data.end(), 0);
+
+  {
+    // for_each
+    std::vector<int> x = data;
+
+    agency::for_each(policy, x.begin(), x.end(), [](int& x)
+    {
+      x += 1;
+    });
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(x[i] == int(i) + 1);
+    }
+  }
+
+  {
+    // transform
+    std::vector<int> result(n);
+
+    agency::transform(policy, data.begin(), data.end(), result.begin(), [](int x)
+    {
+      return 2 * x;
+    });
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(result[i] == 2 * int(i));
+    }
+  }
+
+  {
+    // reduce & transform_reduce
+    long long expected = std::accumulate(data.begin(), data.end(), 13ll);
+
+    assert(agency::reduce(policy, data.begin(), data.end(), 13ll) == expected);
+    assert(agency::transform_reduce(policy, data.begin(), data.end(), 13ll, std::plus<long long>(), [](int x) { return (long long)x; }) == expected);
+  }
+
+  {
+    // inclusive_scan & exclusive_scan
+    std::vector<int> x(n, 1);
+
+    std::vector<int> inclusive(n);
+    agency::inclusive_scan(policy, x.begin(), x.end(), inclusive.begin());
+
+    std::vector<int> exclusive(n);
+    agency::exclusive_scan(policy, x.begin(), x.end(), exclusive.begin(), 0);
+
+    for(size_t i = 0; i < n; ++i)
+    {
+      assert(inclusive[i] == int(i) + 1);
+      assert(exclusive[i] == int(i));
+    }
+  }
+
+  {
+    // sort
+    std::vector<int> x(n);
+    std::default_random_engine rng;
+    std::generate(x.begin(), x.end(), rng);
+
+    agency::sort(policy, x.begin(), x.end());
+    assert(std::is_sorted(x.begin(), x.end()));
+  }
+
+  {
+    // partition
+    std::vector<int> x = data;
+
+    auto is_even = [](int x)
+    {
+      return x % 2 == 0;
+    };
+
+    auto middle = agency::partition(policy, x.begin(), x.end(), is_even);
+
+    assert(middle - x.begin() == std::ptrdiff_t(n / 2));
+    assert(std::is_partitioned(x.begin(), x.end(), is_even));
+  }
+}
+
+
+int main()
+{
+  test(agency::omp::par);
+  test(agency::omp::unseq);
+  test(agency::omp::con);
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
+
@@ -0,0 +1,199 @@
+#include <agency/agency.hpp>
+#include <agency/omp.hpp>
+#include <iostream>
+#include <vector>
+#include <numeric>
+#include <atomic>
+#include <cassert>
+
+
+void test_parallel_execution_policy()
+{
+  using namespace agency;
+
+  for(size_t n : {0, 1, 13, 1000})
+  {
+    std::vector<int> data(n, 0);
+
+    bulk_invoke(omp::par(n), [&](parallel_agent& self)
+    {
+      data[self.index()] = self.index();
+    });
+
+    std::vector<int> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+
+    assert(expected == data);
+  }
+
+  {
+    // test bulk_async & bulk_then
+    size_t n = 1000;
+
+    auto fut = bulk_async(omp::par(n), [](parallel_agent& self)
+    {
+      return single_result<int>(7);
+    });
+
+    auto result = bulk_then(omp::par(n), [](parallel_agent& self, int& past_arg)
+    {
+      return static_cast<int>(self.index()) + past_arg;
+    },
+    fut).get();
+
+    std::vector<int> expected(n);
+    std::iota(expected.begin(), expected.end(), 7);
+
+    assert(std::equal(expected.begin(), expected.end(), result.begin()));
+  }
+}
+
+
+void test_scoped_execution_policy()
+{
+  using namespace agency;
+
+  using agent_type = parallel_group<unsequenced_agent>;
+
+  static_assert(std::is_same<decltype(omp::par(2, omp::unseq(2)).executor()), scoped_executor<omp::parallel_for_executor, omp::simd_executor>&>::value,
+    "omp::par(n, omp::unseq(m)) should use scoped_executor<omp::parallel_for_executor, omp::simd_executor>");
+
+  for(size_t n : {1, 7, 100})
+  {
+    for(size_t m : {1, 8, 33})
+    {
+      std::vector<int> data(n * m, 0);
+
+      bulk_invoke(omp::par(n, omp::unseq(m)), [&](agent_type& self)
+      {
+        size_t i = self.outer().index() * m + self.inner().index();
+        data[i] = i;
+      });
+
+      std::vector<int> expected(n * m);
+      std::iota(expected.begin(), expected.end(), 0);
+
+      assert(expected == data);
+    }
+  }
+
+  {
+    // test inner shared parameters, which each group creates separately
+    size_t n = 100, m = 10;
+
+    std::vector<int> data(n, 0);
+
+    bulk_invoke(omp::par(n, omp::unseq(m)), [&](agent_type& self, std::vector<int>& outer_shared, int& inner_shared)
+    {
+      // only the first agent of each group writes, so the group's agents do not race
+      if(self.inner().index() == 0)
+      {
+        inner_shared += static_cast<int>(self.outer().index());
+        data[self.outer().index()] = inner_shared + outer_shared[self.outer().index()];
+      }
+    },
+    share(std::vector<int>(n, 1)),
+    share_at_scope<1>(13));
+
+    std::vector<int> expected(n);
+    std::iota(expected.begin(), expected.end(), 14);
+
+    assert(expected == data);
+  }
+}
+
+
+void test_concurrent_execution_policy()
+{
+  using namespace agency;
+
+  for(size_t n : {1, 2, 3, 16})
+  {
+    std::vector<int> data(n, 0);
+
+    bulk_invoke(omp::con(n), [&](omp::concurrent_agent& self)
+    {
+      size_t i = self.index();
+
+      // each iteration, every agent reads its neighbor's element from the previous iteration
+      for(int iteration = 0; iteration < 20; ++iteration)
+      {
+        assert(data[(i + 1) % n] == iteration);
+
+        self.wait();
+
+        data[i] = iteration + 1;
+
+        self.wait();
+      }
+    });
+
+    assert(std::vector<int>(n, 20) == data);
+  }
+
+  {
+    // test a group launched from within an OpenMP parallel region
+    // the enclosing region prevents OpenMP from creating a nested team, so the group executes on other threads
+    std::atomic<int> num_groups_complete(0);
+
+    #pragma omp parallel num_threads(2)
+    {
+      size_t n = 4;
+      std::vector<int> data(n, 0);
+
+      bulk_invoke(omp::con(n), [&](omp::concurrent_agent& self)
+      {
+        size_t i = self.index();
+
+        for(int iteration = 0; iteration < 10; ++iteration)
+        {
+          assert(data[(i + 1) % n] == iteration);
+
+          self.wait();
+
+          data[i] = iteration + 1;
+
+          self.wait();
+        }
+      });
+
+      assert(std::vector<int>(n, 10) == data);
+
+      ++num_groups_complete;
+    }
+
+    assert(num_groups_complete > 0);
+  }
+
+  {
+    // test that an exception thrown by an agent is rethrown to the caller
+    bool caught_exception = false;
+
+    try
+    {
+      bulk_invoke(omp::con(4), [](omp::concurrent_agent& self)
+      {
+        if(self.index() == 2) throw 13;
+      });
+    }
+    catch(int e)
+    {
+      assert(e == 13);
+      caught_exception = true;
+    }
+
+    assert(caught_exception);
+  }
+}
+
+
+int main()
+{
+  test_parallel_execution_policy();
+  test_scoped_execution_policy();
+  test_concurrent_execution_policy();
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
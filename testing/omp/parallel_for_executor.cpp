@@ -0,0 +1,145 @@
+#include <iostream>
+#include <type_traits>
+#include <vector>
+#include <numeric>
+#include <cassert>
+
+#include <agency/omp/execution.hpp>
+#include <agency/execution/executor/executor_traits.hpp>
+#include <agency/execution/executor/executor_traits/detail/is_bulk_then_executor.hpp>
+#include <agency/execution/executor/customization_points.hpp>
+#include <agency/execution/executor/properties/bulk_guarantee.hpp>
+#include <agency/execution/executor/properties/schedule.hpp>
+#include <agency/execution/executor/require.hpp>
+#include <agency/execution/executor/query.hpp>
+
+
+template<class Executor>
+void test_bulk_then_execute(Executor exec)
+{
+  using namespace agency;
+
+  agency::future<int> fut = agency::make_ready_future<int>(exec, 7);
+
+  size_t shape = 1000;
+  
+  auto f = exec.bulk_then_execute(
+    [](size_t idx, int& past_arg, std::vector<int>& results, std::vector<int>& shared_arg)
+    {
+      results[idx] = past_arg + shared_arg[idx];
+    },
+    shape,
+    fut,
+    [=]{ return std::vector<int>(shape); },     // results
+    [=]{ return std::vector<int>(shape, 13); }  // shared_arg
+  );
+  
+  auto result = f.get();
+  
+  assert(std::vector<int>(shape, 7 + 13) == result);
+}
+
+
+template<class Executor>
+void test_bulk_twoway_execute(Executor exec)
+{
+  size_t shape = 1000;
+
+  auto f = exec.bulk_twoway_execute(
+    [](size_t idx, std::vector<int>& results, int& shared_arg)
+    {
+      results[idx] = static_cast<int>(idx) + shared_arg;
+    },
+    shape,
+    [=]{ return std::vector<int>(shape); }, // results
+    []{ return 13; }                        // shared_arg
+  );
+
+  std::vector<int> expected(shape);
+  std::iota(expected.begin(), expected.end(), 13);
+
+  assert(expected == f.get());
+}
+
+
+int main()
+{
+  using namespace agency;
+
+  using executor_type = omp::parallel_for_executor;
+
+  static_assert(detail::is_bulk_then_executor<executor_type>::value,
+    "omp::parallel_for_executor should be a bulk then executor");
+
+  static_assert(bulk_guarantee_t::static_query<executor_type>() == bulk_guarantee_t::parallel_t(),
+    "omp::parallel_for_executor should have parallel static bulk guarantee");
+
+  static_assert(detail::is_detected_exact<agency::future<int>, executor_future_t, executor_type, int>::value,
+    "omp::parallel_for_executor should have agency::future future");
+
+  {
+    // test the default schedule
+    executor_type exec;
+
+    assert(agency::query(exec, schedule).is_uniform());
+
+    test_bulk_twoway_execute(exec);
+    test_bulk_then_execute(exec);
+  }
+
+  {
+    // test a dynamic schedule
+    auto exec = agency::require(executor_type(), schedule.dynamic(16));
+
+    static_assert(std::is_same<executor_type, decltype(exec)>::value, "require(omp::parallel_for_executor, schedule) should return omp::parallel_for_executor");
+
+    assert(agency::query(exec, schedule).is_dynamic());
+    assert(agency::query(exec, schedule).chunk_size() == 16);
+    assert(exec != executor_type());
+
+    test_bulk_twoway_execute(exec);
+    test_bulk_then_execute(exec);
+  }
+
+  {
+    // test a guided schedule
+    auto exec = agency::require(executor_type(), schedule.guided(4));
+
+    assert(agency::query(exec, schedule).is_guided());
+    assert(agency::query(exec, schedule).chunk_size() == 4);
+
+    test_bulk_twoway_execute(exec);
+    test_bulk_then_execute(exec);
+  }
+
+  {
+    // test that an exception thrown by an agent is rethrown to the caller
+    executor_type exec;
+
+    bool caught_exception = false;
+
+    try
+    {
+      exec.bulk_twoway_execute(
+        [](size_t idx, int&, int&)
+        {
+          if(idx == 13) throw 13;
+        },
+        100,
+        []{ return 0; },
+        []{ return 0; }
+      ).get();
+    }
+    catch(int e)
+    {
+      assert(e == 13);
+      caught_exception = true;
+    }
+
+    assert(caught_exception);
+  }
+
+  std::cout << "OK" << std::endl;
+
+  return 0;
+}
@@ -45,6 +45,8 @@ int main()
 
   assert(reduce(data.begin(), data.end(), 0, std::plus<int>()) == accumulate(data.begin(), data.end(), 0, std::plus<int>()));
 
+  assert(agency::reduce(agency::par, data.begin(), data.end(), 0, std::plus<int>()) == accumulate(data.begin(), data.end(), 0, std::plus<int>()));
+
   std::cout << "OK" << std::endl;
 
   return 0;
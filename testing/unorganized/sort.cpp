@@ -105,6 +105,18 @@ int main()
 
   assert(std::is_sorted(data.begin(), data.end()));
 
+  std::generate(data.begin(), data.end(), rng);
+
+  // ensure unsorted data
+  data[0] = 1;
+  data[1] = 0;
+
+  assert(!std::is_sorted(data.begin(), data.end()));
+
+  agency::sort(agency::par, data.begin(), data.end());
+
+  assert(std::is_sorted(data.begin(), data.end()));
+
   std::cout << "OK" << std::endl;
 
   return 0;